@@ -0,0 +1,75 @@
+#include "Benchmarks.h"
+
+#if defined(_WIN32)
+#   include <windows.h>
+#else
+#   include <time.h>
+#   include <sched.h>
+#endif
+
+static volatile float sink;
+
+double BenchmarkTime(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+void BenchmarkSink(float value)
+{
+    sink += value;
+}
+
+void BenchmarkYield(void)
+{
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+uint64_t BenchmarkHash(const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("Benchmarks\n");
+
+    failures += BenchmarkFastMath();
+    failures += BenchmarkAssetArchive();
+    failures += BenchmarkVoicePool();
+    failures += BenchmarkMusicStream();
+    failures += BenchmarkShaderCache();
+    failures += BenchmarkBloom();
+    failures += BenchmarkSoftRenderer();
+    failures += BenchmarkRenderRecorder();
+    failures += BenchmarkSpine();
+    failures += BenchmarkSpringGrid();
+    failures += BenchmarkDeformMesh2D();
+    failures += BenchmarkHeightField();
+    failures += BenchmarkLiquidSurface2D();
+    failures += BenchmarkNeonShooterWorld();
+    failures += BenchmarkFileWatcher();
+
+    return failures > 0 ? 1 : 0;
+}
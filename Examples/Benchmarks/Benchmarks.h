@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <raylib.h>
+#include <SpringGrid.h>
+#include <SoftRenderer.h>
+
+// Seconds from an arbitrary origin, high resolution
+double  BenchmarkTime(void);
+
+// Defeat dead code elimination of benchmark results
+void    BenchmarkSink(float value);
+
+// Give the rest of the time slice to other threads while polling
+void    BenchmarkYield(void);
+
+// FNV-1a, to compare frames and buffers across runs
+uint64_t BenchmarkHash(const void* data, size_t size);
+
+// NeonShooter like frame drawn through the Renderer front end, glow is a backend texture
+void    BenchmarkDrawScene(int width, int height, Texture glow, float time);
+
+// One line of frame time and statistics of a SoftRenderer frame, with the hash of its pixels
+void    BenchmarkReportFrame(const char* label, double frameTime, SoftRendererStats stats, SoftRenderer* renderer);
+
+// Spring grid of the LiquidSurface2D example with every tile awake, shared by the spring grid and heightfield benchmarks
+extern const SpringGridParams benchmarkLiquidParams;
+
+// Seconds per tick of ticks updates at 60 Hz, pushed around center every tick when push is set
+double  BenchmarkSpringGridTicks(SpringGrid grid, Vector2 center, bool push, int ticks);
+
+#define BenchmarkReport(name, seconds, iterations) \
+    printf("  %-32s %8.3f ms  %8.2f ns/op\n", name, (seconds) * 1000.0, (seconds) * 1e9 / (double)(iterations))
+
+// Each benchmark return its count of failed accuracy checks
+int     BenchmarkFastMath(void);
+int     BenchmarkAssetArchive(void);
+int     BenchmarkVoicePool(void);
+int     BenchmarkMusicStream(void);
+int     BenchmarkShaderCache(void);
+int     BenchmarkBloom(void);
+int     BenchmarkSoftRenderer(void);
+int     BenchmarkRenderRecorder(void);
+int     BenchmarkSpine(void);
+int     BenchmarkSpringGrid(void);
+int     BenchmarkDeformMesh2D(void);
+int     BenchmarkHeightField(void);
+int     BenchmarkLiquidSurface2D(void);
+int     BenchmarkNeonShooterWorld(void);
+int     BenchmarkFileWatcher(void);
@@ -0,0 +1,212 @@
+#include "Benchmarks.h"
+
+#include <string.h>
+#include <raylib.h>
+#include <AssetArchive.h>
+
+#ifdef RELEASE
+#   define ASSET_PATH "Assets"
+#else
+#   define ASSET_PATH "../Binary/NeonShooter/Assets"
+#endif
+
+#define ASSET_ARCHIVE_PATH ASSET_PATH ".pak"
+
+// NeonShooter startup set: every texture and sound the game load up front or lazily
+static const char* imageNames[] = {
+    "Art/Player.png",
+    "Art/Seeker.png",
+    "Art/Wanderer.png",
+    "Art/Bullet.png",
+    "Art/Black Hole.png",
+    "Art/Laser.png",
+    "Art/Glow.png",
+    "Art/Pointer.png",
+};
+
+static const char* waveNames[] = {
+    "Audios/shoot-01.wav",
+    "Audios/shoot-02.wav",
+    "Audios/shoot-03.wav",
+    "Audios/shoot-04.wav",
+    "Audios/explosion-01.wav",
+    "Audios/explosion-02.wav",
+    "Audios/explosion-03.wav",
+    "Audios/explosion-04.wav",
+    "Audios/explosion-05.wav",
+    "Audios/explosion-06.wav",
+    "Audios/explosion-07.wav",
+    "Audios/explosion-08.wav",
+    "Audios/spawn-01.wav",
+    "Audios/spawn-02.wav",
+    "Audios/spawn-03.wav",
+    "Audios/spawn-04.wav",
+    "Audios/spawn-05.wav",
+    "Audios/spawn-06.wav",
+    "Audios/spawn-07.wav",
+    "Audios/spawn-08.wav",
+};
+
+#define IMAGE_COUNT (int)(sizeof(imageNames) / sizeof(imageNames[0]))
+#define WAVE_COUNT  (int)(sizeof(waveNames) / sizeof(waveNames[0]))
+
+static const char* LoosePath(const char* name)
+{
+    return TextFormat("%s/%s", ASSET_PATH, name);
+}
+
+// Touch one byte per page, the game upload every byte so the pages must be resident
+static float TouchPages(const void* data, uint64_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    uint32_t sum = 0;
+    for (uint64_t i = 0; i < size; i += 4096)
+    {
+        sum += bytes[i];
+    }
+
+    return (float)sum;
+}
+
+// Decode every asset from loose files, what the game do without an archive
+static double LoadLoose(void)
+{
+    double start = BenchmarkTime();
+
+    for (int i = 0; i < IMAGE_COUNT; i++)
+    {
+        Image image = LoadImage(LoosePath(imageNames[i]));
+        BenchmarkSink((float)image.width);
+        UnloadImage(image);
+    }
+
+    for (int i = 0; i < WAVE_COUNT; i++)
+    {
+        Wave wave = LoadWave(LoosePath(waveNames[i]));
+        BenchmarkSink((float)wave.sampleCount);
+        UnloadWave(wave);
+    }
+
+    return BenchmarkTime() - start;
+}
+
+// Map the archive and fetch the same assets, return a negative time when one is missing
+static double LoadPacked(void)
+{
+    double start = BenchmarkTime();
+
+    AssetArchive archive;
+    if (!AssetArchiveOpen(&archive, ASSET_ARCHIVE_PATH))
+    {
+        return -1.0;
+    }
+
+    int missing = 0;
+    for (int i = 0; i < IMAGE_COUNT; i++)
+    {
+        const AssetArchiveEntry* entry = AssetArchiveFind(&archive, imageNames[i]);
+        if (entry && entry->type == ASSET_IMAGE)
+        {
+            BenchmarkSink(TouchPages(AssetArchiveData(&archive, entry), entry->size));
+        }
+        else
+        {
+            missing++;
+        }
+    }
+
+    for (int i = 0; i < WAVE_COUNT; i++)
+    {
+        const AssetArchiveEntry* entry = AssetArchiveFind(&archive, waveNames[i]);
+        if (entry && entry->type == ASSET_WAVE)
+        {
+            BenchmarkSink(TouchPages(AssetArchiveData(&archive, entry), entry->size));
+        }
+        else
+        {
+            missing++;
+        }
+    }
+
+    AssetArchiveClose(&archive);
+
+    double seconds = BenchmarkTime() - start;
+    return missing > 0 ? -1.0 : seconds;
+}
+
+#define MALFORMED_ARCHIVE_PATH "Malformed.pak"
+
+// Params that decode to more bytes than the entry hold would make the upload read past the mapping
+static int CheckMalformedParams(void)
+{
+    static const uint8_t payload[64] = { 0 };
+    static const struct { const char* label; AssetType type; uint32_t params[4]; bool valid; } cases[] = {
+        { "image 4x4",              ASSET_IMAGE, { 4, 4, ASSET_IMAGE_FORMAT, 1 },  true },
+        { "image 4x5",              ASSET_IMAGE, { 4, 5, ASSET_IMAGE_FORMAT, 1 },  false },
+        { "image 65536x65536",      ASSET_IMAGE, { 65536, 65536, ASSET_IMAGE_FORMAT, 1 }, false },
+        { "image RGB8",             ASSET_IMAGE, { 4, 4, UNCOMPRESSED_R8G8B8, 1 }, false },
+        { "image 2 mipmaps",        ASSET_IMAGE, { 4, 4, ASSET_IMAGE_FORMAT, 2 },  false },
+        { "wave 32 samples 16 bit", ASSET_WAVE,  { 32, 44100, 16, 2 },             true },
+        { "wave 33 samples 16 bit", ASSET_WAVE,  { 33, 44100, 16, 1 },             false },
+        { "wave 12 bit",            ASSET_WAVE,  { 32, 44100, 12, 1 },             false },
+        { "wave no channel",        ASSET_WAVE,  { 32, 44100, 16, 0 },             false },
+    };
+
+    int failures = 0;
+    for (int i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++)
+    {
+        AssetArchiveBlob blob = { "Asset", cases[i].type, { 0 }, payload, sizeof(payload) };
+        memcpy(blob.params, cases[i].params, sizeof(blob.params));
+
+        AssetArchive archive;
+        bool opened = AssetArchiveWrite(MALFORMED_ARCHIVE_PATH, &blob, 1) && AssetArchiveOpen(&archive, MALFORMED_ARCHIVE_PATH);
+        if (opened)
+        {
+            AssetArchiveClose(&archive);
+        }
+
+        if (opened != cases[i].valid)
+        {
+            printf("  FAILED: %s in %d bytes %s\n", cases[i].label, (int)sizeof(payload), opened ? "opened" : "rejected");
+            failures++;
+        }
+    }
+    remove(MALFORMED_ARCHIVE_PATH);
+
+    printf("  Entry params against payload size: %d cases, %d failed\n", (int)(sizeof(cases) / sizeof(cases[0])), failures);
+    return failures;
+}
+
+int BenchmarkAssetArchive(void)
+{
+    printf("AssetArchive\n");
+
+    int failures = CheckMalformedParams();
+
+    if (!DirectoryExists(ASSET_PATH))
+    {
+        printf("  skipped: %s not found\n", ASSET_PATH);
+        return failures;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    // First run pay the disk reads, second run measure the OS file cache
+    double looseCold = LoadLoose();
+    double looseWarm = LoadLoose();
+    BenchmarkReport("startup loose (first)", looseCold, IMAGE_COUNT + WAVE_COUNT);
+    BenchmarkReport("startup loose (cached)", looseWarm, IMAGE_COUNT + WAVE_COUNT);
+
+    double packedCold = LoadPacked();
+    double packedWarm = LoadPacked();
+    if (packedCold < 0.0 || packedWarm < 0.0)
+    {
+        printf("  skipped packed: %s missing or stale, run AssetPacker %s %s\n", ASSET_ARCHIVE_PATH, ASSET_PATH, ASSET_ARCHIVE_PATH);
+        return failures;
+    }
+
+    BenchmarkReport("startup packed (first)", packedCold, IMAGE_COUNT + WAVE_COUNT);
+    BenchmarkReport("startup packed (cached)", packedWarm, IMAGE_COUNT + WAVE_COUNT);
+    return failures;
+}
@@ -0,0 +1,162 @@
+#include "Benchmarks.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <Bloom.h>
+#include <Memory.h>
+#include <JobSystem.h>
+
+#define CHECK_WIDTH     96      // Not square, the vertical step is a fraction of a texel like at 720p
+#define CHECK_HEIGHT    54
+#define REPEAT_COUNT    10
+
+// Bloom.frag evaluated texel by texel in double, nearest sampling with repeat wrap
+static void ReferenceBloom(const float* source, double* dest, int width, int height)
+{
+    static const double weights[5] = { 0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216 };
+    double size = width > height ? width : height;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            double u = (x + 0.5) / width;
+            double v = (y + 0.5) / height;
+
+            for (int c = 0; c < 3; c++)
+            {
+                #define SAMPLE(su, sv) source[(((int)floor((sv) * height) % height + height) % height * width + ((int)floor((su) * width) % width + width) % width) * 4 + c]
+
+                double result = SAMPLE(u, v) * weights[0];
+                for (int i = 1; i < 5; i++)
+                {
+                    result += SAMPLE(u + i / size, v) * weights[i];
+                    result += SAMPLE(u - i / size, v) * weights[i];
+                    result += SAMPLE(u, v + i / size) * weights[i];
+                    result += SAMPLE(u, v - i / size) * weights[i];
+                }
+
+                result += SAMPLE(u, v);
+                result = 1.0 - exp(-result * 0.5);
+                dest[(y * width + x) * 4 + c] = pow(result, 1.0 / 2.2);
+
+                #undef SAMPLE
+            }
+
+            dest[(y * width + x) * 4 + 3] = 1.0;
+        }
+    }
+}
+
+static int CheckBloom(void)
+{
+    int failures = 0;
+    int count = CHECK_WIDTH * CHECK_HEIGHT * 4;
+
+    uint8_t* source8 = (uint8_t*)MemoryAlloc(count);
+    uint8_t* dest8 = (uint8_t*)MemoryAlloc(count);
+    float* source = (float*)MemoryAlloc(sizeof(float) * count);
+    float* dest = (float*)MemoryAlloc(sizeof(float) * count);
+    double* expected = (double*)MemoryAlloc(sizeof(double) * count);
+
+    // Mostly black with bright sprites, black pixels exercise the tone map near zero
+    for (int i = 0; i < count; i++)
+    {
+        source8[i] = rand() % 4 == 0 ? (uint8_t)(rand() % 256) : 0;
+        source[i] = source8[i] / 255.0f;
+    }
+    ReferenceBloom(source, expected, CHECK_WIDTH, CHECK_HEIGHT);
+
+    Bloom bloom = BloomNew(CHECK_WIDTH, CHECK_HEIGHT);
+    BloomApplyFloat(&bloom, source, dest);
+    BloomApplyRGBA8(&bloom, source8, dest8);
+    BloomFree(&bloom);
+
+    double floatError = 0.0;
+    int byteError = 0;
+    for (int i = 0; i < count; i++)
+    {
+        floatError = fmax(floatError, fabs(dest[i] - expected[i]));
+        byteError = abs(dest8[i] - (int)floor(expected[i] * 255.0 + 0.5)) > byteError ? abs(dest8[i] - (int)floor(expected[i] * 255.0 + 0.5)) : byteError;
+    }
+    printf("  max error against the shader math: %.2e (float), %d (8 bits)\n", floatError, byteError);
+
+    if (floatError > 1e-5)
+    {
+        printf("  FAILED: float bloom error %.2e > 1e-5\n", floatError);
+        failures++;
+    }
+
+    if (byteError > 1)
+    {
+        printf("  FAILED: 8 bits bloom error %d > 1\n", byteError);
+        failures++;
+    }
+
+    MemoryFree(source8);
+    MemoryFree(dest8);
+    MemoryFree(source);
+    MemoryFree(dest);
+    MemoryFree(expected);
+    return failures;
+}
+
+static void MeasureBloom(const char* label, int width, int height)
+{
+    int count = width * height * 4;
+    uint8_t* source8 = (uint8_t*)MemoryAlloc(count);
+    uint8_t* dest8 = (uint8_t*)MemoryAlloc(count);
+    float* source = (float*)MemoryAlloc(sizeof(float) * count);
+    float* dest = (float*)MemoryAlloc(sizeof(float) * count);
+
+    for (int i = 0; i < count; i++)
+    {
+        source8[i] = (uint8_t)(rand() % 256);
+        source[i] = source8[i] / 255.0f;
+    }
+
+    Bloom bloom = BloomNew(width, height);
+
+    double start = BenchmarkTime();
+    for (int i = 0; i < REPEAT_COUNT; i++)
+    {
+        BloomApplyRGBA8(&bloom, source8, dest8);
+    }
+    double rgba8Time = (BenchmarkTime() - start) / REPEAT_COUNT;
+
+    start = BenchmarkTime();
+    for (int i = 0; i < REPEAT_COUNT; i++)
+    {
+        BloomApplyFloat(&bloom, source, dest);
+    }
+    double floatTime = (BenchmarkTime() - start) / REPEAT_COUNT;
+
+    BenchmarkSink((float)dest8[count / 2] + dest[count / 2]);
+    printf("  %-18s RGBA8 %7.2f ms %7.1f Mpixel/s   float %7.2f ms %7.1f Mpixel/s\n",
+        label, rgba8Time * 1000.0, width * height / rgba8Time * 1e-6, floatTime * 1000.0, width * height / floatTime * 1e-6);
+
+    BloomFree(&bloom);
+    MemoryFree(source8);
+    MemoryFree(dest8);
+    MemoryFree(source);
+    MemoryFree(dest);
+}
+
+int BenchmarkBloom(void)
+{
+    printf("Bloom\n");
+
+    int failures = CheckBloom();
+
+    // Without workers ParallelFor run every batch on the calling thread
+    MeasureBloom("720p, 1 thread", 1280, 720);
+    MeasureBloom("1080p, 1 thread", 1920, 1080);
+
+    JobSystemInit(0);
+    failures += CheckBloom();
+    MeasureBloom("720p, all threads", 1280, 720);
+    MeasureBloom("1080p, all threads", 1920, 1080);
+    JobSystemShutdown();
+
+    return failures;
+}
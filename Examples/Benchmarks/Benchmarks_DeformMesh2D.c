@@ -0,0 +1,491 @@
+#include "Benchmarks.h"
+
+#include <math.h>
+#include <FastMath.h>
+#include <DeformMesh2D.h>
+#include <GridMesh.h>
+#include <JobSystem.h>
+#include <Renderer.h>
+
+#define SPRING_FORCE    20.0f
+#define DAMPING         5.0f
+#define PUSH_FORCE      100.0f
+#define TIME_STEP       (1.0f / 60.0f)
+#define PUSH_TICKS      30
+#define CHECK_TICKS     240
+#define TICK_BUDGET     0.25        // Seconds of ticks per measure
+#define CHECK_WORKERS   3           // Batches run out of order even on few cores
+#define MIN_THREADS     4           // Scaling is measured up to this many threads even on smaller machines
+
+#if FASTMATH_SSE
+#   define KERNEL_NAME  "SSE"
+#else
+#   define KERNEL_NAME  "kernel"
+#endif
+
+// The reference stay scalar whatever the compiler, the kernel is measured against it
+#if defined(_MSC_VER)
+#   define SCALAR_FUNCTION
+#   define SCALAR_LOOP  __pragma(loop(no_vector))
+#elif defined(__clang__)
+#   define SCALAR_FUNCTION
+#   define SCALAR_LOOP  _Pragma("clang loop vectorize(disable)")
+#elif defined(__GNUC__)
+#   define SCALAR_FUNCTION __attribute__((optimize("no-tree-vectorize")))
+#   define SCALAR_LOOP
+#else
+#   define SCALAR_FUNCTION
+#   define SCALAR_LOOP
+#endif
+
+// Single threaded scalar update of MeshDeformation2D before DeformMesh2D, kept as the reference
+SCALAR_FUNCTION static void UpdateScalarMesh(DeformMesh2D mesh, float dt)
+{
+    float spring = mesh.springForce * dt;
+    float factor = fmaxf(0.0f, 1.0f - mesh.damping * dt);
+
+    SCALAR_LOOP
+    for (int i = 0, n = mesh.width * mesh.height; i < n; i++)
+    {
+        float vx = (mesh.velocityX[i] - (mesh.positionX[i] - mesh.originX[i]) * spring) * factor;
+        float vy = (mesh.velocityY[i] - (mesh.positionY[i] - mesh.originY[i]) * spring) * factor;
+
+        mesh.velocityX[i] = vx;
+        mesh.velocityY[i] = vy;
+        mesh.positionX[i] += vx * dt;
+        mesh.positionY[i] += vy * dt;
+    }
+}
+
+// Scan of every vertex, as the mesh did before the forces were culled on the lattice
+static void ApplyScalarForces(DeformMesh2D mesh, const DeformMesh2DForce* forces, int count, float dt)
+{
+    for (int f = 0; f < count; f++)
+    {
+        for (int i = 0, n = mesh.width * mesh.height; i < n; i++)
+        {
+            Vector2 pointToVertex = { mesh.positionX[i] - forces[f].position.x, mesh.positionY[i] - forces[f].position.y };
+            float lengthSq = pointToVertex.x * pointToVertex.x + pointToVertex.y * pointToVertex.y;
+            if (lengthSq < forces[f].radius * forces[f].radius && lengthSq > 0.0f)
+            {
+                float length = sqrtf(lengthSq);
+                float scale = forces[f].force / (1.0f + length) * dt / length;
+                mesh.velocityX[i] += pointToVertex.x * scale;
+                mesh.velocityY[i] += pointToVertex.y * scale;
+            }
+        }
+    }
+}
+
+// Touch points spread over the surface
+static void TouchForces(DeformMesh2DForce* forces, int count, int width, int height, float radius)
+{
+    for (int i = 0; i < count; i++)
+    {
+        forces[i] = (DeformMesh2DForce) { { width * (0.1f + 0.8f * (i % 5) / 4.0f), height * (0.3f + 0.4f * (i / 5)) }, PUSH_FORCE, radius };
+    }
+}
+
+static DeformMesh2D NewBenchmarkMesh(int width, int height, float spacing)
+{
+    DeformMesh2D mesh = DeformMesh2DNew((Rectangle) { 0, 0, (float)width, (float)height }, (Vector2) { spacing, spacing }, SPRING_FORCE, DAMPING);
+    mesh.sleepSpeed = 0.0f;
+    return mesh;
+}
+
+// Odd sizes exercise the scalar tail of the 4 vertices kernel and the partial tiles
+static int CheckDeformMesh2D(int width, int height, float spacing)
+{
+    DeformMesh2D reference = NewBenchmarkMesh(width, height, spacing);
+    DeformMesh2D mesh = NewBenchmarkMesh(width, height, spacing);
+
+    // Sources overlap and reach past the borders
+    DeformMesh2DForce forces[3] = {
+        { { width * 0.37f, height * 0.61f }, PUSH_FORCE, width * 0.25f },
+        { { width * 0.45f, height * 0.55f }, -PUSH_FORCE, width * 0.1f },
+        { { -10.0f, height + 5.0f }, PUSH_FORCE, width * 0.5f },
+    };
+
+    float maxError = 0.0f;
+    for (int tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        if (tick < PUSH_TICKS)
+        {
+            ApplyScalarForces(reference, forces, 3, TIME_STEP);
+            DeformMesh2DApplyForces(mesh, forces, 3, TIME_STEP);
+        }
+
+        UpdateScalarMesh(reference, TIME_STEP);
+        DeformMesh2DUpdate(mesh, TIME_STEP);
+    }
+
+    for (int i = 0, n = mesh.width * mesh.height; i < n; i++)
+    {
+        maxError = fmaxf(maxError, fabsf(mesh.positionX[i] - reference.positionX[i]));
+        maxError = fmaxf(maxError, fabsf(mesh.positionY[i] - reference.positionY[i]));
+    }
+
+    // A sleeping mesh must come back to rest after the same push
+    mesh.sleepSpeed = 1.0f;
+    DeformMesh2DApplyForces(mesh, forces, 3, TIME_STEP);
+    for (int tick = 0; tick < CHECK_TICKS * 4; tick++)
+    {
+        DeformMesh2DUpdate(mesh, TIME_STEP);
+    }
+    int awakeTiles = DeformMesh2DAwakeTileCount(mesh);
+
+    int failures = 0;
+    printf("  %dx%d vertices, %d threads: max difference with the scalar update and forces %.2e px, %d tiles awake after settling\n",
+        mesh.width, mesh.height, JobSystemWorkerCount() + 1, maxError, awakeTiles);
+    if (maxError > 1e-4f || awakeTiles > 0)
+    {
+        printf("  FAILED: DeformMesh2D does not follow the scalar update or does not sleep\n");
+        failures++;
+    }
+
+    DeformMesh2DFree(&mesh);
+    DeformMesh2DFree(&reference);
+    return failures;
+}
+
+typedef void DeformMesh2DUpdateFunc(DeformMesh2D mesh, float dt);
+
+// Same motion before every run, a mesh left damping for seconds end in denormals that are much slower
+static void ShakeMesh(DeformMesh2D mesh)
+{
+    for (int i = 0, n = mesh.width * mesh.height; i < n; i++)
+    {
+        mesh.velocityX[i] = 40.0f * sinf(i * 0.37f);
+        mesh.velocityY[i] = 40.0f * cosf(i * 0.91f);
+        mesh.positionX[i] = mesh.originX[i];
+        mesh.positionY[i] = mesh.originY[i];
+    }
+}
+
+static double TimeTicks(DeformMesh2D mesh, DeformMesh2DUpdateFunc* update)
+{
+    int ticks = 0;
+    double elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        ShakeMesh(mesh);
+
+        double start = BenchmarkTime();
+        for (int tick = 0; tick < PUSH_TICKS; tick++)
+        {
+            update(mesh, TIME_STEP);
+        }
+        elapsed += BenchmarkTime() - start;
+        ticks += PUSH_TICKS;
+    }
+
+    BenchmarkSink(mesh.positionX[mesh.width * mesh.height / 2]);
+    return elapsed / ticks;
+}
+
+// Every tile awake, the cost of a mesh shaken all over
+// The kernel on the calling thread against the scalar reference, then its scaling with the threads
+static void MeasureDeformMesh2D(int width, int height, float spacing, int hardwareThreads)
+{
+    DeformMesh2D mesh = NewBenchmarkMesh(width, height, spacing);
+
+    double scalarTime = TimeTicks(mesh, UpdateScalarMesh);
+    double kernelTime = TimeTicks(mesh, DeformMesh2DUpdate);
+
+    int count = mesh.width * mesh.height;
+    printf("  %2.0f px %8d vertices %6.1f MB  scalar %8.3f ms/tick %5.2f ns/vertex   " KERNEL_NAME " %8.3f ms/tick %5.2f ns/vertex x%.1f\n",
+        spacing, count, count * 6.0 * sizeof(float) / (1024.0 * 1024.0), scalarTime * 1000.0, scalarTime * 1e9 / count, kernelTime * 1000.0, kernelTime * 1e9 / count, scalarTime / kernelTime);
+
+    printf("         " KERNEL_NAME " threads:");
+    int maxThreads = hardwareThreads > MIN_THREADS ? hardwareThreads : MIN_THREADS;
+    for (int threads = 2; threads <= maxThreads; threads *= 2)
+    {
+        JobSystemInit(threads - 1);
+        double threadedTime = TimeTicks(mesh, DeformMesh2DUpdate);
+        JobSystemShutdown();
+
+        printf("  %d x%.1f%s", threads, kernelTime / threadedTime, threads > hardwareThreads ? "*" : "");
+    }
+    printf("\n");
+
+    DeformMesh2DFree(&mesh);
+}
+
+static double TimeForces(DeformMesh2D mesh, const DeformMesh2DForce* forces, int count, bool culled)
+{
+    int runs = 0;
+    double start = BenchmarkTime();
+    double elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        if (culled)
+        {
+            DeformMesh2DApplyForces(mesh, forces, count, TIME_STEP);
+        }
+        else
+        {
+            ApplyScalarForces(mesh, forces, count, TIME_STEP);
+        }
+        runs++;
+        elapsed = BenchmarkTime() - start;
+    }
+
+    BenchmarkSink(mesh.velocityX[mesh.width * mesh.height / 2]);
+    return elapsed / runs;
+}
+
+// Pushes of the example radius, one mouse and ten touch points
+static void MeasureForces(int width, int height, float spacing, float radius)
+{
+    DeformMesh2D mesh = NewBenchmarkMesh(width, height, spacing);
+
+    DeformMesh2DForce forces[MAX_TOUCH_POINTS];
+    TouchForces(forces, MAX_TOUCH_POINTS, width, height, radius);
+
+    double scanTime = TimeForces(mesh, forces, 1, false);
+    double culledTime = TimeForces(mesh, forces, 1, true);
+    double touchScanTime = TimeForces(mesh, forces, MAX_TOUCH_POINTS, false);
+    double touchCulledTime = TimeForces(mesh, forces, MAX_TOUCH_POINTS, true);
+
+    printf("  %2.0f px radius %3.0f  1 force: scan %8.3f ms culled %7.3f ms x%.0f   %d forces: scan %8.3f ms culled %7.3f ms x%.0f\n",
+        spacing, radius, scanTime * 1000.0, culledTime * 1000.0, scanTime / culledTime,
+        MAX_TOUCH_POINTS, touchScanTime * 1000.0, touchCulledTime * 1000.0, touchScanTime / touchCulledTime);
+
+    DeformMesh2DFree(&mesh);
+}
+
+// Backend that only count the triangles, the frame cost is the one of the front end
+static int64_t emittedTriangles;
+
+static void CountClear(void* userData, Color color)
+{
+    (void)userData; (void)color;
+}
+
+static void CountSetBlendMode(void* userData, int blendMode)
+{
+    (void)userData; (void)blendMode;
+}
+
+static void CountDrawTriangles(void* userData, unsigned int textureId, const RendererVertex* vertices, int vertexCount)
+{
+    (void)userData; (void)textureId;
+    emittedTriangles += vertexCount / 3;
+    BenchmarkSink(vertices[vertexCount - 1].x);
+}
+
+static const RendererBackend countingBackend = { NULL, CountClear, CountSetBlendMode, NULL, CountDrawTriangles, NULL };
+
+// Every vertex at its displaced position and two triangles per cell on the corners of the cell
+static int CheckGridMesh(int width, int height, float spacing)
+{
+    DeformMesh2D mesh = NewBenchmarkMesh(width, height, spacing);
+    GridMesh gridMesh = GridMeshNew(mesh.width, mesh.height, WHITE);
+    ShakeMesh(mesh);
+    DeformMesh2DUpdate(mesh, TIME_STEP);
+    GridMeshSetPositionsXY(gridMesh, mesh.positionX, mesh.positionY);
+
+    int errors = 0;
+    for (int i = 0; i < gridMesh.vertexCount; i++)
+    {
+        errors += gridMesh.vertices[i].x != mesh.positionX[i] || gridMesh.vertices[i].y != mesh.positionY[i];
+    }
+
+    const uint32_t* index = gridMesh.indices;
+    for (int i = 0; i < mesh.height - 1; i++)
+    {
+        for (int j = 0; j < mesh.width - 1; j++)
+        {
+            uint32_t topLeft = (uint32_t)(i * mesh.width + j);
+            uint32_t bottomLeft = topLeft + (uint32_t)mesh.width;
+            uint32_t expected[6] = { topLeft, bottomLeft, bottomLeft + 1, topLeft, bottomLeft + 1, topLeft + 1 };
+            for (int k = 0; k < 6; k++)
+            {
+                errors += *index++ != expected[k];
+            }
+        }
+    }
+
+    int failures = 0;
+    printf("  GridMesh %dx%d: %d vertices, %d triangles, %d errors\n", mesh.width, mesh.height, gridMesh.vertexCount, gridMesh.indexCount / 3, errors);
+    if (errors > 0 || index != gridMesh.indices + gridMesh.indexCount)
+    {
+        printf("  FAILED: GridMesh does not follow the deformed grid\n");
+        failures++;
+    }
+
+    GridMeshFree(&gridMesh);
+    DeformMesh2DFree(&mesh);
+    return failures;
+}
+
+// Backend that compare the drawn triangles to the indexed ones, in order
+static GridMesh     comparedMesh;
+static int          comparedIndex;
+static int          comparedErrors;
+
+static void CompareDrawTriangles(void* userData, unsigned int textureId, const RendererVertex* vertices, int vertexCount)
+{
+    (void)userData; (void)textureId;
+    if (vertexCount > comparedMesh.indexCount - comparedIndex)
+    {
+        comparedErrors++;
+        return;
+    }
+
+    for (int i = 0; i < vertexCount; i++)
+    {
+        RendererVertex expected = comparedMesh.vertices[comparedMesh.indices[comparedIndex++]];
+        comparedErrors += vertices[i].x != expected.x || vertices[i].y != expected.y || vertices[i].u != expected.u || vertices[i].v != expected.v;
+    }
+}
+
+static const RendererBackend comparingBackend = { NULL, CountClear, CountSetBlendMode, NULL, CompareDrawTriangles, NULL };
+
+// The raylib parts of a mesh past 16 bit indices draw the same triangles, with no part over the limit
+static int CheckGridMeshParts(int width, int height, float spacing)
+{
+    DeformMesh2D mesh = NewBenchmarkMesh(width, height, spacing);
+    GridMesh gridMesh = GridMeshNew(mesh.width, mesh.height, WHITE);
+    ShakeMesh(mesh);
+    DeformMesh2DUpdate(mesh, TIME_STEP);
+    GridMeshSetPositionsXY(gridMesh, mesh.positionX, mesh.positionY);
+
+    RendererMesh drawMesh = gridMesh.drawMesh;
+    int partVertices = 0;
+    int partTriangles = 0;
+    int largestPart = 0;
+    for (int i = 0; i < drawMesh.partCount; i++)
+    {
+        partVertices += drawMesh.parts[i].vertexCount;
+        partTriangles += drawMesh.parts[i].triangleCount;
+        largestPart = drawMesh.parts[i].vertexCount > largestPart ? drawMesh.parts[i].vertexCount : largestPart;
+    }
+
+    comparedMesh = gridMesh;
+    comparedIndex = 0;
+    comparedErrors = 0;
+    RendererSetBackend(&comparingBackend);
+    GridMeshDraw(gridMesh, (Texture) { 0 });
+    RendererSetBackend(NULL);
+
+    int failures = 0;
+    printf("  GridMesh %dx%d: %d raylib parts, largest %d vertices, %d vertices sent (x%.3f), %d errors\n",
+        mesh.width, mesh.height, drawMesh.partCount, largestPart, partVertices, (float)partVertices / gridMesh.vertexCount, comparedErrors);
+    if (comparedErrors > 0 || comparedIndex != gridMesh.indexCount || partTriangles * 3 != gridMesh.indexCount || largestPart > 65535)
+    {
+        printf("  FAILED: the parts of the mesh do not draw the grid\n");
+        failures++;
+    }
+
+    GridMeshFree(&gridMesh);
+    DeformMesh2DFree(&mesh);
+    return failures;
+}
+
+// MeshDeformation2D before GridMesh, one quad per edge
+static void DrawMeshLines(DeformMesh2D mesh)
+{
+    int cols = mesh.width;
+    for (int i = 1; i < mesh.height; i++)
+    {
+        for (int j = 1; j < cols; j++)
+        {
+            int index = i * cols + j;
+            Vector2 p0 = { mesh.positionX[index], mesh.positionY[index] };
+            RendererDrawLineEx(p0, (Vector2) { mesh.positionX[index - 1], mesh.positionY[index - 1] }, 1.0f, DARKGRAY);
+            RendererDrawLineEx(p0, (Vector2) { mesh.positionX[index - cols], mesh.positionY[index - cols] }, 1.0f, DARKGRAY);
+        }
+    }
+}
+
+// Front end cost of a frame of the mesh, lines against the indexed mesh, without a GPU
+static void MeasureGridMesh(int width, int height, float spacing)
+{
+    DeformMesh2D mesh = NewBenchmarkMesh(width, height, spacing);
+    GridMesh gridMesh = GridMeshNew(mesh.width, mesh.height, WHITE);
+    ShakeMesh(mesh);
+
+    RendererSetBackend(&countingBackend);
+
+    int frames = 0;
+    emittedTriangles = 0;
+    double start = BenchmarkTime();
+    double elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        DrawMeshLines(mesh);
+        frames++;
+        elapsed = BenchmarkTime() - start;
+    }
+    double linesTime = elapsed / frames;
+    int64_t linesTriangles = emittedTriangles / frames;
+
+    frames = 0;
+    start = BenchmarkTime();
+    elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        GridMeshSetPositionsXY(gridMesh, mesh.positionX, mesh.positionY);
+        frames++;
+        elapsed = BenchmarkTime() - start;
+    }
+    double positionsTime = elapsed / frames;
+
+    frames = 0;
+    emittedTriangles = 0;
+    start = BenchmarkTime();
+    elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        GridMeshSetPositionsXY(gridMesh, mesh.positionX, mesh.positionY);
+        GridMeshDraw(gridMesh, (Texture) { 0 });
+        frames++;
+        elapsed = BenchmarkTime() - start;
+    }
+    double meshTime = elapsed / frames;
+    int64_t meshTriangles = emittedTriangles / frames;
+
+    RendererSetBackend(NULL);
+
+    printf("  %2.0f px  lines %8.3f ms/frame %9lld triangles   mesh %8.3f ms/frame %9lld triangles (positions %7.3f ms)   x%.1f\n",
+        spacing, linesTime * 1000.0, (long long)linesTriangles, meshTime * 1000.0, (long long)meshTriangles, positionsTime * 1000.0, linesTime / meshTime);
+
+    GridMeshFree(&gridMesh);
+    DeformMesh2DFree(&mesh);
+}
+
+int BenchmarkDeformMesh2D(void)
+{
+    printf("DeformMesh2D\n");
+
+    // Without workers ParallelFor run every tile row on the calling thread
+    int failures = CheckDeformMesh2D(331, 197, 7.0f);
+
+    JobSystemInit(CHECK_WORKERS);
+    failures += CheckDeformMesh2D(331, 197, 7.0f);
+    failures += CheckDeformMesh2D(1280, 720, 2.0f);
+    JobSystemShutdown();
+
+    JobSystemInit(0);
+    int hardwareThreads = JobSystemWorkerCount() + 1;
+    JobSystemShutdown();
+
+    // 4K surface from the sparse grid of the example to a vertex every 2 pixels, the last one does not fit in the caches
+    printf("  %d hardware threads, * share cores\n", hardwareThreads);
+    MeasureDeformMesh2D(3840, 2160, 64.0f, hardwareThreads);
+    MeasureDeformMesh2D(3840, 2160, 8.0f, hardwareThreads);
+    MeasureDeformMesh2D(3840, 2160, 2.0f, hardwareThreads);
+
+    MeasureForces(3840, 2160, 8.0f, 256.0f);
+    MeasureForces(3840, 2160, 2.0f, 256.0f);
+
+    failures += CheckGridMesh(331, 197, 7.0f);
+    failures += CheckGridMeshParts(331, 197, 7.0f);
+    failures += CheckGridMeshParts(1280, 720, 2.0f);
+    MeasureGridMesh(3840, 2160, 64.0f);
+    MeasureGridMesh(3840, 2160, 8.0f);
+    MeasureGridMesh(3840, 2160, 2.0f);
+
+    return failures;
+}
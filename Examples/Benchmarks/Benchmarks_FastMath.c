@@ -0,0 +1,173 @@
+#include "Benchmarks.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <FastMath.h>
+
+#define SAMPLE_COUNT    (1 << 16)
+#define REPEAT_COUNT    64
+
+static float xs[SAMPLE_COUNT];
+static float ys[SAMPLE_COUNT];
+static float angles[SAMPLE_COUNT];
+static float out0[SAMPLE_COUNT];
+static float out1[SAMPLE_COUNT];
+
+static float RandomRange(float min, float max)
+{
+    return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+static float AngleError(float a, float b)
+{
+    float diff = fabsf(a - b);
+    return diff > FASTMATH_PI ? fabsf(diff - 2.0f * FASTMATH_PI) : diff;
+}
+
+// Check the error bounds documented in FastMath.h, print a failure when one is exceeded
+static int CheckAccuracy(void)
+{
+    int failures = 0;
+
+    float atanError = 0.0f;
+    float atanArrayError = 0.0f;
+    FastAtan2Array(ys, xs, out0, SAMPLE_COUNT);
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+    {
+        float expected = atan2f(ys[i], xs[i]);
+        atanError = fmaxf(atanError, AngleError(FastAtan2f(ys[i], xs[i]), expected));
+        atanArrayError = fmaxf(atanArrayError, AngleError(out0[i], expected));
+    }
+
+    float sinCosError = 0.0f;
+    float sinCosArrayError = 0.0f;
+    FastSinCosArray(angles, out0, out1, SAMPLE_COUNT);
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+    {
+        float s, c;
+        FastSinCosf(angles[i], &s, &c);
+
+        sinCosError = fmaxf(sinCosError, fmaxf(fabsf(s - sinf(angles[i])), fabsf(c - cosf(angles[i]))));
+        sinCosArrayError = fmaxf(sinCosArrayError, fmaxf(fabsf(out0[i] - sinf(angles[i])), fabsf(out1[i] - cosf(angles[i]))));
+    }
+
+    float rsqrtError = 0.0f;
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+    {
+        float x = fabsf(xs[i]) + 1e-3f;
+        float expected = 1.0f / sqrtf(x);
+        rsqrtError = fmaxf(rsqrtError, fabsf(FastRsqrtf(x) - expected) / expected);
+    }
+
+    // Edge cases: axes, zero vector and exact quadrant boundaries
+    if (FastAtan2f(0.0f, 0.0f) != 0.0f) failures++;
+    if (AngleError(FastAtan2f(0.0f, -1.0f), FASTMATH_PI) > 1.5e-5f) failures++;
+    if (AngleError(FastAtan2f(-1.0f, 0.0f), -FASTMATH_HALF_PI) > 1.5e-5f) failures++;
+
+    printf("  atan2 max error:         %.3g rad (scalar) %.3g rad (array), bound 1.5e-5\n", atanError, atanArrayError);
+    printf("  sincos max error:        %.3g (scalar) %.3g (array), bound 5.0e-7 for |angle| < 1000\n", sinCosError, sinCosArrayError);
+    printf("  rsqrt max rel. error:    %.3g, bound 5.0e-7\n", rsqrtError);
+
+    if (atanError > 1.5e-5f || atanArrayError > 1.5e-5f) failures++;
+    if (sinCosError > 5.0e-7f || sinCosArrayError > 5.0e-7f) failures++;
+    if (rsqrtError > 5.0e-7f) failures++;
+
+    if (failures > 0)
+    {
+        printf("  FAILED: %d accuracy checks\n", failures);
+    }
+
+    return failures;
+}
+
+int BenchmarkFastMath(void)
+{
+    printf("FastMath\n");
+
+    srand(1234);
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+    {
+        xs[i] = RandomRange(-1000.0f, 1000.0f);
+        ys[i] = RandomRange(-1000.0f, 1000.0f);
+        angles[i] = RandomRange(-1000.0f, 1000.0f);
+    }
+
+    int failures = CheckAccuracy();
+
+    const int ITERATIONS = SAMPLE_COUNT * REPEAT_COUNT;
+    double start;
+    float sum;
+
+    start = BenchmarkTime(); sum = 0.0f;
+    for (int r = 0; r < REPEAT_COUNT; r++)
+        for (int i = 0; i < SAMPLE_COUNT; i++)
+            sum += atan2f(ys[i], xs[i]);
+    BenchmarkReport("atan2f (libm)", BenchmarkTime() - start, ITERATIONS);
+    BenchmarkSink(sum);
+
+    start = BenchmarkTime(); sum = 0.0f;
+    for (int r = 0; r < REPEAT_COUNT; r++)
+        for (int i = 0; i < SAMPLE_COUNT; i++)
+            sum += FastAtan2f(ys[i], xs[i]);
+    BenchmarkReport("FastAtan2f", BenchmarkTime() - start, ITERATIONS);
+    BenchmarkSink(sum);
+
+    start = BenchmarkTime();
+    for (int r = 0; r < REPEAT_COUNT; r++)
+        FastAtan2Array(ys, xs, out0, SAMPLE_COUNT);
+    BenchmarkReport("FastAtan2Array", BenchmarkTime() - start, ITERATIONS);
+    BenchmarkSink(out0[SAMPLE_COUNT - 1]);
+
+    start = BenchmarkTime(); sum = 0.0f;
+    for (int r = 0; r < REPEAT_COUNT; r++)
+        for (int i = 0; i < SAMPLE_COUNT; i++)
+            sum += sinf(angles[i]) + cosf(angles[i]);
+    BenchmarkReport("sinf + cosf (libm)", BenchmarkTime() - start, ITERATIONS);
+    BenchmarkSink(sum);
+
+    start = BenchmarkTime(); sum = 0.0f;
+    for (int r = 0; r < REPEAT_COUNT; r++)
+    {
+        for (int i = 0; i < SAMPLE_COUNT; i++)
+        {
+            float s, c;
+            FastSinCosf(angles[i], &s, &c);
+            sum += s + c;
+        }
+    }
+    BenchmarkReport("FastSinCosf", BenchmarkTime() - start, ITERATIONS);
+    BenchmarkSink(sum);
+
+    start = BenchmarkTime();
+    for (int r = 0; r < REPEAT_COUNT; r++)
+        FastSinCosArray(angles, out0, out1, SAMPLE_COUNT);
+    BenchmarkReport("FastSinCosArray", BenchmarkTime() - start, ITERATIONS);
+    BenchmarkSink(out0[SAMPLE_COUNT - 1] + out1[SAMPLE_COUNT - 1]);
+
+    start = BenchmarkTime(); sum = 0.0f;
+    for (int r = 0; r < REPEAT_COUNT; r++)
+    {
+        for (int i = 0; i < SAMPLE_COUNT; i++)
+        {
+            float length = sqrtf(xs[i] * xs[i] + ys[i] * ys[i]);
+            sum += xs[i] / length + ys[i] / length;
+        }
+    }
+    BenchmarkReport("normalize (sqrtf)", BenchmarkTime() - start, ITERATIONS);
+    BenchmarkSink(sum);
+
+    start = BenchmarkTime(); sum = 0.0f;
+    for (int r = 0; r < REPEAT_COUNT; r++)
+    {
+        for (int i = 0; i < SAMPLE_COUNT; i++)
+        {
+            float x = xs[i], y = ys[i];
+            FastNormalize2f(&x, &y);
+            sum += x + y;
+        }
+    }
+    BenchmarkReport("FastNormalize2f", BenchmarkTime() - start, ITERATIONS);
+    BenchmarkSink(sum);
+
+    return failures;
+}
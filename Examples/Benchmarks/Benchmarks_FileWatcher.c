@@ -0,0 +1,149 @@
+#include "Benchmarks.h"
+
+#include <string.h>
+#include <FileWatcher.h>
+
+#if defined(_WIN32)
+#   include <direct.h>
+#   define MakeDirectory(path) _mkdir(path)
+#   define RemoveEmptyDirectory(path) _rmdir(path)
+#else
+#   include <unistd.h>
+#   include <sys/stat.h>
+#   define MakeDirectory(path) mkdir(path, 0755)
+#   define RemoveEmptyDirectory(path) rmdir(path)
+#endif
+
+#define WATCH_DIRECTORY "FileWatcherCheck"
+#define WATCH_SUB       WATCH_DIRECTORY "/Art"
+#define WATCH_FILE      "Art/Sprite.png"    // Relative to the watched directory, as reported
+#define FILE_PATH       WATCH_DIRECTORY "/" WATCH_FILE
+#define TEMP_PATH       FILE_PATH ".tmp"
+#define SAVE_COUNT      10
+#define REPORT_TIMEOUT  2.0                 // Seconds, a lost event fail instead of hanging
+#define QUIET_TIME      (4 * FILE_WATCHER_DEBOUNCE)
+
+typedef struct WatchReport
+{
+    int     count;
+    int     others;
+    double  time;
+} WatchReport;
+
+static void OnFileChanged(void* userData, const char* path)
+{
+    WatchReport* report = (WatchReport*)userData;
+    if (strcmp(path, WATCH_FILE) == 0)
+    {
+        report->count++;
+        report->time = BenchmarkTime();
+    }
+    else if (strcmp(path, WATCH_FILE ".tmp") != 0)
+    {
+        printf("  unexpected change of %s\n", path);
+        report->others++;
+    }
+}
+
+static void WriteFile(const char* path, const char* mode, int size)
+{
+    static char bytes[64 * 1024];
+
+    FILE* file = fopen(path, mode);
+    if (file)
+    {
+        fwrite(bytes, 1, size, file);
+        fclose(file);
+    }
+}
+
+// One save the way editors do it, every step emit events on the file
+static void SaveFile(int save)
+{
+    // In place, then a second write of the same save
+    WriteFile(FILE_PATH, "wb", 4096 + save);
+    WriteFile(FILE_PATH, "ab", 1024);
+
+    // Written aside, then renamed over the file
+    WriteFile(TEMP_PATH, "wb", 8192);
+    remove(FILE_PATH);
+    rename(TEMP_PATH, FILE_PATH);
+}
+
+// Every save must be reported exactly once, after the debounce and before the timeout
+static int CheckFileWatcher(FileWatcher* watcher)
+{
+    int failures = 0;
+
+    double minLatency = 1e9;
+    double maxLatency = 0.0;
+    double sumLatency = 0.0;
+    for (int save = 0; save < SAVE_COUNT; save++)
+    {
+        WatchReport report = { 0 };
+
+        SaveFile(save);
+        double saved = BenchmarkTime();
+
+        // Poll like the game does once per frame, then wait some more for a late duplicate
+        double reported = 0.0;
+        for (double now = saved; now - saved < REPORT_TIMEOUT && (report.count == 0 || now - reported < QUIET_TIME); now = BenchmarkTime())
+        {
+            FileWatcherPoll(watcher, OnFileChanged, &report);
+            if (report.count > 0 && reported == 0.0)
+            {
+                reported = report.time;
+            }
+            BenchmarkYield();
+        }
+
+        double latency = reported - saved;
+        if (report.count != 1 || report.others != 0 || latency < FILE_WATCHER_DEBOUNCE)
+        {
+            printf("  FAILED: save %d reported %d times, %d other files, after %.2f ms\n", save, report.count, report.others, latency * 1000.0);
+            failures++;
+            continue;
+        }
+
+        minLatency = latency < minLatency ? latency : minLatency;
+        maxLatency = latency > maxLatency ? latency : maxLatency;
+        sumLatency += latency;
+    }
+
+    int reportedSaves = SAVE_COUNT - failures;
+    if (reportedSaves > 0)
+    {
+        printf("  %d saves of 3 writes each, one reload each, latency %.2f ms avg, %.2f min, %.2f max (debounce %.0f ms)\n",
+            reportedSaves, sumLatency * 1000.0 / reportedSaves, minLatency * 1000.0, maxLatency * 1000.0, FILE_WATCHER_DEBOUNCE * 1000.0);
+    }
+
+    return failures;
+}
+
+int BenchmarkFileWatcher(void)
+{
+    printf("FileWatcher\n");
+
+    MakeDirectory(WATCH_DIRECTORY);
+    MakeDirectory(WATCH_SUB);
+    WriteFile(FILE_PATH, "wb", 4096);
+
+    int failures = 0;
+
+    FileWatcher* watcher = FileWatcherCreate(WATCH_DIRECTORY);
+    if (watcher)
+    {
+        failures += CheckFileWatcher(watcher);
+        FileWatcherDestroy(watcher);
+    }
+    else
+    {
+        printf("  no file notification on this platform, skipped\n");
+    }
+
+    remove(TEMP_PATH);
+    remove(FILE_PATH);
+    RemoveEmptyDirectory(WATCH_SUB);
+    RemoveEmptyDirectory(WATCH_DIRECTORY);
+    return failures;
+}
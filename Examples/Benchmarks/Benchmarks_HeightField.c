@@ -0,0 +1,336 @@
+#include "Benchmarks.h"
+
+#include <math.h>
+#include <Memory.h>
+#include <HeightField.h>
+#include <JobSystem.h>
+
+#define WAVE_SPEED      20.0f       // Points per second
+#define DAMPING         0.35f
+#define PUSH_FORCE      120.0f
+#define TIME_STEP       (1.0f / 60.0f)
+#define PUSH_TICKS      30
+#define CHECK_TICKS     240
+#define TICK_BUDGET     0.25        // Seconds of ticks per measure
+#define GRID_TICKS      60
+#define HEIGHT_STEP     (1.0f / 1024.0f)    // Pixels per unit of the quantized heights, +-32 px
+#define QUANT_ERROR     0.1f                // Pixels the quantized field may drift from the float one, about 100 steps
+#define QUANT_TICKS     10
+
+typedef void HeightFieldUpdateFunc(HeightField* field, float timeStep);
+
+// Single threaded scalar wave equation with its own next buffer, kept as the reference
+static void UpdateScalarField(HeightField* field, float timeStep)
+{
+    float cells = field->waveSpeed * timeStep;
+    float factor = fmaxf(0.0f, 1.0f - field->damping * timeStep);
+    float courant = fminf(cells * cells, (1.0f + factor) * 0.25f * 0.95f);
+
+    for (int i = 1; i < field->rows - 1; i++)
+    {
+        for (int j = 1; j < field->cols - 1; j++)
+        {
+            int index = i * field->cols + j;
+            float center = field->height[index];
+            float laplacian = ((field->height[index - 1] + field->height[index + 1]) + (field->height[index - field->cols] + field->height[index + field->cols])) - center * 4.0f;
+            float velocity = (center - field->prevHeight[index]) * factor;
+            field->prevHeight[index] = (center + velocity) + laplacian * courant;
+        }
+    }
+
+    float* height = field->prevHeight;
+    field->prevHeight = field->height;
+    field->height = height;
+}
+
+static float MaxAbsHeight(HeightField field, int row0, int row1, int col0, int col1)
+{
+    float result = 0.0f;
+    for (int i = row0; i < row1; i++)
+    {
+        for (int j = col0; j < col1; j++)
+        {
+            result = fmaxf(result, fabsf(field.height[i * field.cols + j]));
+        }
+    }
+    return result;
+}
+
+static float BorderHeight(HeightField field)
+{
+    float result = fmaxf(MaxAbsHeight(field, 0, 1, 0, field.cols), MaxAbsHeight(field, field.rows - 1, field.rows, 0, field.cols));
+    return fmaxf(result, fmaxf(MaxAbsHeight(field, 0, field.rows, 0, 1), MaxAbsHeight(field, 0, field.rows, field.cols - 1, field.cols)));
+}
+
+// Odd sizes exercise the scalar tails, the rows split in several jobs when the job system run
+static int CheckHeightField(int cols, int rows)
+{
+    Vector2 spacing = { 16.0f, 16.0f };
+    HeightField reference = HeightFieldNew(cols, rows, (Vector2) { 0, 0 }, spacing, WAVE_SPEED, DAMPING);
+    HeightField field = HeightFieldNew(cols, rows, (Vector2) { 0, 0 }, spacing, WAVE_SPEED, DAMPING);
+
+    // Pushes overlap and reach past the borders
+    Vector2 center = { cols * spacing.x * 0.4f, rows * spacing.y * 0.6f };
+    Vector2 corner = { -8.0f, rows * spacing.y };
+
+    float maxError = 0.0f;
+    for (int tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        if (tick < PUSH_TICKS)
+        {
+            HeightFieldApplyForce(reference, PUSH_FORCE, center, 80.0f, TIME_STEP);
+            HeightFieldApplyForce(reference, -PUSH_FORCE, corner, 120.0f, TIME_STEP);
+            HeightFieldApplyForce(field, PUSH_FORCE, center, 80.0f, TIME_STEP);
+            HeightFieldApplyForce(field, -PUSH_FORCE, corner, 120.0f, TIME_STEP);
+        }
+
+        UpdateScalarField(&reference, TIME_STEP);
+        HeightFieldUpdate(&field, TIME_STEP);
+
+        for (int i = 0; i < field.count; i++)
+        {
+            maxError = fmaxf(maxError, fabsf(field.height[i] - reference.height[i]));
+        }
+    }
+
+    // The ripple must have left the pushes, 4 seconds at 20 points per second cross the field
+    float border = BorderHeight(field);
+    float farHeight = MaxAbsHeight(field, 1, rows / 3, cols - cols / 8 - 1, cols - 1);
+
+    // Too fast waves are clamped to the stable step, the surface must stay bounded
+    field.waveSpeed = 1000.0f;
+    for (int tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        HeightFieldUpdate(&field, TIME_STEP);
+    }
+    float clampedHeight = MaxAbsHeight(field, 0, rows, 0, cols);
+
+    int failures = 0;
+    printf("  %dx%d points, %d threads: max difference with the scalar update %.2e px, border %.2e px, far ripple %.3f px, clamped wave speed %.3f px\n",
+        cols, rows, JobSystemWorkerCount() + 1, maxError, border, farHeight, clampedHeight);
+    if (maxError > 1e-4f || border != 0.0f || farHeight < 1e-3f || !(clampedHeight < 100.0f))
+    {
+        printf("  FAILED: the heightfield does not follow the scalar update, move its border, does not spread or blow up\n");
+        failures++;
+    }
+
+    HeightFieldFree(&field);
+    HeightFieldFree(&reference);
+    return failures;
+}
+
+// Float and int16 fields under the same pushes, the rounding of every update must stay far below a pixel
+static int CheckQuantizedField(int cols, int rows)
+{
+    Vector2 spacing = { 16.0f, 16.0f };
+    HeightField reference = HeightFieldNew(cols, rows, (Vector2) { 0, 0 }, spacing, WAVE_SPEED, DAMPING);
+    HeightField field = HeightFieldNewQuantized(cols, rows, (Vector2) { 0, 0 }, spacing, WAVE_SPEED, DAMPING, HEIGHT_STEP);
+
+    Vector2 center = { cols * spacing.x * 0.4f, rows * spacing.y * 0.6f };
+    Vector2 corner = { -8.0f, rows * spacing.y };
+
+    float maxError = 0.0f;
+    float maxHeight = 0.0f;
+    for (int tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        if (tick < PUSH_TICKS)
+        {
+            HeightFieldApplyForce(reference, PUSH_FORCE, center, 80.0f, TIME_STEP);
+            HeightFieldApplyForce(reference, -PUSH_FORCE, corner, 120.0f, TIME_STEP);
+            HeightFieldApplyForce(field, PUSH_FORCE, center, 80.0f, TIME_STEP);
+            HeightFieldApplyForce(field, -PUSH_FORCE, corner, 120.0f, TIME_STEP);
+        }
+
+        HeightFieldUpdate(&reference, TIME_STEP);
+        HeightFieldUpdate(&field, TIME_STEP);
+
+        for (int i = 0; i < field.count; i++)
+        {
+            maxError = fmaxf(maxError, fabsf(HeightFieldGetHeight(field, i) - reference.height[i]));
+            maxHeight = fmaxf(maxHeight, fabsf(reference.height[i]));
+        }
+    }
+
+    // Refracted positions drawn by LiquidSurface2D, 32 px per unit of slope like the example
+    Vector2* positions = (Vector2*)MemoryAlloc(sizeof(Vector2) * field.count * 2);
+    HeightFieldGetPositions(reference, 0.5f, 32.0f, positions);
+    HeightFieldGetPositions(field, 0.5f, 32.0f, positions + field.count);
+    float positionError = 0.0f;
+    for (int i = 0; i < field.count; i++)
+    {
+        positionError = fmaxf(positionError, fmaxf(fabsf(positions[i].x - positions[field.count + i].x), fabsf(positions[i].y - positions[field.count + i].y)));
+    }
+    MemoryFree(positions);
+
+    // Heights past the int16 range saturate instead of wrapping around
+    HeightFieldApplyForce(field, PUSH_FORCE * 1e4f, center, 80.0f, TIME_STEP);
+    int centerIndex = (int)(center.y / spacing.y) * cols + (int)(center.x / spacing.x);
+    float saturated = HeightFieldGetHeight(field, centerIndex);
+
+    int failures = 0;
+    printf("  %dx%d points, %d threads: int16 heights of %.5f px, max difference with the float field %.2e px for waves of %.3f px, positions %.2e px, saturated at %.2f px\n",
+        cols, rows, JobSystemWorkerCount() + 1, HEIGHT_STEP, maxError, maxHeight, positionError, saturated);
+    if (!(maxError < QUANT_ERROR) || !(positionError < QUANT_ERROR) || !(saturated <= -32.0f))
+    {
+        printf("  FAILED: the quantized field drift from the float one, or wrap around\n");
+        failures++;
+    }
+
+    HeightFieldFree(&field);
+    HeightFieldFree(&reference);
+    return failures;
+}
+
+// Waves all over before every run, a field left damping for seconds end in denormals that are much slower
+static void ShakeField(HeightField field)
+{
+    for (int i = 1; i < field.rows - 1; i++)
+    {
+        for (int j = 1; j < field.cols - 1; j++)
+        {
+            int index = i * field.cols + j;
+            if (field.quantHeight)
+            {
+                field.quantHeight[index] = (int16_t)(4.0f / field.heightStep * sinf(index * 0.37f));
+                field.quantPrevHeight[index] = (int16_t)(4.0f / field.heightStep * cosf(index * 0.91f));
+            }
+            else
+            {
+                field.height[index] = 4.0f * sinf(index * 0.37f);
+                field.prevHeight[index] = 4.0f * cosf(index * 0.91f);
+            }
+        }
+    }
+}
+
+static double TimeFieldTicks(HeightField* field, HeightFieldUpdateFunc* update)
+{
+    int ticks = 0;
+    double elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        ShakeField(*field);
+
+        double start = BenchmarkTime();
+        for (int tick = 0; tick < PUSH_TICKS; tick++)
+        {
+            update(field, TIME_STEP);
+        }
+        elapsed += BenchmarkTime() - start;
+        ticks += PUSH_TICKS;
+    }
+
+    BenchmarkSink(HeightFieldGetHeight(*field, field->count / 2));
+    return elapsed / ticks;
+}
+
+// Few ticks of a field past the caches, one shake is already a pass over the whole state
+static double TimeLargeFieldTicks(HeightField* field)
+{
+    ShakeField(*field);
+
+    // One tick to page the buffers in
+    HeightFieldUpdate(field, TIME_STEP);
+
+    double start = BenchmarkTime();
+    for (int tick = 0; tick < QUANT_TICKS; tick++)
+    {
+        HeightFieldUpdate(field, TIME_STEP);
+    }
+    double elapsed = BenchmarkTime() - start;
+
+    BenchmarkSink(HeightFieldGetHeight(*field, field->count / 2));
+    return elapsed / QUANT_TICKS;
+}
+
+// Float against int16 heights on all threads, from a state that fit in L2 to one past the last level cache
+static void MeasureQuantizedField(int cols, int rows)
+{
+    int count = cols * rows;
+
+    JobSystemInit(0);
+    HeightField field = HeightFieldNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { 1, 1 }, WAVE_SPEED, DAMPING);
+    double floatTime = HeightFieldIsValid(field) ? TimeLargeFieldTicks(&field) : 0.0;
+    HeightFieldFree(&field);
+
+    HeightField quantField = HeightFieldNewQuantized(cols, rows, (Vector2) { 0, 0 }, (Vector2) { 1, 1 }, WAVE_SPEED, DAMPING, HEIGHT_STEP);
+    double quantTime = HeightFieldIsValid(quantField) ? TimeLargeFieldTicks(&quantField) : 0.0;
+    HeightFieldFree(&quantField);
+    int threads = JobSystemWorkerCount() + 1;
+    JobSystemShutdown();
+
+    if (floatTime == 0.0 || quantTime == 0.0)
+    {
+        printf("  %5dx%-5d out of memory, skipped\n", cols, rows);
+        return;
+    }
+
+    printf("  %5dx%-5d %9d points, %2d threads  float %7.1f MB %8.3f ms/tick %5.2f ns/point   int16 %7.1f MB %8.3f ms/tick %5.2f ns/point x%.2f\n",
+        cols, rows, count, threads, 8.0 * count / (1024.0 * 1024.0), floatTime * 1000.0, floatTime * 1e9 / count,
+        4.0 * count / (1024.0 * 1024.0), quantTime * 1000.0, quantTime * 1e9 / count, floatTime / quantTime);
+}
+
+// Keep the grid moving like the shaken field, resting springs skip most of their work
+static void ShakeGrid(SpringGrid grid)
+{
+    for (int i = 0; i < grid.count; i++)
+    {
+        SpringGridApplyForce(grid, i, (Vector2) { 4000.0f * sinf(i * 0.37f), 4000.0f * cosf(i * 0.91f) }, TIME_STEP);
+    }
+}
+
+// Cost per point of the spring grid of LiquidSurface2D against the heightfield on the same points
+static void MeasureHeightField(int width, int height, float spacing)
+{
+    int cols = (int)(width / spacing) + 2;
+    int rows = (int)(height / spacing) + 2;
+    int count = cols * rows;
+
+    SpringGrid grid = SpringGridNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { spacing, spacing }, benchmarkLiquidParams);
+    ShakeGrid(grid);
+    double gridTime = BenchmarkSpringGridTicks(grid, (Vector2) { 0, 0 }, false, GRID_TICKS);
+    SpringGridFree(&grid);
+
+    HeightField field = HeightFieldNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { spacing, spacing }, WAVE_SPEED, DAMPING);
+    double scalarTime = TimeFieldTicks(&field, UpdateScalarField);
+    double simdTime = TimeFieldTicks(&field, HeightFieldUpdate);
+
+    JobSystemInit(0);
+    double threadedTime = TimeFieldTicks(&field, HeightFieldUpdate);
+    int threads = JobSystemWorkerCount() + 1;
+    JobSystemShutdown();
+
+    HeightFieldFree(&field);
+
+    printf("  %2.0f px %8d points  SpringGrid %8.3f ms/tick %6.2f ns/point   heightfield scalar %8.3f ms/tick %5.2f ns/point   SSE %6.2f ns/point x%.1f   SSE %2d threads %6.2f ns/point x%.1f\n",
+        spacing, count, gridTime * 1000.0, gridTime * 1e9 / count, scalarTime * 1000.0, scalarTime * 1e9 / count,
+        simdTime * 1e9 / count, gridTime / simdTime, threads, threadedTime * 1e9 / count, gridTime / threadedTime);
+}
+
+int BenchmarkHeightField(void)
+{
+    printf("HeightField\n");
+
+    int failures = CheckHeightField(37, 23);
+    failures += CheckHeightField(83, 47);
+
+    failures += CheckQuantizedField(37, 23);
+
+    JobSystemInit(0);
+    failures += CheckHeightField(83, 47);
+    failures += CheckQuantizedField(83, 47);
+    JobSystemShutdown();
+
+    // State of a point: 9 floats of the spring grid against 2 floats of the heightfield
+    MeasureHeightField(1280, 720, 16.0f);
+    MeasureHeightField(3840, 2160, 16.0f);
+    MeasureHeightField(3840, 2160, 4.0f);
+
+    // 4K at 4, 2 and 1 px, then 8K at 1 px, the float state of the last one is larger than most last level caches
+    MeasureQuantizedField(962, 542);
+    MeasureQuantizedField(1922, 1082);
+    MeasureQuantizedField(3842, 2162);
+    MeasureQuantizedField(7682, 4322);
+
+    return failures;
+}
@@ -0,0 +1,130 @@
+#include "Benchmarks.h"
+
+#include <math.h>
+#include <string.h>
+#include <Renderer.h>
+#include <JobSystem.h>
+#include <SoftRenderer.h>
+
+#include "../LiquidSurface2D/LiquidSurface2D_Surface.h"
+
+#define SCREEN_WIDTH    1280                    // Window of the example
+#define SCREEN_HEIGHT   720
+#define SIMULATION_RATE 60.0f
+#define POSITION_RATE   30.0f                   // The position solver is stable at half the rate
+#define PUSH_TICKS      60                      // A mouse drag along a circle before the measured frames
+#define PUSH_FORCE      12000.0f                // Same force and radius as the mouse of the example
+#define PUSH_RADIUS     80.0f
+#define FRAME_COUNT     20
+
+static const char* SOLVER_NAMES[LIQUID_SOLVER_COUNT] = { "force solver", "position solver", "heightfield" };
+
+// Frame of the example, the frame rates are left out so the hash only depend on the surface
+static void DrawLiquidFrame(LiquidSurface2D surface, float alpha)
+{
+    RendererClear(RAYWHITE);
+
+    RendererBeginSection("RenderLiquidSurface2D");
+    RenderLiquidSurface2D(surface, alpha);
+    RendererEndSection();
+
+    RendererDrawText(SOLVER_NAMES[surface.solver], 0, 60, 24, DARKGREEN);
+}
+
+static uint64_t HashPixels(SoftRenderer* renderer)
+{
+    return BenchmarkHash(renderer->pixels, (size_t)renderer->width * renderer->height * 4);
+}
+
+// Hash of the last frame, the frame at rest must differ from it
+static uint64_t MeasureLiquidSurface(LiquidSolver solver, const char* threads, int* failures)
+{
+    SoftRenderer renderer = SoftRendererNew(SCREEN_WIDTH, SCREEN_HEIGHT);
+    RendererSetBackend(SoftRendererGetBackend(&renderer));
+
+    uint64_t hash = 0;
+    LiquidSurface2D surface = NewLiquidSurface2D((Rectangle) { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, (Vector2) { 16, 16 }, GRAY);
+    if (IsLiquidSurface2DValid(surface))
+    {
+        Image lines = GenLiquidSurface2DLinesImage(surface);
+        surface.lines = SoftRendererLoadTexture(&renderer, lines);
+        UnloadImage(lines);
+
+        SetLiquidSurface2DSolver(&surface, solver);
+
+        DrawLiquidFrame(surface, 1.0f);
+        SoftRendererEndFrame(&renderer);
+        uint64_t restHash = HashPixels(&renderer);
+
+        float timeStep = 1.0f / (solver == LIQUID_SOLVER_POSITION ? POSITION_RATE : SIMULATION_RATE);
+        for (int tick = 0; tick < PUSH_TICKS; tick++)
+        {
+            float angle = tick * (2.0f * PI / PUSH_TICKS);
+            Vector2 position = { SCREEN_WIDTH * 0.5f + cosf(angle) * 200.0f, SCREEN_HEIGHT * 0.5f + sinf(angle) * 200.0f };
+            ApplyForceOnLiquidSurface2D(surface, PUSH_FORCE, position, PUSH_RADIUS, timeStep);
+            UpdateLiquidSurface2D(&surface, timeStep);
+        }
+
+        SoftRendererStats stats = { 0 };
+        double start = BenchmarkTime();
+        for (int i = 0; i < FRAME_COUNT; i++)
+        {
+            DrawLiquidFrame(surface, 0.5f);
+            stats = SoftRendererEndFrame(&renderer);
+        }
+        double frameTime = (BenchmarkTime() - start) / FRAME_COUNT;
+
+        char label[64];
+        snprintf(label, sizeof(label), "%s, %s", SOLVER_NAMES[solver], threads);
+        BenchmarkReportFrame(label, frameTime, stats, &renderer);
+        hash = HashPixels(&renderer);
+
+        // The whole mesh is drawn, and the push moved the lines
+        int meshTriangles = surface.mesh.indexCount / 3;
+        if (stats.triangles < meshTriangles || hash == restHash)
+        {
+            printf("  FAILED: %d of %d mesh triangles drawn, frame %s the frame at rest\n", stats.triangles, meshTriangles, hash == restHash ? "same as" : "differ from");
+            (*failures)++;
+        }
+
+        SoftRendererUnloadTexture(&renderer, surface.lines);
+        FreeLiquidSurface2D(surface);
+    }
+    else
+    {
+        printf("  FAILED: out of memory\n");
+        (*failures)++;
+    }
+
+    RendererSetBackend(NULL);
+    SoftRendererFree(&renderer);
+    return hash;
+}
+
+int BenchmarkLiquidSurface2D(void)
+{
+    printf("LiquidSurface2D\n");
+
+    int failures = 0;
+
+    // Without workers ParallelFor run every tile on the calling thread
+    uint64_t serialHashes[LIQUID_SOLVER_COUNT];
+    for (int solver = 0; solver < LIQUID_SOLVER_COUNT; solver++)
+    {
+        serialHashes[solver] = MeasureLiquidSurface((LiquidSolver)solver, "1 thread", &failures);
+    }
+
+    JobSystemInit(0);
+    for (int solver = 0; solver < LIQUID_SOLVER_COUNT; solver++)
+    {
+        uint64_t hash = MeasureLiquidSurface((LiquidSolver)solver, "all threads", &failures);
+        if (hash != serialHashes[solver])
+        {
+            printf("  FAILED: %s frame differ between 1 thread and all threads\n", SOLVER_NAMES[solver]);
+            failures++;
+        }
+    }
+    JobSystemShutdown();
+
+    return failures;
+}
@@ -0,0 +1,120 @@
+#include "Benchmarks.h"
+
+#include <raylib.h>
+#include <MusicStream.h>
+
+#ifdef RELEASE
+#   define MUSIC_PATH "Assets/Audios/Music.ogg"
+#else
+#   define MUSIC_PATH "../Binary/NeonShooter/Assets/Audios/Music.ogg"
+#endif
+
+#define BUFFER_FRAMES   4096        // Same refill size as the game
+#define RING_SECONDS    2.0f
+#define PLAY_SECONDS    30.0
+#define SPEEDUP         8.0         // Drain the ring this many times faster than realtime
+#define TINY_SECONDS    0.001f      // Smaller than a decode chunk
+
+static int16_t frames[BUFFER_FRAMES * 2];
+
+static void SleepUntil(double time)
+{
+    while (BenchmarkTime() < time)
+    {
+        BenchmarkYield();
+    }
+}
+
+// A ring asked smaller than a decode chunk must still fill
+static int CheckTinyBuffer(void)
+{
+    MusicStream stream;
+    if (!MusicStreamOpen(&stream, MUSIC_PATH, TINY_SECONDS, true))
+    {
+        printf("  FAILED: can not open %s with a %.3f s ring\n", MUSIC_PATH, TINY_SECONDS);
+        return 1;
+    }
+
+    double start = BenchmarkTime();
+    while (MusicStreamBufferedFrames(&stream) == 0 && BenchmarkTime() - start < 1.0)
+    {
+        BenchmarkYield();
+    }
+
+    int buffered = MusicStreamBufferedFrames(&stream);
+    MusicStreamClose(&stream);
+
+    printf("  %.3f s ring: %d frames buffered\n", TINY_SECONDS, buffered);
+    if (buffered == 0)
+    {
+        printf("  FAILED: a ring smaller than a decode chunk is never filled\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Headless consumer: drain the ring like the audio device would, only faster, and count the underruns
+int BenchmarkMusicStream(void)
+{
+    printf("MusicStream\n");
+
+    if (!FileExists(MUSIC_PATH))
+    {
+        printf("  skipped: %s not found\n", MUSIC_PATH);
+        return 0;
+    }
+
+    int failures = CheckTinyBuffer();
+
+    MusicStream stream;
+    double start = BenchmarkTime();
+    if (!MusicStreamOpen(&stream, MUSIC_PATH, RING_SECONDS, true))
+    {
+        printf("  FAILED: can not decode %s\n", MUSIC_PATH);
+        return failures + 1;
+    }
+
+    // The game open the music at startup, the ring is full long before the first play
+    while (MusicStreamBufferedFrames(&stream) + BUFFER_FRAMES * 2 < (int)(RING_SECONDS * stream.sampleRate))
+    {
+        BenchmarkYield();
+    }
+    double prefill = BenchmarkTime() - start;
+
+    double period = BUFFER_FRAMES / (double)stream.sampleRate / SPEEDUP;
+    int buffers = (int)(PLAY_SECONDS * stream.sampleRate / BUFFER_FRAMES);
+
+    double longestRead = 0.0;
+    double totalRead = 0.0;
+    start = BenchmarkTime();
+    for (int i = 0; i < buffers; i++)
+    {
+        SleepUntil(start + i * period);
+
+        double readStart = BenchmarkTime();
+        MusicStreamRead(&stream, frames, BUFFER_FRAMES);
+        double readTime = BenchmarkTime() - readStart;
+        longestRead = readTime > longestRead ? readTime : longestRead;
+        totalRead += readTime;
+
+        BenchmarkSink((float)frames[0]);
+    }
+    double elapsed = BenchmarkTime() - start;
+
+    int underruns = (int)stream.underruns;
+    double decodedSeconds = (double)stream.decodedFrames / stream.sampleRate;
+    printf("  %d Hz %d channels, ring prefilled in %.2f ms\n", stream.sampleRate, stream.channels, prefill * 1000.0);
+    MusicStreamClose(&stream);
+
+    printf("  played %.0f s in %.2f s (%.0fx realtime), decoded %.1f s\n", PLAY_SECONDS, elapsed, SPEEDUP, decodedSeconds);
+    BenchmarkReport("MusicStreamRead (4096 frames)", totalRead, buffers);
+    printf("  longest read %.3f ms, %d underruns\n", longestRead * 1000.0, underruns);
+
+    if (underruns > 0)
+    {
+        printf("  FAILED: the decoder did not keep up at %.0fx realtime\n", SPEEDUP);
+        failures++;
+    }
+
+    return failures;
+}
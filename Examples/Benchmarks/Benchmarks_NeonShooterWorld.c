@@ -0,0 +1,396 @@
+#include "Benchmarks.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <Renderer.h>
+#include <JobSystem.h>
+#include <SoftRenderer.h>
+
+#include "../../Games/NeonShooter/NeonShooter_World.h"
+#include "../../Games/NeonShooter/NeonShooter_GameAudio.h"
+#include "../../Games/NeonShooter/NeonShooter_ParticleSystem.h"
+
+#define WORLD_WIDTH     1280.0f     // Screen size of the game
+#define WORLD_HEIGHT    720.0f
+#define TIME_STEP       (1.0f / 60.0f)
+#define WORLD_SEED      1234
+#define CHECK_TICKS     25          // Seekers reach the player after about 30 ticks, the game over clear the world
+#define CHECK_WORKERS   3           // Batches run out of order even on few cores
+#define MEASURE_TICKS   20
+#define RENDER_TICKS    20          // Frame drawn before the game over, the entities are not drawn after it
+#define FRAME_COUNT     10
+#define SPRITE_CACHE    16
+
+#ifdef RELEASE
+#define ASSET_PATH      "Assets"
+#else
+#define ASSET_PATH      "../Binary/NeonShooter/Assets"
+#endif
+
+// Headless stand-ins of the game modules the world call, no window, no audio device
+static int frameCount;
+
+// Sprites are loaded in this renderer when the scene is drawn, the updates only need their size
+static SoftRenderer* spriteRenderer;
+static const char*   spritePaths[SPRITE_CACHE];
+static Sprite        sprites[SPRITE_CACHE];
+static int           spriteCount;
+
+int GetFrameCount(void)
+{
+    return frameCount;
+}
+
+Sprite CacheSprite(const char* path)
+{
+    if (spriteRenderer)
+    {
+        for (int i = 0; i < spriteCount; i++)
+        {
+            if (strcmp(spritePaths[i], path) == 0)
+            {
+                return sprites[i];
+            }
+        }
+
+        Image image = LoadImage(TextFormat(ASSET_PATH "/%s", path));
+        if (image.data && spriteCount < SPRITE_CACHE)
+        {
+            Texture texture = SoftRendererLoadTexture(spriteRenderer, image);
+            UnloadImage(image);
+
+            spritePaths[spriteCount] = path;
+            sprites[spriteCount] = (Sprite) { texture, { 0.0f, 0.0f, (float)texture.width, (float)texture.height } };
+            return sprites[spriteCount++];
+        }
+        UnloadImage(image);
+    }
+
+    // Size of the game art, the entity radius come from it
+    bool bullet = strstr(path, "Bullet") != NULL;
+    return (Sprite) { .source = { 0.0f, 0.0f, bullet ? 28.0f : 40.0f, bullet ? 9.0f : 40.0f } };
+}
+
+static void ReleaseSprites(void)
+{
+    for (int i = 0; i < spriteCount; i++)
+    {
+        SoftRendererUnloadTexture(spriteRenderer, sprites[i].texture);
+    }
+    spriteCount = 0;
+}
+
+void GameAudioPlayMusic(void) {}
+void GameAudioStopMusic(void) {}
+void GameAudioPlayShoot(void) {}
+void GameAudioPlayExplosion(void) {}
+void GameAudioPlaySpawn(void) {}
+
+static World NewStressWorld(int enemyCount, bool parallel)
+{
+    srand(WORLD_SEED);
+    ClearParticles();
+
+    World world = WorldNew((Vector2) { WORLD_WIDTH, WORLD_HEIGHT });
+    world.parallel = parallel;
+    world.gameOverTimer = 0.0f;     // No intro, the spawns are applied by the first tick
+
+    // A black hole on the first tick, so the attraction passes destroy enemies
+    world.blackHoleSpawnRate = 101;
+    world.spawnTimer = world.spawnInterval;
+
+    WorldSpawnStress(&world, enemyCount);
+    return world;
+}
+
+// The player stand still and fire, every run of a tick draw the same random numbers
+static void TickWorld(World* world, int tick)
+{
+    srand(WORLD_SEED + tick);
+    frameCount = tick;
+    WorldUpdate(world, 0.0f, 0.0f, (Vector2) { 1.0f, 0.0f }, true, TIME_STEP);
+}
+
+static bool SameVector(Vector2 a, Vector2 b)
+{
+    return a.x == b.x && a.y == b.y;
+}
+
+static bool SameEntity(Entity a, Entity b)
+{
+    return a.active == b.active && a.color.a == b.color.a
+        && SameVector(a.position, b.position) && SameVector(a.velocity, b.velocity) && SameVector(a.direction, b.direction);
+}
+
+// Free slots too, spawns of the next ticks reuse them in order
+static bool SameEntities(FreeList(Entity) a, FreeList(Entity) b)
+{
+    if (FreeListCount(a) != FreeListCount(b) || ArrayCount(a.freeElements) != ArrayCount(b.freeElements))
+    {
+        return false;
+    }
+
+    for (int i = 0, n = FreeListCount(a); i < n; i++)
+    {
+        if (!SameEntity(a.elements[i], b.elements[i]))
+        {
+            return false;
+        }
+    }
+
+    return memcmp(a.freeElements, b.freeElements, sizeof(int) * ArrayCount(a.freeElements)) == 0;
+}
+
+// Field by field, the padding of the union is not initialized
+static bool SameEvent(WorldEvent a, WorldEvent b)
+{
+    if (a.type != b.type)
+    {
+        return false;
+    }
+
+    switch (a.type)
+    {
+    case WORLD_EVENT_SPAWN:
+        return a.spawn.entity == b.spawn.entity && SameVector(a.spawn.position, b.spawn.position) && SameVector(a.spawn.velocity, b.spawn.velocity);
+
+    case WORLD_EVENT_DESTROY:
+        return a.destroy.entity == b.destroy.entity && a.destroy.index == b.destroy.index
+            && a.destroy.explosion == b.destroy.explosion && SameVector(a.destroy.position, b.destroy.position);
+
+    case WORLD_EVENT_PLAY_SOUND:
+        return a.playSound.sound == b.playSound.sound;
+
+    case WORLD_EVENT_GRID_IMPULSE:
+        return a.gridImpulse.impulse == b.gridImpulse.impulse && a.gridImpulse.force == b.gridImpulse.force
+            && SameVector(a.gridImpulse.position, b.gridImpulse.position) && a.gridImpulse.radius == b.gridImpulse.radius;
+
+    default:
+        return true;
+    }
+}
+
+static bool SameWorld(World a, World b)
+{
+    if (ArrayCount(a.flushedEvents) != ArrayCount(b.flushedEvents))
+    {
+        return false;
+    }
+
+    for (int i = 0, n = ArrayCount(a.flushedEvents); i < n; i++)
+    {
+        if (!SameEvent(a.flushedEvents[i], b.flushedEvents[i]))
+        {
+            return false;
+        }
+    }
+
+    // Grid impulses add up in event order, the grid is only bit exact when the order is kept
+    return SameEntity(a.player, b.player)
+        && SameEntities(a.bullets, b.bullets) && SameEntities(a.seekers, b.seekers)
+        && SameEntities(a.wanderers, b.wanderers) && SameEntities(a.blackHoles, b.blackHoles)
+        && memcmp(a.grid.positionX, b.grid.positionX, sizeof(float) * a.grid.count) == 0
+        && memcmp(a.grid.positionY, b.grid.positionY, sizeof(float) * a.grid.count) == 0;
+}
+
+static int CountEvents(Array(WorldEvent) events, WorldEventType type)
+{
+    int count = 0;
+    for (int i = 0, n = ArrayCount(events); i < n; i++)
+    {
+        count += events[i].type == type;
+    }
+    return count;
+}
+
+// Serial and parallel worlds in lockstep, batches merge their event buffers in batch order so every tick must match exactly
+static int CheckWorldUpdate(int enemyCount)
+{
+    World serial = NewStressWorld(enemyCount, false);
+    World parallel = NewStressWorld(enemyCount, true);
+
+    int mismatchTick = -1;
+    int eventCount = 0;
+    int destroyCount = 0;
+    for (int tick = 0; tick < CHECK_TICKS && mismatchTick < 0; tick++)
+    {
+        TickWorld(&serial, tick);
+        TickWorld(&parallel, tick);
+
+        eventCount += ArrayCount(serial.flushedEvents);
+        destroyCount += CountEvents(serial.flushedEvents, WORLD_EVENT_DESTROY);
+        if (!SameWorld(serial, parallel))
+        {
+            mismatchTick = tick;
+        }
+    }
+
+    int failures = 0;
+    printf("  %6d enemies, %d threads: %d events, %d destroyed, %d enemies left, first mismatch of events or entities at tick %d\n",
+        enemyCount, JobSystemWorkerCount() + 1, eventCount, destroyCount, WorldEnemyCount(serial), mismatchTick);
+    if (mismatchTick >= 0 || destroyCount == 0)
+    {
+        printf("  FAILED: the parallel update does not match the serial one, or destroyed nothing\n");
+        failures++;
+    }
+
+    WorldFree(&parallel);
+    WorldFree(&serial);
+    return failures;
+}
+
+static double TimeWorldTicks(int enemyCount, bool parallel, int* enemiesLeft)
+{
+    World world = NewStressWorld(enemyCount, parallel);
+
+    // Apply the spawns
+    TickWorld(&world, 0);
+
+    double start = BenchmarkTime();
+    for (int tick = 1; tick <= MEASURE_TICKS; tick++)
+    {
+        TickWorld(&world, tick);
+    }
+    double elapsed = BenchmarkTime() - start;
+
+    *enemiesLeft = WorldEnemyCount(world);
+    WorldFree(&world);
+    return elapsed / MEASURE_TICKS;
+}
+
+static void MeasureWorldUpdate(int enemyCount)
+{
+    int serialLeft, parallelLeft;
+    double serialTime = TimeWorldTicks(enemyCount, false, &serialLeft);
+    double parallelTime = TimeWorldTicks(enemyCount, true, &parallelLeft);
+
+    printf("  %6d enemies  serial %8.3f ms/tick   parallel %2d threads %8.3f ms/tick x%.1f   (%d and %d enemies left)\n",
+        enemyCount, serialTime * 1000.0, JobSystemWorkerCount() + 1, parallelTime * 1000.0, serialTime / parallelTime, serialLeft, parallelLeft);
+}
+
+// Frame of the game without the frame rates, the hash only depend on the world
+static void DrawWorldFrame(World world, float alpha)
+{
+    RendererClear(BLACK);
+
+    Camera2D camera = {
+        (Vector2){ WORLD_WIDTH * 0.5f, WORLD_HEIGHT * 0.5f },
+        (Vector2){ 0, 0 },
+        0,
+        0.5f,
+    };
+    RendererBeginMode2D(camera);
+    {
+        WorldRender(world, alpha);
+
+        RendererBeginSection("DrawParticles");
+        DrawParticles(alpha);
+        RendererEndSection();
+    }
+    RendererEndMode2D();
+
+    RendererBeginSection("Hud");
+    RendererDrawText(TextFormat("Enemies: %d", WorldEnemyCount(world)), 0, 96, 18, RAYWHITE);
+    RendererEndSection();
+}
+
+static int CountLitPixels(SoftRenderer* renderer)
+{
+    int count = 0;
+    for (int i = 0, n = renderer->width * renderer->height; i < n; i++)
+    {
+        const uint8_t* pixel = renderer->pixels + (size_t)i * 4;
+        count += (pixel[0] | pixel[1] | pixel[2]) != 0;
+    }
+    return count;
+}
+
+// The stress world drawn like the game draw it: warp grid, entities, particles of the explosions, hud
+// Hash of the last frame, 0 when the art is missing
+static uint64_t MeasureWorldRender(int enemyCount, const char* threads, int* failures)
+{
+    SoftRenderer renderer = SoftRendererNew((int)WORLD_WIDTH, (int)WORLD_HEIGHT);
+    RendererSetBackend(SoftRendererGetBackend(&renderer));
+    spriteRenderer = &renderer;
+
+    uint64_t hash = 0;
+    World world = NewStressWorld(enemyCount, true);
+    if (world.player.sprite.texture.id != 0)
+    {
+        for (int tick = 0; tick < RENDER_TICKS; tick++)
+        {
+            TickWorld(&world, tick);
+            UpdateParticles(&world, TIME_STEP);
+        }
+
+        SoftRendererStats stats = { 0 };
+        double start = BenchmarkTime();
+        for (int i = 0; i < FRAME_COUNT; i++)
+        {
+            DrawWorldFrame(world, 0.5f);
+            stats = SoftRendererEndFrame(&renderer);
+        }
+        double frameTime = (BenchmarkTime() - start) / FRAME_COUNT;
+
+        char label[64];
+        snprintf(label, sizeof(label), "%d enemies, %s", enemyCount, threads);
+        BenchmarkReportFrame(label, frameTime, stats, &renderer);
+        hash = BenchmarkHash(renderer.pixels, (size_t)renderer.width * renderer.height * 4);
+
+        // Entities and explosions are still on screen before the game over
+        if (world.gameOverTimer > 0 || WorldEnemyCount(world) == 0 || CountLitPixels(&renderer) == 0)
+        {
+            printf("  FAILED: the scene is not drawn, game over %.2f, %d enemies\n", world.gameOverTimer, WorldEnemyCount(world));
+            (*failures)++;
+        }
+    }
+    else
+    {
+        printf("  no art in " ASSET_PATH ", skipped\n");
+    }
+
+    WorldFree(&world);
+    ReleaseSprites();
+    spriteRenderer = NULL;
+
+    RendererSetBackend(NULL);
+    SoftRendererFree(&renderer);
+    return hash;
+}
+
+int BenchmarkNeonShooterWorld(void)
+{
+    printf("NeonShooterWorld\n");
+
+    int failures = 0;
+
+    InitParticles();
+
+    JobSystemInit(CHECK_WORKERS);
+    failures += CheckWorldUpdate(1000);
+    failures += CheckWorldUpdate(10000);
+    failures += CheckWorldUpdate(50000);
+    JobSystemShutdown();
+
+    JobSystemInit(0);
+    MeasureWorldUpdate(1000);
+    MeasureWorldUpdate(10000);
+    MeasureWorldUpdate(50000);
+    JobSystemShutdown();
+
+    // Without workers ParallelFor run every batch on the calling thread
+    uint64_t serialHash = MeasureWorldRender(1000, "1 thread", &failures);
+
+    JobSystemInit(0);
+    uint64_t parallelHash = MeasureWorldRender(1000, "all threads", &failures);
+    JobSystemShutdown();
+
+    if (serialHash != parallelHash)
+    {
+        printf("  FAILED: frame differ between 1 thread and all threads\n");
+        failures++;
+    }
+
+    ReleaseParticles();
+    return failures;
+}
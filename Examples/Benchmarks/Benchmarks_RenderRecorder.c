@@ -0,0 +1,222 @@
+#include "Benchmarks.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <Memory.h>
+#include <Renderer.h>
+#include <SoftRenderer.h>
+#include <RenderRecorder.h>
+
+#define SCENE_WIDTH         1280
+#define SCENE_HEIGHT        720
+#define REPEAT_COUNT        10
+#define RECORD_PATH         "Benchmarks.rgdc"
+#define CAPTURE_PATH        "Frame.rgdc"    // Written by NeonShooter and the Spine example with F5
+
+static Texture LoadGlow(SoftRenderer* renderer)
+{
+    Image image = GenImageGradientRadial(32, 32, 0.0f, WHITE, BLANK);
+    Texture texture = SoftRendererLoadTexture(renderer, image);
+    UnloadImage(image);
+    return texture;
+}
+
+static uint64_t HashFrame(SoftRenderer* renderer)
+{
+    return BenchmarkHash(renderer->pixels, (size_t)renderer->width * renderer->height * 4);
+}
+
+static int CheckRenderRecorder(void)
+{
+    int failures = 0;
+
+    // Record while drawing on a first renderer, replay on a second one with the same textures
+    SoftRenderer live = SoftRendererNew(SCENE_WIDTH, SCENE_HEIGHT);
+    SoftRenderer replay = SoftRendererNew(SCENE_WIDTH, SCENE_HEIGHT);
+    Texture glow = LoadGlow(&live);
+    LoadGlow(&replay);
+
+    RenderRecorder recorder = RenderRecorderNew(SoftRendererGetBackend(&live));
+    RenderRecorderBeginFrame(&recorder, SCENE_WIDTH, SCENE_HEIGHT);
+    RendererSetBackend(RenderRecorderGetBackend(&recorder));
+    BenchmarkDrawScene(SCENE_WIDTH, SCENE_HEIGHT, glow, 0.5f);
+    RendererSetBackend(NULL);
+    int size = RenderRecorderEndFrame(&recorder);
+    SoftRendererStats liveStats = SoftRendererEndFrame(&live);
+
+    if (!RenderRecorderSave(&recorder, RECORD_PATH))
+    {
+        printf("  FAILED: cannot write %s\n", RECORD_PATH);
+        failures++;
+    }
+
+    int loadedSize;
+    uint8_t* loaded = RenderRecordLoad(RECORD_PATH, &loadedSize);
+    remove(RECORD_PATH);
+    if (!loaded || loadedSize != size || BenchmarkHash(loaded, loadedSize) != BenchmarkHash(recorder.buffer, size))
+    {
+        printf("  FAILED: loaded record differ from the recorded one\n");
+        failures++;
+    }
+
+    if (!RenderRecordReplay(loaded, loadedSize, SoftRendererGetBackend(&replay)))
+    {
+        printf("  FAILED: replay rejected the record\n");
+        failures++;
+    }
+    SoftRendererStats replayStats = SoftRendererEndFrame(&replay);
+
+    if (HashFrame(&live) != HashFrame(&replay) || replayStats.drawCalls != liveStats.drawCalls || replayStats.pixelsShaded != liveStats.pixelsShaded)
+    {
+        printf("  FAILED: replayed frame differ from the live one\n");
+        failures++;
+    }
+
+    // Summary counts match the backend ones, its area estimate stay close to the rasterized fragments
+    RenderRecordSummary summary;
+    if (!RenderRecordSummarize(loaded, loadedSize, &summary))
+    {
+        printf("  FAILED: summary rejected the record\n");
+        failures++;
+    }
+    else
+    {
+        double shadedOverdraw = (double)liveStats.pixelsShaded / ((double)SCENE_WIDTH * SCENE_HEIGHT);
+        printf("  %d bytes, %d commands, overdraw %.3f estimated, %.3f rasterized\n", summary.bytes, summary.commands, summary.overdraw, shadedOverdraw);
+        for (int i = 0; i < summary.sectionCount; i++)
+        {
+            const RenderSectionSummary* section = &summary.sections[i];
+            printf("  %-10s %6d draws %7d triangles %3d texture %2d blend %2d transform changes  overdraw %.3f\n",
+                section->name, section->drawCalls, section->triangles, section->textureChanges, section->blendChanges, section->transformChanges,
+                section->coveredArea / ((double)SCENE_WIDTH * SCENE_HEIGHT));
+        }
+
+        if (summary.total.drawCalls != liveStats.drawCalls || summary.total.triangles != liveStats.triangles
+            || summary.total.textureChanges != liveStats.textureChanges || summary.total.blendChanges != liveStats.blendChanges)
+        {
+            printf("  FAILED: summary counts differ from the renderer ones\n");
+            failures++;
+        }
+
+        if (fabs(summary.overdraw - shadedOverdraw) > shadedOverdraw * 0.02)
+        {
+            printf("  FAILED: overdraw estimate %.3f too far from %.3f\n", summary.overdraw, shadedOverdraw);
+            failures++;
+        }
+
+        if (summary.sectionCount != 3)
+        {
+            printf("  FAILED: %d sections, expected 3\n", summary.sectionCount);
+            failures++;
+        }
+    }
+
+    // Truncated and damaged records are rejected, not read past their end
+    if (RenderRecordReplay(loaded, loadedSize - 7, SoftRendererGetBackend(&replay)) || RenderRecordSummarize(loaded, loadedSize - 7, &summary))
+    {
+        printf("  FAILED: truncated record accepted\n");
+        failures++;
+    }
+
+    loaded[sizeof(RenderRecordHeader)] = 0xFF;
+    if (RenderRecordSummarize(loaded, loadedSize, &summary))
+    {
+        printf("  FAILED: unknown command accepted\n");
+        failures++;
+    }
+    SoftRendererEndFrame(&replay);
+
+    MemoryFree(loaded);
+    RenderRecorderFree(&recorder);
+    SoftRendererFree(&live);
+    SoftRendererFree(&replay);
+    return failures;
+}
+
+static void MeasureRenderRecorder(void)
+{
+    SoftRenderer renderer = SoftRendererNew(SCENE_WIDTH, SCENE_HEIGHT);
+    Texture glow = LoadGlow(&renderer);
+
+    // Recording alone is the overhead a captured frame add to the game
+    RenderRecorder recorder = RenderRecorderNew(NULL);
+    RendererSetBackend(RenderRecorderGetBackend(&recorder));
+
+    int size = 0;
+    double start = BenchmarkTime();
+    for (int i = 0; i < REPEAT_COUNT; i++)
+    {
+        RenderRecorderBeginFrame(&recorder, SCENE_WIDTH, SCENE_HEIGHT);
+        BenchmarkDrawScene(SCENE_WIDTH, SCENE_HEIGHT, glow, 0.5f);
+        size = RenderRecorderEndFrame(&recorder);
+    }
+    double recordTime = (BenchmarkTime() - start) / REPEAT_COUNT;
+    RendererSetBackend(NULL);
+
+    RenderRecordSummary summary = { 0 };
+    start = BenchmarkTime();
+    for (int i = 0; i < REPEAT_COUNT; i++)
+    {
+        RenderRecordSummarize(recorder.buffer, size, &summary);
+    }
+    double summaryTime = (BenchmarkTime() - start) / REPEAT_COUNT;
+
+    start = BenchmarkTime();
+    for (int i = 0; i < REPEAT_COUNT; i++)
+    {
+        RenderRecordReplay(recorder.buffer, size, SoftRendererGetBackend(&renderer));
+        SoftRendererEndFrame(&renderer);
+    }
+    double replayTime = (BenchmarkTime() - start) / REPEAT_COUNT;
+
+    BenchmarkSink(summary.overdraw);
+    printf("  record %6.2f ms  summarize %6.2f ms  replay %6.2f ms  %7.1f KB/frame, %d draws\n",
+        recordTime * 1000.0, summaryTime * 1000.0, replayTime * 1000.0, size / 1024.0, summary.total.drawCalls);
+
+    RenderRecorderFree(&recorder);
+    SoftRendererFree(&renderer);
+}
+
+// Offline profile of a frame captured in a game, its textures are unknown to the SoftRenderer and drawn white
+static void ReplayCapture(void)
+{
+    int size;
+    uint8_t* data = RenderRecordLoad(CAPTURE_PATH, &size);
+    if (!data)
+    {
+        return;
+    }
+
+    RenderRecordSummary summary;
+    if (!RenderRecordSummarize(data, size, &summary) || summary.width <= 0 || summary.height <= 0)
+    {
+        printf("  %s is not a valid frame record\n", CAPTURE_PATH);
+        MemoryFree(data);
+        return;
+    }
+
+    SoftRenderer renderer = SoftRendererNew(summary.width, summary.height);
+
+    double start = BenchmarkTime();
+    RenderRecordReplay(data, size, SoftRendererGetBackend(&renderer));
+    SoftRendererStats stats = SoftRendererEndFrame(&renderer);
+    double replayTime = BenchmarkTime() - start;
+
+    printf("  %s: %dx%d, replayed in %.2f ms, overdraw %.2f\n", CAPTURE_PATH, summary.width, summary.height, replayTime * 1000.0,
+        (double)stats.pixelsShaded / ((double)summary.width * summary.height));
+    RenderRecordPrintSummary(&summary);
+
+    SoftRendererFree(&renderer);
+    MemoryFree(data);
+}
+
+int BenchmarkRenderRecorder(void)
+{
+    printf("RenderRecorder\n");
+
+    int failures = CheckRenderRecorder();
+    MeasureRenderRecorder();
+    ReplayCapture();
+
+    return failures;
+}
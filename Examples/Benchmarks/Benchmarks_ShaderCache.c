@@ -0,0 +1,168 @@
+#include "Benchmarks.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <ShaderCache.h>
+
+#define CACHE_PATH      "ShaderCache"
+#define SHADER_NAME     "Shaders/Bloom.frag"
+#define BINARY_SIZE     (64 * 1024)     // Order of a driver binary for a small post process shader
+#define READ_COUNT      200
+
+static const char* driver = "Vendor|Renderer|4.6.0|raylib 3.0";
+static const char* fragment = "#version 330\nin vec2 fragTexCoord;\nout vec4 finalColor;\nvoid main() { finalColor = vec4(fragTexCoord, 0.0, 1.0); }\n";
+
+static bool SameKey(ShaderCacheKey a, ShaderCacheKey b)
+{
+    return a.driverHash == b.driverHash && a.sourceHash == b.sourceHash;
+}
+
+// Rewrite one byte of the entry, or cut it, like a crash or a disk error would
+static void DamageEntry(long offset, bool truncate)
+{
+    char path[512];
+    ShaderCacheFilePath(path, sizeof(path), CACHE_PATH, SHADER_NAME);
+
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        return;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* bytes = (char*)malloc(size);
+    size = (long)fread(bytes, 1, size, file);
+    fclose(file);
+
+    if (!truncate)
+    {
+        bytes[offset] ^= 0x5A;
+    }
+
+    file = fopen(path, "wb");
+    fwrite(bytes, 1, truncate ? offset : size, file);
+    fclose(file);
+    free(bytes);
+}
+
+static int CheckRead(const char* label, ShaderCacheKey key, ShaderCacheResult expected)
+{
+    ShaderBinary binary;
+    ShaderCacheResult result = ShaderCacheRead(CACHE_PATH, SHADER_NAME, key, &binary);
+    ShaderBinaryFree(&binary);
+
+    if (result != expected)
+    {
+        printf("  FAILED: %s read %d, expected %d\n", label, result, expected);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Software path: keying, invalidation and file format checked without a GL context
+static int CheckShaderCache(ShaderBinary binary)
+{
+    int failures = 0;
+
+    ShaderCacheKey key = ShaderCacheMakeKey(driver, NULL, fragment);
+    failures += !SameKey(key, ShaderCacheMakeKey(driver, NULL, fragment));
+    failures += SameKey(key, ShaderCacheMakeKey(driver, "", fragment));
+    failures += ShaderCacheMakeKey("a", "ab", "c").sourceHash == ShaderCacheMakeKey("a", "a", "bc").sourceHash;
+
+    ShaderCacheKey newDriver = ShaderCacheMakeKey("Vendor|Renderer|4.6.1|raylib 3.0", NULL, fragment);
+    failures += newDriver.driverHash == key.driverHash || newDriver.sourceHash != key.sourceHash;
+
+    char* edited = (char*)malloc(strlen(fragment) + 1);
+    strcpy(edited, fragment);
+    edited[strlen(edited) - 4] = ' ';
+    ShaderCacheKey newSource = ShaderCacheMakeKey(driver, NULL, edited);
+    failures += newSource.sourceHash == key.sourceHash || newSource.driverHash != key.driverHash;
+    free(edited);
+
+    if (failures > 0)
+    {
+        printf("  FAILED: %d key checks\n", failures);
+    }
+
+    ShaderCacheRemove(CACHE_PATH, SHADER_NAME);
+    failures += CheckRead("empty cache", key, SHADER_CACHE_MISS);
+
+    if (!ShaderCacheWrite(CACHE_PATH, SHADER_NAME, key, binary))
+    {
+        printf("  FAILED: can not write to %s\n", CACHE_PATH);
+        return failures + 1;
+    }
+
+    ShaderBinary read;
+    if (ShaderCacheRead(CACHE_PATH, SHADER_NAME, key, &read) != SHADER_CACHE_HIT
+        || read.format != binary.format || read.size != binary.size || memcmp(read.data, binary.data, binary.size) != 0)
+    {
+        printf("  FAILED: entry does not round trip\n");
+        failures++;
+    }
+    ShaderBinaryFree(&read);
+
+    failures += CheckRead("edited source", newSource, SHADER_CACHE_STALE);
+    failures += CheckRead("driver update", newDriver, SHADER_CACHE_STALE);
+
+    // A stale entry is replaced in place, the name always map to one file
+    ShaderCacheWrite(CACHE_PATH, SHADER_NAME, newSource, binary);
+    failures += CheckRead("rewritten entry", newSource, SHADER_CACHE_HIT);
+    failures += CheckRead("previous sources", key, SHADER_CACHE_STALE);
+
+    DamageEntry((long)sizeof(ShaderCacheHeader) + BINARY_SIZE / 2, false);
+    failures += CheckRead("flipped binary byte", newSource, SHADER_CACHE_CORRUPT);
+
+    ShaderCacheWrite(CACHE_PATH, SHADER_NAME, newSource, binary);
+    DamageEntry((long)sizeof(ShaderCacheHeader) + BINARY_SIZE / 2, true);
+    failures += CheckRead("truncated binary", newSource, SHADER_CACHE_CORRUPT);
+
+    ShaderCacheWrite(CACHE_PATH, SHADER_NAME, newSource, binary);
+    DamageEntry(0, false);
+    failures += CheckRead("bad magic", newSource, SHADER_CACHE_CORRUPT);
+
+    return failures;
+}
+
+int BenchmarkShaderCache(void)
+{
+    printf("ShaderCache\n");
+
+    ShaderBinary binary = { 0x8E21, BINARY_SIZE, malloc(BINARY_SIZE) };
+    for (int i = 0; i < BINARY_SIZE; i++)
+    {
+        ((unsigned char*)binary.data)[i] = (unsigned char)(i * 131 + (i >> 8));
+    }
+
+    int failures = CheckShaderCache(binary);
+
+    ShaderCacheKey key = ShaderCacheMakeKey(driver, NULL, fragment);
+    ShaderCacheWrite(CACHE_PATH, SHADER_NAME, key, binary);
+
+    int hits = 0;
+    double start = BenchmarkTime();
+    for (int i = 0; i < READ_COUNT; i++)
+    {
+        // What a cached launch pay per shader before glProgramBinary: hash the sources, read and check the entry
+        ShaderBinary read;
+        key = ShaderCacheMakeKey(driver, NULL, fragment);
+        hits += ShaderCacheRead(CACHE_PATH, SHADER_NAME, key, &read) == SHADER_CACHE_HIT;
+        ShaderBinaryFree(&read);
+    }
+    BenchmarkReport("ShaderCacheRead (64 KB)", BenchmarkTime() - start, READ_COUNT);
+
+    if (hits != READ_COUNT)
+    {
+        printf("  FAILED: %d of %d cached reads missed\n", READ_COUNT - hits, READ_COUNT);
+        failures++;
+    }
+
+    ShaderCacheRemove(CACHE_PATH, SHADER_NAME);
+
+    ShaderBinaryFree(&binary);
+    return failures;
+}
@@ -0,0 +1,227 @@
+#include "Benchmarks.h"
+
+#include <math.h>
+#include <Renderer.h>
+#include <JobSystem.h>
+#include <SoftRenderer.h>
+
+#define CHECK_SIZE      64
+#define SCENE_SPRITES   2000
+#define SCENE_GRID_STEP 40      // World units between warp grid points, like NeonShooter
+#define REPEAT_COUNT    10
+
+static bool PixelEquals(SoftRenderer* renderer, int x, int y, Color color)
+{
+    const uint8_t* pixel = renderer->pixels + ((size_t)y * renderer->width + x) * 4;
+    return pixel[0] == color.r && pixel[1] == color.g && pixel[2] == color.b && pixel[3] == color.a;
+}
+
+static int ExpectPixel(SoftRenderer* renderer, const char* check, int x, int y, Color color)
+{
+    if (PixelEquals(renderer, x, y, color))
+    {
+        return 0;
+    }
+
+    const uint8_t* pixel = renderer->pixels + ((size_t)y * renderer->width + x) * 4;
+    printf("  FAILED: %s, pixel (%d, %d) is (%d, %d, %d, %d), expected (%d, %d, %d, %d)\n",
+        check, x, y, pixel[0], pixel[1], pixel[2], pixel[3], color.r, color.g, color.b, color.a);
+    return 1;
+}
+
+static uint64_t HashFrame(SoftRenderer* renderer)
+{
+    return BenchmarkHash(renderer->pixels, (size_t)renderer->width * renderer->height * 4);
+}
+
+static int CheckSoftRenderer(void)
+{
+    int failures = 0;
+
+    SoftRenderer renderer = SoftRendererNew(CHECK_SIZE, CHECK_SIZE);
+    RendererSetBackend(SoftRendererGetBackend(&renderer));
+
+    // Edges are exclusive at the bottom right, like the GPU with pixel centers
+    RendererClear(BLACK);
+    RendererDrawRectangleRec((Rectangle) { 10, 10, 20, 20 }, RED);
+    SoftRendererStats stats = SoftRendererEndFrame(&renderer);
+    failures += ExpectPixel(&renderer, "rectangle inside", 10, 10, RED);
+    failures += ExpectPixel(&renderer, "rectangle inside", 29, 29, RED);
+    failures += ExpectPixel(&renderer, "rectangle outside", 9, 9, BLACK);
+    failures += ExpectPixel(&renderer, "rectangle outside", 30, 30, BLACK);
+    if (stats.pixelsShaded != 400 || stats.drawCalls != 1 || stats.triangles != 2)
+    {
+        printf("  FAILED: rectangle stats %d draws, %d triangles, %lld pixels\n", stats.drawCalls, stats.triangles, (long long)stats.pixelsShaded);
+        failures++;
+    }
+
+    // The diagonal of a quad must not be blended twice, tiles must not leave seams
+    RendererClear(BLACK);
+    RendererBeginBlendMode(BLEND_ADDITIVE);
+    RendererDrawRectangleRec((Rectangle) { 0, 0, CHECK_SIZE, CHECK_SIZE }, (Color) { 10, 10, 10, 255 });
+    RendererDrawRectangleRec((Rectangle) { 16, 16, 8, 8 }, (Color) { 100, 0, 0, 255 });
+    RendererDrawRectangleRec((Rectangle) { 16, 16, 8, 8 }, (Color) { 100, 0, 0, 255 });
+    RendererEndBlendMode();
+    stats = SoftRendererEndFrame(&renderer);
+    failures += ExpectPixel(&renderer, "additive diagonal", 0, 0, (Color) { 10, 10, 10, 255 });
+    failures += ExpectPixel(&renderer, "additive diagonal", 40, 40, (Color) { 10, 10, 10, 255 });
+    failures += ExpectPixel(&renderer, "additive diagonal", 63, 63, (Color) { 10, 10, 10, 255 });
+    failures += ExpectPixel(&renderer, "additive overlap", 20, 20, (Color) { 210, 10, 10, 255 });
+    if (stats.pixelsShaded != CHECK_SIZE * CHECK_SIZE + 128 || stats.blendChanges != 2)
+    {
+        printf("  FAILED: additive stats %d blend changes, %lld pixels\n", stats.blendChanges, (long long)stats.pixelsShaded);
+        failures++;
+    }
+
+    // Alpha blending of a half transparent color
+    RendererClear(BLACK);
+    RendererDrawRectangleRec((Rectangle) { 0, 0, 8, 8 }, (Color) { 255, 255, 255, 128 });
+    SoftRendererEndFrame(&renderer);
+    failures += ExpectPixel(&renderer, "alpha blend", 4, 4, (Color) { 128, 128, 128, 191 });
+
+    // Quadrants of a 2x2 texture stretched on 16x16, then flipped on both axis
+    Color texels[4] = { RED, GREEN, BLUE, WHITE };
+    Image image = { texels, 2, 2, 1, UNCOMPRESSED_R8G8B8A8 };
+    Texture texture = SoftRendererLoadTexture(&renderer, image);
+
+    RendererClear(BLACK);
+    RendererDrawTexturePro(texture, (Rectangle) { 0, 0, 2, 2 }, (Rectangle) { 0, 0, 16, 16 }, (Vector2) { 0, 0 }, 0.0f, WHITE);
+    RendererDrawTexturePro(texture, (Rectangle) { 0, 0, -2, -2 }, (Rectangle) { 32, 32, 16, 16 }, (Vector2) { 8, 8 }, 0.0f, WHITE);
+    SoftRendererEndFrame(&renderer);
+    failures += ExpectPixel(&renderer, "texture", 4, 4, RED);
+    failures += ExpectPixel(&renderer, "texture", 12, 4, GREEN);
+    failures += ExpectPixel(&renderer, "texture", 4, 12, BLUE);
+    failures += ExpectPixel(&renderer, "texture", 12, 12, WHITE);
+    failures += ExpectPixel(&renderer, "flipped texture", 28, 28, WHITE);
+    failures += ExpectPixel(&renderer, "flipped texture", 36, 36, RED);
+
+    // A quarter turn around the center swap the quadrants
+    RendererClear(BLACK);
+    RendererDrawTexturePro(texture, (Rectangle) { 0, 0, 2, 2 }, (Rectangle) { 32, 32, 16, 16 }, (Vector2) { 8, 8 }, 90.0f, WHITE);
+    SoftRendererEndFrame(&renderer);
+    failures += ExpectPixel(&renderer, "rotated texture", 36, 28, RED);
+    failures += ExpectPixel(&renderer, "rotated texture", 28, 28, BLUE);
+
+    SoftRendererUnloadTexture(&renderer, texture);
+
+    RendererSetBackend(NULL);
+    SoftRendererFree(&renderer);
+    return failures;
+}
+
+void BenchmarkReportFrame(const char* label, double frameTime, SoftRendererStats stats, SoftRenderer* renderer)
+{
+    printf("  %-18s %7.2f ms/frame  %5d draws %6d triangles %3d texture changes %2d blend changes  overdraw %.2f  hash %016llx\n",
+        label, frameTime * 1000.0, stats.drawCalls, stats.triangles, stats.textureChanges, stats.blendChanges,
+        (double)stats.pixelsShaded / ((double)renderer->width * renderer->height), (unsigned long long)HashFrame(renderer));
+}
+
+static float SceneRandom(uint32_t* state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return (*state >> 8) / 16777216.0f;
+}
+
+// NeonShooter like frame: additive warp grid, additive sprites through a zoomed camera, text on top
+void BenchmarkDrawScene(int width, int height, Texture glow, float time)
+{
+    RendererClear(BLACK);
+
+    Camera2D camera = { (Vector2) { width * 0.5f, height * 0.5f }, (Vector2) { 0, 0 }, 0.0f, 0.5f };
+    RendererBeginMode2D(camera);
+    {
+        float halfWidth = (float)width;
+        float halfHeight = (float)height;
+
+        RendererBeginSection("WarpGrid");
+        RendererBeginBlendMode(BLEND_ADDITIVE);
+        Color gridColor = { 30, 30, 139, 156 };
+        for (float y = -halfHeight; y <= halfHeight; y += SCENE_GRID_STEP)
+        {
+            for (float x = -halfWidth; x <= halfWidth; x += SCENE_GRID_STEP)
+            {
+                float wave = sinf(x * 0.01f + time) * 6.0f;
+                RendererDrawLineEx((Vector2) { x, y + wave }, (Vector2) { x + SCENE_GRID_STEP, y + wave }, 2.0f, gridColor);
+                RendererDrawLineEx((Vector2) { x + wave, y }, (Vector2) { x + wave, y + SCENE_GRID_STEP }, 2.0f, gridColor);
+            }
+        }
+        RendererEndSection();
+
+        // Same sprites every frame, generated instead of stored
+        RendererBeginSection("Sprites");
+        uint32_t seed = 1;
+        for (int i = 0; i < SCENE_SPRITES; i++)
+        {
+            Vector2 position = { (SceneRandom(&seed) * 2.0f - 1.0f) * halfWidth, (SceneRandom(&seed) * 2.0f - 1.0f) * halfHeight };
+            float rotation = SceneRandom(&seed) * 360.0f;
+            float size = glow.width * (0.5f + SceneRandom(&seed) * 1.5f);
+            Color color = { (unsigned char)(SceneRandom(&seed) * 255.0f), (unsigned char)(SceneRandom(&seed) * 255.0f), (unsigned char)(SceneRandom(&seed) * 255.0f), 200 };
+
+            RendererDrawTexturePro(glow, (Rectangle) { 0, 0, (float)glow.width, (float)glow.height },
+                (Rectangle) { position.x, position.y, size, size }, (Vector2) { size * 0.5f, size * 0.5f },
+                rotation + time * 90.0f, color);
+        }
+        RendererEndBlendMode();
+        RendererEndSection();
+    }
+    RendererEndMode2D();
+
+    RendererBeginSection("Hud");
+    for (int i = 0; i < 5; i++)
+    {
+        RendererDrawText(TextFormat("CPU FPS: %d - Enemies: %d", 60 + i, SCENE_SPRITES), 0, i * 24, 18, RAYWHITE);
+    }
+    RendererEndSection();
+}
+
+static uint64_t MeasureScene(const char* label, int width, int height)
+{
+    SoftRenderer renderer = SoftRendererNew(width, height);
+    RendererSetBackend(SoftRendererGetBackend(&renderer));
+
+    Image glowImage = GenImageGradientRadial(32, 32, 0.0f, WHITE, BLANK);
+    Texture glow = SoftRendererLoadTexture(&renderer, glowImage);
+    UnloadImage(glowImage);
+
+    SoftRendererStats stats = { 0 };
+    double start = BenchmarkTime();
+    for (int i = 0; i < REPEAT_COUNT; i++)
+    {
+        BenchmarkDrawScene(width, height, glow, 0.0f);
+        stats = SoftRendererEndFrame(&renderer);
+    }
+    double frameTime = (BenchmarkTime() - start) / REPEAT_COUNT;
+
+    uint64_t hash = HashFrame(&renderer);
+    BenchmarkReportFrame(label, frameTime, stats, &renderer);
+
+    RendererSetBackend(NULL);
+    SoftRendererFree(&renderer);
+    return hash;
+}
+
+int BenchmarkSoftRenderer(void)
+{
+    printf("SoftRenderer\n");
+
+    int failures = CheckSoftRenderer();
+
+    // Without workers ParallelFor run every tile on the calling thread
+    uint64_t serialHash = MeasureScene("720p, 1 thread", 1280, 720);
+    MeasureScene("1080p, 1 thread", 1920, 1080);
+
+    JobSystemInit(0);
+    failures += CheckSoftRenderer();
+    uint64_t parallelHash = MeasureScene("720p, all threads", 1280, 720);
+    MeasureScene("1080p, all threads", 1920, 1080);
+    JobSystemShutdown();
+
+    // Tiles own their pixels and keep the submission order, frames must not depend on thread count
+    if (serialHash != parallelHash)
+    {
+        printf("  FAILED: frame differ between 1 thread and all threads\n");
+        failures++;
+    }
+
+    return failures;
+}
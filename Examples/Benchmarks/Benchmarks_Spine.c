@@ -0,0 +1,158 @@
+#include "Benchmarks.h"
+
+#include <spine/spine.h>
+#include <Renderer.h>
+#include <JobSystem.h>
+#include <SoftRenderer.h>
+
+#include "../Spine/raylib-spine.h"
+
+#define SPINE_PATH      "../Assets/spineboy/"   // Same assets as the example
+#define SCREEN_WIDTH    800                     // Window of the example
+#define SCREEN_HEIGHT   450
+#define TIME_STEP       (1.0f / 60.0f)
+#define WALK_TICKS      30                      // Frames of the walk before the measured ones
+#define FRAME_COUNT     20
+#define HUD_HEIGHT      40                      // Rows of the text
+
+// Atlas pages go in this renderer, raylib-spine load them with raylib otherwise
+static SoftRenderer* atlasRenderer;
+
+static Texture2D LoadAtlasTexture(const char* path)
+{
+    Image image = LoadImage(path);
+    Texture2D texture = image.data ? SoftRendererLoadTexture(atlasRenderer, image) : (Texture2D) { 0 };
+    UnloadImage(image);
+    return texture;
+}
+
+static void UnloadAtlasTexture(Texture2D texture)
+{
+    SoftRendererUnloadTexture(atlasRenderer, texture);
+}
+
+static int CountCoveredPixels(SoftRenderer* renderer, int firstRow, Color background)
+{
+    int count = 0;
+    for (int i = firstRow * renderer->width, n = renderer->width * renderer->height; i < n; i++)
+    {
+        const uint8_t* pixel = renderer->pixels + (size_t)i * 4;
+        count += pixel[0] != background.r || pixel[1] != background.g || pixel[2] != background.b;
+    }
+    return count;
+}
+
+// Frame of the example: the walk animation advanced one tick, the skeleton, the text on top
+static void DrawSpineFrame(spSkeleton* skeleton, spAnimationState* animationState)
+{
+    RendererClear(RAYWHITE);
+
+    spAnimationState_update(animationState, TIME_STEP);
+    spAnimationState_apply(animationState, skeleton);
+    spSkeleton_updateWorldTransform(skeleton);
+
+    RendererBeginSection("drawSkeleton");
+    drawSkeleton(skeleton, (Vector3) { SCREEN_WIDTH / 2, SCREEN_HEIGHT, 0 });
+    RendererEndSection();
+
+    RendererDrawText("60 FPS", 10, 10, 20, LIME);
+}
+
+// Hash of the last frame, 0 when the assets are missing
+static uint64_t MeasureSpine(const char* label, int* failures)
+{
+    SoftRenderer renderer = SoftRendererNew(SCREEN_WIDTH, SCREEN_HEIGHT);
+    RendererSetBackend(SoftRendererGetBackend(&renderer));
+
+    atlasRenderer = &renderer;
+    texture_2d_set_loader(LoadAtlasTexture, UnloadAtlasTexture);
+
+    uint64_t hash = 0;
+    spAtlas* atlas = spAtlas_createFromFile(SPINE_PATH "spineboy.atlas", 0);
+    spSkeletonJson* json = atlas ? spSkeletonJson_create(atlas) : NULL;
+    spSkeletonData* skeletonData = json ? spSkeletonJson_readSkeletonDataFile(json, SPINE_PATH "spineboy-pro.json") : NULL;
+    if (skeletonData)
+    {
+        spBone_setYDown(true);
+        spSkeleton* skeleton = spSkeleton_create(skeletonData);
+        skeleton->scaleX = 0.5f;
+        skeleton->scaleY = 0.5f;
+
+        spAnimationStateData* animationStateData = spAnimationStateData_create(skeletonData);
+        spAnimationState* animationState = spAnimationState_create(animationStateData);
+        spAnimationState_addAnimationByName(animationState, 0, "walk", 1, 0);
+
+        for (int i = 0; i < WALK_TICKS; i++)
+        {
+            DrawSpineFrame(skeleton, animationState);
+            SoftRendererEndFrame(&renderer);
+        }
+
+        SoftRendererStats stats = { 0 };
+        double start = BenchmarkTime();
+        for (int i = 0; i < FRAME_COUNT; i++)
+        {
+            DrawSpineFrame(skeleton, animationState);
+            stats = SoftRendererEndFrame(&renderer);
+        }
+        double frameTime = (BenchmarkTime() - start) / FRAME_COUNT;
+
+        BenchmarkReportFrame(label, frameTime, stats, &renderer);
+        hash = BenchmarkHash(renderer.pixels, (size_t)renderer.width * renderer.height * 4);
+
+        // The skeleton cover part of the frame below the text
+        int covered = CountCoveredPixels(&renderer, HUD_HEIGHT, RAYWHITE);
+        if (covered == 0)
+        {
+            printf("  FAILED: spineboy is not drawn, %d triangles\n", stats.triangles);
+            (*failures)++;
+        }
+
+        spAnimationState_dispose(animationState);
+        spAnimationStateData_dispose(animationStateData);
+        spSkeleton_dispose(skeleton);
+        spSkeletonData_dispose(skeletonData);
+    }
+    else
+    {
+        printf("  no spineboy assets in " SPINE_PATH ", skipped\n");
+    }
+
+    if (json)
+    {
+        spSkeletonJson_dispose(json);
+    }
+    if (atlas)
+    {
+        spAtlas_dispose(atlas);
+    }
+    texture_2d_destroy();
+    texture_2d_set_loader(NULL, NULL);
+    atlasRenderer = NULL;
+
+    RendererSetBackend(NULL);
+    SoftRendererFree(&renderer);
+    return hash;
+}
+
+int BenchmarkSpine(void)
+{
+    printf("Spine\n");
+
+    int failures = 0;
+
+    // Without workers ParallelFor run every tile on the calling thread
+    uint64_t serialHash = MeasureSpine("spineboy, 1 thread", &failures);
+
+    JobSystemInit(0);
+    uint64_t parallelHash = MeasureSpine("spineboy, all threads", &failures);
+    JobSystemShutdown();
+
+    if (serialHash != parallelHash)
+    {
+        printf("  FAILED: frame differ between 1 thread and all threads\n");
+        failures++;
+    }
+
+    return failures;
+}
@@ -0,0 +1,771 @@
+#include "Benchmarks.h"
+
+#include <math.h>
+#include <string.h>
+#include <Memory.h>
+#include <SpringGrid.h>
+
+#define SPACING         16.0f
+#define TIME_STEP       (1.0f / 60.0f)
+#define CHECK_TICKS     240
+#define IMPULSE_TICKS   30
+#define TICK_BUDGET     0.25        // Seconds of ticks per measure
+
+// Pointer based springs of LiquidSurface2D before SpringGrid, kept as the reference
+typedef struct LegacyPoint
+{
+    Vector2 position;
+    Vector2 velocity;
+    Vector2 acceleration;
+    float   invMass;
+    float   damping;
+} LegacyPoint;
+
+typedef struct LegacySpring
+{
+    LegacyPoint* p0;
+    LegacyPoint* p1;
+    float   targetLength;
+    float   stiffness;
+    float   damping;
+    float   force;
+} LegacySpring;
+
+typedef struct LegacyGrid
+{
+    int             count;
+    int             springCount;
+    LegacyPoint*    points;
+    LegacyPoint*    fixedPoints;
+    LegacySpring*   springs;
+} LegacyGrid;
+
+const SpringGridParams benchmarkLiquidParams = {
+    .stiffness = 0.28f,
+    .damping = 2.0f,
+    .restLength = 0.95f,
+    .force = 250.0f,
+
+    .borderStiffness = 0.2f,
+    .borderDamping = 5.0f,
+    .anchorStiffness = 0.004f,
+    .anchorDamping = 20.0f,
+    .anchorStep = 3,
+
+    .pointDamping = 3.0f,
+    .restThreshold = 0.0f,
+
+    .sleepThreshold = 0.0f,
+};
+
+static LegacySpring NewLegacySpring(LegacyPoint* p0, LegacyPoint* p1, float stiffness, float damping)
+{
+    float dx = p0->position.x - p1->position.x;
+    float dy = p0->position.y - p1->position.y;
+    return (LegacySpring) { p0, p1, sqrtf(dx * dx + dy * dy) * benchmarkLiquidParams.restLength, stiffness, damping, benchmarkLiquidParams.force };
+}
+
+static LegacyGrid NewLegacyGrid(int cols, int rows)
+{
+    int count = cols * rows;
+    LegacyGrid grid = {
+        .count = count,
+        .springCount = 0,
+        .points = (LegacyPoint*)MemoryAlloc(sizeof(LegacyPoint) * count),
+        .fixedPoints = (LegacyPoint*)MemoryAlloc(sizeof(LegacyPoint) * count),
+        .springs = (LegacySpring*)MemoryAlloc(sizeof(LegacySpring) * 3 * count),
+    };
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            int index = i * cols + j;
+            Vector2 position = { j * SPACING, i * SPACING };
+            grid.points[index] = (LegacyPoint) { position, { 0, 0 }, { 0, 0 }, 1.0f, benchmarkLiquidParams.pointDamping };
+            grid.fixedPoints[index] = grid.points[index];
+
+            if (i == 0 || j == 0 || i == rows - 1 || j == cols - 1)
+            {
+                grid.springs[grid.springCount++] = NewLegacySpring(&grid.fixedPoints[index], &grid.points[index], benchmarkLiquidParams.borderStiffness, benchmarkLiquidParams.borderDamping);
+            }
+            else if (i % 3 == 0 && j % 3 == 0)
+            {
+                grid.springs[grid.springCount++] = NewLegacySpring(&grid.fixedPoints[index], &grid.points[index], benchmarkLiquidParams.anchorStiffness, benchmarkLiquidParams.anchorDamping);
+            }
+
+            if (j > 0)
+            {
+                grid.springs[grid.springCount++] = NewLegacySpring(&grid.points[index - 1], &grid.points[index], benchmarkLiquidParams.stiffness, benchmarkLiquidParams.damping);
+            }
+
+            if (i > 0)
+            {
+                grid.springs[grid.springCount++] = NewLegacySpring(&grid.points[index - cols], &grid.points[index], benchmarkLiquidParams.stiffness, benchmarkLiquidParams.damping);
+            }
+        }
+    }
+
+    return grid;
+}
+
+static void FreeLegacyGrid(LegacyGrid* grid)
+{
+    MemoryFree(grid->points);
+    MemoryFree(grid->fixedPoints);
+    MemoryFree(grid->springs);
+}
+
+static void UpdateLegacyGrid(LegacyGrid grid, float timeStep)
+{
+    for (int i = 0; i < grid.springCount; i++)
+    {
+        LegacySpring spring = grid.springs[i];
+
+        float dx = spring.p0->position.x - spring.p1->position.x;
+        float dy = spring.p0->position.y - spring.p1->position.y;
+        float len = sqrtf(dx * dx + dy * dy);
+        if (len > spring.targetLength)
+        {
+            float changeRate = (len - spring.targetLength) / len;
+            float velocityFactor = fmaxf(0.0f, 1.0f - spring.damping * timeStep);
+            float fx = dx * spring.stiffness * changeRate - (spring.p1->velocity.x - spring.p0->velocity.x) * velocityFactor;
+            float fy = dy * spring.stiffness * changeRate - (spring.p1->velocity.y - spring.p0->velocity.y) * velocityFactor;
+
+            spring.p0->acceleration.x -= fx * spring.force * spring.p0->invMass * timeStep;
+            spring.p0->acceleration.y -= fy * spring.force * spring.p0->invMass * timeStep;
+            spring.p1->acceleration.x += fx * spring.force * spring.p1->invMass * timeStep;
+            spring.p1->acceleration.y += fy * spring.force * spring.p1->invMass * timeStep;
+        }
+    }
+
+    for (int i = 0; i < grid.count; i++)
+    {
+        LegacyPoint* point = &grid.points[i];
+        point->velocity.x += point->acceleration.x * timeStep;
+        point->velocity.y += point->acceleration.y * timeStep;
+        point->position.x += point->velocity.x * timeStep;
+        point->position.y += point->velocity.y * timeStep;
+
+        float factor = fmaxf(0.0f, 1.0f - point->damping * timeStep);
+        point->acceleration.x *= factor;
+        point->acceleration.y *= factor;
+        point->velocity.x *= factor;
+        point->velocity.y *= factor;
+        point->damping = benchmarkLiquidParams.pointDamping;
+    }
+}
+
+// Same radial push as a mouse press on LiquidSurface2D
+static Vector2 ImpulseForce(Vector2 position, Vector2 center, float radius, bool* outInside)
+{
+    float dx = position.x - center.x;
+    float dy = position.y - center.y;
+    float dist = sqrtf(dx * dx + dy * dy);
+    *outInside = dist < radius;
+
+    float scale = 12000.0f / (100.0f + dist);
+    return (Vector2) { dx * scale, dy * scale };
+}
+
+static int TileOfPoint(const SpringGrid* grid, int index)
+{
+    int i = index / grid->cols;
+    int j = index - i * grid->cols;
+    return (i / SPRING_GRID_TILE_SIZE) * grid->tileCols + j / SPRING_GRID_TILE_SIZE;
+}
+
+static void ApplyImpulses(LegacyGrid* legacy, SpringGrid* grid, Vector2 center, float timeStep)
+{
+    // SpringGrid damp whole tiles, the pointer springs raise the damping of every point of the tiles a push touch
+    int tileCount = grid->tileCols * grid->tileRows;
+    uint8_t* pushedTiles = legacy ? (uint8_t*)MemoryAlloc(tileCount) : NULL;
+    if (pushedTiles)
+    {
+        MemoryInit(pushedTiles, 0, tileCount);
+    }
+
+    for (int i = 0; i < grid->count; i++)
+    {
+        bool inside;
+        if (pushedTiles)
+        {
+            Vector2 force = ImpulseForce(legacy->points[i].position, center, 80.0f, &inside);
+            if (inside)
+            {
+                legacy->points[i].acceleration.x += force.x * timeStep;
+                legacy->points[i].acceleration.y += force.y * timeStep;
+                pushedTiles[TileOfPoint(grid, i)] = 1;
+            }
+        }
+
+        Vector2 force = ImpulseForce(SpringGridPosition(*grid, i), center, 80.0f, &inside);
+        if (inside)
+        {
+            SpringGridApplyForce(*grid, i, force, timeStep);
+            SpringGridIncreaseDamping(*grid, i, 1.0f / 0.6f);
+        }
+    }
+
+    if (pushedTiles)
+    {
+        for (int i = 0; i < grid->count; i++)
+        {
+            if (pushedTiles[TileOfPoint(grid, i)])
+            {
+                legacy->points[i].damping = benchmarkLiquidParams.pointDamping * (1.0f / 0.6f);
+            }
+        }
+        MemoryFree(pushedTiles);
+    }
+}
+
+static int CheckSpringGrid(int cols, int rows)
+{
+    LegacyGrid legacy = NewLegacyGrid(cols, rows);
+    SpringGrid grid = SpringGridNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { SPACING, SPACING }, benchmarkLiquidParams);
+
+    // Sum order of the forces differ, the paths must still agree well under a pixel
+    // SpringGrid derive the velocities from positions rounded to 1e-4 px, a spring that cross its rest length
+    // one tick apart turn that into a few hundredths of a pixel
+    Vector2 center = { cols * SPACING * 0.4f, rows * SPACING * 0.6f };
+    float maxError = 0.0f;
+    float maxMotion = 0.0f;
+    for (int tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        if (tick < IMPULSE_TICKS)
+        {
+            ApplyImpulses(&legacy, &grid, center, TIME_STEP);
+        }
+
+        UpdateLegacyGrid(legacy, TIME_STEP);
+        SpringGridUpdate(grid, TIME_STEP);
+
+        for (int i = 0; i < grid.count; i++)
+        {
+            Vector2 position = SpringGridPosition(grid, i);
+            maxError = fmaxf(maxError, fmaxf(fabsf(position.x - legacy.points[i].position.x), fabsf(position.y - legacy.points[i].position.y)));
+            maxMotion = fmaxf(maxMotion, fabsf(legacy.points[i].position.x - legacy.fixedPoints[i].position.x));
+        }
+    }
+
+    int failures = 0;
+    printf("  %dx%d points: max difference with the pointer springs %.2e px, max motion %.1f px\n", cols, rows, maxError, maxMotion);
+    if (maxError > 0.1f || maxMotion < 1.0f)
+    {
+        printf("  FAILED: SpringGrid does not follow the pointer springs\n");
+        failures++;
+    }
+
+    SpringGridFree(&grid);
+    FreeLegacyGrid(&legacy);
+    return failures;
+}
+
+// Every point at rest within the radius must be in the culled range, for pushes inside, across and outside the grid
+static int CheckRangeInRadius(void)
+{
+    SpringGrid grid = SpringGridNew(37, 23, (Vector2) { 5.0f, -3.0f }, (Vector2) { SPACING, SPACING * 0.5f }, benchmarkLiquidParams);
+
+    const Vector3 pushes[] = {
+        { 300.0f, 80.0f, 80.0f }, { 5.0f, -3.0f, 40.0f }, { -60.0f, 50.0f, 80.0f }, { 600.0f, 200.0f, 17.0f },
+        { 10000.0f, 50.0f, 80.0f }, { 200.0f, 100.0f, 1e9f }, { 200.0f, 100.0f, 0.0f },
+    };
+
+    int missed = 0;
+    int visited = 0;
+    for (int p = 0; p < (int)(sizeof(pushes) / sizeof(pushes[0])); p++)
+    {
+        Vector2 center = { pushes[p].x, pushes[p].y };
+        float radius = pushes[p].z;
+        SpringGridRange range = SpringGridRangeInRadius(grid, center, radius);
+        visited += (range.row1 - range.row0) * (range.col1 - range.col0);
+
+        for (int i = 0; i < grid.rows; i++)
+        {
+            for (int j = 0; j < grid.cols; j++)
+            {
+                Vector2 position = SpringGridPosition(grid, i * grid.cols + j);
+                float dx = position.x - center.x;
+                float dy = position.y - center.y;
+                bool inRange = i >= range.row0 && i < range.row1 && j >= range.col0 && j < range.col1;
+                missed += dx * dx + dy * dy < radius * radius && !inRange;
+            }
+        }
+    }
+
+    printf("  Culled force ranges: %d points visited for %d pushes over %d points, %d missed\n",
+        visited, (int)(sizeof(pushes) / sizeof(pushes[0])), grid.count, missed);
+
+    SpringGridFree(&grid);
+    if (missed > 0)
+    {
+        printf("  FAILED: SpringGridRangeInRadius miss points in the radius\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Bytes loaded and stored by the solver loops in a tick, every element counted once per pass
+
+static size_t LegacyBytesPerTick(LegacyGrid grid)
+{
+    // Each spring is read, its 2 ends load position and velocity then load and store acceleration
+    size_t springBytes = sizeof(LegacySpring) + 2 * (sizeof(Vector2) * 2 + sizeof(Vector2) * 2);
+
+    // Integration load and store the whole point
+    return grid.springCount * springBytes + grid.count * sizeof(LegacyPoint) * 2;
+}
+
+static size_t SpringGridBytesPerTick(SpringGrid grid)
+{
+    size_t anchors = 2 * grid.cols + 2 * (grid.rows - 2);
+    if (grid.params.anchorStep > 0)
+    {
+        anchors += (size_t)((grid.rows - 2) / grid.params.anchorStep) * ((grid.cols - 2) / grid.params.anchorStep);
+    }
+
+    // Velocities are derived from the positions and the previous positions, damping is per tile
+    // The previous positions are saved by the integration, no copy pass
+    size_t horizontal = 4 + 4 + 4;      // Positions and previous positions, row scratch store and load, acceleration load and store
+    size_t vertical = 8 + 8;            // Both rows of the pair
+    size_t integrate = 6 + 6;           // Position, previous position and acceleration
+    size_t anchor = 6 + 2;              // Only anchored points
+
+    return sizeof(float) * ((horizontal + vertical + integrate) * grid.count + anchor * anchors);
+}
+
+static void MeasureSpringGrid(const char* label, int width, int height)
+{
+    int cols = (int)(width / SPACING) + 2;
+    int rows = (int)(height / SPACING) + 2;
+
+    LegacyGrid legacy = NewLegacyGrid(cols, rows);
+    SpringGrid grid = SpringGridNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { SPACING, SPACING }, benchmarkLiquidParams);
+
+    // Keep the grid moving, resting springs skip most of their work
+    Vector2 center = { width * 0.5f, height * 0.5f };
+    ApplyImpulses(&legacy, &grid, center, TIME_STEP);
+
+    int ticks = 0;
+    double start = BenchmarkTime();
+    double elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        UpdateLegacyGrid(legacy, TIME_STEP);
+        ticks++;
+        elapsed = BenchmarkTime() - start;
+    }
+    double legacyTime = elapsed / ticks;
+
+    ticks = 0;
+    start = BenchmarkTime();
+    elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        SpringGridUpdate(grid, TIME_STEP);
+        ticks++;
+        elapsed = BenchmarkTime() - start;
+    }
+    double gridTime = elapsed / ticks;
+
+    BenchmarkSink(grid.positionX[grid.count / 2] + legacy.points[grid.count / 2].position.x);
+
+    double legacyBytes = (double)LegacyBytesPerTick(legacy);
+    double gridBytes = (double)SpringGridBytesPerTick(grid);
+    printf("  %-12s %7d points  pointer springs %8.3f ms/tick %6.2f ns/point   SpringGrid %8.3f ms/tick %6.2f ns/point   x%.1f\n",
+        label, grid.count, legacyTime * 1000.0, legacyTime * 1e9 / grid.count, gridTime * 1000.0, gridTime * 1e9 / grid.count, legacyTime / gridTime);
+    printf("  %-12s %7s         pointer springs %8.2f MB/tick %6.1f B/point    SpringGrid %8.2f MB/tick %6.1f B/point    x%.1f\n",
+        "", "", legacyBytes / (1024.0 * 1024.0), legacyBytes / grid.count, gridBytes / (1024.0 * 1024.0), gridBytes / grid.count, legacyBytes / gridBytes);
+
+    SpringGridFree(&grid);
+    FreeLegacyGrid(&legacy);
+}
+
+// Stretch and kinetic energy of the grid, with the spring constants the position solver use
+static double SpringGridEnergy(SpringGrid grid)
+{
+    const SpringGridParams params = grid.params;
+    const double force = params.force / params.pointDamping;
+    double energy = 0.0;
+
+    for (int i = 0; i < grid.rows; i++)
+    {
+        for (int j = 0; j < grid.cols; j++)
+        {
+            int index = i * grid.cols + j;
+            Vector2 velocity = SpringGridVelocity(grid, index);
+            energy += 0.5 * ((double)velocity.x * velocity.x + (double)velocity.y * velocity.y);
+
+            for (int k = 0; k < 2; k++)
+            {
+                int next = k == 0 ? index + 1 : index + grid.cols;
+                if ((k == 0 && j + 1 == grid.cols) || (k == 1 && i + 1 == grid.rows))
+                {
+                    continue;
+                }
+
+                double restLength = (k == 0 ? grid.spacing.x : grid.spacing.y) * params.restLength;
+                double length = hypot(grid.positionX[next] - grid.positionX[index], grid.positionY[next] - grid.positionY[index]);
+                if (length > restLength)
+                {
+                    energy += 0.5 * params.stiffness * force * (length - restLength) * (length - restLength);
+                }
+            }
+
+            bool border = i == 0 || j == 0 || i == grid.rows - 1 || j == grid.cols - 1;
+            bool anchor = !border && i % params.anchorStep == 0 && j % params.anchorStep == 0;
+            if (border || anchor)
+            {
+                double dx = grid.positionX[index] - (grid.origin.x + j * grid.spacing.x);
+                double dy = grid.positionY[index] - (grid.origin.y + i * grid.spacing.y);
+                energy += 0.5 * (border ? params.borderStiffness : params.anchorStiffness) * force * (dx * dx + dy * dy);
+            }
+        }
+    }
+
+    return energy;
+}
+
+// Push the grid for a quarter second then let it ring, a stable solver never end above the energy it had when the push stopped
+static int SweepSolverStability(int solver, const char* label)
+{
+    static const float rates[] = { 120.0f, 60.0f, 30.0f, 20.0f, 15.0f, 10.0f };
+    const float simulatedTime = 4.0f;
+    const int cols = 82, rows = 47;
+
+    int unstable = 0;
+    printf("  %-9s", label);
+    for (int r = 0; r < (int)(sizeof(rates) / sizeof(rates[0])); r++)
+    {
+        float timeStep = 1.0f / rates[r];
+        SpringGridParams params = benchmarkLiquidParams;
+        params.solver = solver;
+
+        SpringGrid grid = SpringGridNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { SPACING, SPACING }, params);
+        Vector2 center = { cols * SPACING * 0.4f, rows * SPACING * 0.6f };
+
+        int pushTicks = (int)ceilf(0.25f / timeStep);
+        int ticks = (int)ceilf(simulatedTime / timeStep);
+        double pushEnergy = 0.0;
+        double energy = 0.0;
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            if (tick < pushTicks)
+            {
+                ApplyImpulses(NULL, &grid, center, timeStep);
+            }
+
+            SpringGridUpdate(grid, timeStep);
+            energy = SpringGridEnergy(grid);
+            if (tick == pushTicks - 1)
+            {
+                pushEnergy = energy;
+            }
+        }
+
+        // Energy drift: what is left of the energy after the push, above 1 the solver add energy
+        double drift = energy / pushEnergy;
+        bool stable = isfinite(drift) && drift <= 1.0;
+        unstable += !stable;
+        printf("  %3.0f Hz %s", rates[r], stable ? "" : "!");
+        printf(isfinite(drift) && drift < 1e6 ? "%.1e" : "diverge", drift);
+
+        SpringGridFree(&grid);
+    }
+    printf("\n");
+
+    return unstable;
+}
+
+// CPU of one simulated second, the force solver at 60 Hz against the position solver at lower rates
+static void MeasureSolverCost(int width, int height)
+{
+    static const struct { int solver; float rate; const char* label; } modes[] = {
+        { SPRING_GRID_SOLVER_FORCE,     60.0f, "force 60 Hz" },
+        { SPRING_GRID_SOLVER_POSITION,  60.0f, "position 60 Hz" },
+        { SPRING_GRID_SOLVER_POSITION,  30.0f, "position 30 Hz" },
+    };
+
+    int cols = (int)(width / SPACING) + 2;
+    int rows = (int)(height / SPACING) + 2;
+
+    printf("  %dx%d", width, height);
+    for (int m = 0; m < (int)(sizeof(modes) / sizeof(modes[0])); m++)
+    {
+        SpringGridParams params = benchmarkLiquidParams;
+        params.solver = modes[m].solver;
+        SpringGrid grid = SpringGridNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { SPACING, SPACING }, params);
+        ApplyImpulses(NULL, &grid, (Vector2) { width * 0.5f, height * 0.5f }, 1.0f / modes[m].rate);
+
+        int ticks = 0;
+        double start = BenchmarkTime();
+        double elapsed = 0.0;
+        while (elapsed < TICK_BUDGET)
+        {
+            SpringGridUpdate(grid, 1.0f / modes[m].rate);
+            ticks++;
+            elapsed = BenchmarkTime() - start;
+        }
+
+        BenchmarkSink(grid.positionX[grid.count / 2]);
+        printf("   %s %6.3f ms/s", modes[m].label, elapsed / ticks * modes[m].rate * 1000.0);
+        SpringGridFree(&grid);
+    }
+    printf("\n");
+}
+
+double BenchmarkSpringGridTicks(SpringGrid grid, Vector2 center, bool push, int ticks)
+{
+    double start = BenchmarkTime();
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        if (push)
+        {
+            ApplyImpulses(NULL, &grid, center, TIME_STEP);
+        }
+        SpringGridUpdate(grid, TIME_STEP);
+    }
+    double elapsed = BenchmarkTime() - start;
+
+    BenchmarkSink(grid.positionX[grid.count / 2]);
+    return elapsed / ticks;
+}
+
+// Sleeping tiles against a grid that never sleep: idle cost, cost of a steady push, and how far the sleeping grid drift
+static int MeasureSleepingTiles(const char* label, int width, int height, float sleepThreshold)
+{
+    int cols = (int)(width / SPACING) + 2;
+    int rows = (int)(height / SPACING) + 2;
+    Vector2 center = { width * 0.4f, height * 0.6f };
+
+    SpringGridParams params = benchmarkLiquidParams;
+    SpringGrid awake = SpringGridNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { SPACING, SPACING }, params);
+    params.sleepThreshold = sleepThreshold;
+    SpringGrid sleeping = SpringGridNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { SPACING, SPACING }, params);
+
+    // Same push then 20 seconds to settle, the dent of the push is slow to recover
+    // Tiles freeze below the threshold while the awake grid keep creeping, a pixel or two apart is expected
+    float maxError = 0.0f;
+    for (int tick = 0; tick < 1200 + IMPULSE_TICKS; tick++)
+    {
+        if (tick < IMPULSE_TICKS)
+        {
+            ApplyImpulses(NULL, &awake, center, TIME_STEP);
+            ApplyImpulses(NULL, &sleeping, center, TIME_STEP);
+        }
+
+        SpringGridUpdate(awake, TIME_STEP);
+        SpringGridUpdate(sleeping, TIME_STEP);
+
+        for (int i = 0; i < awake.count; i++)
+        {
+            maxError = fmaxf(maxError, fmaxf(fabsf(awake.positionX[i] - sleeping.positionX[i]), fabsf(awake.positionY[i] - sleeping.positionY[i])));
+        }
+    }
+
+    int ticks = 60;
+    double awakeIdle = BenchmarkSpringGridTicks(awake, center, false, ticks);
+    double sleepingIdle = BenchmarkSpringGridTicks(sleeping, center, false, ticks);
+
+    int tileCount = sleeping.tileCols * sleeping.tileRows;
+    int settledTiles = SpringGridAwakeTileCount(sleeping);
+    double awakePush = BenchmarkSpringGridTicks(awake, center, true, ticks);
+    double sleepingPush = BenchmarkSpringGridTicks(sleeping, center, true, ticks);
+    int pushTiles = SpringGridAwakeTileCount(sleeping);
+
+    printf("  %-12s idle: %d/%d tiles awake %8.3f ms/tick (awake grid %8.3f)   push: %d/%d tiles awake %8.3f ms/tick (awake grid %8.3f)   max drift %.2f px\n",
+        label, settledTiles, tileCount, sleepingIdle * 1000.0, awakeIdle * 1000.0, pushTiles, tileCount, sleepingPush * 1000.0, awakePush * 1000.0, maxError);
+
+    int failures = 0;
+    if (settledTiles > 0 || maxError > 2.0f)
+    {
+        printf("  FAILED: the tiles did not sleep or the sleeping grid drift from the awake grid\n");
+        failures++;
+    }
+
+    SpringGridFree(&sleeping);
+    SpringGridFree(&awake);
+    return failures;
+}
+
+#define SNAPSHOT_PATH "SpringGrid.snapshot"
+
+static uint64_t HashGridBlock(SpringGrid grid)
+{
+    return BenchmarkHash(grid.positionX, SpringGridSnapshotSize(grid) - sizeof(SpringGridSnapshotHeader));
+}
+
+// A restored grid must be the same bytes and keep moving the same, stale or truncated snapshots must not load
+static int CheckSnapshot(int cols, int rows)
+{
+    SpringGridParams params = benchmarkLiquidParams;
+    params.sleepThreshold = 1.0f;
+    SpringGrid grid = SpringGridNew(cols, rows, (Vector2) { 5.0f, -3.0f }, (Vector2) { SPACING, SPACING }, params);
+
+    // Saved in the middle of a push, some tiles asleep and the forces of the next tick pending
+    Vector2 center = { cols * SPACING * 0.3f, rows * SPACING * 0.6f };
+    for (int tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        if (tick % 100 < IMPULSE_TICKS)
+        {
+            ApplyImpulses(NULL, &grid, center, TIME_STEP);
+        }
+        SpringGridUpdate(grid, TIME_STEP);
+    }
+    ApplyImpulses(NULL, &grid, center, TIME_STEP);
+
+    bool saved = SpringGridSave(grid, SNAPSHOT_PATH);
+    SpringGrid loaded = SpringGridLoad(SNAPSHOT_PATH);
+    remove(SNAPSHOT_PATH);
+
+    bool same = SpringGridIsValid(loaded) && loaded.cols == grid.cols && loaded.rows == grid.rows
+        && memcmp(&loaded.params, &grid.params, sizeof(SpringGridParams)) == 0
+        && loaded.origin.x == grid.origin.x && loaded.spacing.y == grid.spacing.y && HashGridBlock(loaded) == HashGridBlock(grid);
+
+    // Both continue bit for bit
+    for (int tick = 0; tick < CHECK_TICKS && same; tick++)
+    {
+        if (tick < IMPULSE_TICKS)
+        {
+            ApplyImpulses(NULL, &grid, center, TIME_STEP);
+            ApplyImpulses(NULL, &loaded, center, TIME_STEP);
+        }
+        SpringGridUpdate(grid, TIME_STEP);
+        SpringGridUpdate(loaded, TIME_STEP);
+    }
+    same = same && HashGridBlock(loaded) == HashGridBlock(grid);
+
+    // Same bytes whatever the buffer held before, no stack garbage in the padding
+    size_t size = SpringGridSnapshotSize(grid);
+    uint8_t* buffer = (uint8_t*)MemoryAlloc(size);
+    MemoryInit(buffer, 0xCD, size);
+    SpringGridWriteSnapshot(grid, buffer);
+    uint64_t firstHash = BenchmarkHash(buffer, size);
+    MemoryInit(buffer, 0x00, size);
+    SpringGridWriteSnapshot(grid, buffer);
+    bool deterministic = BenchmarkHash(buffer, size) == firstHash;
+    SpringGrid truncated = SpringGridFromSnapshot(buffer, size - 1);
+    ((SpringGridSnapshotHeader*)buffer)->version += 1;
+    SpringGrid stale = SpringGridFromSnapshot(buffer, size);
+    SpringGrid missing = SpringGridLoad(SNAPSHOT_PATH);
+    bool rejected = !SpringGridIsValid(truncated) && !SpringGridIsValid(stale) && !SpringGridIsValid(missing);
+
+    printf("  Snapshot %dx%d points: %.2f MB, saved %s, restored %s, stale and truncated %s, bytes %s\n",
+        cols, rows, size / (1024.0 * 1024.0), saved ? "yes" : "no", same ? "identical" : "different", rejected ? "rejected" : "loaded",
+        deterministic ? "deterministic" : "differ between writes");
+
+    MemoryFree(buffer);
+    SpringGridFree(&loaded);
+    SpringGridFree(&grid);
+    if (!saved || !same || !rejected || !deterministic)
+    {
+        printf("  FAILED: SpringGrid snapshot does not round trip or is not deterministic\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Launch cost: build the grid and settle a push from rest, against loading the settled grid
+static void MeasureSnapshot(const char* label, int width, int height, float spacing)
+{
+    int cols = (int)(width / spacing) + 2;
+    int rows = (int)(height / spacing) + 2;
+    Vector2 center = { width * 0.5f, height * 0.5f };
+
+    SpringGridParams params = benchmarkLiquidParams;
+    params.sleepThreshold = 1.0f;
+
+    double start = BenchmarkTime();
+    SpringGrid grid = SpringGridNew(cols, rows, (Vector2) { 0, 0 }, (Vector2) { spacing, spacing }, params);
+    for (int tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        if (tick < IMPULSE_TICKS)
+        {
+            ApplyImpulses(NULL, &grid, center, TIME_STEP);
+        }
+        SpringGridUpdate(grid, TIME_STEP);
+    }
+    double coldTime = BenchmarkTime() - start;
+
+    if (!SpringGridSave(grid, SNAPSHOT_PATH))
+    {
+        printf("  %-12s skipped: cannot write %s\n", label, SNAPSHOT_PATH);
+        SpringGridFree(&grid);
+        return;
+    }
+
+    // The file was just written, it load from the OS file cache
+    int loads = 0;
+    start = BenchmarkTime();
+    double elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        SpringGrid loaded = SpringGridLoad(SNAPSHOT_PATH);
+        BenchmarkSink(loaded.positionX[loaded.count / 2]);
+        SpringGridFree(&loaded);
+        loads++;
+        elapsed = BenchmarkTime() - start;
+    }
+    double loadTime = elapsed / loads;
+    remove(SNAPSHOT_PATH);
+
+    size_t size = SpringGridSnapshotSize(grid);
+    void* buffer = MemoryAlloc(size);
+    SpringGridWriteSnapshot(grid, buffer);
+
+    loads = 0;
+    start = BenchmarkTime();
+    elapsed = 0.0;
+    while (elapsed < TICK_BUDGET)
+    {
+        SpringGrid loaded = SpringGridFromSnapshot(buffer, size);
+        BenchmarkSink(loaded.positionX[loaded.count / 2]);
+        SpringGridFree(&loaded);
+        loads++;
+        elapsed = BenchmarkTime() - start;
+    }
+    double memoryTime = elapsed / loads;
+
+    printf("  %-12s %7d points %6.2f MB  new and settle %d ticks %8.3f ms   load file %7.3f ms x%.0f   from memory %7.3f ms\n",
+        label, grid.count, size / (1024.0 * 1024.0), CHECK_TICKS, coldTime * 1000.0, loadTime * 1000.0, coldTime / loadTime, memoryTime * 1000.0);
+
+    MemoryFree(buffer);
+    SpringGridFree(&grid);
+}
+
+int BenchmarkSpringGrid(void)
+{
+    printf("SpringGrid\n");
+
+    // Odd sizes exercise the scalar tails of the 4 lanes kernels
+    int failures = CheckSpringGrid(37, 23);
+    failures += CheckSpringGrid(82, 47);
+    failures += CheckRangeInRadius();
+
+    MeasureSpringGrid("1280x720", 1280, 720);
+    MeasureSpringGrid("3840x2160", 3840, 2160);
+
+    // Energy drift against the time step, the position solver must hold at every rate
+    printf("  Energy left 4s after a push:\n");
+    SweepSolverStability(SPRING_GRID_SOLVER_FORCE, "force");
+    int unstable = SweepSolverStability(SPRING_GRID_SOLVER_POSITION, "position");
+    if (unstable > 0)
+    {
+        printf("  FAILED: the position solver gain energy at %d rates\n", unstable);
+        failures++;
+    }
+
+    MeasureSolverCost(1280, 720);
+    MeasureSolverCost(3840, 2160);
+
+    failures += MeasureSleepingTiles("1280x720", 1280, 720, 1.0f);
+    failures += MeasureSleepingTiles("3840x2160", 3840, 2160, 1.0f);
+
+    failures += CheckSnapshot(37, 23);
+    failures += CheckSnapshot(243, 137);
+    MeasureSnapshot("1280x720", 1280, 720, SPACING);
+    MeasureSnapshot("3840x2160", 3840, 2160, 4.0f);
+
+    return failures;
+}
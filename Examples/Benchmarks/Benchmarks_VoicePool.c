@@ -0,0 +1,152 @@
+#include "Benchmarks.h"
+
+#include <VoicePool.h>
+
+#define VOICE_COUNT     12
+#define SOUND_LENGTH    20      // Ticks a stub sound play for
+#define TICK_COUNT      10000
+
+enum
+{
+    CATEGORY_SHOOT,
+    CATEGORY_EXPLOSION,
+};
+
+// Headless mixer: voices play for SOUND_LENGTH ticks, count the starts of the current tick
+typedef struct StubMixer
+{
+    int     remaining[VOICE_COUNT];
+    int     samples[VOICE_COUNT];
+    int     startedThisTick;
+    int     stopped;
+} StubMixer;
+
+static bool StubStart(void* userData, int voice, int sample, float volume)
+{
+    StubMixer* mixer = (StubMixer*)userData;
+    (void)volume;
+
+    mixer->remaining[voice] = SOUND_LENGTH;
+    mixer->samples[voice] = sample;
+    mixer->startedThisTick++;
+    return true;
+}
+
+static void StubStop(void* userData, int voice)
+{
+    StubMixer* mixer = (StubMixer*)userData;
+    mixer->remaining[voice] = 0;
+    mixer->stopped++;
+}
+
+static bool StubIsPlaying(void* userData, int voice)
+{
+    StubMixer* mixer = (StubMixer*)userData;
+    return mixer->remaining[voice] > 0;
+}
+
+static void StubTick(StubMixer* mixer)
+{
+    for (int i = 0; i < VOICE_COUNT; i++)
+    {
+        if (mixer->remaining[i] > 0) mixer->remaining[i]--;
+    }
+    mixer->startedThisTick = 0;
+}
+
+static VoicePool NewStubPool(StubMixer* mixer)
+{
+    *mixer = (StubMixer) { 0 };
+
+    VoicePool pool = VoicePoolNew(VOICE_COUNT, (VoiceBackend) { mixer, StubStart, StubStop, StubIsPlaying });
+    VoicePoolSetCategory(&pool, CATEGORY_SHOOT, 3);
+    VoicePoolSetCategory(&pool, CATEGORY_EXPLOSION, 4);
+    return pool;
+}
+
+static int CheckVoicePool(void)
+{
+    int failures = 0;
+    StubMixer mixer;
+    VoicePool pool = NewStubPool(&mixer);
+
+    // A collision loop asking for 40 explosions with 8 samples: 8 distinct requests, 4 voices
+    for (int i = 0; i < 40; i++)
+    {
+        VoicePoolPlay(&pool, CATEGORY_EXPLOSION, i % 8, 0.4f, 3);
+    }
+
+    VoicePoolStats stats = VoicePoolUpdate(&pool);
+    printf("  burst of 40 explosions:  %d started, %d coalesced, %d dropped\n", mixer.startedThisTick, stats.coalesced, stats.dropped);
+
+    if (mixer.startedThisTick != 4 || stats.started != 4) failures++;
+    if (stats.coalesced != 32 || stats.dropped != 4) failures++;
+    if (VoicePoolActiveCount(&pool, CATEGORY_EXPLOSION) != 4) failures++;
+    StubTick(&mixer);
+
+    // The category is full, a new tick steal its oldest voice
+    VoicePoolPlay(&pool, CATEGORY_EXPLOSION, 0, 0.4f, 3);
+    stats = VoicePoolUpdate(&pool);
+    if (stats.started != 1 || stats.stolen != 1 || VoicePoolActiveCount(&pool, CATEGORY_EXPLOSION) != 4) failures++;
+    StubTick(&mixer);
+
+    // Lower priority shoots take the free voices but never steal explosions
+    VoicePoolPlay(&pool, CATEGORY_SHOOT, 0, 0.2f, 1);
+    VoicePoolPlay(&pool, CATEGORY_SHOOT, 1, 0.2f, 1);
+    VoicePoolPlay(&pool, CATEGORY_SHOOT, 2, 0.2f, 1);
+    VoicePoolPlay(&pool, CATEGORY_SHOOT, 3, 0.2f, 1);
+    stats = VoicePoolUpdate(&pool);
+    if (stats.started != 3 || stats.stolen != 0 || VoicePoolActiveCount(&pool, CATEGORY_EXPLOSION) != 4) failures++;
+    StubTick(&mixer);
+
+    // Finished voices are released on the next update
+    for (int i = 0; i < SOUND_LENGTH; i++)
+    {
+        StubTick(&mixer);
+    }
+    VoicePoolUpdate(&pool);
+    if (VoicePoolActiveCount(&pool, CATEGORY_EXPLOSION) != 0 || VoicePoolActiveCount(&pool, CATEGORY_SHOOT) != 0) failures++;
+
+    VoicePoolFree(&pool);
+
+    if (failures > 0)
+    {
+        printf("  FAILED: %d voice pool checks\n", failures);
+    }
+
+    return failures;
+}
+
+int BenchmarkVoicePool(void)
+{
+    printf("VoicePool\n");
+
+    int failures = CheckVoicePool();
+
+    StubMixer mixer;
+    VoicePool pool = NewStubPool(&mixer);
+
+    int started = 0;
+    double start = BenchmarkTime();
+    for (int tick = 0; tick < TICK_COUNT; tick++)
+    {
+        // Holding fire and a heavy fight: a shoot every 6 ticks, 30 explosions every tick
+        if (tick % 6 == 0)
+        {
+            VoicePoolPlay(&pool, CATEGORY_SHOOT, tick % 4, 0.2f, 1);
+        }
+
+        for (int i = 0; i < 30; i++)
+        {
+            VoicePoolPlay(&pool, CATEGORY_EXPLOSION, (tick + i) % 8, 0.4f, 3);
+        }
+
+        started += VoicePoolUpdate(&pool).started;
+        StubTick(&mixer);
+    }
+    BenchmarkReport("VoicePoolUpdate (31 requests)", BenchmarkTime() - start, TICK_COUNT);
+    printf("  %.2f voices started per tick\n", started / (double)TICK_COUNT);
+
+    VoicePoolFree(&pool);
+    return failures;
+}
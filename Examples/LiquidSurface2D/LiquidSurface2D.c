@@ -1,55 +1,12 @@
+#include "LiquidSurface2D_Surface.h"
+
 #include <raylib.h>
-#include <raymath.h>
-#include <Array.h>
+#include <Renderer.h>
+#include <JobSystem.h>
 
 #include <assert.h>
 
-const int DEFAULT_POINT_DAMPING = 3.0f;
-
-typedef struct LiquidPoint2D
-{
-    Vector2 position;
-    Vector2 velocity;
-    Vector2 acceleration;
-    
-    float invMass;
-    float damping;
-} LiquidPoint2D;
-
-typedef struct LiquidSpring2D
-{
-    LiquidPoint2D* p0;
-    LiquidPoint2D* p1;
- 
-    float targetLength;
-    float stiffness;
-    float damping;
-    float force;
-} LiquidSpring2D;
-
-typedef struct LiquidSurface2D
-{
-    int cols;
-    int rows;
-
-    float cellWidth;
-    float cellHeight;
-
-    Array(LiquidPoint2D) points;
-    Array(LiquidPoint2D) fixedPoints;
-
-    Array(LiquidSpring2D) springs;
-} LiquidSurface2D;
-
-bool            IsLiquidSurface2DValid(LiquidSurface2D surface);
-
-LiquidSurface2D NewLiquidSurface2D(Rectangle bounds, Vector2 spacing);
-void            FreeLiquidSurface2D(LiquidSurface2D surface);
-
-void            UpdateLiquidSurface2D(LiquidSurface2D surface, float dt);
-void            RenderLiquidSurface2D(LiquidSurface2D surface, Color lineColor);
-
-void            ApplyForceOnLiquidSurface2D(LiquidSurface2D surface, float force, Vector2 position, float radius, float dt);
+const char* SNAPSHOT_PATH = "LiquidSurface2D.snapshot";
 
 int main(void)
 {
@@ -57,16 +14,29 @@ int main(void)
     const int SCREEN_HEIGHT = 720;
     SetConfigFlags(FLAG_VSYNC_HINT);
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Liquid Surface 2D");
+
+    // Simulation run at fixed rate, rendering interpolate between the last two ticks
+    // Tab cycle the position solver, stable at half the rate, then the heightfield
+    const float SIMULATION_RATE = 60.0f;
+    const float POSITION_SIMULATION_RATE = 30.0f;
+    const char* SOLVER_NAMES[LIQUID_SOLVER_COUNT] = { "Force solver (Tab)", "Position solver (Tab)", "Heightfield (Tab)" };
     //SetTargetFPS(60);
 
-    LiquidSurface2D surface = NewLiquidSurface2D((Rectangle) { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, (Vector2) { 16, 16 });
+    // Heightfield rows and mesh positions are updated on all threads
+    JobSystemInit(0);
+
+    LiquidSurface2D surface = NewLiquidSurface2D((Rectangle) { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT }, (Vector2) { 16, 16 }, GRAY);
     if (!IsLiquidSurface2DValid(surface))
     {
         assert(0 && "Out of memory");
     }
 
+    Image lines = GenLiquidSurface2DLinesImage(surface);
+    surface.lines = LoadTextureFromImage(lines);
+    UnloadImage(lines);
+
     float timer     = 0.0f;
-    float timeStep  = 1.0f / 60.0f;
+    float timeStep  = 1.0f / SIMULATION_RATE;
 
     int   fpsCount    = 0;
     int   fpsValue    = 0;
@@ -75,18 +45,56 @@ int main(void)
 
     while (!WindowShouldClose())
     {
+        if (IsKeyPressed(KEY_TAB))
+        {
+            SetLiquidSurface2DSolver(&surface, (LiquidSolver)((surface.solver + 1) % LIQUID_SOLVER_COUNT));
+            timeStep = 1.0f / (surface.solver == LIQUID_SOLVER_POSITION ? POSITION_SIMULATION_RATE : SIMULATION_RATE);
+            timer = 0.0f;
+        }
+
+        // F5 save the spring grid, F9 restore it as it was
+        if (IsKeyPressed(KEY_F5))
+        {
+            SpringGridSave(surface.grid, SNAPSHOT_PATH);
+        }
+
+        if (IsKeyPressed(KEY_F9))
+        {
+            SpringGrid grid = SpringGridLoad(SNAPSHOT_PATH);
+            if (SpringGridIsValid(grid) && grid.cols == surface.grid.cols && grid.rows == surface.grid.rows)
+            {
+                SpringGridFree(&surface.grid);
+                surface.grid = grid;
+                SetLiquidSurface2DSolver(&surface, surface.solver);
+            }
+            else
+            {
+                SpringGridFree(&grid);
+            }
+        }
+
         timer += GetFrameTime();
         while (timer >= timeStep)
         {
             timer -= timeStep;
             fpsCount += 1;
 
-            if (IsMouseButtonDown(MOUSE_LEFT_BUTTON))
+            // Every touch point push the surface, the mouse when there is no touch
+            LiquidForce forces[MAX_TOUCH_POINTS];
+            int forceCount = 0;
+            for (int i = 0, n = GetTouchPointsCount(); i < n && i < MAX_TOUCH_POINTS; i++)
+            {
+                forces[forceCount++] = (LiquidForce) { GetTouchPosition(i), 12000.0f, 80.0f };
+            }
+
+            if (forceCount == 0 && IsMouseButtonDown(MOUSE_LEFT_BUTTON))
             {
-                ApplyForceOnLiquidSurface2D(surface, 12000.0f, GetMousePosition(), 80.0f, timeStep);
+                forces[forceCount++] = (LiquidForce) { GetMousePosition(), 12000.0f, 80.0f };
             }
 
-            UpdateLiquidSurface2D(surface, timeStep);
+            ApplyForcesOnLiquidSurface2D(surface, forces, forceCount, timeStep);
+
+            UpdateLiquidSurface2D(&surface, timeStep);
         }
 
         fpsTimer += GetFrameTime();
@@ -100,182 +108,28 @@ int main(void)
 
         BeginDrawing();
         {
-            ClearBackground(RAYWHITE);
-
-            RenderLiquidSurface2D(surface, GRAY);
-
-            DrawText(TextFormat("CPU FPS: %d", fpsValue), 0, 0, 24, DARKGREEN);
-            DrawText(TextFormat("GPU FPS: %d", GetFPS()), 0, 30, 24, DARKGREEN);
-        }
-        EndDrawing();
-    }
-
-    FreeLiquidSurface2D(surface);
-    CloseWindow();
-    return 0;
-}
-
-bool IsLiquidSurface2DValid(LiquidSurface2D surface)
-{
-    return !(surface.cols <= 0 || surface.rows <= 0 || !surface.points || !surface.fixedPoints || !surface.springs);
-}
-
-LiquidPoint2D NewLiquidPoint2D(Vector2 position, float invMass)
-{
-    return (LiquidPoint2D) {
-        position, (Vector2) { 0, 0 }, (Vector2) { 0, 0 }, invMass, DEFAULT_POINT_DAMPING
-    };
-}
+            RendererClear(RAYWHITE);
 
-LiquidSpring2D NewLiquidSpring2D(LiquidPoint2D* p0, LiquidPoint2D* p1, float stiffness, float damping)
-{
-    return (LiquidSpring2D) {
-        p0, p1,
-
-        Vector2Distance(p0->position, p1->position) * 0.95f,
-        stiffness, damping, 250.0f
-    };
-}
+            RendererBeginSection("RenderLiquidSurface2D");
+            RenderLiquidSurface2D(surface, timer / timeStep);
+            RendererEndSection();
 
-LiquidSurface2D NewLiquidSurface2D(Rectangle bounds, Vector2 spacing)
-{
-    int cols = (int)(bounds.width / spacing.x) + 2;
-    int rows = (int)(bounds.height / spacing.y) + 2;
-
-    int pointCount = cols * rows;
-    Array(LiquidPoint2D) points = ArrayNew(LiquidPoint2D, pointCount);
-    Array(LiquidPoint2D) fixedPoints = ArrayNew(LiquidPoint2D, pointCount);
-    Array(LiquidSpring2D) springs = ArrayNew(LiquidSpring2D, 4 * pointCount);
-
-    if (!points || !fixedPoints || !springs)
-    {
-        ArrayFree(springs);
-        ArrayFree(fixedPoints);
-        ArrayFree(points);
-
-        return (LiquidSurface2D) { 0 };
-    }
-
-    ArraySetCount(points, pointCount);
-    ArraySetCount(fixedPoints, pointCount);
-
-    for (int i = 0; i < rows; i++)
-    {
-        for (int j = 0; j < cols; j++)
-        {
-            int index = i * cols + j;
-
-            Vector2 position = { bounds.x + j * spacing.x, bounds.y + i * spacing.y };
-            points[index] = NewLiquidPoint2D(position, 1.0f);
-            fixedPoints[index] = NewLiquidPoint2D(position, 1.0f);
-
-            if (i == 0 || j == 0 || i == rows - 1 || j == cols - 1)
-            {
-                ArrayPush(springs, NewLiquidSpring2D(&fixedPoints[index], &points[index], 0.2f, 5.0f));
-            }
-            else if (i % 3 == 0 && j % 3 == 0)
-            {
-                ArrayPush(springs, NewLiquidSpring2D(&fixedPoints[index], &points[index], 0.004f, 20.0f));
-            }
-
-            const float stiffness = 0.28f;
-            const float damping = 2.0f;
-            if (j > 0)
-            {
-                ArrayPush(springs, NewLiquidSpring2D(&points[i * cols + (j - 1)], &points[index], stiffness, damping));
-            }
-
-            if (i > 0)
+            RendererDrawText(TextFormat("CPU FPS: %d", fpsValue), 0, 0, 24, DARKGREEN);
+            RendererDrawText(TextFormat("GPU FPS: %d", GetFPS()), 0, 30, 24, DARKGREEN);
+            RendererDrawText(SOLVER_NAMES[surface.solver], 0, 60, 24, DARKGREEN);
+            if (surface.solver != LIQUID_SOLVER_HEIGHT_FIELD)
             {
-                ArrayPush(springs, NewLiquidSpring2D(&points[(i - 1) * cols + j], &points[index], stiffness, damping));
+                RendererDrawText(TextFormat("Awake tiles: %d/%d", SpringGridAwakeTileCount(surface.grid), surface.grid.tileCols * surface.grid.tileRows), 0, 90, 24, DARKGREEN);
             }
         }
+        EndDrawing();
     }
 
-    return (LiquidSurface2D) {
-        cols, rows, spacing.x, spacing.y,
-
-        points, fixedPoints, springs
-    };
-}
-
-void FreeLiquidSurface2D(LiquidSurface2D surface)
-{
-    ArrayFree(surface.points);
-    ArrayFree(surface.fixedPoints);
-    ArrayFree(surface.springs);
-}
-
-void UpdateLiquidSurface2D(LiquidSurface2D surface, float timeStep)
-{
-    for (int i = 0, n = ArrayCount(surface.springs); i < n; i++)
-    {
-        LiquidSpring2D spring = surface.springs[i];
-
-        Vector2 diff = Vector2Subtract(spring.p0->position, spring.p1->position);
-        float len = Vector2Length(diff);
-        if (len > spring.targetLength)
-        {
-            float changeRate = (len - spring.targetLength) / len;
-            Vector2 diffVelocity = Vector2Subtract(spring.p1->velocity, spring.p0->velocity);
-            Vector2 force = Vector2Subtract(Vector2Scale(diff, spring.stiffness * changeRate), Vector2Scale(diffVelocity, fmaxf(0.0f, 1.0f - spring.damping * timeStep)));
-            
-            spring.p0->acceleration = Vector2Add(spring.p0->acceleration, Vector2Scale(Vector2Negate(force), spring.force * spring.p0->invMass * timeStep));
-            spring.p1->acceleration = Vector2Add(spring.p1->acceleration, Vector2Scale(force, spring.force * spring.p1->invMass * timeStep));
-        }
-    }
-
-    for (int i = 0, n = ArrayCount(surface.points); i < n; i++)
-    {
-        LiquidPoint2D point = surface.points[i];
-
-        point.velocity = Vector2Add(point.velocity, Vector2Scale(point.acceleration, timeStep));
-        point.position = Vector2Add(point.position, Vector2Scale(point.velocity, timeStep));
-
-        point.acceleration = Vector2Scale(point.acceleration, fmaxf(0.0f, 1.0f - point.damping * timeStep));
-        point.velocity = Vector2Scale(point.velocity, fmaxf(0.0f, 1.0f - point.damping * timeStep));
-
-        point.damping = DEFAULT_POINT_DAMPING;
-
-        surface.points[i] = point;
-    }
-}
-
-void RenderLiquidSurface2D(LiquidSurface2D surface, Color lineColor)
-{
-    int cols = surface.cols;
-    int rows = surface.rows;
-
-    for (int i = 1; i < rows; i++)
-    {
-        for (int j = 1; j < cols; j++)
-        {
-            Vector2 p0 = surface.points[i * cols + j].position;
-            Vector2 p1 = surface.points[(i - 1) * cols + j].position;
-            Vector2 p2 = surface.points[i * cols + (j - 1)].position;
-
-            DrawLineEx(p0, p1, 1.0f, lineColor);
-            DrawLineEx(p0, p2, 1.0f, lineColor);
-        }
-    }
-}
+    UnloadTexture(surface.lines);
+    FreeLiquidSurface2D(surface);
 
-void ApplyForceOnLiquidSurface2D(LiquidSurface2D surface, float force, Vector2 position, float radius, float timeStep)
-{
-    for (int i = 0, n = ArrayCount(surface.points); i < n; i++)
-    {
-        LiquidPoint2D point = surface.points[i];
-        Vector2 diff = Vector2Subtract(point.position, position);
-        float dist = Vector2Length(diff);
-        if (dist < radius)
-        {
-            float accuratedForce = force / (100.0f + dist);
-            Vector2 directionForce = Vector2Scale(diff, accuratedForce);
+    JobSystemShutdown();
 
-            point.acceleration = Vector2Add(point.acceleration, Vector2Scale(directionForce, point.invMass * timeStep));
-            point.damping = point.damping * (1.0f / 0.6f);
-            
-            surface.points[i] = point;
-        }
-    }
+    CloseWindow();
+    return 0;
 }
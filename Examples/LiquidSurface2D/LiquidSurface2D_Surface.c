@@ -0,0 +1,155 @@
+#include "LiquidSurface2D_Surface.h"
+
+#include <raymath.h>
+#include <Memory.h>
+
+const float DEFAULT_POINT_DAMPING = 3.0f;
+
+// The heightfield take the force of the springs as the acceleration of the water at the center of a push
+const float HEIGHT_FIELD_FORCE_SCALE = 0.05f;
+const float HEIGHT_FIELD_REFRACTION = 32.0f;
+
+// Past the size of L2 the heightfield update wait on memory, larger surfaces keep int16 heights of 1/1024 px, up to +-32 px
+const int   HEIGHT_FIELD_QUANTIZED_POINTS = 1 << 18;
+const float HEIGHT_FIELD_STEP = 1.0f / 1024.0f;
+
+bool IsLiquidSurface2DValid(LiquidSurface2D surface)
+{
+    return SpringGridIsValid(surface.grid) && HeightFieldIsValid(surface.field) && surface.positions && GridMeshIsValid(surface.mesh);
+}
+
+LiquidSurface2D NewLiquidSurface2D(Rectangle bounds, Vector2 spacing, Color lineColor)
+{
+    int cols = (int)(bounds.width / spacing.x) + 2;
+    int rows = (int)(bounds.height / spacing.y) + 2;
+
+    SpringGridParams params = {
+        .stiffness = 0.28f,
+        .damping = 2.0f,
+        .restLength = 0.95f,
+        .force = 250.0f,
+
+        .borderStiffness = 0.2f,
+        .borderDamping = 5.0f,
+        .anchorStiffness = 0.004f,
+        .anchorDamping = 20.0f,
+        .anchorStep = 3,
+
+        .pointDamping = DEFAULT_POINT_DAMPING,
+        .restThreshold = 0.0f,
+
+        .sleepThreshold = 1.0f,
+    };
+
+    // Waves cross 20 points per second and lose half their speed in 2 seconds
+    Vector2 origin = { bounds.x, bounds.y };
+    LiquidSurface2D surface = {
+        .solver = LIQUID_SOLVER_FORCE,
+        .grid = SpringGridNew(cols, rows, origin, spacing, params),
+        .field = cols * rows > HEIGHT_FIELD_QUANTIZED_POINTS
+            ? HeightFieldNewQuantized(cols, rows, origin, spacing, 20.0f, 0.35f, HEIGHT_FIELD_STEP)
+            : HeightFieldNew(cols, rows, origin, spacing, 20.0f, 0.35f),
+        .positions = (Vector2*)MemoryAlloc(sizeof(Vector2) * cols * rows),
+        .mesh = GridMeshNew(cols, rows, lineColor),
+    };
+
+    return surface;
+}
+
+void FreeLiquidSurface2D(LiquidSurface2D surface)
+{
+    SpringGridFree(&surface.grid);
+    HeightFieldFree(&surface.field);
+    MemoryFree(surface.positions);
+    GridMeshFree(&surface.mesh);
+}
+
+Image GenLiquidSurface2DLinesImage(LiquidSurface2D surface)
+{
+    return GridMeshGenLinesImage(surface.mesh, (int)surface.grid.spacing.x, (int)surface.grid.spacing.y, WHITE, BLANK);
+}
+
+// Both models keep their state, switching back resume where it was left
+void SetLiquidSurface2DSolver(LiquidSurface2D* surface, LiquidSolver solver)
+{
+    surface->solver = solver;
+    if (solver != LIQUID_SOLVER_HEIGHT_FIELD)
+    {
+        surface->grid.params.solver = solver == LIQUID_SOLVER_POSITION ? SPRING_GRID_SOLVER_POSITION : SPRING_GRID_SOLVER_FORCE;
+    }
+}
+
+void UpdateLiquidSurface2D(LiquidSurface2D* surface, float timeStep)
+{
+    if (surface->solver == LIQUID_SOLVER_HEIGHT_FIELD)
+    {
+        HeightFieldUpdate(&surface->field, timeStep);
+    }
+    else
+    {
+        SpringGridUpdate(surface->grid, timeStep);
+    }
+}
+
+// One indexed mesh for the whole surface, its positions are rewritten in place every frame
+void RenderLiquidSurface2D(LiquidSurface2D surface, float alpha)
+{
+    if (surface.solver == LIQUID_SOLVER_HEIGHT_FIELD)
+    {
+        HeightFieldGetPositions(surface.field, alpha, HEIGHT_FIELD_REFRACTION, surface.positions);
+        GridMeshSetPositions(surface.mesh, surface.positions);
+    }
+    else
+    {
+        SpringGrid grid = surface.grid;
+        GridMeshSetPositionsLerp(surface.mesh, grid.prevPositionX, grid.prevPositionY, grid.positionX, grid.positionY, alpha);
+    }
+    GridMeshDraw(surface.mesh, surface.lines);
+}
+
+void ApplyForceOnLiquidSurface2D(LiquidSurface2D surface, float force, Vector2 position, float radius, float timeStep)
+{
+    LiquidForce source = { position, force, radius };
+    ApplyForcesOnLiquidSurface2D(surface, &source, 1, timeStep);
+}
+
+// Visit the lattice cells around each force only, forces add up in their order
+void ApplyForcesOnLiquidSurface2D(LiquidSurface2D surface, const LiquidForce* forces, int count, float timeStep)
+{
+    // Ripples of the heightfield, each push dent the water
+    if (surface.solver == LIQUID_SOLVER_HEIGHT_FIELD)
+    {
+        for (int f = 0; f < count; f++)
+        {
+            HeightFieldApplyForce(surface.field, forces[f].force * HEIGHT_FIELD_FORCE_SCALE, forces[f].position, forces[f].radius, timeStep);
+        }
+        return;
+    }
+
+    SpringGrid grid = surface.grid;
+
+    for (int f = 0; f < count; f++)
+    {
+        float radius = forces[f].radius;
+        SpringGridRange range = SpringGridRangeInRadius(grid, forces[f].position, radius);
+
+        for (int i = range.row0; i < range.row1; i++)
+        {
+            for (int j = range.col0; j < range.col1; j++)
+            {
+                int index = i * grid.cols + j;
+
+                Vector2 diff = Vector2Subtract(SpringGridPosition(grid, index), forces[f].position);
+                float distSq = diff.x * diff.x + diff.y * diff.y;
+                if (distSq < radius * radius)
+                {
+                    float accuratedForce = forces[f].force / (100.0f + sqrtf(distSq));
+                    Vector2 directionForce = Vector2Scale(diff, accuratedForce);
+
+                    SpringGridApplyForce(grid, index, directionForce, timeStep);
+                    SpringGridIncreaseDamping(grid, index, 1.0f / 0.6f);
+                }
+            }
+        }
+    }
+}
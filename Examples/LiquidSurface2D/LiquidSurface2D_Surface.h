@@ -0,0 +1,47 @@
+#pragma once
+
+#include <raylib.h>
+#include <GridMesh.h>
+#include <SpringGrid.h>
+#include <HeightField.h>
+
+typedef enum LiquidSolver
+{
+    LIQUID_SOLVER_FORCE,        // Spring grid, explicit spring forces
+    LIQUID_SOLVER_POSITION,     // Spring grid, position solver
+    LIQUID_SOLVER_HEIGHT_FIELD, // Scalar wave equation, the lines are refracted by the slope of the water
+
+    LIQUID_SOLVER_COUNT,
+} LiquidSolver;
+
+typedef struct LiquidSurface2D
+{
+    LiquidSolver solver;
+
+    SpringGrid  grid;
+    HeightField field;
+    Vector2*    positions;  // Refracted points of the heightfield
+    GridMesh    mesh;       // Drawn textured with the lines of the grid
+    Texture     lines;      // From GenLiquidSurface2DLinesImage
+} LiquidSurface2D;
+
+typedef struct LiquidForce
+{
+    Vector2 position;
+    float   force;
+    float   radius;
+} LiquidForce;
+
+bool            IsLiquidSurface2DValid(LiquidSurface2D surface);
+
+// The lines texture is left to the caller, raylib in the example, the software renderer in the Benchmarks
+LiquidSurface2D NewLiquidSurface2D(Rectangle bounds, Vector2 spacing, Color lineColor);
+void            FreeLiquidSurface2D(LiquidSurface2D surface);
+Image           GenLiquidSurface2DLinesImage(LiquidSurface2D surface);
+
+void            SetLiquidSurface2DSolver(LiquidSurface2D* surface, LiquidSolver solver);
+void            UpdateLiquidSurface2D(LiquidSurface2D* surface, float dt);
+void            RenderLiquidSurface2D(LiquidSurface2D surface, float alpha);
+
+void            ApplyForceOnLiquidSurface2D(LiquidSurface2D surface, float force, Vector2 position, float radius, float dt);
+void            ApplyForcesOnLiquidSurface2D(LiquidSurface2D surface, const LiquidForce* forces, int count, float dt);
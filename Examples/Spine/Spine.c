@@ -13,6 +13,8 @@
 #include "raylib-spine.h"
 #include <stdio.h>
 #include <rlgl.h>
+#include <Renderer.h>
+#include <RenderRecorder.h>
 
 #if defined(PLATFORM_WEB)
 #include <emscripten/emscripten.h>
@@ -29,18 +31,43 @@ spAnimationStateData* animationStateData;
 spAnimationState* animationState;
 Vector3 skeletonPosition = { SCREEN_WIDTH / 2, SCREEN_HEIGHT, 0 };
 
+// F5 record the draw calls of the next frame, replay and summarize it offline with the Benchmarks example
+#define FRAME_CAPTURE_PATH "Frame.rgdc"
+RenderRecorder frameRecorder;
+
 void UpdateDrawFrame(void) {
     // Draw
     //----------------------------------------------------------------------------------
+    bool captureFrame = IsKeyPressed(KEY_F5);
+
     BeginDrawing();
 
-    ClearBackground(RAYWHITE);
+    if (captureFrame) {
+        RenderRecorderBeginFrame(&frameRecorder, GetScreenWidth(), GetScreenHeight());
+        RendererSetBackend(RenderRecorderGetBackend(&frameRecorder));
+    }
+
+    RendererClear(RAYWHITE);
 
     spAnimationState_update(animationState, GetFrameTime());
     spAnimationState_apply(animationState, skeleton);
     spSkeleton_updateWorldTransform(skeleton);
+
+    RendererBeginSection("drawSkeleton");
     drawSkeleton(skeleton, skeletonPosition);
-    DrawFPS(10, 10);
+    RendererEndSection();
+
+    RendererDrawText(TextFormat("%2i FPS", GetFPS()), 10, 10, 20, LIME);
+
+    if (captureFrame) {
+        RendererSetBackend(NULL);
+
+        RenderRecordSummary summary;
+        int size = RenderRecorderEndFrame(&frameRecorder);
+        if (RenderRecorderSave(&frameRecorder, FRAME_CAPTURE_PATH) && RenderRecordSummarize(frameRecorder.buffer, size, &summary)) {
+            RenderRecordPrintSummary(&summary);
+        }
+    }
 
     EndDrawing();
     //----------------------------------------------------------------------------------
@@ -84,6 +111,8 @@ int main()
     spSkeleton_updateWorldTransform(skeleton);
 
     SetTargetFPS(60);
+
+    frameRecorder = RenderRecorderNew(RendererGetRaylibBackend());
     //--------------------------------------------------------------------------------------
 
     // Main game loop
@@ -106,6 +135,7 @@ int main()
     spAtlas_dispose(atlas);
     spSkeleton_dispose(skeleton);
     texture_2d_destroy(); // Destroy textures loaded by spine
+    RenderRecorderFree(&frameRecorder);
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
 
@@ -15,6 +15,7 @@
 #include <spine/extension.h>
 #include <rlgl.h>
 #include <stdio.h>
+#include <Renderer.h>
 
 float anti_z_fighting_index = SP_LAYER_SPACING_BASE;
 
@@ -23,6 +24,20 @@ float anti_z_fighting_index = SP_LAYER_SPACING_BASE;
 static Texture2D tm_textures[MAX_TEXTURES] = {0};
 static int texture_index = 0;
 
+// Atlas pages are raylib textures by default, the Benchmarks example load them in the software renderer
+static Texture2D (*texture_2d_loader)(const char *path) = NULL;
+static void (*texture_2d_unloader)(Texture2D texture) = NULL;
+
+void texture_2d_set_loader(Texture2D (*loader)(const char *path), void (*unloader)(Texture2D texture)) {
+    texture_2d_loader = loader;
+    texture_2d_unloader = unloader;
+}
+
+static void texture_2d_unload(Texture2D texture) {
+    if (texture_2d_unloader) texture_2d_unloader(texture);
+    else UnloadTexture(texture);
+}
+
 char *_spUtil_readFile(const char *path, int *length) {
     return _spReadFile(path, length);
 }
@@ -30,7 +45,7 @@ char *_spUtil_readFile(const char *path, int *length) {
 void _spAtlasPage_disposeTexture(spAtlasPage *self) {
     if (self->rendererObject == NULL) return;
     Texture2D *t2d = self->rendererObject;
-    UnloadTexture(*t2d);
+    texture_2d_unload(*t2d);
 }
 
 typedef struct Vertex {
@@ -63,86 +78,70 @@ void addVertex(float x, float y, float u, float v, float r, float g, float b, fl
     *index += 1;
 }
 
+static RendererVertex engine_vertex(Vertex vertex, Vector3 position) {
+    RendererVertex result = {
+        position.x + vertex.x, position.y + vertex.y,
+        vertex.u, vertex.v,
+        (Color) { (unsigned char)(vertex.r * 255.0f), (unsigned char)(vertex.g * 255.0f), (unsigned char)(vertex.b * 255.0f), (unsigned char)(vertex.a * 255.0f) },
+    };
+    return result;
+}
+
 void engine_draw_region(Vertex* vertices, Texture* texture, Vector3 position, int* vertex_order){
-    Vertex vertex;
-    rlEnableTexture(texture->id);
-    rlPushMatrix();
-    {
-        rlBegin(RL_QUADS);
-        {
-            rlNormal3f(0.0f, 0.0f, 1.0f);
-            for (int i = 0; i < 4; i++){
-                vertex = vertices[vertex_order[i]];
-                rlTexCoord2f(vertex.u, vertex.v);
-                rlColor4f(vertex.r, vertex.g, vertex.b, vertex.a);
-                rlVertex3f( position.x + vertex.x, position.y + vertex.y, position.z + anti_z_fighting_index);
-            }
-        }rlEnd();
+    // Drawing order is enough for the layers, the quad is split in two triangles for the Renderer
+    static const int quad_triangles[6] = { 0, 1, 2, 0, 2, 3 };
+
+    RendererVertex triangles[6];
+    for (int i = 0; i < 6; i++){
+        triangles[i] = engine_vertex(vertices[vertex_order[quad_triangles[i]]], position);
+    }
+    RendererDrawTriangles(texture->id, triangles, 6);
 
 #ifdef SP_DRAW_DOUBLE_FACED
-        rlBegin(RL_QUADS);
-        {
-            rlNormal3f(0.0f, 0.0f, 1.0f);
-            for (int i = 3; i >= 0; i--){
-                vertex = vertices[vertex_order[i]];
-                rlTexCoord2f(vertex.u, vertex.v);
-                rlColor4f(vertex.r, vertex.g, vertex.b, vertex.a);
-                rlVertex3f( position.x + vertex.x, position.y + vertex.y, position.z - anti_z_fighting_index);
-            }
-        }rlEnd();
+    for (int i = 0; i < 6; i++){
+        triangles[i] = engine_vertex(vertices[vertex_order[quad_triangles[5 - i]]], position);
+    }
+    RendererDrawTriangles(texture->id, triangles, 6);
 #endif
-
-    }rlPopMatrix();
-    rlDisableTexture();
 }
 void engine_drawMesh(Vertex *vertices, int start, int count, Texture *texture, Vector3 position, int *vertex_order) {
-    Vertex vertex;
-    rlPushMatrix();
-    {
-        for (int vertexIndex = start; vertexIndex < count; vertexIndex += 3) {
-            rlEnableTexture(texture->id);
-            rlBegin(RL_QUADS);
-            {
-                int i;
-                for (i = 2; i > -1; i--) {
-                    vertex = vertices[vertexIndex + i];
-                    rlTexCoord2f(vertex.u, vertex.v);
-                    rlColor4f(vertex.r, vertex.g, vertex.b, vertex.a);
-                    rlVertex3f(position.x + vertex.x, position.y + vertex.y, position.z + anti_z_fighting_index);
-                }
-                rlVertex3f(position.x + vertex.x, position.y + vertex.y, position.z + anti_z_fighting_index);
-            }
-            rlEnd();
 #ifdef SP_DRAW_DOUBLE_FACED
-            fprintf(stderr, "double sided not supported for mesh based spine files\n");
-            exit(-1);
+    fprintf(stderr, "double sided not supported for mesh based spine files\n");
+    exit(-1);
 #endif
 
+    static RendererVertex triangles[MAX_VERTICES_PER_ATTACHMENT];
+    int triangleVertices = 0;
+    for (int vertexIndex = start; vertexIndex < count; vertexIndex += 3) {
+        for (int i = 2; i > -1; i--) {
+            triangles[triangleVertices++] = engine_vertex(vertices[vertexIndex + i], position);
+        }
+    }
+    RendererDrawTriangles(texture->id, triangles, triangleVertices);
+
 #ifdef SP_RENDER_WIREFRAME
-                DrawTriangleLines((Vector2) {vertices[vertexIndex].x + position.x, vertices[vertexIndex].y + position.y},
+    for (int vertexIndex = start; vertexIndex < count; vertexIndex += 3) {
+        RendererDrawTriangleLines((Vector2) {vertices[vertexIndex].x + position.x, vertices[vertexIndex].y + position.y},
                                   (Vector2) {vertices[vertexIndex + 1].x + position.x, vertices[vertexIndex + 1].y + position.y},
                                   (Vector2) {vertices[vertexIndex + 2].x + position.x, vertices[vertexIndex + 2].y + position.y}, vertexIndex == 0 ? RED : GREEN);
-#endif
-
-        }
-
-
-
     }
-    rlPopMatrix();
-    rlDisableTexture();
+#endif
 }
 
 Texture2D *texture_2d_create(char *path) {
-    tm_textures[texture_index] = LoadTexture(path);
     Texture2D *t = &tm_textures[texture_index];
-    SetTextureFilter(*t, FILTER_BILINEAR);
+    if (texture_2d_loader) {
+        *t = texture_2d_loader(path);
+    } else {
+        *t = LoadTexture(path);
+        SetTextureFilter(*t, FILTER_BILINEAR);
+    }
     texture_index++;
     return t;
 }
 
 void texture_2d_destroy() {
-    while (texture_index--) UnloadTexture(tm_textures[texture_index]);
+    while (texture_index > 0) texture_2d_unload(tm_textures[--texture_index]);
 }
 
 void _spAtlasPage_createTexture(spAtlasPage *self, const char *path) {
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Single file archive of assets, memory mapped at runtime
+// Layout: header, entries sorted by name hash, then blobs aligned to ASSET_ARCHIVE_ALIGNMENT
+
+#define ASSET_ARCHIVE_MAGIC         0x4B504752u     // "RGPK"
+#define ASSET_ARCHIVE_VERSION       1
+#define ASSET_ARCHIVE_ALIGNMENT     16
+#define ASSET_IMAGE_FORMAT          7               // UNCOMPRESSED_R8G8B8A8 of raylib, the only pixel format of image entries
+
+typedef enum AssetType
+{
+    ASSET_RAW,      // File bytes as is
+    ASSET_IMAGE,    // Decoded pixels, params: width, height, format, mipmaps; RGBA8 with a single mip
+    ASSET_WAVE,     // Decoded PCM, params: sampleCount, sampleRate, sampleSize, channels; sampleCount counts every channel
+} AssetType;
+
+typedef struct AssetArchiveHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    entryCount;
+    uint32_t    entrySize;      // sizeof(AssetArchiveEntry) of the writer, catch layout changes
+} AssetArchiveHeader;
+
+typedef struct AssetArchiveEntry
+{
+    uint64_t    hash;
+    uint64_t    offset;         // From the start of the archive
+    uint64_t    size;
+    uint32_t    type;
+    uint32_t    params[4];
+    uint32_t    reserved;
+} AssetArchiveEntry;
+
+typedef struct AssetArchive
+{
+    const uint8_t*              base;
+    size_t                      size;
+
+    const AssetArchiveEntry*    entries;
+    int                         entryCount;
+
+    void*                       file;
+    void*                       mapping;
+} AssetArchive;
+
+// Blob given to the writer, data is copied into the archive
+typedef struct AssetArchiveBlob
+{
+    const char* name;
+    AssetType   type;
+    uint32_t    params[4];
+    const void* data;
+    uint64_t    size;
+} AssetArchiveBlob;
+
+// FNV-1a of the name, '\\' hash as '/' so names are the same on every platform
+uint64_t                    AssetArchiveHash(const char* name);
+
+// Map the archive in memory and validate its table, the archive is zeroed on failure
+// Image and wave entries must hold the bytes their params decode to, they are uploaded as is
+bool                        AssetArchiveOpen(AssetArchive* archive, const char* path);
+void                        AssetArchiveClose(AssetArchive* archive);
+
+const AssetArchiveEntry*    AssetArchiveFind(const AssetArchive* archive, const char* name);
+const AssetArchiveEntry*    AssetArchiveFindHash(const AssetArchive* archive, uint64_t hash);
+
+// Zero-copy view of an entry, valid until the archive is closed
+const void*                 AssetArchiveData(const AssetArchive* archive, const AssetArchiveEntry* entry);
+
+// Write blobs to a new archive, fail on I/O error or name hash collision
+bool                        AssetArchiveWrite(const char* path, const AssetArchiveBlob* blobs, int count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "Array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Skyline bottom-left rectangle packer, for building texture atlases
+// Rectangles fit best when added from the tallest to the shortest
+
+typedef struct AtlasRect
+{
+    int x;
+    int y;
+    int width;
+    int height;
+} AtlasRect;
+
+typedef struct AtlasSkyline
+{
+    int x;
+    int y;
+    int width;
+} AtlasSkyline;
+
+typedef struct AtlasPacker
+{
+    int                 width;
+    int                 height;
+    Array(AtlasSkyline) skyline;    // Top edge of the packed area, sorted by x, cover the whole width
+} AtlasPacker;
+
+AtlasPacker AtlasPackerNew(int width, int height);
+void        AtlasPackerFree(AtlasPacker* packer);
+
+// Place a width x height rectangle at the lowest position it fit, return false when the atlas is full
+bool        AtlasPackerAdd(AtlasPacker* packer, int width, int height, AtlasRect* outRect);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+#define AtomicLoad(ptr)                         (_ReadWriteBarrier(), *(volatile long*)(ptr))
+#define AtomicStore(ptr, value)                 ((void)_InterlockedExchange((volatile long*)(ptr), (long)(value)))
+
+#define AtomicAdd(ptr, value)                   (_InterlockedExchangeAdd((volatile long*)(ptr), (long)(value)) + (long)(value))
+#define AtomicIncrement(ptr)                    _InterlockedIncrement((volatile long*)(ptr))
+#define AtomicDecrement(ptr)                    _InterlockedDecrement((volatile long*)(ptr))
+
+#define AtomicCompareExchange(ptr, expected, desired) \
+    (_InterlockedCompareExchange((volatile long*)(ptr), (long)(desired), (long)(expected)) == (long)(expected))
+#else
+#define AtomicLoad(ptr)                         __atomic_load_n((volatile long*)(ptr), __ATOMIC_ACQUIRE)
+#define AtomicStore(ptr, value)                 __atomic_store_n((volatile long*)(ptr), (long)(value), __ATOMIC_RELEASE)
+
+#define AtomicAdd(ptr, value)                   __atomic_add_fetch((volatile long*)(ptr), (long)(value), __ATOMIC_SEQ_CST)
+#define AtomicIncrement(ptr)                    __atomic_add_fetch((volatile long*)(ptr), 1, __ATOMIC_SEQ_CST)
+#define AtomicDecrement(ptr)                    __atomic_sub_fetch((volatile long*)(ptr), 1, __ATOMIC_SEQ_CST)
+
+#define AtomicCompareExchange(ptr, expected, desired) \
+    __extension__ ({ long __expected = (long)(expected); __atomic_compare_exchange_n((volatile long*)(ptr), &__expected, (long)(desired), 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); })
+#endif
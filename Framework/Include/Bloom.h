@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPU version of the NeonShooter bloom post process, for headless rendering and frame captures
+// Same math as Bloom.frag: 4 taps each side on the horizontal and vertical axes, nearest sampling
+// with repeat wrap, then tone map 1 - exp(-x * 0.5) and gamma 2.2. Rows are split over the job system
+// and pixels are processed as one SSE vector of RGBA when available
+
+#define BLOOM_TAPS 4
+
+typedef struct Bloom
+{
+    int     width;
+    int     height;
+
+    int     tapsX[BLOOM_TAPS * 2];      // Pixel offsets of +i then -i texel steps, as the shader sample them
+    int     tapsY[BLOOM_TAPS * 2];
+
+    float*  scratch;                    // RGBA float copy of 8 bits sources
+} Bloom;
+
+Bloom   BloomNew(int width, int height);
+void    BloomFree(Bloom* bloom);
+
+// RGBA pixels, tightly packed, destination must not alias the source, alpha is written opaque
+void    BloomApplyRGBA8(Bloom* bloom, const uint8_t* source, uint8_t* dest);
+void    BloomApplyFloat(Bloom* bloom, const float* source, float* dest);
+
+#ifdef __cplusplus
+}
+#endif
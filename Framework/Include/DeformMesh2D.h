@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include <raylib.h>
+
+#include "Array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Grid of vertices pulled back to their origin by a damped spring, vertices do not see their neighbors
+// Vertices are grouped in tiles that sleep at their origin once they settle, forces wake the tiles they touch
+// The update run tile rows in parallel on the job system, 4 vertices at once with SSE2
+
+#define DEFORM_MESH_2D_TILE_SIZE    8       // Vertices per side of a tile
+#define DEFORM_MESH_2D_WAKE_IMPULSE 0.01f   // Smaller pushes do not wake a sleeping tile
+
+typedef struct DeformMesh2D
+{
+    int             width;              // Vertices per row
+    int             height;             // Rows
+
+    float           cellWidth;
+    float           cellHeight;
+
+    float           damping;
+    float           springForce;
+
+    float           sleepSpeed;         // Pixels per second, 0 to keep every tile awake
+    float           sleepDisplacement;  // Pixels
+
+    // Struct of arrays, a register hold the same coordinate of 4 vertices
+    Array(float)    positionX;
+    Array(float)    positionY;
+    Array(float)    velocityX;
+    Array(float)    velocityY;
+    Array(float)    originX;
+    Array(float)    originY;
+
+    int             tileCols;
+    int             tileRows;
+    Array(bool)     tileAwake;
+} DeformMesh2D;
+
+typedef struct DeformMesh2DForce
+{
+    Vector2         position;
+    float           force;
+    float           radius;             // Vertices further are not pushed
+} DeformMesh2DForce;
+
+// Zeroed mesh when out of memory, check with DeformMesh2DIsValid
+DeformMesh2D    DeformMesh2DNew(Rectangle bounds, Vector2 spacing, float springForce, float damping);
+void            DeformMesh2DFree(DeformMesh2D* mesh);
+bool            DeformMesh2DIsValid(DeformMesh2D mesh);
+
+void            DeformMesh2DUpdate(DeformMesh2D mesh, float dt);
+
+// Push the vertices in radius away from position, the force fall off with the distance
+// Only the lattice cells around the forces are visited
+void            DeformMesh2DApplyForce(DeformMesh2D mesh, float force, Vector2 position, float radius, float dt);
+
+// Many sources in one sweep, e.g. touch points
+void            DeformMesh2DApplyForces(DeformMesh2D mesh, const DeformMesh2DForce* forces, int count, float dt);
+
+int             DeformMesh2DAwakeTileCount(DeformMesh2D mesh);
+
+#ifdef __cplusplus
+}
+#endif
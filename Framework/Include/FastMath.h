@@ -0,0 +1,238 @@
+#pragma once
+
+// Polynomial approximations of the trigonometric functions used in hot loops
+// Error bounds are measured against libm over the ranges noted, see Examples/Benchmarks
+
+#include <math.h>
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FASTMATH_SSE 1
+#include <emmintrin.h>
+#else
+#define FASTMATH_SSE 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef _MSC_VER
+#define FASTMATH_INLINE static __forceinline
+#elif defined(__cplusplus)
+#define FASTMATH_INLINE inline
+#else
+#define FASTMATH_INLINE static inline
+#endif
+
+#define FASTMATH_PI         3.14159265358979323846f
+#define FASTMATH_HALF_PI    1.57079632679489661923f
+
+// atan(z) for z in [0, 1], 9th order polynomial (Abramowitz & Stegun 4.4.47), max error 1.5e-5 rad (float rounding included)
+FASTMATH_INLINE float FastAtanUnit(float z)
+{
+    float s = z * z;
+    return z * (0.9998660f + s * (-0.3302995f + s * (0.1801410f + s * (-0.0851330f + s * 0.0208351f))));
+}
+
+// atan2 for any (y, x), max error 1.5e-5 rad (float rounding included), return 0 for (0, 0)
+FASTMATH_INLINE float FastAtan2f(float y, float x)
+{
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+
+    float mx = ax > ay ? ax : ay;
+    float mn = ax > ay ? ay : ax;
+    if (mx == 0.0f)
+    {
+        return 0.0f;
+    }
+
+    float r = FastAtanUnit(mn / mx);
+    if (ay > ax) r = FASTMATH_HALF_PI - r;
+    if (x < 0.0f) r = FASTMATH_PI - r;
+    return y < 0.0f ? -r : r;
+}
+
+// pi/2 split in three parts, the first two have few enough bits that q * part is exact for |q| < 2^15
+#define FASTMATH_HALF_PI_A  1.5703125f
+#define FASTMATH_HALF_PI_B  4.837512969970703125e-4f
+#define FASTMATH_HALF_PI_C  7.54978995489188216e-8f
+
+// sin and cos of one angle, max error 5.0e-7 for |angle| < 1000 rad, degrade slowly past that
+FASTMATH_INLINE void FastSinCosf(float angle, float* outSin, float* outCos)
+{
+    // Reduce to [-pi/4, pi/4] and a quadrant
+    float t = angle * (2.0f / FASTMATH_PI);
+    int   qi = (int)(t + (t >= 0.0f ? 0.5f : -0.5f));
+    float q = (float)qi;
+    float r = ((angle - q * FASTMATH_HALF_PI_A) - q * FASTMATH_HALF_PI_B) - q * FASTMATH_HALF_PI_C;
+    int   quadrant = qi & 3;
+
+    float r2 = r * r;
+    float s = r + r * r2 * (-1.6666667e-1f + r2 * (8.3333337e-3f + r2 * -1.9841270e-4f));
+    float c = 1.0f + r2 * (-0.5f + r2 * (4.1666668e-2f + r2 * (-1.3888889e-3f + r2 * 2.4801587e-5f)));
+
+    switch (quadrant)
+    {
+    case 0: *outSin =  s; *outCos =  c; break;
+    case 1: *outSin =  c; *outCos = -s; break;
+    case 2: *outSin = -s; *outCos = -c; break;
+    default:*outSin = -c; *outCos =  s; break;
+    }
+}
+
+// 1 / sqrt(x), relative error 5.0e-7 (SSE estimate refined by one Newton step)
+FASTMATH_INLINE float FastRsqrtf(float x)
+{
+#if FASTMATH_SSE
+    float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    return y * (1.5f - 0.5f * x * y * y);
+#else
+    return 1.0f / sqrtf(x);
+#endif
+}
+
+// Normalize (x, y) in place with one division, leave zero vectors untouched
+// sqrtss is as fast as the refined rsqrt estimate on current CPUs, and exact
+FASTMATH_INLINE void FastNormalize2f(float* x, float* y)
+{
+    float lengthSq = *x * *x + *y * *y;
+    if (lengthSq > 0.0f)
+    {
+        float inv = 1.0f / sqrtf(lengthSq);
+        *x *= inv;
+        *y *= inv;
+    }
+}
+
+// Rotate the direction (x, y) by a small angle, keep it unit length without any atan2
+FASTMATH_INLINE void FastRotate2f(float* x, float* y, float angle)
+{
+    float s, c;
+    FastSinCosf(angle, &s, &c);
+
+    float rx = *x * c - *y * s;
+    float ry = *x * s + *y * c;
+    *x = rx;
+    *y = ry;
+}
+
+// Angle between two directions at amount, lerp the directions so it always take the shortest path
+// No wrap around of angles to handle, opposite directions give the angle of the end one
+FASTMATH_INLINE float FastLerpAngle2f(float startX, float startY, float endX, float endY, float amount)
+{
+    float x = startX + (endX - startX) * amount;
+    float y = startY + (endY - startY) * amount;
+    return x == 0.0f && y == 0.0f ? FastAtan2f(endY, endX) : FastAtan2f(y, x);
+}
+
+// ----------------------------------
+// Array kernels, 4 lanes at once when SSE2 is available
+// Same polynomials as the scalar functions, so the same error bounds
+// ----------------------------------
+
+#if FASTMATH_SSE
+FASTMATH_INLINE __m128 FastAtan2f4(__m128 y, __m128 x)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    __m128 ax = _mm_andnot_ps(signMask, x);
+    __m128 ay = _mm_andnot_ps(signMask, y);
+
+    __m128 mx = _mm_max_ps(ax, ay);
+    __m128 mn = _mm_min_ps(ax, ay);
+    __m128 zero = _mm_cmpeq_ps(mx, _mm_setzero_ps());
+
+    __m128 z = _mm_div_ps(mn, _mm_or_ps(mx, _mm_and_ps(zero, _mm_set1_ps(1.0f))));
+    __m128 s = _mm_mul_ps(z, z);
+
+    __m128 r = _mm_add_ps(_mm_set1_ps(-0.0851330f), _mm_mul_ps(s, _mm_set1_ps(0.0208351f)));
+    r = _mm_add_ps(_mm_set1_ps(0.1801410f), _mm_mul_ps(s, r));
+    r = _mm_add_ps(_mm_set1_ps(-0.3302995f), _mm_mul_ps(s, r));
+    r = _mm_add_ps(_mm_set1_ps(0.9998660f), _mm_mul_ps(s, r));
+    r = _mm_mul_ps(z, r);
+
+    __m128 swapped = _mm_cmpgt_ps(ay, ax);
+    r = _mm_or_ps(_mm_and_ps(swapped, _mm_sub_ps(_mm_set1_ps(FASTMATH_HALF_PI), r)), _mm_andnot_ps(swapped, r));
+
+    __m128 negX = _mm_cmplt_ps(x, _mm_setzero_ps());
+    r = _mm_or_ps(_mm_and_ps(negX, _mm_sub_ps(_mm_set1_ps(FASTMATH_PI), r)), _mm_andnot_ps(negX, r));
+
+    r = _mm_or_ps(r, _mm_and_ps(_mm_cmplt_ps(y, _mm_setzero_ps()), signMask));
+    return _mm_andnot_ps(zero, r);
+}
+
+FASTMATH_INLINE void FastSinCosf4(__m128 angle, __m128* outSin, __m128* outCos)
+{
+    __m128 q = _mm_mul_ps(angle, _mm_set1_ps(2.0f / FASTMATH_PI));
+    __m128i qi = _mm_cvtps_epi32(q);                // round to nearest
+    q = _mm_cvtepi32_ps(qi);
+
+    __m128 r = _mm_sub_ps(angle, _mm_mul_ps(q, _mm_set1_ps(FASTMATH_HALF_PI_A)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(FASTMATH_HALF_PI_B)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(FASTMATH_HALF_PI_C)));
+
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 s = _mm_add_ps(_mm_set1_ps(8.3333337e-3f), _mm_mul_ps(r2, _mm_set1_ps(-1.9841270e-4f)));
+    s = _mm_add_ps(_mm_set1_ps(-1.6666667e-1f), _mm_mul_ps(r2, s));
+    s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), s));
+
+    __m128 c = _mm_add_ps(_mm_set1_ps(-1.3888889e-3f), _mm_mul_ps(r2, _mm_set1_ps(2.4801587e-5f)));
+    c = _mm_add_ps(_mm_set1_ps(4.1666668e-2f), _mm_mul_ps(r2, c));
+    c = _mm_add_ps(_mm_set1_ps(-0.5f), _mm_mul_ps(r2, c));
+    c = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, c));
+
+    // Odd quadrants swap sin and cos, quadrant 1, 2 negate cos, quadrant 2, 3 negate sin
+    __m128i quadrant = _mm_and_si128(qi, _mm_set1_epi32(3));
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_srli_epi32(quadrant, 1), 31));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_xor_si128(_mm_srli_epi32(quadrant, 1), _mm_and_si128(quadrant, _mm_set1_epi32(1))), 31));
+
+    __m128 rs = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+    __m128 rc = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+    *outSin = _mm_xor_ps(rs, sinSign);
+    *outCos = _mm_xor_ps(rc, cosSign);
+}
+#endif
+
+FASTMATH_INLINE void FastAtan2Array(const float* y, const float* x, float* result, int count)
+{
+    int i = 0;
+#if FASTMATH_SSE
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(result + i, FastAtan2f4(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        result[i] = FastAtan2f(y[i], x[i]);
+    }
+}
+
+FASTMATH_INLINE void FastSinCosArray(const float* angles, float* sines, float* cosines, int count)
+{
+    int i = 0;
+#if FASTMATH_SSE
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 s, c;
+        FastSinCosf4(_mm_loadu_ps(angles + i), &s, &c);
+        _mm_storeu_ps(sines + i, s);
+        _mm_storeu_ps(cosines + i, c);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        FastSinCosf(angles[i], &sines[i], &cosines[i]);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Notify the files written under a directory tree, polled without blocking
+// inotify on Linux, ReadDirectoryChangesW on Windows
+typedef struct FileWatcher FileWatcher;
+
+// A save write a file several times, it is reported once no event came for that long
+#define FILE_WATCHER_DEBOUNCE   0.05
+
+// path is relative to the watched directory, with '/' separators
+typedef void FileChangedFunc(void* userData, const char* path);
+
+FileWatcher*    FileWatcherCreate(const char* directory);
+void            FileWatcherDestroy(FileWatcher* watcher);
+
+// Report once every file that stayed unchanged for FILE_WATCHER_DEBOUNCE seconds, return the count of files reported
+int             FileWatcherPoll(FileWatcher* watcher, FileChangedFunc* func, void* userData);
+
+#ifdef __cplusplus
+}
+#endif
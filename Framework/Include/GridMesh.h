@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <raylib.h>
+
+#include "Renderer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Indexed triangle mesh of a cols x rows grid of points, to draw deformation grids as one textured surface
+// Indices and texture coordinates are built once, the positions are rewritten in place every frame
+// The buffers are public so the mesh can be checked and timed without a window, raylib get the indices on the first draw
+
+typedef struct GridMesh
+{
+    int                 cols;
+    int                 rows;
+    int                 vertexCount;
+    int                 indexCount;
+
+    RendererVertex*     vertices;   // Texture coordinates span [0, 1] over the grid
+    uint32_t*           indices;    // Two triangles per cell, in row order
+
+    RendererMesh        drawMesh;   // Indices split for raylib, the draws only send the positions
+} GridMesh;
+
+// Zeroed mesh when out of memory, check with GridMeshIsValid
+GridMesh    GridMeshNew(int cols, int rows, Color color);
+void        GridMeshFree(GridMesh* mesh);
+bool        GridMeshIsValid(GridMesh mesh);
+
+// Positions of the grid points in row order
+void        GridMeshSetPositions(GridMesh mesh, const Vector2* positions);
+void        GridMeshSetPositionsXY(GridMesh mesh, const float* x, const float* y);
+
+// Struct of arrays positions interpolated between two states, for rendering between fixed rate updates
+void        GridMeshSetPositionsLerp(GridMesh mesh, const float* prevX, const float* prevY, const float* x, const float* y, float alpha);
+
+void        GridMeshDraw(GridMesh mesh, Texture texture);
+
+// Lines along the rows and columns of the grid at rest, drawn on the mesh it look like a wireframe of the grid
+Image       GridMeshGenLinesImage(GridMesh mesh, int cellWidth, int cellHeight, Color lineColor, Color background);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <raylib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Water surface as one height per point of a regular grid, waves follow the discrete 2D wave equation
+// Far cheaper than a spring network: a scalar per point, the 5 point stencil read its neighbors in the row and the rows around
+// Leapfrog integration only keep the heights of the last two updates, the update write the next heights over the oldest ones
+// The border points stay at rest, the update run rows in parallel on the job system, 4 points at once with SSE2
+// Large fields can keep int16 heights in steps of heightStep pixels, half the memory of the floats for the bandwidth bound update
+
+#define HEIGHT_FIELD_BATCH_ROWS 16      // Rows per job of the update
+
+typedef struct HeightField
+{
+    int         cols;
+    int         rows;
+    int         count;
+    Vector2     origin;         // Rest position of the first point
+    Vector2     spacing;
+
+    float       waveSpeed;      // Points per second the waves travel, clamped to the stable limit of the time step
+    float       damping;        // Fraction of the wave speed lost per second
+
+    float       heightStep;     // Pixels per unit of the int16 heights, 0 when the heights are floats
+
+    float*      height;         // Pixels, positive up, NULL when quantized
+    float*      prevHeight;     // Before the last update, for render interpolation
+    int16_t*    quantHeight;    // Units of heightStep, saturate at +-32767 units, NULL when not quantized
+    int16_t*    quantPrevHeight;
+} HeightField;
+
+// Zeroed field when out of memory, check with HeightFieldIsValid
+HeightField HeightFieldNew(int cols, int rows, Vector2 origin, Vector2 spacing, float waveSpeed, float damping);
+
+// Same field with int16 heights, every update round them to heightStep, the heights saturate at 32767 * heightStep
+HeightField HeightFieldNewQuantized(int cols, int rows, Vector2 origin, Vector2 spacing, float waveSpeed, float damping, float heightStep);
+void        HeightFieldFree(HeightField* field);
+bool        HeightFieldIsValid(HeightField field);
+
+// Height of a point in pixels, for both kind of fields
+float       HeightFieldGetHeight(HeightField field, int index);
+
+// Swap the height buffers, take the field by pointer
+void        HeightFieldUpdate(HeightField* field, float timeStep);
+
+// Push the surface down around position, the push fall off smoothly to zero at radius
+void        HeightFieldApplyForce(HeightField field, float force, Vector2 position, float radius, float timeStep);
+
+// Rest positions moved along the slope of the surface as if refracted by the water, refraction is pixels per unit of slope
+// Heights are interpolated between the last two updates by alpha
+void        HeightFieldGetPositions(HeightField field, float alpha, float refraction, Vector2* positions);
+
+#ifdef __cplusplus
+}
+#endif
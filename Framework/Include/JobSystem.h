@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Count of jobs in flight, a job group is done when its counter reach zero
+typedef struct JobCounter
+{
+    volatile long value;
+} JobCounter;
+
+typedef void JobFunc(void* userData);
+
+// Process elements [start, end) of a parallel for, batchIndex is stable for the same count and batchSize
+typedef void ParallelForFunc(void* userData, int start, int end, int batchIndex);
+
+// Start worker threads, workerCount <= 0 use the hardware threads minus the main thread
+bool    JobSystemInit(int workerCount);
+void    JobSystemShutdown(void);
+
+int     JobSystemWorkerCount(void);
+
+// Schedule a job, run it right away when the job system is not initialized or the queue is full
+void    JobSystemRun(JobCounter* counter, JobFunc* func, void* userData);
+
+// Wait for all jobs of the counter, the calling thread help executing the queued jobs of that counter only
+void    JobSystemWait(JobCounter* counter);
+bool    JobSystemIsDone(JobCounter* counter);
+
+int     ParallelForBatchCount(int count, int batchSize);
+
+// Split [0, count) into batches of batchSize and process them on all threads, return when all batches are done
+void    ParallelFor(int count, int batchSize, ParallelForFunc* func, void* userData);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "RingBuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Ogg Vorbis music decoded on a dedicated thread into a ring of 16 bits interleaved frames
+// The consumer only copy out of the ring, it never decode nor block
+
+typedef struct MusicStream
+{
+    void*           decoder;
+    int             sampleRate;
+    int             channels;
+    bool            looping;
+
+    RingBuffer      ring;
+
+    void*           thread;
+    volatile long   running;
+    volatile long   finished;       // Decoder reached the end and does not loop
+
+    volatile long   decodedFrames;
+    volatile long   underruns;      // Reads that found less frames than asked
+} MusicStream;
+
+// Open from a file or from memory (kept alive by the caller until close), then start decoding
+// The decoding thread use the stream in place, it must not move until closed
+// The ring hold bufferSeconds of audio, and at least two decode chunks
+bool    MusicStreamOpen(MusicStream* stream, const char* path, float bufferSeconds, bool looping);
+bool    MusicStreamOpenMemory(MusicStream* stream, const void* data, int size, float bufferSeconds, bool looping);
+void    MusicStreamClose(MusicStream* stream);
+
+int     MusicStreamBufferedFrames(const MusicStream* stream);
+bool    MusicStreamIsFinished(const MusicStream* stream);
+
+// Copy frameCount frames out of the ring, pad with silence and count an underrun when short
+// Return the frames that came from the music
+int     MusicStreamRead(MusicStream* stream, int16_t* frames, int frameCount);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Array.h"
+#include "Renderer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Command stream of the Renderer front end, recorded by a backend that forward to another one
+// A frame is a header then commands, each a 4 bytes tag and a payload padded to 4 bytes, vertices stay in screen space
+// Dump it to a file, replay it on the SoftRenderer and summarize it without a GPU
+
+#define RENDER_RECORD_MAGIC         0x43444752u     // "RGDC"
+#define RENDER_RECORD_VERSION       1
+#define RENDER_RECORD_MAX_SECTIONS  16
+#define RENDER_RECORD_NAME_LENGTH   32
+
+typedef enum RenderCommand
+{
+    RENDER_COMMAND_CLEAR = 1,       // Color
+    RENDER_COMMAND_BLEND_MODE,      // Blend mode in the tag, no payload
+    RENDER_COMMAND_TRANSFORM,       // RendererTransform
+    RENDER_COMMAND_DRAW,            // uint32 texture id, uint32 vertex count, RendererVertex[count]
+    RENDER_COMMAND_SECTION,         // Name length in the tag then the name, empty to end the section
+} RenderCommand;
+
+typedef struct RenderCommandTag
+{
+    uint8_t     command;
+    uint8_t     argument;
+    uint16_t    payloadWords;       // Payload size in 4 bytes words, DRAW store its vertex count instead
+} RenderCommandTag;
+
+typedef struct RenderRecordHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    int32_t     width;              // Viewport the frame was drawn in
+    int32_t     height;
+    uint32_t    commandBytes;       // Bytes of commands following the header
+    uint32_t    commandCount;
+} RenderRecordHeader;
+
+typedef struct RenderSectionSummary
+{
+    char        name[RENDER_RECORD_NAME_LENGTH];
+    int         drawCalls;
+    int         triangles;
+    int         textureChanges;
+    int         blendChanges;
+    int         transformChanges;
+    double      coveredArea;        // Pixels covered by its triangles inside the viewport, overlaps counted
+} RenderSectionSummary;
+
+typedef struct RenderRecordSummary
+{
+    int                     width;
+    int                     height;
+    int                     bytes;
+    int                     commands;
+    int                     clears;
+    int                     vertices;
+    RenderSectionSummary    total;
+    float                   overdraw;       // Covered area per viewport pixel, close to the SoftRenderer shaded fragments
+    int                     sectionCount;   // Draws outside a section are only in the total
+    RenderSectionSummary    sections[RENDER_RECORD_MAX_SECTIONS];
+} RenderRecordSummary;
+
+typedef struct RenderRecorder
+{
+    Array(uint8_t)          buffer;         // Header then commands of the current frame
+    int                     commandCount;
+    const RendererBackend*  target;         // NULL to only record
+    RendererBackend         backend;
+} RenderRecorder;
+
+RenderRecorder          RenderRecorderNew(const RendererBackend* target);
+void                    RenderRecorderFree(RenderRecorder* recorder);
+
+// Install with RendererSetBackend(RenderRecorderGetBackend(&recorder))
+const RendererBackend*  RenderRecorderGetBackend(RenderRecorder* recorder);
+
+// Drop the previous frame, start recording a new one
+void                    RenderRecorderBeginFrame(RenderRecorder* recorder, int width, int height);
+
+// Finish the header, the frame is recorder->buffer and the returned byte count
+int                     RenderRecorderEndFrame(RenderRecorder* recorder);
+bool                    RenderRecorderSave(const RenderRecorder* recorder, const char* path);
+
+// Whole file in memory, MemoryFree it
+uint8_t*                RenderRecordLoad(const char* path, int* outSize);
+
+// Send the commands to a backend, false when the record is truncated or invalid
+bool                    RenderRecordReplay(const uint8_t* data, int size, const RendererBackend* backend);
+bool                    RenderRecordSummarize(const uint8_t* data, int size, RenderRecordSummary* outSummary);
+void                    RenderRecordPrintSummary(const RenderRecordSummary* summary);
+
+#ifdef __cplusplus
+}
+#endif
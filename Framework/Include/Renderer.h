@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <raylib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Drawing front end for the raylib calls the games and examples use
+// Forward to raylib by default, or tessellate to triangles for a backend, e.g. the software rasterizer
+
+// Screen space vertex, the transform stack is already applied
+typedef struct RendererVertex
+{
+    float   x, y;
+    float   u, v;
+    Color   color;
+} RendererVertex;
+
+// Row major 2D affine transform: x' = m[0] x + m[1] y + m[2], y' = m[3] x + m[4] y + m[5]
+typedef struct RendererTransform
+{
+    float   m[6];
+} RendererTransform;
+
+typedef struct RendererBackend
+{
+    void*   userData;
+
+    void    (*clear)(void* userData, Color color);
+    void    (*setBlendMode)(void* userData, int blendMode);
+    void    (*setTransform)(void* userData, const RendererTransform* transform);    // Optional, for recording
+    void    (*drawTriangles)(void* userData, unsigned int textureId, const RendererVertex* vertices, int vertexCount);
+    void    (*section)(void* userData, const char* name);                        // Optional, NULL name end the section
+} RendererBackend;
+
+// NULL to draw with raylib again, the backend must outlive its use
+void    RendererSetBackend(const RendererBackend* backend);
+bool    RendererHasBackend(void);
+
+// Backend drawing the tessellated triangles with rlgl, to wrap in another backend while the window is open
+const RendererBackend* RendererGetRaylibBackend(void);
+
+void    RendererClear(Color color);
+void    RendererBeginBlendMode(int blendMode);
+void    RendererEndBlendMode(void);
+
+void    RendererPushMatrix(void);
+void    RendererPopMatrix(void);
+void    RendererTranslate(float x, float y);
+void    RendererRotate(float degrees);
+void    RendererScale(float x, float y);
+
+// Same transform as raylib: offset + rotation * zoom * (position - target)
+void    RendererBeginMode2D(Camera2D camera);
+void    RendererEndMode2D(void);
+
+void    RendererDrawTexturePro(Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+void    RendererDrawTextureRec(Texture texture, Rectangle source, Vector2 position, Color tint);
+void    RendererDrawLineEx(Vector2 start, Vector2 end, float thick, Color color);
+void    RendererDrawCircleV(Vector2 center, float radius, Color color);
+void    RendererDrawRectangleRec(Rectangle rec, Color color);
+void    RendererDrawRectangleLines(Rectangle rec, Color color);
+void    RendererDrawTriangleLines(Vector2 v1, Vector2 v2, Vector2 v3, Color color);
+
+// Named part of the frame for profiling backends, sections do not nest
+void    RendererBeginSection(const char* name);
+void    RendererEndSection(void);
+
+// Backends draw a built in 3x5 pixel font, metrics differ from the raylib default font
+void    RendererDrawText(const char* text, int x, int y, int fontSize, Color color);
+
+// Triangle list, textureId 0 is untextured
+void    RendererDrawTriangles(unsigned int textureId, const RendererVertex* vertices, int vertexCount);
+
+// Indexed triangle list, three indices per triangle, expanded in batches for the backend
+// Without backend every call go through the rlgl batch, a RendererMesh keep the indices on the GPU
+void    RendererDrawIndexedTriangles(unsigned int textureId, const RendererVertex* vertices, const uint32_t* indices, int indexCount);
+
+// Indexed triangles drawn every frame with only the positions changing
+// Split in raylib meshes of at most 65535 vertices, raylib 3.0 indices are 16 bits
+// Indices, texture coordinates and colors are taken on creation and uploaded on the first draw with raylib,
+// the draws only update the positions. Backends get the same triangles expanded in batches
+typedef struct RendererMesh
+{
+    int         vertexCount;    // Of the vertices given on creation and to the draws
+    int         partCount;
+    Mesh*       parts;
+    uint32_t*   partVertices;   // Source vertex of every vertex of the parts, one part after the other
+} RendererMesh;
+
+// No window needed, zeroed mesh when out of memory, check with RendererMeshIsValid
+RendererMesh RendererMeshNew(const RendererVertex* vertices, int vertexCount, const uint32_t* indices, int indexCount);
+void    RendererMeshFree(RendererMesh* mesh);
+bool    RendererMeshIsValid(RendererMesh mesh);
+
+// Vertices in the order given on creation, only their positions are read
+void    RendererDrawMesh(RendererMesh mesh, unsigned int textureId, const RendererVertex* vertices);
+
+#ifdef __cplusplus
+}
+#endif
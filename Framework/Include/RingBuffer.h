@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lock-free ring of bytes for one producer thread and one consumer thread
+// Positions only grow and wrap around 2^32, the capacity is a power of two so masking stay valid
+typedef struct RingBuffer
+{
+    uint8_t*        data;
+    uint32_t        capacity;
+    volatile long   writePosition;  // Only written by the producer
+    volatile long   readPosition;   // Only written by the consumer
+} RingBuffer;
+
+// Capacity is rounded up to a power of two
+bool        RingBufferInit(RingBuffer* ring, uint32_t capacity);
+void        RingBufferFree(RingBuffer* ring);
+
+uint32_t    RingBufferReadable(const RingBuffer* ring);
+uint32_t    RingBufferWritable(const RingBuffer* ring);
+
+// Producer side, write as much as fit and return the written size
+uint32_t    RingBufferWrite(RingBuffer* ring, const void* data, uint32_t size);
+
+// Consumer side, read as much as available and return the read size
+uint32_t    RingBufferRead(RingBuffer* ring, void* data, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include <raylib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Compiled shader programs saved to disk with glGetProgramBinary, one file per shader name
+// Layout: header then the driver binary, entries are only valid for the same driver and sources
+
+#define SHADER_CACHE_MAGIC      0x43534752u     // "RGSC"
+#define SHADER_CACHE_VERSION    1
+
+typedef struct ShaderCacheKey
+{
+    uint64_t    driverHash;     // Vendor, renderer, GL and raylib versions, binaries are driver specific
+    uint64_t    sourceHash;     // Vertex and fragment sources, NULL meaning the raylib default
+} ShaderCacheKey;
+
+typedef struct ShaderCacheHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint64_t    driverHash;
+    uint64_t    sourceHash;
+    uint32_t    binaryFormat;
+    uint32_t    binarySize;
+    uint64_t    checksum;       // Of the binary, catch truncated and partially written files
+} ShaderCacheHeader;
+
+typedef struct ShaderBinary
+{
+    uint32_t    format;
+    uint32_t    size;
+    void*       data;
+} ShaderBinary;
+
+typedef enum ShaderCacheResult
+{
+    SHADER_CACHE_HIT,
+    SHADER_CACHE_MISS,          // No file for this name
+    SHADER_CACHE_STALE,         // Sources or driver changed since it was written
+    SHADER_CACHE_CORRUPT,       // Bad header, size or checksum
+} ShaderCacheResult;
+
+typedef struct ShaderCacheStats
+{
+    int         hits;
+    int         misses;         // Include stale and corrupt entries
+    int         rejected;       // Binaries the driver refused to load, usually after an update
+    int         written;
+} ShaderCacheStats;
+
+typedef struct ShaderCache
+{
+    char                directory[256];
+    bool                available;      // Driver support program binaries
+    uint64_t            driverHash;
+    ShaderCacheStats    stats;
+} ShaderCache;
+
+// Keying and file format, no GPU needed
+ShaderCacheKey      ShaderCacheMakeKey(const char* driver, const char* vsCode, const char* fsCode);
+void                ShaderCacheFilePath(char* buffer, size_t bufferSize, const char* directory, const char* name);
+ShaderCacheResult   ShaderCacheRead(const char* directory, const char* name, ShaderCacheKey key, ShaderBinary* outBinary);
+bool                ShaderCacheWrite(const char* directory, const char* name, ShaderCacheKey key, ShaderBinary binary);
+void                ShaderCacheRemove(const char* directory, const char* name);
+void                ShaderBinaryFree(ShaderBinary* binary);
+
+// Need a current GL context, the cache is disabled when the driver does not support program binaries
+ShaderCache         ShaderCacheNew(const char* directory);
+
+// Load the cached binary when it is still valid, otherwise compile with LoadShaderCode and save it
+// Same result as LoadShaderCode, including the default shader when compilation fail
+Shader              ShaderCacheLoad(ShaderCache* cache, const char* name, const char* vsCode, const char* fsCode);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Array.h"
+#include "Renderer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPU rasterizer behind the Renderer front end, for frame captures and draw statistics without a GPU
+// Triangles are queued and binned in tiles, tiles are rasterized in parallel on the job system
+// Nearest texture sampling, alpha, additive and multiplied blending with the raylib equations
+
+#define SOFT_RENDERER_TILE_SIZE 64
+
+typedef struct SoftTexture
+{
+    unsigned int    id;
+    int             width;
+    int             height;
+    uint8_t*        pixels;         // RGBA8
+} SoftTexture;
+
+typedef struct SoftTriangle
+{
+    RendererVertex  vertices[3];
+    unsigned int    textureId;
+    int             blendMode;
+} SoftTriangle;
+
+typedef struct SoftRendererStats
+{
+    int             drawCalls;      // drawTriangles calls from the front end
+    int             triangles;
+    int             textureChanges;
+    int             blendChanges;
+    int64_t         pixelsShaded;   // Fragments that passed the coverage test, divide by the frame area for overdraw
+} SoftRendererStats;
+
+typedef struct SoftRenderer
+{
+    int                 width;
+    int                 height;
+    uint8_t*            pixels;     // RGBA8, row major, top row first
+
+    int                 tileColumns;
+    int                 tileRows;
+    Array(int)*         tileBins;   // Triangle indices per tile, in submission order
+
+    Array(SoftTriangle) triangles;
+    Array(SoftTexture)  textures;
+    unsigned int        nextTextureId;
+
+    int                 blendMode;
+    unsigned int        lastTextureId;
+    int64_t*            tilePixels; // Fragments per tile of the last flush
+
+    RendererBackend     backend;
+    SoftRendererStats   stats;
+} SoftRenderer;
+
+SoftRenderer    SoftRendererNew(int width, int height);
+void            SoftRendererFree(SoftRenderer* renderer);
+
+// Install with RendererSetBackend(SoftRendererGetBackend(&renderer))
+const RendererBackend* SoftRendererGetBackend(SoftRenderer* renderer);
+
+// Texture ids are private to the renderer, keep raylib textures and software textures apart
+Texture         SoftRendererLoadTexture(SoftRenderer* renderer, Image image);
+void            SoftRendererUnloadTexture(SoftRenderer* renderer, Texture texture);
+
+// Rasterize the queued triangles, the pixels are complete after it
+void            SoftRendererFlush(SoftRenderer* renderer);
+
+// Flush and return the statistics of the frame, then start counting the next one
+SoftRendererStats SoftRendererEndFrame(SoftRenderer* renderer);
+
+// View of the pixels, valid until the renderer is freed, ExportImage it for captures
+Image           SoftRendererGetImage(SoftRenderer* renderer);
+
+#ifdef __cplusplus
+}
+#endif
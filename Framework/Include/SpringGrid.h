@@ -0,0 +1,145 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include <raylib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Regular grid of unit point masses tied by springs, the topology is implicit in the grid indices
+// Structural springs link each point to its right and bottom neighbors, anchor springs pull points back to their rest position
+// No spring is stored: rest lengths come from the spacing, stiffness and damping from the class of the spring in the params
+// Struct of arrays, the update run 4 points at once with SSE2
+// Only positions and accelerations are stored, velocities are derived from the last move and damping is per tile
+// Points are grouped in tiles that sleep once they settle, forces wake the tiles they touch and moving tiles wake their neighbors
+
+#define SPRING_GRID_TILE_SIZE   16      // Points per side of a tile
+#define SPRING_GRID_SLEEP_TICKS 30      // Quiet updates before a tile sleep
+
+#define SPRING_GRID_SNAPSHOT_MAGIC      0x53475253u     // "SRGS"
+#define SPRING_GRID_SNAPSHOT_VERSION    2
+#define SPRING_GRID_SNAPSHOT_NAME       "SpringGrid"    // Entry of the snapshot in its archive
+
+typedef enum SpringGridSolver
+{
+    SPRING_GRID_SOLVER_FORCE,       // Explicit spring forces, stable at 1/60 with heavy damping
+    SPRING_GRID_SOLVER_POSITION,    // Verlet with relaxed distance constraints, stable at large time steps
+} SpringGridSolver;
+
+typedef struct SpringGridParams
+{
+    float   stiffness;          // Structural springs between neighbors
+    float   damping;
+    float   restLength;         // Fraction of the spacing, structural springs only pull when stretched past it
+    float   force;              // Scale of every spring force
+
+    float   borderStiffness;    // Anchors of the border points, 0 to leave the border free
+    float   borderDamping;
+    float   anchorStiffness;    // Loose anchors of one point every anchorStep rows and columns, 0 for none
+    float   anchorDamping;
+    int     anchorStep;
+
+    float   pointDamping;       // Damping of every point, impulses raise it in their tile for one tick
+    float   restThreshold;      // Points slower than it do not move, accelerations below it snap to zero, 0 to keep them
+
+    // The position solver use stiffness * force / pointDamping as the spring constant and ignore the spring damping
+    int     solver;             // SpringGridSolver, can change between updates
+    int     substeps;           // Sub steps of the position solver per update, 0 for one
+
+    float   sleepThreshold;     // Tiles whose speed and acceleration stay below it go to sleep, 0 to keep every tile awake
+} SpringGridParams;
+
+typedef struct SpringGrid
+{
+    int                 cols;
+    int                 rows;
+    int                 count;
+    Vector2             origin;         // Rest position of the first point
+    Vector2             spacing;
+    SpringGridParams    params;
+
+    float*              positionX;
+    float*              positionY;
+    float*              prevPositionX;  // Before the last update, for render interpolation and the velocities
+    float*              prevPositionY;
+    float*              accelerationX;  // Filtered forces of the force solver, pending forces until the next update
+    float*              accelerationY;
+
+    float*              forceX;         // Scratch of the structural springs, one row and a padding lane
+    float*              forceY;
+
+    int                 tileCols;
+    int                 tileRows;
+    uint8_t*            tileAwake;      // Sleeping tiles are not updated, their points do not move
+    uint8_t*            tileQuietTicks; // 0 when the tile moved in the last update
+    float*              tileMotion;     // Max squared speed or acceleration of the last update
+    float*              tileDamping;    // Damping of the next update, impulses raise it
+    float*              tileVelocityScale;  // Velocity of a point per unit of its last move, damping of the last update over its time step
+} SpringGrid;
+
+// Points [row0, row1) x [col0, col1) of the grid, empty when row0 == row1
+typedef struct SpringGridRange
+{
+    int                 row0, row1;
+    int                 col0, col1;
+} SpringGridRange;
+
+// Snapshot of a grid: this header then the block of the grid as is, every point array and the tile states
+// Native endian, a snapshot only load on the platform that wrote it
+typedef struct SpringGridSnapshotHeader
+{
+    uint32_t            magic;
+    uint32_t            version;
+    uint32_t            headerSize;     // sizeof(SpringGridSnapshotHeader) of the writer, catch layout changes
+    uint32_t            reserved;
+    uint64_t            blockSize;      // Bytes after the header
+
+    int32_t             cols;
+    int32_t             rows;
+    Vector2             origin;
+    Vector2             spacing;
+    SpringGridParams    params;
+} SpringGridSnapshotHeader;
+
+// Zeroed grid when out of memory, check with SpringGridIsValid
+SpringGrid  SpringGridNew(int cols, int rows, Vector2 origin, Vector2 spacing, SpringGridParams params);
+void        SpringGridFree(SpringGrid* grid);
+bool        SpringGridIsValid(SpringGrid grid);
+
+void        SpringGridUpdate(SpringGrid grid, float timeStep);
+
+// Accumulate a force for the next update, every point has unit mass, wake the tile of the point
+void        SpringGridApplyForce(SpringGrid grid, int index, Vector2 force, float timeStep);
+
+// Raise the damping of the tile of the point to pointDamping * factor for the next update
+void        SpringGridIncreaseDamping(SpringGrid grid, int index, float factor);
+
+void        SpringGridWake(SpringGrid grid, int index);
+int         SpringGridAwakeTileCount(SpringGrid grid);
+
+// Points whose rest position is within radius of position plus a cell, to visit only the points a force can reach
+// A point displaced by more than a cell into the radius from outside is not in the range
+SpringGridRange SpringGridRangeInRadius(SpringGrid grid, Vector2 position, float radius);
+
+Vector2     SpringGridPosition(SpringGrid grid, int index);
+Vector2     SpringGridVelocity(SpringGrid grid, int index);
+Vector2     SpringGridRenderPosition(SpringGrid grid, int index, float alpha);
+
+// Warm start: save a settled grid once, restore it with one allocation and one copy instead of settling from rest
+size_t      SpringGridSnapshotSize(SpringGrid grid);
+void        SpringGridWriteSnapshot(SpringGrid grid, void* buffer);
+
+// Zeroed grid when the snapshot is truncated, of another version or out of memory
+SpringGrid  SpringGridFromSnapshot(const void* data, size_t size);
+
+// Snapshot as the single entry of an AssetArchive, loading map the file and copy the block out of it
+bool        SpringGridSave(SpringGrid grid, const char* path);
+SpringGrid  SpringGridLoad(const char* path);
+
+#ifdef __cplusplus
+}
+#endif
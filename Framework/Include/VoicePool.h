@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed set of voices shared by sound categories, with per category polyphony limits
+// Play requests are queued and coalesced, then started once per tick by VoicePoolUpdate
+
+#define VOICE_POOL_MAX_CATEGORIES   8
+
+// Playback is delegated to a backend, so the pool run the same with an audio device or a headless stub
+typedef struct VoiceBackend
+{
+    void*   userData;
+
+    // Return false when the sample can not play (not loaded yet), the voice stay free
+    bool    (*start)(void* userData, int voice, int sample, float volume);
+    void    (*stop)(void* userData, int voice);
+    bool    (*isPlaying)(void* userData, int voice);
+} VoiceBackend;
+
+typedef struct Voice
+{
+    bool        active;
+    int         category;
+    int         sample;
+    int         priority;
+    uint32_t    startTick;
+} Voice;
+
+typedef struct VoiceRequest
+{
+    int         category;
+    int         sample;
+    int         priority;
+    float       volume;
+    int         order;          // Keep the request order between equal priorities
+} VoiceRequest;
+
+typedef struct VoiceCategory
+{
+    int         maxVoices;
+    int         activeVoices;
+} VoiceCategory;
+
+typedef struct VoicePoolStats
+{
+    int         started;
+    int         stolen;
+    int         coalesced;      // Requests merged into an identical one of the same tick
+    int         dropped;        // Requests refused by the polyphony limits
+} VoicePoolStats;
+
+typedef struct VoicePool
+{
+    VoiceBackend        backend;
+
+    Voice*              voices;
+    int                 voiceCount;
+
+    VoiceCategory       categories[VOICE_POOL_MAX_CATEGORIES];
+
+    Array(VoiceRequest) requests;
+    int                 coalesced;
+    uint32_t            tick;
+} VoicePool;
+
+VoicePool   VoicePoolNew(int voiceCount, VoiceBackend backend);
+void        VoicePoolFree(VoicePool* pool);
+
+// Cap the voices a category can hold at once, a category default to the whole pool
+void        VoicePoolSetCategory(VoicePool* pool, int category, int maxVoices);
+
+// Queue a play request, identical requests (same category and sample) of a tick start one voice
+void        VoicePoolPlay(VoicePool* pool, int category, int sample, float volume, int priority);
+
+// Stop every voice of the category and drop its queued requests
+void        VoicePoolStop(VoicePool* pool, int category);
+
+// Release finished voices and start the queued requests, stealing voices by priority then age
+VoicePoolStats VoicePoolUpdate(VoicePool* pool);
+
+int         VoicePoolActiveCount(const VoicePool* pool, int category);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,335 @@
+#include "AssetArchive.h"
+#include "Memory.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#endif
+
+uint64_t AssetArchiveHash(const char* name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char* c = name; *c; c++)
+    {
+        hash ^= (uint8_t)(*c == '\\' ? '/' : *c);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static bool MapFile(AssetArchive* archive, const char* path)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!base)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    archive->base = (const uint8_t*)base;
+    archive->size = (size_t)size.QuadPart;
+    archive->file = file;
+    archive->mapping = mapping;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (base == MAP_FAILED)
+    {
+        return false;
+    }
+
+    archive->base = (const uint8_t*)base;
+    archive->size = (size_t)info.st_size;
+    archive->file = NULL;
+    archive->mapping = NULL;
+#endif
+
+    return true;
+}
+
+static void UnmapFile(AssetArchive* archive)
+{
+    if (!archive->base)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(archive->base);
+    CloseHandle((HANDLE)archive->mapping);
+    CloseHandle((HANDLE)archive->file);
+#else
+    munmap((void*)archive->base, archive->size);
+#endif
+}
+
+// Bytes read from the payload when the params are given to raylib
+static bool ValidatePayload(const AssetArchiveEntry* entry)
+{
+    if (entry->type == ASSET_IMAGE)
+    {
+        uint32_t width = entry->params[0];
+        uint32_t height = entry->params[1];
+        return width > 0 && height > 0
+            && entry->params[2] == ASSET_IMAGE_FORMAT
+            && entry->params[3] == 1
+            && (uint64_t)width * height * 4 <= entry->size;
+    }
+
+    if (entry->type == ASSET_WAVE)
+    {
+        uint32_t sampleCount = entry->params[0];
+        uint32_t sampleSize = entry->params[2];
+        uint32_t channels = entry->params[3];
+        return (sampleSize == 8 || sampleSize == 16 || sampleSize == 32)
+            && channels > 0 && sampleCount % channels == 0
+            && (uint64_t)sampleCount * (sampleSize / 8) <= entry->size;
+    }
+
+    return true;
+}
+
+static bool ValidateArchive(const AssetArchive* archive)
+{
+    if (archive->size < sizeof(AssetArchiveHeader))
+    {
+        return false;
+    }
+
+    const AssetArchiveHeader* header = (const AssetArchiveHeader*)archive->base;
+    if (header->magic != ASSET_ARCHIVE_MAGIC
+        || header->version != ASSET_ARCHIVE_VERSION
+        || header->entrySize != sizeof(AssetArchiveEntry))
+    {
+        return false;
+    }
+
+    uint64_t tableEnd = sizeof(AssetArchiveHeader) + (uint64_t)header->entryCount * sizeof(AssetArchiveEntry);
+    if (tableEnd > archive->size)
+    {
+        return false;
+    }
+
+    const AssetArchiveEntry* entries = (const AssetArchiveEntry*)(archive->base + sizeof(AssetArchiveHeader));
+    for (uint32_t i = 0; i < header->entryCount; i++)
+    {
+        const AssetArchiveEntry* entry = &entries[i];
+        if (entry->offset < tableEnd || entry->offset > archive->size || entry->size > archive->size - entry->offset)
+        {
+            return false;
+        }
+
+        if (!ValidatePayload(entry))
+        {
+            return false;
+        }
+
+        // Lookup is a binary search, the table must be strictly sorted
+        if (i > 0 && entries[i - 1].hash >= entry->hash)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool AssetArchiveOpen(AssetArchive* archive, const char* path)
+{
+    *archive = (AssetArchive) { 0 };
+
+    if (!MapFile(archive, path))
+    {
+        *archive = (AssetArchive) { 0 };
+        return false;
+    }
+
+    if (!ValidateArchive(archive))
+    {
+        UnmapFile(archive);
+        *archive = (AssetArchive) { 0 };
+        return false;
+    }
+
+    const AssetArchiveHeader* header = (const AssetArchiveHeader*)archive->base;
+    archive->entries = (const AssetArchiveEntry*)(archive->base + sizeof(AssetArchiveHeader));
+    archive->entryCount = (int)header->entryCount;
+    return true;
+}
+
+void AssetArchiveClose(AssetArchive* archive)
+{
+    UnmapFile(archive);
+    *archive = (AssetArchive) { 0 };
+}
+
+const AssetArchiveEntry* AssetArchiveFindHash(const AssetArchive* archive, uint64_t hash)
+{
+    int low = 0;
+    int high = archive->entryCount - 1;
+
+    while (low <= high)
+    {
+        int mid = low + ((high - low) >> 1);
+        uint64_t midHash = archive->entries[mid].hash;
+
+        if (midHash == hash)
+        {
+            return &archive->entries[mid];
+        }
+        else if (midHash < hash)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+
+    return NULL;
+}
+
+const AssetArchiveEntry* AssetArchiveFind(const AssetArchive* archive, const char* name)
+{
+    return AssetArchiveFindHash(archive, AssetArchiveHash(name));
+}
+
+const void* AssetArchiveData(const AssetArchive* archive, const AssetArchiveEntry* entry)
+{
+    return archive->base + entry->offset;
+}
+
+typedef struct BlobOrder
+{
+    uint64_t    hash;
+    int         index;
+} BlobOrder;
+
+static int CompareBlobOrder(const void* a, const void* b)
+{
+    uint64_t ha = ((const BlobOrder*)a)->hash;
+    uint64_t hb = ((const BlobOrder*)b)->hash;
+    return ha < hb ? -1 : (ha > hb ? 1 : 0);
+}
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+    return (offset + (ASSET_ARCHIVE_ALIGNMENT - 1)) & ~(uint64_t)(ASSET_ARCHIVE_ALIGNMENT - 1);
+}
+
+bool AssetArchiveWrite(const char* path, const AssetArchiveBlob* blobs, int count)
+{
+    BlobOrder* order = (BlobOrder*)MemoryAlloc(sizeof(BlobOrder) * (count > 0 ? count : 1));
+    AssetArchiveEntry* entries = (AssetArchiveEntry*)MemoryAlloc(sizeof(AssetArchiveEntry) * (count > 0 ? count : 1));
+    if (!order || !entries)
+    {
+        MemoryFree(order);
+        MemoryFree(entries);
+        return false;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        order[i] = (BlobOrder) { AssetArchiveHash(blobs[i].name), i };
+    }
+    qsort(order, count, sizeof(BlobOrder), CompareBlobOrder);
+
+    bool result = true;
+    uint64_t offset = AlignOffset(sizeof(AssetArchiveHeader) + (uint64_t)count * sizeof(AssetArchiveEntry));
+    for (int i = 0; i < count; i++)
+    {
+        if (i > 0 && order[i - 1].hash == order[i].hash)
+        {
+            fprintf(stderr, "[AssetArchive] Hash collision: %s and %s\n", blobs[order[i - 1].index].name, blobs[order[i].index].name);
+            result = false;
+        }
+
+        const AssetArchiveBlob* blob = &blobs[order[i].index];
+        entries[i] = (AssetArchiveEntry) {
+            .hash   = order[i].hash,
+            .offset = offset,
+            .size   = blob->size,
+            .type   = (uint32_t)blob->type,
+            .params = { blob->params[0], blob->params[1], blob->params[2], blob->params[3] },
+        };
+
+        offset = AlignOffset(offset + blob->size);
+    }
+
+    FILE* file = result ? fopen(path, "wb") : NULL;
+    if (file)
+    {
+        static const uint8_t padding[ASSET_ARCHIVE_ALIGNMENT] = { 0 };
+
+        AssetArchiveHeader header = { ASSET_ARCHIVE_MAGIC, ASSET_ARCHIVE_VERSION, (uint32_t)count, sizeof(AssetArchiveEntry) };
+        result = fwrite(&header, sizeof(header), 1, file) == 1;
+        result = result && (count == 0 || fwrite(entries, sizeof(AssetArchiveEntry), count, file) == (size_t)count);
+
+        uint64_t written = sizeof(AssetArchiveHeader) + (uint64_t)count * sizeof(AssetArchiveEntry);
+        for (int i = 0; i < count && result; i++)
+        {
+            const AssetArchiveBlob* blob = &blobs[order[i].index];
+
+            size_t pad = (size_t)(entries[i].offset - written);
+            result = fwrite(padding, 1, pad, file) == pad;
+            result = result && (blob->size == 0 || fwrite(blob->data, 1, (size_t)blob->size, file) == blob->size);
+
+            written = entries[i].offset + blob->size;
+        }
+
+        result = (fclose(file) == 0) && result;
+    }
+    else
+    {
+        result = false;
+    }
+
+    MemoryFree(order);
+    MemoryFree(entries);
+    return result;
+}
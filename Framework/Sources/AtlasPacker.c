@@ -0,0 +1,124 @@
+#include "AtlasPacker.h"
+
+AtlasPacker AtlasPackerNew(int width, int height)
+{
+    AtlasPacker packer = { width, height, ArrayNew(AtlasSkyline, 32) };
+
+    AtlasSkyline ground = { 0, 0, width };
+    ArrayPush(packer.skyline, ground);
+    return packer;
+}
+
+void AtlasPackerFree(AtlasPacker* packer)
+{
+    ArrayFree(packer->skyline);
+    *packer = (AtlasPacker) { 0 };
+}
+
+// Lowest y a rectangle starting at skyline node index can sit at, -1 when it does not fit
+static int FitSkyline(const AtlasPacker* packer, int index, int width, int height)
+{
+    int x = packer->skyline[index].x;
+    if (x + width > packer->width)
+    {
+        return -1;
+    }
+
+    int y = 0;
+    int remaining = width;
+    for (int i = index, n = ArrayCount(packer->skyline); remaining > 0 && i < n; i++)
+    {
+        const AtlasSkyline* node = &packer->skyline[i];
+        y = node->y > y ? node->y : y;
+        remaining -= node->width;
+    }
+
+    return y + height <= packer->height ? y : -1;
+}
+
+bool AtlasPackerAdd(AtlasPacker* packer, int width, int height, AtlasRect* outRect)
+{
+    int bestIndex = -1;
+    int bestY = packer->height;
+    int bestWidth = packer->width;
+
+    for (int i = 0, n = ArrayCount(packer->skyline); i < n; i++)
+    {
+        int y = FitSkyline(packer, i, width, height);
+        if (y < 0)
+        {
+            continue;
+        }
+
+        // Lowest top edge first, then the narrowest node to keep wide gaps for wide rectangles
+        if (y + height < bestY + height || (y == bestY && packer->skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestY = y;
+            bestWidth = packer->skyline[i].width;
+        }
+    }
+
+    if (bestIndex < 0)
+    {
+        return false;
+    }
+
+    AtlasRect rect = { packer->skyline[bestIndex].x, bestY, width, height };
+    *outRect = rect;
+
+    // Insert the new top edge, then cut the nodes it now cover
+    AtlasSkyline node = { rect.x, rect.y + height, width };
+    ArrayPush(packer->skyline, node);
+    for (int i = ArrayCount(packer->skyline) - 1; i > bestIndex; i--)
+    {
+        packer->skyline[i] = packer->skyline[i - 1];
+    }
+    packer->skyline[bestIndex] = node;
+
+    int right = rect.x + width;
+    int i = bestIndex + 1;
+    while (i < ArrayCount(packer->skyline))
+    {
+        AtlasSkyline* next = &packer->skyline[i];
+        if (next->x >= right)
+        {
+            break;
+        }
+
+        int covered = right - next->x;
+        if (covered < next->width)
+        {
+            next->x += covered;
+            next->width -= covered;
+            break;
+        }
+
+        // Fully covered, remove it
+        for (int j = i, n = ArrayCount(packer->skyline) - 1; j < n; j++)
+        {
+            packer->skyline[j] = packer->skyline[j + 1];
+        }
+        ArraySetCount(packer->skyline, ArrayCount(packer->skyline) - 1);
+    }
+
+    // Merge neighbours at the same height
+    for (int k = 0; k + 1 < ArrayCount(packer->skyline); )
+    {
+        if (packer->skyline[k].y == packer->skyline[k + 1].y)
+        {
+            packer->skyline[k].width += packer->skyline[k + 1].width;
+            for (int j = k + 1, n = ArrayCount(packer->skyline) - 1; j < n; j++)
+            {
+                packer->skyline[j] = packer->skyline[j + 1];
+            }
+            ArraySetCount(packer->skyline, ArrayCount(packer->skyline) - 1);
+        }
+        else
+        {
+            k++;
+        }
+    }
+
+    return true;
+}
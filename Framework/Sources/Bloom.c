@@ -0,0 +1,247 @@
+#include "Bloom.h"
+#include "Memory.h"
+#include "FastMath.h"
+#include "JobSystem.h"
+
+#include <stdbool.h>
+
+#define BLOOM_BATCH_ROWS 8
+
+// Bloom.frag weights, center first
+static const float bloomWeights[BLOOM_TAPS + 1] = { 0.227027f, 0.1945946f, 0.1216216f, 0.054054f, 0.016216f };
+
+typedef struct BloomPass
+{
+    Bloom*          bloom;
+    const float*    source;
+    uint8_t*        dest8;
+    float*          destFloat;
+    const uint8_t*  convert;    // 8 bits source converted to scratch by the first pass
+} BloomPass;
+
+// The shader step 1 / max(width, height) in texture space, sampled at the texel center with nearest filtering
+static void ComputeTaps(int* taps, int size, int maxSize)
+{
+    for (int i = 1; i <= BLOOM_TAPS; i++)
+    {
+        float step = (float)i * (float)size / (float)maxSize;
+        taps[i - 1] = (int)floorf(0.5f + step);
+        taps[BLOOM_TAPS + i - 1] = (int)floorf(0.5f - step);
+    }
+}
+
+Bloom BloomNew(int width, int height)
+{
+    Bloom bloom = { 0 };
+    bloom.width = width;
+    bloom.height = height;
+    bloom.scratch = (float*)MemoryAlloc(sizeof(float) * 4 * width * height);
+
+    int maxSize = width > height ? width : height;
+    ComputeTaps(bloom.tapsX, width, maxSize);
+    ComputeTaps(bloom.tapsY, height, maxSize);
+    return bloom;
+}
+
+void BloomFree(Bloom* bloom)
+{
+    MemoryFree(bloom->scratch);
+    *bloom = (Bloom) { 0 };
+}
+
+static int Wrap(int value, int size)
+{
+    value %= size;
+    return value < 0 ? value + size : value;
+}
+
+#if FASTMATH_SSE
+// 2^x for x in [-126, 0], degree 6 polynomial on the fraction, relative error 2e-7
+static __m128 Exp2f4(__m128 x)
+{
+    x = _mm_max_ps(x, _mm_set1_ps(-126.0f));
+
+    __m128i n = _mm_cvtps_epi32(x);
+    __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(n));
+
+    __m128 p = _mm_add_ps(_mm_set1_ps(1.3333558e-3f), _mm_mul_ps(f, _mm_set1_ps(1.5403530e-4f)));
+    p = _mm_add_ps(_mm_set1_ps(9.6181291e-3f), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(5.5504109e-2f), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(2.4022651e-1f), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(6.9314718e-1f), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(f, p));
+
+    __m128i scale = _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+    return _mm_mul_ps(p, _mm_castsi128_ps(scale));
+}
+
+// log2(x) for normal x > 0, mantissa reduced to [sqrt(0.5), sqrt(2)) then atanh series, absolute error 1e-7
+static __m128 Log2f4(__m128 x)
+{
+    __m128i bits = _mm_castps_si128(x);
+    __m128i exponent = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+    __m128 large = _mm_cmpgt_ps(m, _mm_set1_ps(1.41421356f));
+    m = _mm_or_ps(_mm_and_ps(large, _mm_mul_ps(m, _mm_set1_ps(0.5f))), _mm_andnot_ps(large, m));
+    __m128 e = _mm_add_ps(_mm_cvtepi32_ps(exponent), _mm_and_ps(large, _mm_set1_ps(1.0f)));
+
+    __m128 t = _mm_div_ps(_mm_sub_ps(m, _mm_set1_ps(1.0f)), _mm_add_ps(m, _mm_set1_ps(1.0f)));
+    __m128 t2 = _mm_mul_ps(t, t);
+
+    __m128 p = _mm_add_ps(_mm_set1_ps(1.0f / 7.0f), _mm_mul_ps(t2, _mm_set1_ps(1.0f / 9.0f)));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 5.0f), _mm_mul_ps(t2, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 3.0f), _mm_mul_ps(t2, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(t2, p));
+
+    // ln(m) = 2 t p, log2 = ln / ln 2
+    return _mm_add_ps(e, _mm_mul_ps(_mm_mul_ps(t, p), _mm_set1_ps(2.0f * 1.44269504f)));
+}
+
+// pow(1 - exp(-x * 0.5), 1 / 2.2), alpha forced to 1
+static __m128 ToneMap4(__m128 x)
+{
+    __m128 y = _mm_sub_ps(_mm_set1_ps(1.0f), Exp2f4(_mm_mul_ps(x, _mm_set1_ps(-0.5f * 1.44269504f))));
+
+    __m128 black = _mm_cmple_ps(y, _mm_set1_ps(1e-30f));
+    __m128 result = Exp2f4(_mm_mul_ps(Log2f4(_mm_max_ps(y, _mm_set1_ps(1e-30f))), _mm_set1_ps(1.0f / 2.2f)));
+    result = _mm_andnot_ps(black, result);
+
+    const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+    return _mm_or_ps(_mm_andnot_ps(alphaMask, result), _mm_and_ps(alphaMask, _mm_set1_ps(1.0f)));
+}
+#endif
+
+static void ConvertRows(void* userData, int start, int end, int batchIndex)
+{
+    BloomPass* pass = (BloomPass*)userData;
+    (void)batchIndex;
+
+    int width = pass->bloom->width;
+    const uint8_t* source = pass->convert + (size_t)start * width * 4;
+    float* dest = pass->bloom->scratch + (size_t)start * width * 4;
+
+    int i = 0;
+    int count = (end - start) * width;
+#if FASTMATH_SSE
+    const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(source + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+        _mm_storeu_ps(dest + i * 4 + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+        _mm_storeu_ps(dest + i * 4 + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+        _mm_storeu_ps(dest + i * 4 + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+        _mm_storeu_ps(dest + i * 4 + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+    }
+#endif
+
+    for (i *= 4; i < count * 4; i++)
+    {
+        dest[i] = source[i] * (1.0f / 255.0f);
+    }
+}
+
+static void BloomRows(void* userData, int start, int end, int batchIndex)
+{
+    BloomPass* pass = (BloomPass*)userData;
+    const Bloom* bloom = pass->bloom;
+    (void)batchIndex;
+
+    const int width = bloom->width;
+    const int height = bloom->height;
+
+    // Interior columns read their taps without wrapping
+    int minX = 0, maxX = width;
+    for (int i = 0; i < BLOOM_TAPS; i++)
+    {
+        minX = -bloom->tapsX[BLOOM_TAPS + i] > minX ? -bloom->tapsX[BLOOM_TAPS + i] : minX;
+        maxX = width - bloom->tapsX[i] < maxX ? width - bloom->tapsX[i] : maxX;
+    }
+
+    for (int y = start; y < end; y++)
+    {
+        const float* row = pass->source + (size_t)y * width * 4;
+        const float* rowsY[BLOOM_TAPS * 2];
+        for (int i = 0; i < BLOOM_TAPS * 2; i++)
+        {
+            rowsY[i] = pass->source + (size_t)Wrap(y + bloom->tapsY[i], height) * width * 4;
+        }
+
+        for (int x = 0; x < width; x++)
+        {
+            int columns[BLOOM_TAPS * 2];
+            bool inside = x >= minX && x < maxX;
+            for (int i = 0; i < BLOOM_TAPS * 2; i++)
+            {
+                columns[i] = (inside ? x + bloom->tapsX[i] : Wrap(x + bloom->tapsX[i], width)) * 4;
+            }
+
+#if FASTMATH_SSE
+            __m128 center = _mm_loadu_ps(row + x * 4);
+            __m128 result = _mm_add_ps(center, _mm_mul_ps(center, _mm_set1_ps(bloomWeights[0])));
+            for (int i = 0; i < BLOOM_TAPS; i++)
+            {
+                __m128 sum = _mm_add_ps(
+                    _mm_add_ps(_mm_loadu_ps(row + columns[i]), _mm_loadu_ps(row + columns[BLOOM_TAPS + i])),
+                    _mm_add_ps(_mm_loadu_ps(rowsY[i] + x * 4), _mm_loadu_ps(rowsY[BLOOM_TAPS + i] + x * 4)));
+                result = _mm_add_ps(result, _mm_mul_ps(sum, _mm_set1_ps(bloomWeights[i + 1])));
+            }
+
+            result = ToneMap4(result);
+            if (pass->dest8)
+            {
+                __m128i value = _mm_cvtps_epi32(_mm_mul_ps(result, _mm_set1_ps(255.0f)));
+                value = _mm_packs_epi32(value, value);
+                value = _mm_packus_epi16(value, value);
+                *(int*)(pass->dest8 + ((size_t)y * width + x) * 4) = _mm_cvtsi128_si32(value);
+            }
+            else
+            {
+                _mm_storeu_ps(pass->destFloat + ((size_t)y * width + x) * 4, result);
+            }
+#else
+            float result[4];
+            for (int c = 0; c < 4; c++)
+            {
+                float value = row[x * 4 + c] * (1.0f + bloomWeights[0]);
+                for (int i = 0; i < BLOOM_TAPS; i++)
+                {
+                    float sum = row[columns[i] + c] + row[columns[BLOOM_TAPS + i] + c] + rowsY[i][x * 4 + c] + rowsY[BLOOM_TAPS + i][x * 4 + c];
+                    value += sum * bloomWeights[i + 1];
+                }
+
+                result[c] = c == 3 ? 1.0f : powf(1.0f - expf(-value * 0.5f), 1.0f / 2.2f);
+            }
+
+            for (int c = 0; c < 4; c++)
+            {
+                if (pass->dest8)
+                {
+                    pass->dest8[((size_t)y * width + x) * 4 + c] = (uint8_t)(result[c] * 255.0f + 0.5f);
+                }
+                else
+                {
+                    pass->destFloat[((size_t)y * width + x) * 4 + c] = result[c];
+                }
+            }
+#endif
+        }
+    }
+}
+
+void BloomApplyRGBA8(Bloom* bloom, const uint8_t* source, uint8_t* dest)
+{
+    BloomPass pass = { bloom, bloom->scratch, dest, NULL, source };
+    ParallelFor(bloom->height, BLOOM_BATCH_ROWS, ConvertRows, &pass);
+    ParallelFor(bloom->height, BLOOM_BATCH_ROWS, BloomRows, &pass);
+}
+
+void BloomApplyFloat(Bloom* bloom, const float* source, float* dest)
+{
+    BloomPass pass = { bloom, source, NULL, dest, NULL };
+    ParallelFor(bloom->height, BLOOM_BATCH_ROWS, BloomRows, &pass);
+}
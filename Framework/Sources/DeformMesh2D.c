@@ -0,0 +1,368 @@
+#include "DeformMesh2D.h"
+#include "FastMath.h"
+#include "JobSystem.h"
+
+#include <math.h>
+
+#define TILE_SIZE DEFORM_MESH_2D_TILE_SIZE
+
+typedef struct DeformMesh2DPass
+{
+    DeformMesh2D                mesh;
+    float                       dt;
+
+    const DeformMesh2DForce*    forces;
+    int                         forceCount;
+    int                         tileRowStart;   // First tile row of the batches
+} DeformMesh2DPass;
+
+DeformMesh2D DeformMesh2DNew(Rectangle bounds, Vector2 spacing, float springForce, float damping)
+{
+    int cols = (int)(bounds.width / spacing.x) + 2;
+    int rows = (int)(bounds.height / spacing.y) + 2;
+
+    int vertexCount = cols * rows;
+    int tileCols = (cols + TILE_SIZE - 1) / TILE_SIZE;
+    int tileRows = (rows + TILE_SIZE - 1) / TILE_SIZE;
+
+    DeformMesh2D mesh = {
+        .width = cols,
+        .height = rows,
+
+        .cellWidth = spacing.x,
+        .cellHeight = spacing.y,
+
+        .damping = damping,
+        .springForce = springForce,
+
+        .sleepSpeed = 1.0f,
+        .sleepDisplacement = 0.1f,
+
+        .positionX = ArrayNew(float, vertexCount),
+        .positionY = ArrayNew(float, vertexCount),
+        .velocityX = ArrayNew(float, vertexCount),
+        .velocityY = ArrayNew(float, vertexCount),
+        .originX = ArrayNew(float, vertexCount),
+        .originY = ArrayNew(float, vertexCount),
+
+        .tileCols = tileCols,
+        .tileRows = tileRows,
+        .tileAwake = ArrayNew(bool, tileCols * tileRows),
+    };
+
+    if (!mesh.positionX || !mesh.positionY || !mesh.velocityX || !mesh.velocityY || !mesh.originX || !mesh.originY || !mesh.tileAwake)
+    {
+        DeformMesh2DFree(&mesh);
+        return mesh;
+    }
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            int index = i * cols + j;
+            float x = bounds.x + j * spacing.x;
+            float y = bounds.y + i * spacing.y;
+
+            mesh.positionX[index] = x;
+            mesh.positionY[index] = y;
+            mesh.velocityX[index] = 0.0f;
+            mesh.velocityY[index] = 0.0f;
+            mesh.originX[index] = x;
+            mesh.originY[index] = y;
+        }
+    }
+
+    // Mesh start at rest, every tile sleep until a force touch it
+    for (int i = 0, n = tileCols * tileRows; i < n; i++)
+    {
+        mesh.tileAwake[i] = false;
+    }
+
+    return mesh;
+}
+
+void DeformMesh2DFree(DeformMesh2D* mesh)
+{
+    ArrayFree(mesh->positionX);
+    ArrayFree(mesh->positionY);
+    ArrayFree(mesh->velocityX);
+    ArrayFree(mesh->velocityY);
+    ArrayFree(mesh->originX);
+    ArrayFree(mesh->originY);
+    ArrayFree(mesh->tileAwake);
+    *mesh = (DeformMesh2D) { 0 };
+}
+
+bool DeformMesh2DIsValid(DeformMesh2D mesh)
+{
+    return mesh.width > 0 && mesh.positionX != NULL;
+}
+
+// Integrate vertices [start, end), x and y follow the same equation on their own arrays
+static void UpdateVertices(DeformMesh2D mesh, int start, int end, float dt)
+{
+    const float spring = mesh.springForce * dt;
+    const float factor = fmaxf(0.0f, 1.0f - mesh.damping * dt);
+
+    int i = start;
+#if FASTMATH_SSE
+    // Same operations in the same order as the scalar tail, so the result does not depend on the alignment of the range
+    const __m128 spring4 = _mm_set1_ps(spring);
+    const __m128 factor4 = _mm_set1_ps(factor);
+    const __m128 dt4 = _mm_set1_ps(dt);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(mesh.positionX + i);
+        __m128 vx = _mm_loadu_ps(mesh.velocityX + i);
+        vx = _mm_mul_ps(_mm_sub_ps(vx, _mm_mul_ps(_mm_sub_ps(x, _mm_loadu_ps(mesh.originX + i)), spring4)), factor4);
+        _mm_storeu_ps(mesh.velocityX + i, vx);
+        _mm_storeu_ps(mesh.positionX + i, _mm_add_ps(x, _mm_mul_ps(vx, dt4)));
+
+        __m128 y = _mm_loadu_ps(mesh.positionY + i);
+        __m128 vy = _mm_loadu_ps(mesh.velocityY + i);
+        vy = _mm_mul_ps(_mm_sub_ps(vy, _mm_mul_ps(_mm_sub_ps(y, _mm_loadu_ps(mesh.originY + i)), spring4)), factor4);
+        _mm_storeu_ps(mesh.velocityY + i, vy);
+        _mm_storeu_ps(mesh.positionY + i, _mm_add_ps(y, _mm_mul_ps(vy, dt4)));
+    }
+#endif
+
+    for (; i < end; i++)
+    {
+        float vx = (mesh.velocityX[i] - (mesh.positionX[i] - mesh.originX[i]) * spring) * factor;
+        float vy = (mesh.velocityY[i] - (mesh.positionY[i] - mesh.originY[i]) * spring) * factor;
+
+        mesh.velocityX[i] = vx;
+        mesh.velocityY[i] = vy;
+        mesh.positionX[i] += vx * dt;
+        mesh.positionY[i] += vy * dt;
+    }
+}
+
+// Every vertex of the tile slower and closer to its origin than the sleep thresholds, the tile is still in the cache
+static bool IsTileSettled(DeformMesh2D mesh, int rowStart, int rowEnd, int colStart, int colEnd)
+{
+    float sleepSpeedSq = mesh.sleepSpeed * mesh.sleepSpeed;
+    float sleepDisplacementSq = mesh.sleepDisplacement * mesh.sleepDisplacement;
+
+    for (int i = rowStart; i < rowEnd; i++)
+    {
+        for (int j = colStart; j < colEnd; j++)
+        {
+            int index = i * mesh.width + j;
+            float vx = mesh.velocityX[index];
+            float vy = mesh.velocityY[index];
+            float dx = mesh.positionX[index] - mesh.originX[index];
+            float dy = mesh.positionY[index] - mesh.originY[index];
+            if (vx * vx + vy * vy >= sleepSpeedSq || dx * dx + dy * dy >= sleepDisplacementSq)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// A batch is a row of tiles, tiles are only written by their batch
+static void UpdateTileRows(void* userData, int start, int end, int batchIndex)
+{
+    (void)batchIndex;
+
+    const DeformMesh2DPass* pass = (const DeformMesh2DPass*)userData;
+    DeformMesh2D mesh = pass->mesh;
+
+    for (int tileY = start; tileY < end; tileY++)
+    {
+        int rowStart = tileY * TILE_SIZE;
+        int rowEnd = rowStart + TILE_SIZE < mesh.height ? rowStart + TILE_SIZE : mesh.height;
+
+        // Without sleeping the rows are updated at once
+        if (mesh.sleepSpeed <= 0.0f)
+        {
+            UpdateVertices(mesh, rowStart * mesh.width, rowEnd * mesh.width, pass->dt);
+            continue;
+        }
+
+        for (int tileX = 0; tileX < mesh.tileCols; tileX++)
+        {
+            int tile = tileY * mesh.tileCols + tileX;
+            if (!mesh.tileAwake[tile])
+            {
+                continue;
+            }
+
+            int colStart = tileX * TILE_SIZE;
+            int colEnd = colStart + TILE_SIZE < mesh.width ? colStart + TILE_SIZE : mesh.width;
+
+            for (int i = rowStart; i < rowEnd; i++)
+            {
+                UpdateVertices(mesh, i * mesh.width + colStart, i * mesh.width + colEnd, pass->dt);
+            }
+
+            // Vertices have no neighbors, a settled tile snap to its origin and stop
+            if (IsTileSettled(mesh, rowStart, rowEnd, colStart, colEnd))
+            {
+                for (int i = rowStart; i < rowEnd; i++)
+                {
+                    for (int j = colStart; j < colEnd; j++)
+                    {
+                        int index = i * mesh.width + j;
+                        mesh.velocityX[index] = 0.0f;
+                        mesh.velocityY[index] = 0.0f;
+                        mesh.positionX[index] = mesh.originX[index];
+                        mesh.positionY[index] = mesh.originY[index];
+                    }
+                }
+
+                mesh.tileAwake[tile] = false;
+            }
+        }
+    }
+}
+
+void DeformMesh2DUpdate(DeformMesh2D mesh, float dt)
+{
+    DeformMesh2DPass pass = { .mesh = mesh, .dt = dt };
+    ParallelFor(mesh.tileRows, 1, UpdateTileRows, &pass);
+}
+
+// Vertices around a force on the rest lattice, [row0, row1) x [col0, col1), empty when row0 == row1
+// A vertex displaced by more than a cell into the radius from outside is not seen
+typedef struct DeformMesh2DRange
+{
+    int row0, row1;
+    int col0, col1;
+} DeformMesh2DRange;
+
+// Lattice line at or before position, clamped to [0, count], positions are relative to the first vertex
+static int LatticeIndex(float position, float spacing, int count)
+{
+    return (int)fmaxf(0.0f, fminf((float)count, floorf(position / spacing)));
+}
+
+static DeformMesh2DRange ForceRange(DeformMesh2D mesh, DeformMesh2DForce force)
+{
+    float reach = force.radius + fmaxf(mesh.cellWidth, mesh.cellHeight);
+    float x = force.position.x - mesh.originX[0];
+    float y = force.position.y - mesh.originY[0];
+
+    DeformMesh2DRange range;
+    range.row0 = LatticeIndex(y - reach, mesh.cellHeight, mesh.height);
+    range.row1 = LatticeIndex(y + reach + mesh.cellHeight, mesh.cellHeight, mesh.height);
+    range.col0 = LatticeIndex(x - reach, mesh.cellWidth, mesh.width);
+    range.col1 = LatticeIndex(x + reach + mesh.cellWidth, mesh.cellWidth, mesh.width);
+    if (range.row0 >= range.row1 || range.col0 >= range.col1)
+    {
+        range.row1 = range.row0;
+    }
+    return range;
+}
+
+// Every force of the batch rows in one pass, forces add up in their order
+static void ApplyForceTileRows(void* userData, int start, int end, int batchIndex)
+{
+    (void)batchIndex;
+
+    const DeformMesh2DPass* pass = (const DeformMesh2DPass*)userData;
+    DeformMesh2D mesh = pass->mesh;
+    bool sleeping = mesh.sleepSpeed > 0.0f;
+
+    int batchRow0 = (pass->tileRowStart + start) * TILE_SIZE;
+    int batchRow1 = (pass->tileRowStart + end) * TILE_SIZE;
+    for (int f = 0; f < pass->forceCount; f++)
+    {
+        DeformMesh2DForce force = pass->forces[f];
+        DeformMesh2DRange range = ForceRange(mesh, force);
+
+        int row0 = range.row0 > batchRow0 ? range.row0 : batchRow0;
+        int row1 = range.row1 < batchRow1 ? range.row1 : batchRow1;
+        for (int i = row0; i < row1; i++)
+        {
+            for (int j = range.col0; j < range.col1; j++)
+            {
+                int index = i * mesh.width + j;
+
+                Vector2 pointToVertex = { mesh.positionX[index] - force.position.x, mesh.positionY[index] - force.position.y };
+                float lengthSq = pointToVertex.x * pointToVertex.x + pointToVertex.y * pointToVertex.y;
+
+                // A vertex right under the force has no direction to go
+                if (lengthSq >= force.radius * force.radius || lengthSq <= 0.0f)
+                {
+                    continue;
+                }
+
+                float length = sqrtf(lengthSq);
+                float impulse = force.force / (1.0f + length) * pass->dt;
+
+                // Far vertices get a tiny push, only wake the tiles the force really move
+                int tile = (i / TILE_SIZE) * mesh.tileCols + j / TILE_SIZE;
+                if (sleeping && !mesh.tileAwake[tile])
+                {
+                    if (impulse < DEFORM_MESH_2D_WAKE_IMPULSE)
+                    {
+                        continue;
+                    }
+                    mesh.tileAwake[tile] = true;
+                }
+
+                float scale = impulse / length;
+                mesh.velocityX[index] += pointToVertex.x * scale;
+                mesh.velocityY[index] += pointToVertex.y * scale;
+            }
+        }
+    }
+}
+
+void DeformMesh2DApplyForce(DeformMesh2D mesh, float force, Vector2 position, float radius, float dt)
+{
+    DeformMesh2DForce source = { position, force, radius };
+    DeformMesh2DApplyForces(mesh, &source, 1, dt);
+}
+
+void DeformMesh2DApplyForces(DeformMesh2D mesh, const DeformMesh2DForce* forces, int count, float dt)
+{
+    if (!DeformMesh2DIsValid(mesh))
+    {
+        return;
+    }
+
+    // Only the tile rows under a force are visited
+    int row0 = mesh.height, row1 = 0;
+    for (int f = 0; f < count; f++)
+    {
+        DeformMesh2DRange range = ForceRange(mesh, forces[f]);
+        if (range.row0 < range.row1)
+        {
+            row0 = range.row0 < row0 ? range.row0 : row0;
+            row1 = range.row1 > row1 ? range.row1 : row1;
+        }
+    }
+
+    if (row0 >= row1)
+    {
+        return;
+    }
+
+    int tileRowStart = row0 / TILE_SIZE;
+    int tileRowEnd = (row1 + TILE_SIZE - 1) / TILE_SIZE;
+
+    DeformMesh2DPass pass = { .mesh = mesh, .dt = dt, .forces = forces, .forceCount = count, .tileRowStart = tileRowStart };
+    ParallelFor(tileRowEnd - tileRowStart, 1, ApplyForceTileRows, &pass);
+}
+
+int DeformMesh2DAwakeTileCount(DeformMesh2D mesh)
+{
+    int tileCount = mesh.tileCols * mesh.tileRows;
+    if (mesh.sleepSpeed <= 0.0f)
+    {
+        return tileCount;
+    }
+
+    int awakeTiles = 0;
+    for (int i = 0; i < tileCount; i++)
+    {
+        awakeTiles += mesh.tileAwake[i];
+    }
+    return awakeTiles;
+}
@@ -0,0 +1,335 @@
+#include "FileWatcher.h"
+#include "Array.h"
+#include "Memory.h"
+#include "Debug.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#   include <windows.h>
+#elif defined(__linux__)
+#   include <dirent.h>
+#   include <errno.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/inotify.h>
+#   include <sys/stat.h>
+#   include <time.h>
+#endif
+
+#define MAX_WATCH_PATH      256
+#define EVENT_BUFFER_SIZE   (16 * 1024)
+
+typedef struct WatchPath
+{
+    char    path[MAX_WATCH_PATH];
+    double  time;                   // Of the last event on the file
+} WatchPath;
+
+#if defined(__linux__)
+typedef struct WatchDirectory
+{
+    int     descriptor;
+    char    path[MAX_WATCH_PATH];   // Relative to the root, empty for the root
+} WatchDirectory;
+#endif
+
+struct FileWatcher
+{
+    char                    directory[MAX_WATCH_PATH];
+    Array(WatchPath)        changes;
+
+#if defined(_WIN32)
+    HANDLE                  handle;
+    OVERLAPPED              overlapped;
+    DWORD                   buffer[EVENT_BUFFER_SIZE / sizeof(DWORD)];
+#elif defined(__linux__)
+    int                     fd;
+    Array(WatchDirectory)   directories;
+    char                    buffer[EVENT_BUFFER_SIZE];
+#endif
+};
+
+static double GetWatchTime(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Editors save by writing a temporary then renaming it, and emit several events per save
+// The events of one save may come over several polls, the debounce restart on each of them
+static void AddChange(FileWatcher* watcher, const char* path)
+{
+    double now = GetWatchTime();
+    for (int i = 0, n = ArrayCount(watcher->changes); i < n; i++)
+    {
+        if (strcmp(watcher->changes[i].path, path) == 0)
+        {
+            watcher->changes[i].time = now;
+            return;
+        }
+    }
+
+    WatchPath change;
+    change.time = now;
+    snprintf(change.path, sizeof(change.path), "%s", path);
+    for (char* c = change.path; *c; c++)
+    {
+        if (*c == '\\') *c = '/';
+    }
+
+    ArrayPush(watcher->changes, change);
+}
+
+#if defined(_WIN32)
+static bool BeginRead(FileWatcher* watcher)
+{
+    ResetEvent(watcher->overlapped.hEvent);
+    return ReadDirectoryChangesW(watcher->handle, watcher->buffer, sizeof(watcher->buffer), TRUE,
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, NULL, &watcher->overlapped, NULL) != 0;
+}
+
+static void ReadEvents(FileWatcher* watcher)
+{
+    DWORD size = 0;
+    while (GetOverlappedResult(watcher->handle, &watcher->overlapped, &size, FALSE))
+    {
+        const uint8_t* cursor = (const uint8_t*)watcher->buffer;
+        while (size > 0)
+        {
+            const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)cursor;
+            if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+            {
+                char path[MAX_WATCH_PATH];
+                int length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, (int)(info->FileNameLength / sizeof(WCHAR)), path, sizeof(path) - 1, NULL, NULL);
+                path[length] = 0;
+                AddChange(watcher, path);
+            }
+
+            if (info->NextEntryOffset == 0)
+            {
+                break;
+            }
+            cursor += info->NextEntryOffset;
+        }
+
+        if (!BeginRead(watcher))
+        {
+            break;
+        }
+    }
+}
+#elif defined(__linux__)
+static void AddWatches(FileWatcher* watcher, const char* relative)
+{
+    char directory[MAX_WATCH_PATH * 2];
+    snprintf(directory, sizeof(directory), relative[0] ? "%s/%s" : "%s", watcher->directory, relative);
+
+    WatchDirectory watch;
+    watch.descriptor = inotify_add_watch(watcher->fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (watch.descriptor < 0)
+    {
+        return;
+    }
+    snprintf(watch.path, sizeof(watch.path), "%s", relative);
+    ArrayPush(watcher->directories, watch);
+
+    DIR* dir = opendir(directory);
+    if (!dir)
+    {
+        return;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        char child[MAX_WATCH_PATH * 2];
+        int childLength = snprintf(child, sizeof(child), "%s/%s", directory, entry->d_name);
+        if (childLength < 0 || childLength >= (int)sizeof(child))
+        {
+            continue;
+        }
+
+        struct stat info;
+        if (stat(child, &info) == 0 && S_ISDIR(info.st_mode))
+        {
+            // A truncated path would watch the directory under the wrong name, its changes would never match
+            char childRelative[MAX_WATCH_PATH];
+            int relativeLength = snprintf(childRelative, sizeof(childRelative), relative[0] ? "%s/%s" : "%s%s", relative, entry->d_name);
+            if (relativeLength < 0 || relativeLength >= (int)sizeof(childRelative))
+            {
+                DebugPrint("Path too long, not watched: %s", child);
+                continue;
+            }
+            AddWatches(watcher, childRelative);
+        }
+    }
+
+    closedir(dir);
+}
+
+static const char* FindWatchPath(FileWatcher* watcher, int descriptor)
+{
+    for (int i = 0, n = ArrayCount(watcher->directories); i < n; i++)
+    {
+        if (watcher->directories[i].descriptor == descriptor)
+        {
+            return watcher->directories[i].path;
+        }
+    }
+
+    return NULL;
+}
+
+static void ReadEvents(FileWatcher* watcher)
+{
+    for (;;)
+    {
+        ssize_t size = read(watcher->fd, watcher->buffer, sizeof(watcher->buffer));
+        if (size <= 0)
+        {
+            break;
+        }
+
+        for (char* cursor = watcher->buffer; cursor < watcher->buffer + size; )
+        {
+            const struct inotify_event* event = (const struct inotify_event*)cursor;
+            cursor += sizeof(struct inotify_event) + event->len;
+
+            const char* directory = FindWatchPath(watcher, event->wd);
+            if (!directory || event->len == 0)
+            {
+                continue;
+            }
+
+            char path[MAX_WATCH_PATH];
+            snprintf(path, sizeof(path), directory[0] ? "%s/%s" : "%s%s", directory, event->name);
+
+            if (event->mask & IN_ISDIR)
+            {
+                // New sub directory, its files are reported from now on
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    AddWatches(watcher, path);
+                }
+            }
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+            {
+                AddChange(watcher, path);
+            }
+        }
+    }
+}
+#endif
+
+FileWatcher* FileWatcherCreate(const char* directory)
+{
+    FileWatcher* watcher = (FileWatcher*)MemoryAlloc(sizeof(FileWatcher));
+    MemoryInit(watcher, 0, sizeof(FileWatcher));
+    snprintf(watcher->directory, sizeof(watcher->directory), "%s", directory);
+
+#if defined(_WIN32)
+    watcher->handle = CreateFileA(directory, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    watcher->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+
+    if (watcher->handle == INVALID_HANDLE_VALUE || !watcher->overlapped.hEvent || !BeginRead(watcher))
+    {
+        FileWatcherDestroy(watcher);
+        return NULL;
+    }
+#elif defined(__linux__)
+    watcher->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher->fd < 0)
+    {
+        MemoryFree(watcher);
+        return NULL;
+    }
+
+    AddWatches(watcher, "");
+    if (ArrayCount(watcher->directories) == 0)
+    {
+        FileWatcherDestroy(watcher);
+        return NULL;
+    }
+#else
+    // No native notification on this platform
+    MemoryFree(watcher);
+    return NULL;
+#endif
+
+    return watcher;
+}
+
+void FileWatcherDestroy(FileWatcher* watcher)
+{
+    if (!watcher)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    if (watcher->handle != INVALID_HANDLE_VALUE)
+    {
+        CancelIo(watcher->handle);
+        CloseHandle(watcher->handle);
+    }
+
+    if (watcher->overlapped.hEvent)
+    {
+        CloseHandle(watcher->overlapped.hEvent);
+    }
+#elif defined(__linux__)
+    close(watcher->fd);
+    ArrayFree(watcher->directories);
+#endif
+
+    ArrayFree(watcher->changes);
+    MemoryFree(watcher);
+}
+
+int FileWatcherPoll(FileWatcher* watcher, FileChangedFunc* func, void* userData)
+{
+    if (!watcher)
+    {
+        return 0;
+    }
+
+#if defined(_WIN32) || defined(__linux__)
+    ReadEvents(watcher);
+#endif
+
+    double now = GetWatchTime();
+    int count = 0;
+    for (int i = 0; i < ArrayCount(watcher->changes); )
+    {
+        WatchPath change = watcher->changes[i];
+        if (now - change.time < FILE_WATCHER_DEBOUNCE)
+        {
+            i++;
+            continue;
+        }
+
+        // Copied out, the array is compacted under it
+        ArrayErase(watcher->changes, i);
+        func(userData, change.path);
+        count++;
+    }
+
+    return count;
+}
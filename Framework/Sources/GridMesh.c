@@ -0,0 +1,181 @@
+#include "GridMesh.h"
+#include "Memory.h"
+#include "JobSystem.h"
+
+#define GRID_MESH_BATCH_ROWS 32
+
+typedef struct GridMeshPass
+{
+    GridMesh        mesh;
+    const Vector2*  positions;
+    const float*    prevX;
+    const float*    prevY;
+    const float*    x;
+    const float*    y;
+    float           alpha;
+} GridMeshPass;
+
+GridMesh GridMeshNew(int cols, int rows, Color color)
+{
+    if (cols < 2 || rows < 2)
+    {
+        return (GridMesh) { 0 };
+    }
+
+    int vertexCount = cols * rows;
+    int indexCount = (cols - 1) * (rows - 1) * 6;
+
+    // Vertices first, the indices after keep both aligned
+    size_t size = sizeof(RendererVertex) * vertexCount + sizeof(uint32_t) * indexCount;
+    RendererVertex* block = (RendererVertex*)MemoryAlloc(size);
+    if (!block)
+    {
+        return (GridMesh) { 0 };
+    }
+
+    GridMesh mesh = {
+        .cols = cols,
+        .rows = rows,
+        .vertexCount = vertexCount,
+        .indexCount = indexCount,
+
+        .vertices = block,
+        .indices = (uint32_t*)(block + vertexCount),
+    };
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            float u = (float)j / (float)(cols - 1);
+            float v = (float)i / (float)(rows - 1);
+            mesh.vertices[i * cols + j] = (RendererVertex) { 0.0f, 0.0f, u, v, color };
+        }
+    }
+
+    // Corners in order top left, bottom left, bottom right, top right, like the Renderer quads
+    uint32_t* index = mesh.indices;
+    for (int i = 0; i < rows - 1; i++)
+    {
+        for (int j = 0; j < cols - 1; j++)
+        {
+            uint32_t topLeft = (uint32_t)(i * cols + j);
+            uint32_t bottomLeft = topLeft + (uint32_t)cols;
+
+            *index++ = topLeft;
+            *index++ = bottomLeft;
+            *index++ = bottomLeft + 1;
+            *index++ = topLeft;
+            *index++ = bottomLeft + 1;
+            *index++ = topLeft + 1;
+        }
+    }
+
+    mesh.drawMesh = RendererMeshNew(mesh.vertices, vertexCount, mesh.indices, indexCount);
+    if (!RendererMeshIsValid(mesh.drawMesh))
+    {
+        MemoryFree(block);
+        return (GridMesh) { 0 };
+    }
+
+    return mesh;
+}
+
+void GridMeshFree(GridMesh* mesh)
+{
+    // The indices live in the block of the vertices
+    RendererMeshFree(&mesh->drawMesh);
+    MemoryFree(mesh->vertices);
+    *mesh = (GridMesh) { 0 };
+}
+
+bool GridMeshIsValid(GridMesh mesh)
+{
+    return mesh.vertexCount > 0 && mesh.vertices != NULL;
+}
+
+static void CopyPositionRows(void* userData, int start, int end, int batchIndex)
+{
+    (void)batchIndex;
+
+    const GridMeshPass* pass = (const GridMeshPass*)userData;
+    RendererVertex* vertices = pass->mesh.vertices;
+
+    for (int i = start * pass->mesh.cols, n = end * pass->mesh.cols; i < n; i++)
+    {
+        vertices[i].x = pass->positions[i].x;
+        vertices[i].y = pass->positions[i].y;
+    }
+}
+
+void GridMeshSetPositions(GridMesh mesh, const Vector2* positions)
+{
+    GridMeshPass pass = { .mesh = mesh, .positions = positions };
+    ParallelFor(mesh.rows, GRID_MESH_BATCH_ROWS, CopyPositionRows, &pass);
+}
+
+static void CopyPositionRowsXY(void* userData, int start, int end, int batchIndex)
+{
+    (void)batchIndex;
+
+    const GridMeshPass* pass = (const GridMeshPass*)userData;
+    RendererVertex* vertices = pass->mesh.vertices;
+
+    for (int i = start * pass->mesh.cols, n = end * pass->mesh.cols; i < n; i++)
+    {
+        vertices[i].x = pass->x[i];
+        vertices[i].y = pass->y[i];
+    }
+}
+
+void GridMeshSetPositionsXY(GridMesh mesh, const float* x, const float* y)
+{
+    GridMeshPass pass = { .mesh = mesh, .x = x, .y = y };
+    ParallelFor(mesh.rows, GRID_MESH_BATCH_ROWS, CopyPositionRowsXY, &pass);
+}
+
+static void LerpPositionRows(void* userData, int start, int end, int batchIndex)
+{
+    (void)batchIndex;
+
+    const GridMeshPass* pass = (const GridMeshPass*)userData;
+    RendererVertex* vertices = pass->mesh.vertices;
+    float alpha = pass->alpha;
+
+    for (int i = start * pass->mesh.cols, n = end * pass->mesh.cols; i < n; i++)
+    {
+        vertices[i].x = pass->prevX[i] + (pass->x[i] - pass->prevX[i]) * alpha;
+        vertices[i].y = pass->prevY[i] + (pass->y[i] - pass->prevY[i]) * alpha;
+    }
+}
+
+void GridMeshSetPositionsLerp(GridMesh mesh, const float* prevX, const float* prevY, const float* x, const float* y, float alpha)
+{
+    GridMeshPass pass = { .mesh = mesh, .prevX = prevX, .prevY = prevY, .x = x, .y = y, .alpha = alpha };
+    ParallelFor(mesh.rows, GRID_MESH_BATCH_ROWS, LerpPositionRows, &pass);
+}
+
+void GridMeshDraw(GridMesh mesh, Texture texture)
+{
+    RendererDrawMesh(mesh.drawMesh, texture.id, mesh.vertices);
+}
+
+Image GridMeshGenLinesImage(GridMesh mesh, int cellWidth, int cellHeight, Color lineColor, Color background)
+{
+    int width = (mesh.cols - 1) * cellWidth + 1;
+    int height = (mesh.rows - 1) * cellHeight + 1;
+
+    Image image = GenImageColor(width, height, background);
+    Color* pixels = (Color*)image.data;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            if (x % cellWidth == 0 || y % cellHeight == 0)
+            {
+                pixels[y * width + x] = lineColor;
+            }
+        }
+    }
+    return image;
+}
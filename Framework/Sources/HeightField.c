@@ -0,0 +1,340 @@
+#include "HeightField.h"
+#include "Memory.h"
+#include "FastMath.h"
+#include "JobSystem.h"
+
+#include <math.h>
+
+#define STABLE_MARGIN   0.95f   // Fraction of the stable limit the clamped wave speed reach
+#define QUANT_MAX       32767.0f
+
+typedef struct HeightFieldPass
+{
+    HeightField     field;
+    float           courant;    // Squared cells the waves travel per update
+    float           factor;     // Velocity kept per update
+
+    float           alpha;
+    float           refraction;
+    Vector2*        positions;
+} HeightFieldPass;
+
+static int PadToLanes(int count)
+{
+    return (count + 3) & ~3;
+}
+
+// Nearest unit, saturated at the int16 range like the packed results of the update
+static inline int16_t QuantizeHeight(float units)
+{
+    return (int16_t)lrintf(fmaxf(-QUANT_MAX - 1.0f, fminf(QUANT_MAX, units)));
+}
+
+HeightField HeightFieldNew(int cols, int rows, Vector2 origin, Vector2 spacing, float waveSpeed, float damping)
+{
+    if (cols < 3 || rows < 3)
+    {
+        return (HeightField) { 0 };
+    }
+
+    int count = cols * rows;
+    int stride = PadToLanes(count);
+
+    // Surface start flat, at rest
+    size_t size = sizeof(float) * 2 * stride;
+    float* block = (float*)MemoryAlloc(size);
+    if (!block)
+    {
+        return (HeightField) { 0 };
+    }
+    MemoryInit(block, 0, size);
+
+    return (HeightField) {
+        .cols = cols,
+        .rows = rows,
+        .count = count,
+        .origin = origin,
+        .spacing = spacing,
+
+        .waveSpeed = waveSpeed,
+        .damping = damping,
+
+        .height = block,
+        .prevHeight = block + stride,
+    };
+}
+
+HeightField HeightFieldNewQuantized(int cols, int rows, Vector2 origin, Vector2 spacing, float waveSpeed, float damping, float heightStep)
+{
+    if (cols < 3 || rows < 3 || !(heightStep > 0.0f))
+    {
+        return (HeightField) { 0 };
+    }
+
+    int count = cols * rows;
+    int stride = (count + 7) & ~7;  // 8 int16 lanes
+
+    size_t size = sizeof(int16_t) * 2 * stride;
+    int16_t* block = (int16_t*)MemoryAlloc(size);
+    if (!block)
+    {
+        return (HeightField) { 0 };
+    }
+    MemoryInit(block, 0, size);
+
+    return (HeightField) {
+        .cols = cols,
+        .rows = rows,
+        .count = count,
+        .origin = origin,
+        .spacing = spacing,
+
+        .waveSpeed = waveSpeed,
+        .damping = damping,
+        .heightStep = heightStep,
+
+        .quantHeight = block,
+        .quantPrevHeight = block + stride,
+    };
+}
+
+void HeightFieldFree(HeightField* field)
+{
+    // Both buffers live in one block, the first one in memory may be either after the swaps
+    if (field->quantHeight)
+    {
+        MemoryFree(field->quantHeight < field->quantPrevHeight ? field->quantHeight : field->quantPrevHeight);
+    }
+    else
+    {
+        MemoryFree(field->height < field->prevHeight ? field->height : field->prevHeight);
+    }
+    *field = (HeightField) { 0 };
+}
+
+bool HeightFieldIsValid(HeightField field)
+{
+    return field.count > 0 && (field.height != NULL || field.quantHeight != NULL);
+}
+
+float HeightFieldGetHeight(HeightField field, int index)
+{
+    return field.quantHeight ? field.quantHeight[index] * field.heightStep : field.height[index];
+}
+
+// Interior points of rows [start, end) offset by the border row, the next heights overwrite the previous ones in place
+// A point read its own previous height only, so rows of different jobs never race
+static void UpdateRows(void* userData, int start, int end, int batchIndex)
+{
+    (void)batchIndex;
+
+    const HeightFieldPass* pass = (const HeightFieldPass*)userData;
+    const int cols = pass->field.cols;
+    const float courant = pass->courant;
+    const float factor = pass->factor;
+
+    for (int i = start + 1; i < end + 1; i++)
+    {
+        const float* height = pass->field.height + i * cols;
+        const float* above = height - cols;
+        const float* below = height + cols;
+        float* prev = pass->field.prevHeight + i * cols;
+
+        int j = 1;
+#if FASTMATH_SSE
+        const __m128 courant4 = _mm_set1_ps(courant);
+        const __m128 factor4 = _mm_set1_ps(factor);
+        const __m128 four = _mm_set1_ps(4.0f);
+        for (; j + 4 <= cols - 1; j += 4)
+        {
+            __m128 center = _mm_loadu_ps(height + j);
+            __m128 sides = _mm_add_ps(_mm_loadu_ps(height + j - 1), _mm_loadu_ps(height + j + 1));
+            __m128 laplacian = _mm_sub_ps(_mm_add_ps(sides, _mm_add_ps(_mm_loadu_ps(above + j), _mm_loadu_ps(below + j))), _mm_mul_ps(center, four));
+            __m128 velocity = _mm_mul_ps(_mm_sub_ps(center, _mm_loadu_ps(prev + j)), factor4);
+            _mm_storeu_ps(prev + j, _mm_add_ps(_mm_add_ps(center, velocity), _mm_mul_ps(laplacian, courant4)));
+        }
+#endif
+        for (; j < cols - 1; j++)
+        {
+            float center = height[j];
+            float laplacian = ((height[j - 1] + height[j + 1]) + (above[j] + below[j])) - center * 4.0f;
+            float velocity = (center - prev[j]) * factor;
+            prev[j] = (center + velocity) + laplacian * courant;
+        }
+    }
+}
+
+// Weights of the quantized update in 1/16384, the sums of the products stay under 3 * 2^29
+#define QUANT_SHIFT     14
+#define QUANT_ONE       (1 << QUANT_SHIFT)
+
+static inline int16_t SaturateHeight(int units)
+{
+    return (int16_t)(units < -32768 ? -32768 : units > 32767 ? 32767 : units);
+}
+
+// Same update in units of heightStep, it is linear so the step never enter the math
+// The stencil is regrouped as center * (1 + factor - 4 courant) - prev * factor + neighbors * courant, pairs of int16 go through pmaddwd
+// The weights are derived from the rounded courant and damping so they still sum to one, rounded one by one the surface drift away
+// The int32 sums are exact, the SSE loop and the scalar tail round the same way, only the int16 buffers are memory traffic
+static void UpdateQuantizedRows(void* userData, int start, int end, int batchIndex)
+{
+    (void)batchIndex;
+
+    const HeightFieldPass* pass = (const HeightFieldPass*)userData;
+    const int cols = pass->field.cols;
+    const int sideWeight = (int)lrintf(pass->courant * QUANT_ONE);
+    const int dampWeight = (int)lrintf((1.0f - pass->factor) * QUANT_ONE);
+    const int prevWeight = dampWeight - QUANT_ONE;
+    const int centerWeight = 2 * QUANT_ONE - 4 * sideWeight - dampWeight < 32767 ? 2 * QUANT_ONE - 4 * sideWeight - dampWeight : 32767;  // Clamped without waves nor damping
+    const int round = QUANT_ONE / 2;
+
+    for (int i = start + 1; i < end + 1; i++)
+    {
+        const int16_t* height = pass->field.quantHeight + i * cols;
+        const int16_t* above = height - cols;
+        const int16_t* below = height + cols;
+        int16_t* prev = pass->field.quantPrevHeight + i * cols;
+
+        int j = 1;
+#if FASTMATH_SSE
+        const __m128i centerPrev8 = _mm_set1_epi32((int)(((uint32_t)prevWeight << 16) | (uint16_t)centerWeight));
+        const __m128i sides8 = _mm_set1_epi32((int)(((uint32_t)sideWeight << 16) | (uint16_t)sideWeight));
+        const __m128i round4 = _mm_set1_epi32(round);
+        for (; j + 8 <= cols - 1; j += 8)
+        {
+            __m128i center = _mm_loadu_si128((const __m128i*)(height + j));
+            __m128i last = _mm_loadu_si128((const __m128i*)(prev + j));
+            __m128i left = _mm_loadu_si128((const __m128i*)(height + j - 1));
+            __m128i right = _mm_loadu_si128((const __m128i*)(height + j + 1));
+            __m128i up = _mm_loadu_si128((const __m128i*)(above + j));
+            __m128i down = _mm_loadu_si128((const __m128i*)(below + j));
+
+            __m128i low = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(center, last), centerPrev8), _mm_madd_epi16(_mm_unpacklo_epi16(left, right), sides8));
+            low = _mm_add_epi32(low, _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(up, down), sides8), round4));
+            __m128i high = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(center, last), centerPrev8), _mm_madd_epi16(_mm_unpackhi_epi16(left, right), sides8));
+            high = _mm_add_epi32(high, _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(up, down), sides8), round4));
+
+            _mm_storeu_si128((__m128i*)(prev + j), _mm_packs_epi32(_mm_srai_epi32(low, QUANT_SHIFT), _mm_srai_epi32(high, QUANT_SHIFT)));
+        }
+#endif
+        for (; j < cols - 1; j++)
+        {
+            int sum = (height[j] * centerWeight + prev[j] * prevWeight) + (height[j - 1] * sideWeight + height[j + 1] * sideWeight)
+                + ((above[j] * sideWeight + below[j] * sideWeight) + round);
+            prev[j] = SaturateHeight(sum >> QUANT_SHIFT);
+        }
+    }
+}
+
+void HeightFieldUpdate(HeightField* field, float timeStep)
+{
+    float cells = field->waveSpeed * timeStep;
+
+    // The checkerboard mode grow past (1 + factor) / 4 cells squared, 0.5 without damping
+    float factor = fmaxf(0.0f, 1.0f - field->damping * timeStep);
+    HeightFieldPass pass = {
+        .field = *field,
+        .courant = fminf(cells * cells, (1.0f + factor) * 0.25f * STABLE_MARGIN),
+        .factor = factor,
+    };
+    ParallelFor(field->rows - 2, HEIGHT_FIELD_BATCH_ROWS, field->quantHeight ? UpdateQuantizedRows : UpdateRows, &pass);
+
+    // The oldest buffer now hold the next heights
+    float* height = field->prevHeight;
+    field->prevHeight = field->height;
+    field->height = height;
+
+    int16_t* quantHeight = field->quantPrevHeight;
+    field->quantPrevHeight = field->quantHeight;
+    field->quantHeight = quantHeight;
+}
+
+// Lattice line at or before position, clamped to [0, count]
+static int LatticeIndex(float position, float spacing, int count)
+{
+    return (int)fmaxf(0.0f, fminf((float)count, floorf(position / spacing)));
+}
+
+void HeightFieldApplyForce(HeightField field, float force, Vector2 position, float radius, float timeStep)
+{
+    float x = position.x - field.origin.x;
+    float y = position.y - field.origin.y;
+
+    // Interior points only, the border stay at rest
+    int row0 = LatticeIndex(y - radius, field.spacing.y, field.rows - 1);
+    int row1 = LatticeIndex(y + radius + field.spacing.y, field.spacing.y, field.rows - 1);
+    int col0 = LatticeIndex(x - radius, field.spacing.x, field.cols - 1);
+    int col1 = LatticeIndex(x + radius + field.spacing.x, field.spacing.x, field.cols - 1);
+
+    // The force change the velocity, leapfrog keep it as the difference of the two buffers
+    float push = force * timeStep * timeStep;
+    float invRadiusSq = 1.0f / (radius * radius);
+    for (int i = row0 > 1 ? row0 : 1; i < row1; i++)
+    {
+        float dy = i * field.spacing.y - y;
+        for (int j = col0 > 1 ? col0 : 1; j < col1; j++)
+        {
+            float dx = j * field.spacing.x - x;
+            float t = 1.0f - (dx * dx + dy * dy) * invRadiusSq;
+            if (t > 0.0f && field.quantHeight)
+            {
+                int index = i * field.cols + j;
+                field.quantHeight[index] = QuantizeHeight(field.quantHeight[index] - push * t * t / field.heightStep);
+            }
+            else if (t > 0.0f)
+            {
+                field.height[i * field.cols + j] -= push * t * t;
+            }
+        }
+    }
+}
+
+static inline float RenderHeight(const HeightField* field, int index, float alpha)
+{
+    if (field->quantHeight)
+    {
+        float prev = field->quantPrevHeight[index];
+        return (prev + (field->quantHeight[index] - prev) * alpha) * field->heightStep;
+    }
+    return field->prevHeight[index] + (field->height[index] - field->prevHeight[index]) * alpha;
+}
+
+static void GetPositionRows(void* userData, int start, int end, int batchIndex)
+{
+    (void)batchIndex;
+
+    const HeightFieldPass* pass = (const HeightFieldPass*)userData;
+    const HeightField* field = &pass->field;
+    const int cols = field->cols;
+    const int rows = field->rows;
+
+    // Central differences, one sided on the border
+    for (int i = start; i < end; i++)
+    {
+        int up = i > 0 ? i - 1 : i;
+        int down = i < rows - 1 ? i + 1 : i;
+        float scaleY = pass->refraction / ((down - up) * field->spacing.y);
+        float restY = field->origin.y + i * field->spacing.y;
+
+        for (int j = 0; j < cols; j++)
+        {
+            int left = j > 0 ? j - 1 : j;
+            int right = j < cols - 1 ? j + 1 : j;
+            float scaleX = pass->refraction / ((right - left) * field->spacing.x);
+
+            float slopeX = RenderHeight(field, i * cols + right, pass->alpha) - RenderHeight(field, i * cols + left, pass->alpha);
+            float slopeY = RenderHeight(field, down * cols + j, pass->alpha) - RenderHeight(field, up * cols + j, pass->alpha);
+            pass->positions[i * cols + j] = (Vector2) {
+                field->origin.x + j * field->spacing.x + slopeX * scaleX,
+                restY + slopeY * scaleY,
+            };
+        }
+    }
+}
+
+void HeightFieldGetPositions(HeightField field, float alpha, float refraction, Vector2* positions)
+{
+    HeightFieldPass pass = { .field = field, .alpha = alpha, .refraction = refraction, .positions = positions };
+    ParallelFor(field.rows, HEIGHT_FIELD_BATCH_ROWS, GetPositionRows, &pass);
+}
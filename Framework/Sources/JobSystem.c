@@ -0,0 +1,397 @@
+#include "JobSystem.h"
+#include "Atomic.h"
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#   include <windows.h>
+
+typedef HANDLE              Thread;
+typedef CRITICAL_SECTION    Mutex;
+typedef CONDITION_VARIABLE  Condition;
+
+#   define MutexInit(mutex)                 InitializeCriticalSection(mutex)
+#   define MutexDestroy(mutex)              DeleteCriticalSection(mutex)
+#   define MutexLock(mutex)                 EnterCriticalSection(mutex)
+#   define MutexUnlock(mutex)               LeaveCriticalSection(mutex)
+
+#   define ConditionInit(cond)              InitializeConditionVariable(cond)
+#   define ConditionDestroy(cond)           ((void)(cond))
+#   define ConditionWait(cond, mutex)       SleepConditionVariableCS(cond, mutex, INFINITE)
+#   define ConditionSignal(cond)            WakeConditionVariable(cond)
+#   define ConditionBroadcast(cond)         WakeAllConditionVariable(cond)
+
+#   define ThreadYield()                    SwitchToThread()
+#else
+#   include <pthread.h>
+#   include <sched.h>
+#   include <unistd.h>
+
+typedef pthread_t           Thread;
+typedef pthread_mutex_t     Mutex;
+typedef pthread_cond_t      Condition;
+
+#   define MutexInit(mutex)                 pthread_mutex_init(mutex, NULL)
+#   define MutexDestroy(mutex)              pthread_mutex_destroy(mutex)
+#   define MutexLock(mutex)                 pthread_mutex_lock(mutex)
+#   define MutexUnlock(mutex)               pthread_mutex_unlock(mutex)
+
+#   define ConditionInit(cond)              pthread_cond_init(cond, NULL)
+#   define ConditionDestroy(cond)           pthread_cond_destroy(cond)
+#   define ConditionWait(cond, mutex)       pthread_cond_wait(cond, mutex)
+#   define ConditionSignal(cond)            pthread_cond_signal(cond)
+#   define ConditionBroadcast(cond)         pthread_cond_broadcast(cond)
+
+#   define ThreadYield()                    sched_yield()
+#endif
+
+#define JOB_QUEUE_CAPACITY      1024
+#define MAX_WORKER_THREADS      32
+#define MAX_PARALLEL_BATCHES    512
+
+typedef struct Job
+{
+    JobFunc*    func;
+    void*       userData;
+    JobCounter* counter;
+} Job;
+
+typedef struct ParallelForBatch
+{
+    ParallelForFunc*    func;
+    void*               userData;
+    int                 start;
+    int                 end;
+    int                 batchIndex;
+} ParallelForBatch;
+
+static struct
+{
+    bool        running;
+
+    Mutex       mutex;
+    Condition   condition;
+
+    Job         queue[JOB_QUEUE_CAPACITY];
+    int         head;
+    int         count;
+
+    Thread      workers[MAX_WORKER_THREADS];
+    int         workerCount;
+} jobSystem;
+
+static int GetHardwareThreads(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+static void ExecuteJob(Job job)
+{
+    job.func(job.userData);
+    if (job.counter)
+    {
+        AtomicDecrement(&job.counter->value);
+    }
+}
+
+// Must be called with the mutex locked
+static bool PopJob(Job* job)
+{
+    if (jobSystem.count == 0)
+    {
+        return false;
+    }
+
+    *job = jobSystem.queue[jobSystem.head];
+    jobSystem.head = (jobSystem.head + 1) % JOB_QUEUE_CAPACITY;
+    jobSystem.count--;
+    return true;
+}
+
+// Must be called with the mutex locked, take the first queued job of the counter
+static bool PopJobOf(JobCounter* counter, Job* job)
+{
+    for (int i = 0; i < jobSystem.count; i++)
+    {
+        int slot = (jobSystem.head + i) % JOB_QUEUE_CAPACITY;
+        if (jobSystem.queue[slot].counter != counter)
+        {
+            continue;
+        }
+
+        *job = jobSystem.queue[slot];
+
+        // Jobs queued before it move down one slot, the others keep their order
+        for (int j = i; j > 0; j--)
+        {
+            jobSystem.queue[(jobSystem.head + j) % JOB_QUEUE_CAPACITY] = jobSystem.queue[(jobSystem.head + j - 1) % JOB_QUEUE_CAPACITY];
+        }
+        jobSystem.head = (jobSystem.head + 1) % JOB_QUEUE_CAPACITY;
+        jobSystem.count--;
+        return true;
+    }
+
+    return false;
+}
+
+static bool TryExecuteJob(void)
+{
+    Job job;
+
+    MutexLock(&jobSystem.mutex);
+    bool popped = PopJob(&job);
+    MutexUnlock(&jobSystem.mutex);
+
+    if (popped)
+    {
+        ExecuteJob(job);
+    }
+
+    return popped;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI WorkerMain(LPVOID param)
+#else
+static void* WorkerMain(void* param)
+#endif
+{
+    (void)param;
+
+    MutexLock(&jobSystem.mutex);
+    while (jobSystem.running)
+    {
+        Job job;
+        if (PopJob(&job))
+        {
+            MutexUnlock(&jobSystem.mutex);
+            ExecuteJob(job);
+            MutexLock(&jobSystem.mutex);
+        }
+        else
+        {
+            ConditionWait(&jobSystem.condition, &jobSystem.mutex);
+        }
+    }
+    MutexUnlock(&jobSystem.mutex);
+
+    return 0;
+}
+
+bool JobSystemInit(int workerCount)
+{
+    if (jobSystem.running)
+    {
+        return true;
+    }
+
+    if (workerCount <= 0)
+    {
+        workerCount = GetHardwareThreads() - 1;
+    }
+
+    if (workerCount > MAX_WORKER_THREADS)
+    {
+        workerCount = MAX_WORKER_THREADS;
+    }
+
+    MutexInit(&jobSystem.mutex);
+    ConditionInit(&jobSystem.condition);
+
+    jobSystem.head = 0;
+    jobSystem.count = 0;
+    jobSystem.running = true;
+    jobSystem.workerCount = 0;
+
+    for (int i = 0; i < workerCount; i++)
+    {
+#if defined(_WIN32)
+        Thread thread = CreateThread(NULL, 0, WorkerMain, NULL, 0, NULL);
+        if (!thread)
+        {
+            break;
+        }
+#else
+        Thread thread;
+        if (pthread_create(&thread, NULL, WorkerMain, NULL) != 0)
+        {
+            break;
+        }
+#endif
+
+        jobSystem.workers[jobSystem.workerCount++] = thread;
+    }
+
+    return true;
+}
+
+void JobSystemShutdown(void)
+{
+    if (!jobSystem.running)
+    {
+        return;
+    }
+
+    // Drain what left so no counter is waiting forever
+    while (TryExecuteJob())
+    {
+    }
+
+    MutexLock(&jobSystem.mutex);
+    jobSystem.running = false;
+    ConditionBroadcast(&jobSystem.condition);
+    MutexUnlock(&jobSystem.mutex);
+
+    for (int i = 0; i < jobSystem.workerCount; i++)
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(jobSystem.workers[i], INFINITE);
+        CloseHandle(jobSystem.workers[i]);
+#else
+        pthread_join(jobSystem.workers[i], NULL);
+#endif
+    }
+
+    jobSystem.workerCount = 0;
+
+    ConditionDestroy(&jobSystem.condition);
+    MutexDestroy(&jobSystem.mutex);
+}
+
+int JobSystemWorkerCount(void)
+{
+    return jobSystem.workerCount;
+}
+
+void JobSystemRun(JobCounter* counter, JobFunc* func, void* userData)
+{
+    Job job = { func, userData, counter };
+
+    if (counter)
+    {
+        AtomicIncrement(&counter->value);
+    }
+
+    if (!jobSystem.running || jobSystem.workerCount == 0)
+    {
+        ExecuteJob(job);
+        return;
+    }
+
+    MutexLock(&jobSystem.mutex);
+    if (jobSystem.count < JOB_QUEUE_CAPACITY)
+    {
+        int tail = (jobSystem.head + jobSystem.count) % JOB_QUEUE_CAPACITY;
+        jobSystem.queue[tail] = job;
+        jobSystem.count++;
+
+        ConditionSignal(&jobSystem.condition);
+        MutexUnlock(&jobSystem.mutex);
+    }
+    else
+    {
+        MutexUnlock(&jobSystem.mutex);
+        ExecuteJob(job);
+    }
+}
+
+bool JobSystemIsDone(JobCounter* counter)
+{
+    return AtomicLoad(&counter->value) == 0;
+}
+
+// Only the jobs of the counter are helped with, a long job of another group (asset streaming) would stall the waiting thread
+void JobSystemWait(JobCounter* counter)
+{
+    while (!JobSystemIsDone(counter))
+    {
+        Job job;
+
+        MutexLock(&jobSystem.mutex);
+        bool popped = PopJobOf(counter, &job);
+        MutexUnlock(&jobSystem.mutex);
+
+        if (popped)
+        {
+            ExecuteJob(job);
+        }
+        else
+        {
+            ThreadYield();
+        }
+    }
+}
+
+int ParallelForBatchCount(int count, int batchSize)
+{
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    if (batchSize < 1)
+    {
+        batchSize = 1;
+    }
+
+    return (count + batchSize - 1) / batchSize;
+}
+
+static void ParallelForJob(void* userData)
+{
+    ParallelForBatch* batch = (ParallelForBatch*)userData;
+    batch->func(batch->userData, batch->start, batch->end, batch->batchIndex);
+}
+
+void ParallelFor(int count, int batchSize, ParallelForFunc* func, void* userData)
+{
+    int batchCount = ParallelForBatchCount(count, batchSize);
+    if (batchCount == 0)
+    {
+        return;
+    }
+
+    if (batchSize < 1)
+    {
+        batchSize = 1;
+    }
+
+    // No workers, or not worth it: run on the calling thread with the same batching
+    if (!jobSystem.running || jobSystem.workerCount == 0 || batchCount == 1)
+    {
+        for (int i = 0; i < batchCount; i++)
+        {
+            int start = i * batchSize;
+            int end = start + batchSize < count ? start + batchSize : count;
+            func(userData, start, end, i);
+        }
+        return;
+    }
+
+    // Batches which not fit in the descriptors table run in chunks, keep the same batch indices
+    ParallelForBatch batches[MAX_PARALLEL_BATCHES];
+    for (int first = 0; first < batchCount; first += MAX_PARALLEL_BATCHES)
+    {
+        int chunkCount = batchCount - first < MAX_PARALLEL_BATCHES ? batchCount - first : MAX_PARALLEL_BATCHES;
+
+        JobCounter counter = { 0 };
+        for (int i = 0; i < chunkCount; i++)
+        {
+            int batchIndex = first + i;
+            int start = batchIndex * batchSize;
+            int end = start + batchSize < count ? start + batchSize : count;
+
+            batches[i] = (ParallelForBatch){ func, userData, start, end, batchIndex };
+            JobSystemRun(&counter, ParallelForJob, &batches[i]);
+        }
+
+        JobSystemWait(&counter);
+    }
+}
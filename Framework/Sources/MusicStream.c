@@ -0,0 +1,208 @@
+#include "MusicStream.h"
+#include "Atomic.h"
+#include "Memory.h"
+
+#if defined(_WIN32)
+#   include <windows.h>
+#else
+#   include <pthread.h>
+#   include <time.h>
+#endif
+
+// stb_vorbis is compiled in raylib for LoadMusicStream, only the few entry points needed are declared
+typedef struct stb_vorbis stb_vorbis;
+
+typedef struct stb_vorbis_info
+{
+    unsigned int    sample_rate;
+    int             channels;
+
+    unsigned int    setup_memory_required;
+    unsigned int    setup_temp_memory_required;
+    unsigned int    temp_memory_required;
+
+    int             max_frame_size;
+} stb_vorbis_info;
+
+extern stb_vorbis*      stb_vorbis_open_filename(const char* filename, int* error, const void* alloc_buffer);
+extern stb_vorbis*      stb_vorbis_open_memory(const unsigned char* data, int len, int* error, const void* alloc_buffer);
+extern stb_vorbis_info  stb_vorbis_get_info(stb_vorbis* f);
+extern int              stb_vorbis_get_samples_short_interleaved(stb_vorbis* f, int channels, short* buffer, int num_shorts);
+extern int              stb_vorbis_seek_start(stb_vorbis* f);
+extern void             stb_vorbis_close(stb_vorbis* f);
+
+#define DECODE_CHUNK_FRAMES     1024
+#define MAX_CHANNELS            2
+
+static void SleepMilliseconds(int milliseconds)
+{
+#if defined(_WIN32)
+    Sleep((DWORD)milliseconds);
+#else
+    struct timespec duration = { 0, milliseconds * 1000000L };
+    nanosleep(&duration, NULL);
+#endif
+}
+
+static void DecodeMain(MusicStream* stream)
+{
+    int16_t chunk[DECODE_CHUNK_FRAMES * MAX_CHANNELS];
+    const uint32_t frameSize = sizeof(int16_t) * stream->channels;
+    const uint32_t chunkSize = DECODE_CHUNK_FRAMES * frameSize;
+
+    while (AtomicLoad(&stream->running))
+    {
+        // Decode a whole chunk only when it fit, the consumer drain at realtime so a short nap is enough
+        if (RingBufferWritable(&stream->ring) < chunkSize || AtomicLoad(&stream->finished))
+        {
+            SleepMilliseconds(2);
+            continue;
+        }
+
+        int frames = stb_vorbis_get_samples_short_interleaved((stb_vorbis*)stream->decoder, stream->channels, chunk, DECODE_CHUNK_FRAMES * stream->channels);
+        if (frames == 0)
+        {
+            if (stream->looping && stb_vorbis_seek_start((stb_vorbis*)stream->decoder))
+            {
+                continue;
+            }
+
+            AtomicStore(&stream->finished, 1);
+            continue;
+        }
+
+        RingBufferWrite(&stream->ring, chunk, frames * frameSize);
+        AtomicAdd(&stream->decodedFrames, frames);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI DecodeThread(LPVOID param)
+#else
+static void* DecodeThread(void* param)
+#endif
+{
+    DecodeMain((MusicStream*)param);
+    return 0;
+}
+
+static bool StartStream(MusicStream* stream, stb_vorbis* decoder, float bufferSeconds, bool looping)
+{
+    *stream = (MusicStream) { 0 };
+    if (!decoder)
+    {
+        return false;
+    }
+
+    stb_vorbis_info info = stb_vorbis_get_info(decoder);
+    if (info.channels < 1 || info.channels > MAX_CHANNELS)
+    {
+        stb_vorbis_close(decoder);
+        return false;
+    }
+
+    stream->decoder = decoder;
+    stream->sampleRate = (int)info.sample_rate;
+    stream->channels = info.channels;
+    stream->looping = looping;
+
+    // The decoder only write whole chunks, a ring smaller than two would never be refilled
+    uint32_t frames = (uint32_t)(bufferSeconds * info.sample_rate);
+    frames = frames > 2 * DECODE_CHUNK_FRAMES ? frames : 2 * DECODE_CHUNK_FRAMES;
+    if (!RingBufferInit(&stream->ring, frames * sizeof(int16_t) * info.channels))
+    {
+        stb_vorbis_close(decoder);
+        *stream = (MusicStream) { 0 };
+        return false;
+    }
+
+    stream->running = 1;
+
+#if defined(_WIN32)
+    HANDLE thread = CreateThread(NULL, 0, DecodeThread, stream, 0, NULL);
+    bool started = thread != NULL;
+    stream->thread = thread;
+#else
+    pthread_t* thread = (pthread_t*)MemoryAlloc(sizeof(pthread_t));
+    bool started = pthread_create(thread, NULL, DecodeThread, stream) == 0;
+    stream->thread = thread;
+#endif
+
+    if (!started)
+    {
+        stream->running = 0;
+        MusicStreamClose(stream);
+        return false;
+    }
+
+    return true;
+}
+
+bool MusicStreamOpen(MusicStream* stream, const char* path, float bufferSeconds, bool looping)
+{
+    int error = 0;
+    return StartStream(stream, stb_vorbis_open_filename(path, &error, NULL), bufferSeconds, looping);
+}
+
+bool MusicStreamOpenMemory(MusicStream* stream, const void* data, int size, float bufferSeconds, bool looping)
+{
+    int error = 0;
+    return StartStream(stream, stb_vorbis_open_memory((const unsigned char*)data, size, &error, NULL), bufferSeconds, looping);
+}
+
+void MusicStreamClose(MusicStream* stream)
+{
+    if (stream->thread)
+    {
+        bool wasRunning = AtomicLoad(&stream->running) != 0;
+        AtomicStore(&stream->running, 0);
+
+#if defined(_WIN32)
+        if (wasRunning) WaitForSingleObject((HANDLE)stream->thread, INFINITE);
+        CloseHandle((HANDLE)stream->thread);
+#else
+        if (wasRunning) pthread_join(*(pthread_t*)stream->thread, NULL);
+        MemoryFree(stream->thread);
+#endif
+    }
+
+    if (stream->decoder)
+    {
+        stb_vorbis_close((stb_vorbis*)stream->decoder);
+    }
+
+    RingBufferFree(&stream->ring);
+    *stream = (MusicStream) { 0 };
+}
+
+int MusicStreamBufferedFrames(const MusicStream* stream)
+{
+    return stream->channels > 0 ? (int)(RingBufferReadable(&stream->ring) / (sizeof(int16_t) * stream->channels)) : 0;
+}
+
+bool MusicStreamIsFinished(const MusicStream* stream)
+{
+    return AtomicLoad(&stream->finished) && RingBufferReadable(&stream->ring) == 0;
+}
+
+int MusicStreamRead(MusicStream* stream, int16_t* frames, int frameCount)
+{
+    const uint32_t frameSize = sizeof(int16_t) * stream->channels;
+    uint32_t size = frameCount * frameSize;
+
+    // The decoder only write whole frames, so the ring always hold whole frames
+    uint32_t read = RingBufferRead(&stream->ring, frames, size);
+
+    if (read < size)
+    {
+        MemoryInit((uint8_t*)frames + read, 0, size - read);
+
+        // Running dry at the end of a non looping music is not an underrun
+        if (!AtomicLoad(&stream->finished))
+        {
+            AtomicIncrement(&stream->underruns);
+        }
+    }
+
+    return (int)(read / frameSize);
+}
@@ -0,0 +1,520 @@
+#include "RenderRecorder.h"
+#include "Debug.h"
+#include "Memory.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define WORD_SIZE 4
+
+static void RecorderClear(void* userData, Color color);
+static void RecorderSetBlendMode(void* userData, int blendMode);
+static void RecorderSetTransform(void* userData, const RendererTransform* transform);
+static void RecorderDrawTriangles(void* userData, unsigned int textureId, const RendererVertex* vertices, int vertexCount);
+static void RecorderSection(void* userData, const char* name);
+
+RenderRecorder RenderRecorderNew(const RendererBackend* target)
+{
+    RenderRecorder recorder = { 0 };
+    recorder.buffer = ArrayNew(uint8_t, 64 * 1024);
+    recorder.target = target;
+    return recorder;
+}
+
+void RenderRecorderFree(RenderRecorder* recorder)
+{
+    ArrayFree(recorder->buffer);
+    *recorder = (RenderRecorder) { 0 };
+}
+
+const RendererBackend* RenderRecorderGetBackend(RenderRecorder* recorder)
+{
+    recorder->backend = (RendererBackend) { recorder, RecorderClear, RecorderSetBlendMode, RecorderSetTransform, RecorderDrawTriangles, RecorderSection };
+    return &recorder->backend;
+}
+
+// Append zeroed bytes, the pointer is valid until the next append
+static uint8_t* RecorderAppend(RenderRecorder* recorder, int size)
+{
+    int count = ArrayCount(recorder->buffer);
+    ArrayEnsure(recorder->buffer, count + size);
+    ArraySetCount(recorder->buffer, count + size);
+    MemoryInit(recorder->buffer + count, 0, size);
+    return recorder->buffer + count;
+}
+
+static void RecorderWrite(RenderRecorder* recorder, RenderCommand command, int argument, int payloadWords, const void* payload, int payloadSize)
+{
+    RenderCommandTag tag = { (uint8_t)command, (uint8_t)argument, (uint16_t)payloadWords };
+
+    uint8_t* dest = RecorderAppend(recorder, (int)sizeof(tag) + (payloadSize + WORD_SIZE - 1) / WORD_SIZE * WORD_SIZE);
+    MemoryCopy(dest, &tag, sizeof(tag));
+    if (payloadSize > 0)
+    {
+        MemoryCopy(dest + sizeof(tag), payload, payloadSize);
+    }
+
+    recorder->commandCount++;
+}
+
+void RenderRecorderBeginFrame(RenderRecorder* recorder, int width, int height)
+{
+    ArrayClear(recorder->buffer);
+    recorder->commandCount = 0;
+
+    RenderRecordHeader header = { RENDER_RECORD_MAGIC, RENDER_RECORD_VERSION, width, height, 0, 0 };
+    MemoryCopy(RecorderAppend(recorder, sizeof(header)), &header, sizeof(header));
+}
+
+int RenderRecorderEndFrame(RenderRecorder* recorder)
+{
+    int size = ArrayCount(recorder->buffer);
+    if (size < (int)sizeof(RenderRecordHeader))
+    {
+        return 0;
+    }
+
+    RenderRecordHeader* header = (RenderRecordHeader*)recorder->buffer;
+    header->commandBytes = (uint32_t)(size - sizeof(RenderRecordHeader));
+    header->commandCount = (uint32_t)recorder->commandCount;
+    return size;
+}
+
+bool RenderRecorderSave(const RenderRecorder* recorder, const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    size_t size = (size_t)ArrayCount(recorder->buffer);
+    bool written = fwrite(recorder->buffer, 1, size, file) == size;
+    return fclose(file) == 0 && written;
+}
+
+uint8_t* RenderRecordLoad(const char* path, int* outSize)
+{
+    *outSize = 0;
+
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = size > 0 ? (uint8_t*)MemoryAlloc((size_t)size) : NULL;
+    if (data && fread(data, 1, (size_t)size, file) != (size_t)size)
+    {
+        MemoryFree(data);
+        data = NULL;
+    }
+
+    fclose(file);
+    *outSize = data ? (int)size : 0;
+    return data;
+}
+
+static void RecorderClear(void* userData, Color color)
+{
+    RenderRecorder* recorder = (RenderRecorder*)userData;
+    RecorderWrite(recorder, RENDER_COMMAND_CLEAR, 0, 1, &color, sizeof(color));
+
+    if (recorder->target)
+    {
+        recorder->target->clear(recorder->target->userData, color);
+    }
+}
+
+static void RecorderSetBlendMode(void* userData, int blendMode)
+{
+    RenderRecorder* recorder = (RenderRecorder*)userData;
+    RecorderWrite(recorder, RENDER_COMMAND_BLEND_MODE, blendMode, 0, NULL, 0);
+
+    if (recorder->target)
+    {
+        recorder->target->setBlendMode(recorder->target->userData, blendMode);
+    }
+}
+
+static void RecorderSetTransform(void* userData, const RendererTransform* transform)
+{
+    RenderRecorder* recorder = (RenderRecorder*)userData;
+    RecorderWrite(recorder, RENDER_COMMAND_TRANSFORM, 0, sizeof(*transform) / WORD_SIZE, transform, sizeof(*transform));
+
+    if (recorder->target && recorder->target->setTransform)
+    {
+        recorder->target->setTransform(recorder->target->userData, transform);
+    }
+}
+
+static void RecorderDrawTriangles(void* userData, unsigned int textureId, const RendererVertex* vertices, int vertexCount)
+{
+    RenderRecorder* recorder = (RenderRecorder*)userData;
+
+    // Front end calls stay far below the tag limit, split the rest on whole triangles
+    for (int first = 0; first < vertexCount; first += 65535 / 3 * 3)
+    {
+        int count = vertexCount - first < 65535 / 3 * 3 ? vertexCount - first : 65535 / 3 * 3;
+
+        RenderCommandTag tag = { RENDER_COMMAND_DRAW, 0, (uint16_t)count };
+        uint32_t ids[2] = { textureId, (uint32_t)count };
+
+        uint8_t* dest = RecorderAppend(recorder, (int)(sizeof(tag) + sizeof(ids) + sizeof(RendererVertex) * count));
+        MemoryCopy(dest, &tag, sizeof(tag));
+        MemoryCopy(dest + sizeof(tag), ids, sizeof(ids));
+        MemoryCopy(dest + sizeof(tag) + sizeof(ids), vertices + first, sizeof(RendererVertex) * count);
+        recorder->commandCount++;
+
+        if (recorder->target)
+        {
+            recorder->target->drawTriangles(recorder->target->userData, textureId, vertices + first, count);
+        }
+    }
+}
+
+static void RecorderSection(void* userData, const char* name)
+{
+    RenderRecorder* recorder = (RenderRecorder*)userData;
+
+    int length = name ? (int)strlen(name) : 0;
+    length = length < RENDER_RECORD_NAME_LENGTH - 1 ? length : RENDER_RECORD_NAME_LENGTH - 1;
+    RecorderWrite(recorder, RENDER_COMMAND_SECTION, length, (length + WORD_SIZE - 1) / WORD_SIZE, name, length);
+
+    if (recorder->target && recorder->target->section)
+    {
+        recorder->target->section(recorder->target->userData, name);
+    }
+}
+
+typedef struct RecordCommand
+{
+    RenderCommand           command;
+    Color                   color;
+    int                     blendMode;
+    RendererTransform       transform;
+    unsigned int            textureId;
+    int                     vertexCount;
+    const RendererVertex*   vertices;       // Points in the record, payloads are 4 bytes aligned
+    char                    name[RENDER_RECORD_NAME_LENGTH];
+} RecordCommand;
+
+typedef struct RecordReader
+{
+    const uint8_t*  cursor;
+    const uint8_t*  end;
+} RecordReader;
+
+static bool RecordReaderBegin(RecordReader* reader, const uint8_t* data, int size, RenderRecordHeader* outHeader)
+{
+    if (!data || size < (int)sizeof(RenderRecordHeader))
+    {
+        return false;
+    }
+
+    MemoryCopy(outHeader, data, sizeof(*outHeader));
+    if (outHeader->magic != RENDER_RECORD_MAGIC || outHeader->version != RENDER_RECORD_VERSION
+        || outHeader->commandBytes != (uint32_t)(size - sizeof(RenderRecordHeader)))
+    {
+        return false;
+    }
+
+    reader->cursor = data + sizeof(RenderRecordHeader);
+    reader->end = data + size;
+    return true;
+}
+
+// False at the end of the record, *outValid tell a clean end from a truncated or unknown command
+static bool RecordReaderNext(RecordReader* reader, RecordCommand* outCommand, bool* outValid)
+{
+    *outValid = true;
+    if (reader->cursor == reader->end)
+    {
+        return false;
+    }
+
+    *outValid = false;
+    if (reader->end - reader->cursor < (int)sizeof(RenderCommandTag))
+    {
+        return false;
+    }
+
+    RenderCommandTag tag;
+    MemoryCopy(&tag, reader->cursor, sizeof(tag));
+
+    const uint8_t* payload = reader->cursor + sizeof(tag);
+    size_t payloadSize = tag.command == RENDER_COMMAND_DRAW
+        ? 2 * sizeof(uint32_t) + sizeof(RendererVertex) * tag.payloadWords
+        : (size_t)tag.payloadWords * WORD_SIZE;
+    if ((size_t)(reader->end - payload) < payloadSize)
+    {
+        return false;
+    }
+
+    outCommand->command = (RenderCommand)tag.command;
+    switch (tag.command)
+    {
+    case RENDER_COMMAND_CLEAR:
+        if (payloadSize != WORD_SIZE) return false;
+        MemoryCopy(&outCommand->color, payload, sizeof(Color));
+        break;
+
+    case RENDER_COMMAND_BLEND_MODE:
+        outCommand->blendMode = tag.argument;
+        break;
+
+    case RENDER_COMMAND_TRANSFORM:
+        if (payloadSize != sizeof(RendererTransform)) return false;
+        MemoryCopy(&outCommand->transform, payload, sizeof(RendererTransform));
+        break;
+
+    case RENDER_COMMAND_DRAW:
+    {
+        uint32_t ids[2];
+        MemoryCopy(ids, payload, sizeof(ids));
+        if (ids[1] != tag.payloadWords) return false;
+
+        outCommand->textureId = ids[0];
+        outCommand->vertexCount = (int)ids[1];
+        outCommand->vertices = (const RendererVertex*)(payload + sizeof(ids));
+        break;
+    }
+
+    case RENDER_COMMAND_SECTION:
+        if (tag.argument >= RENDER_RECORD_NAME_LENGTH || (size_t)(tag.argument + WORD_SIZE - 1) / WORD_SIZE * WORD_SIZE != payloadSize) return false;
+        MemoryCopy(outCommand->name, payload, tag.argument);
+        outCommand->name[tag.argument] = 0;
+        break;
+
+    default:
+        return false;
+    }
+
+    reader->cursor = payload + payloadSize;
+    *outValid = true;
+    return true;
+}
+
+bool RenderRecordReplay(const uint8_t* data, int size, const RendererBackend* backend)
+{
+    RecordReader reader;
+    RenderRecordHeader header;
+    if (!RecordReaderBegin(&reader, data, size, &header))
+    {
+        return false;
+    }
+
+    RecordCommand command;
+    bool valid;
+    while (RecordReaderNext(&reader, &command, &valid))
+    {
+        switch (command.command)
+        {
+        case RENDER_COMMAND_CLEAR:
+            backend->clear(backend->userData, command.color);
+            break;
+
+        case RENDER_COMMAND_BLEND_MODE:
+            backend->setBlendMode(backend->userData, command.blendMode);
+            break;
+
+        case RENDER_COMMAND_TRANSFORM:
+            if (backend->setTransform) backend->setTransform(backend->userData, &command.transform);
+            break;
+
+        case RENDER_COMMAND_DRAW:
+            backend->drawTriangles(backend->userData, command.textureId, command.vertices, command.vertexCount);
+            break;
+
+        case RENDER_COMMAND_SECTION:
+            if (backend->section) backend->section(backend->userData, command.name[0] ? command.name : NULL);
+            break;
+        }
+    }
+
+    return valid;
+}
+
+// Sutherland-Hodgman against one side of the viewport, axis 0 is x
+static int ClipPolygon(const float* input, int count, float* output, int axis, float bound, bool keepBelow)
+{
+    int outCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const float* a = &input[i * 2];
+        const float* b = &input[((i + 1) % count) * 2];
+        bool aInside = keepBelow ? a[axis] <= bound : a[axis] >= bound;
+        bool bInside = keepBelow ? b[axis] <= bound : b[axis] >= bound;
+
+        if (aInside)
+        {
+            output[outCount * 2 + 0] = a[0];
+            output[outCount * 2 + 1] = a[1];
+            outCount++;
+        }
+
+        if (aInside != bInside)
+        {
+            float t = (bound - a[axis]) / (b[axis] - a[axis]);
+            output[outCount * 2 + 0] = a[0] + (b[0] - a[0]) * t;
+            output[outCount * 2 + 1] = a[1] + (b[1] - a[1]) * t;
+            outCount++;
+        }
+    }
+
+    return outCount;
+}
+
+static double CoveredArea(const RendererVertex* vertices, int width, int height)
+{
+    // A triangle clipped by 4 planes has at most 7 corners
+    float polygon[2][16 * 2] = {
+        { vertices[0].x, vertices[0].y, vertices[1].x, vertices[1].y, vertices[2].x, vertices[2].y },
+    };
+
+    int count = 3;
+    count = ClipPolygon(polygon[0], count, polygon[1], 0, 0.0f, false);
+    count = ClipPolygon(polygon[1], count, polygon[0], 0, (float)width, true);
+    count = ClipPolygon(polygon[0], count, polygon[1], 1, 0.0f, false);
+    count = ClipPolygon(polygon[1], count, polygon[0], 1, (float)height, true);
+
+    double area = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        const float* a = &polygon[0][i * 2];
+        const float* b = &polygon[0][((i + 1) % count) * 2];
+        area += (double)a[0] * b[1] - (double)b[0] * a[1];
+    }
+
+    return area < 0.0 ? -area * 0.5 : area * 0.5;
+}
+
+static RenderSectionSummary* FindSection(RenderRecordSummary* summary, const char* name)
+{
+    for (int i = 0; i < summary->sectionCount; i++)
+    {
+        if (strcmp(summary->sections[i].name, name) == 0)
+        {
+            return &summary->sections[i];
+        }
+    }
+
+    if (summary->sectionCount == RENDER_RECORD_MAX_SECTIONS)
+    {
+        return NULL;
+    }
+
+    RenderSectionSummary* section = &summary->sections[summary->sectionCount++];
+    strcpy(section->name, name);
+    return section;
+}
+
+bool RenderRecordSummarize(const uint8_t* data, int size, RenderRecordSummary* outSummary)
+{
+    RenderRecordSummary summary = { 0 };
+    strcpy(summary.total.name, "Frame");
+
+    RecordReader reader;
+    RenderRecordHeader header;
+    if (!RecordReaderBegin(&reader, data, size, &header))
+    {
+        return false;
+    }
+
+    summary.width = header.width;
+    summary.height = header.height;
+    summary.bytes = size;
+
+    RenderSectionSummary dummy = { 0 };
+    RenderSectionSummary* section = &dummy;
+    int blendMode = BLEND_ALPHA;
+    unsigned int textureId = 0;
+
+    RecordCommand command;
+    bool valid;
+    while (RecordReaderNext(&reader, &command, &valid))
+    {
+        summary.commands++;
+
+        switch (command.command)
+        {
+        case RENDER_COMMAND_CLEAR:
+            summary.clears++;
+            break;
+
+        case RENDER_COMMAND_BLEND_MODE:
+            if (command.blendMode != blendMode)
+            {
+                blendMode = command.blendMode;
+                section->blendChanges++;
+                summary.total.blendChanges++;
+            }
+            break;
+
+        case RENDER_COMMAND_TRANSFORM:
+            section->transformChanges++;
+            summary.total.transformChanges++;
+            break;
+
+        case RENDER_COMMAND_DRAW:
+        {
+            if (command.textureId != textureId)
+            {
+                textureId = command.textureId;
+                section->textureChanges++;
+                summary.total.textureChanges++;
+            }
+
+            double area = 0.0;
+            for (int i = 0; i + 3 <= command.vertexCount; i += 3)
+            {
+                area += CoveredArea(&command.vertices[i], header.width, header.height);
+            }
+
+            section->drawCalls++;
+            section->triangles += command.vertexCount / 3;
+            section->coveredArea += area;
+            summary.total.drawCalls++;
+            summary.total.triangles += command.vertexCount / 3;
+            summary.total.coveredArea += area;
+            summary.vertices += command.vertexCount;
+            break;
+        }
+
+        case RENDER_COMMAND_SECTION:
+            section = command.name[0] ? FindSection(&summary, command.name) : NULL;
+            section = section ? section : &dummy;
+            break;
+        }
+    }
+
+    if (!valid)
+    {
+        return false;
+    }
+
+    summary.overdraw = header.width > 0 && header.height > 0 ? (float)(summary.total.coveredArea / ((double)header.width * header.height)) : 0.0f;
+    *outSummary = summary;
+    return true;
+}
+
+static void PrintSection(const RenderSectionSummary* section, int width, int height)
+{
+    DebugPrint("  %-24s %6d draws %7d triangles %5d texture %4d blend %4d transform changes, overdraw %.2f",
+        section->name, section->drawCalls, section->triangles, section->textureChanges, section->blendChanges, section->transformChanges,
+        width > 0 && height > 0 ? section->coveredArea / ((double)width * height) : 0.0);
+}
+
+void RenderRecordPrintSummary(const RenderRecordSummary* summary)
+{
+    DebugPrint("Frame %dx%d: %d commands in %d bytes, %d vertices, %d clears", summary->width, summary->height, summary->commands, summary->bytes, summary->vertices, summary->clears);
+    PrintSection(&summary->total, summary->width, summary->height);
+    for (int i = 0; i < summary->sectionCount; i++)
+    {
+        PrintSection(&summary->sections[i], summary->width, summary->height);
+    }
+}
@@ -0,0 +1,775 @@
+#include "Renderer.h"
+#include "Memory.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <rlgl.h>
+
+#define MAX_TRANSFORM_DEPTH     32
+#define CIRCLE_SEGMENTS         36      // raylib DrawCircleV step of 10 degrees
+#define TEXT_BATCH_QUADS        64
+#define INDEXED_BATCH_TRIANGLES 256
+#define MESH_PART_VERTICES      65535   // raylib 3.0 mesh indices are 16 bits
+#define MESH_VBO_COUNT          7       // Buffers of a raylib mesh, DEFAULT_MESH_VERTEX_BUFFERS of models.c
+
+static const RendererBackend*   backend;
+static RendererTransform        transforms[MAX_TRANSFORM_DEPTH];
+static int                      transformDepth;
+
+// 3x5 glyphs from ' ' to 'Z', one row per byte, bit 2 is the left column
+static const unsigned char fontGlyphs[][5] = {
+    { 0, 0, 0, 0, 0 }, { 2, 2, 2, 0, 2 }, { 5, 5, 0, 0, 0 }, { 5, 7, 5, 7, 5 }, // space ! " #
+    { 3, 6, 2, 3, 6 }, { 5, 1, 2, 4, 5 }, { 2, 5, 2, 5, 3 }, { 2, 2, 0, 0, 0 }, // $ % & '
+    { 1, 2, 2, 2, 1 }, { 4, 2, 2, 2, 4 }, { 0, 5, 2, 5, 0 }, { 0, 2, 7, 2, 0 }, // ( ) * +
+    { 0, 0, 0, 2, 4 }, { 0, 0, 7, 0, 0 }, { 0, 0, 0, 0, 2 }, { 1, 1, 2, 4, 4 }, // , - . /
+    { 7, 5, 5, 5, 7 }, { 2, 6, 2, 2, 7 }, { 7, 1, 7, 4, 7 }, { 7, 1, 3, 1, 7 }, // 0 1 2 3
+    { 5, 5, 7, 1, 1 }, { 7, 4, 7, 1, 7 }, { 7, 4, 7, 5, 7 }, { 7, 1, 1, 1, 1 }, // 4 5 6 7
+    { 7, 5, 7, 5, 7 }, { 7, 5, 7, 1, 7 }, { 0, 2, 0, 2, 0 }, { 0, 2, 0, 2, 4 }, // 8 9 : ;
+    { 1, 2, 4, 2, 1 }, { 0, 7, 0, 7, 0 }, { 4, 2, 1, 2, 4 }, { 7, 1, 3, 0, 2 }, // < = > ?
+    { 7, 5, 7, 4, 7 }, { 2, 5, 7, 5, 5 }, { 6, 5, 6, 5, 6 }, { 3, 4, 4, 4, 3 }, // @ A B C
+    { 6, 5, 5, 5, 6 }, { 7, 4, 6, 4, 7 }, { 7, 4, 6, 4, 4 }, { 3, 4, 5, 5, 3 }, // D E F G
+    { 5, 5, 7, 5, 5 }, { 7, 2, 2, 2, 7 }, { 1, 1, 1, 5, 2 }, { 5, 5, 6, 5, 5 }, // H I J K
+    { 4, 4, 4, 4, 7 }, { 5, 7, 7, 5, 5 }, { 6, 5, 5, 5, 5 }, { 2, 5, 5, 5, 2 }, // L M N O
+    { 6, 5, 6, 4, 4 }, { 2, 5, 5, 6, 3 }, { 6, 5, 6, 5, 5 }, { 3, 4, 2, 1, 6 }, // P Q R S
+    { 7, 2, 2, 2, 2 }, { 5, 5, 5, 5, 7 }, { 5, 5, 5, 5, 2 }, { 5, 5, 7, 7, 5 }, // T U V W
+    { 5, 5, 2, 5, 5 }, { 5, 5, 2, 2, 2 }, { 7, 1, 2, 4, 7 },                    // X Y Z
+};
+
+#define FONT_GLYPH_COUNT (int)(sizeof(fontGlyphs) / sizeof(fontGlyphs[0]))
+
+static RendererTransform* CurrentTransform(void)
+{
+    return &transforms[transformDepth];
+}
+
+static void NotifyTransform(void)
+{
+    if (backend->setTransform)
+    {
+        backend->setTransform(backend->userData, CurrentTransform());
+    }
+}
+
+void RendererSetBackend(const RendererBackend* newBackend)
+{
+    backend = newBackend;
+    transformDepth = 0;
+    transforms[0] = (RendererTransform) { { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f } };
+}
+
+bool RendererHasBackend(void)
+{
+    return backend != NULL;
+}
+
+static void RaylibClear(void* userData, Color color)
+{
+    (void)userData;
+    ClearBackground(color);
+}
+
+static void RaylibSetBlendMode(void* userData, int blendMode)
+{
+    (void)userData;
+    BeginBlendMode(blendMode);
+}
+
+// Vertices are in screen space, the rlgl matrix stack is left untouched while a backend is set
+static void RaylibDrawTriangles(void* userData, unsigned int textureId, const RendererVertex* vertices, int vertexCount)
+{
+    (void)userData;
+
+    if (rlCheckBufferLimit(vertexCount))
+    {
+        rlglDraw();
+    }
+
+    rlEnableTexture(textureId ? textureId : GetTextureDefault().id);
+    rlBegin(RL_TRIANGLES);
+    for (int i = 0; i < vertexCount; i++)
+    {
+        const RendererVertex* vertex = &vertices[i];
+        rlColor4ub(vertex->color.r, vertex->color.g, vertex->color.b, vertex->color.a);
+        rlTexCoord2f(vertex->u, vertex->v);
+        rlVertex2f(vertex->x, vertex->y);
+    }
+    rlEnd();
+    rlDisableTexture();
+}
+
+static const RendererBackend raylibBackend = { NULL, RaylibClear, RaylibSetBlendMode, NULL, RaylibDrawTriangles, NULL };
+
+const RendererBackend* RendererGetRaylibBackend(void)
+{
+    return &raylibBackend;
+}
+
+void RendererClear(Color color)
+{
+    if (!backend)
+    {
+        ClearBackground(color);
+        return;
+    }
+
+    backend->clear(backend->userData, color);
+}
+
+void RendererBeginBlendMode(int blendMode)
+{
+    if (!backend)
+    {
+        BeginBlendMode(blendMode);
+        return;
+    }
+
+    backend->setBlendMode(backend->userData, blendMode);
+}
+
+void RendererEndBlendMode(void)
+{
+    if (!backend)
+    {
+        EndBlendMode();
+        return;
+    }
+
+    backend->setBlendMode(backend->userData, BLEND_ALPHA);
+}
+
+void RendererPushMatrix(void)
+{
+    if (!backend)
+    {
+        rlPushMatrix();
+        return;
+    }
+
+    if (transformDepth + 1 < MAX_TRANSFORM_DEPTH)
+    {
+        transforms[transformDepth + 1] = transforms[transformDepth];
+        transformDepth++;
+    }
+}
+
+void RendererPopMatrix(void)
+{
+    if (!backend)
+    {
+        rlPopMatrix();
+        return;
+    }
+
+    if (transformDepth > 0)
+    {
+        transformDepth--;
+        NotifyTransform();
+    }
+}
+
+// Post multiply like rlgl, the last transform apply first to the vertices
+void RendererTranslate(float x, float y)
+{
+    if (!backend)
+    {
+        rlTranslatef(x, y, 0.0f);
+        return;
+    }
+
+    float* m = CurrentTransform()->m;
+    m[2] += m[0] * x + m[1] * y;
+    m[5] += m[3] * x + m[4] * y;
+    NotifyTransform();
+}
+
+void RendererRotate(float degrees)
+{
+    if (!backend)
+    {
+        rlRotatef(degrees, 0.0f, 0.0f, 1.0f);
+        return;
+    }
+
+    float s = sinf(degrees * DEG2RAD);
+    float c = cosf(degrees * DEG2RAD);
+
+    float* m = CurrentTransform()->m;
+    float a = m[0], b = m[1], d = m[3], e = m[4];
+    m[0] = a * c + b * s;
+    m[1] = b * c - a * s;
+    m[3] = d * c + e * s;
+    m[4] = e * c - d * s;
+    NotifyTransform();
+}
+
+void RendererScale(float x, float y)
+{
+    if (!backend)
+    {
+        rlScalef(x, y, 1.0f);
+        return;
+    }
+
+    float* m = CurrentTransform()->m;
+    m[0] *= x;
+    m[3] *= x;
+    m[1] *= y;
+    m[4] *= y;
+    NotifyTransform();
+}
+
+void RendererBeginMode2D(Camera2D camera)
+{
+    if (!backend)
+    {
+        BeginMode2D(camera);
+        return;
+    }
+
+    RendererPushMatrix();
+    RendererTranslate(camera.offset.x, camera.offset.y);
+    RendererRotate(camera.rotation);
+    RendererScale(camera.zoom, camera.zoom);
+    RendererTranslate(-camera.target.x, -camera.target.y);
+}
+
+void RendererEndMode2D(void)
+{
+    if (!backend)
+    {
+        EndMode2D();
+        return;
+    }
+
+    RendererPopMatrix();
+}
+
+void RendererBeginSection(const char* name)
+{
+    if (backend && backend->section)
+    {
+        backend->section(backend->userData, name);
+    }
+}
+
+void RendererEndSection(void)
+{
+    if (backend && backend->section)
+    {
+        backend->section(backend->userData, NULL);
+    }
+}
+
+static RendererVertex MakeVertex(float x, float y, float u, float v, Color color)
+{
+    const float* m = CurrentTransform()->m;
+
+    RendererVertex vertex = {
+        m[0] * x + m[1] * y + m[2],
+        m[3] * x + m[4] * y + m[5],
+        u, v,
+        color,
+    };
+    return vertex;
+}
+
+// Corners in order top left, bottom left, bottom right, top right, like raylib quads
+static void EmitQuad(unsigned int textureId, const RendererVertex* quad)
+{
+    RendererVertex vertices[6] = { quad[0], quad[1], quad[2], quad[0], quad[2], quad[3] };
+    backend->drawTriangles(backend->userData, textureId, vertices, 6);
+}
+
+static void EmitRectangle(float x, float y, float width, float height, Color color)
+{
+    RendererVertex quad[4] = {
+        MakeVertex(x, y, 0.0f, 0.0f, color),
+        MakeVertex(x, y + height, 0.0f, 0.0f, color),
+        MakeVertex(x + width, y + height, 0.0f, 0.0f, color),
+        MakeVertex(x + width, y, 0.0f, 0.0f, color),
+    };
+    EmitQuad(0, quad);
+}
+
+void RendererDrawTexturePro(Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    if (!backend)
+    {
+        DrawTexturePro(texture, source, dest, origin, rotation, tint);
+        return;
+    }
+
+    if (texture.id == 0)
+    {
+        return;
+    }
+
+    // Same flips as raylib: negative source width mirror the u, negative height the v
+    bool flipX = false;
+    if (source.width < 0)
+    {
+        flipX = true;
+        source.width *= -1;
+    }
+
+    if (source.height < 0)
+    {
+        source.y -= source.height;
+    }
+
+    float width = (float)texture.width;
+    float height = (float)texture.height;
+    float u0 = source.x / width;
+    float u1 = (source.x + source.width) / width;
+    float v0 = source.y / height;
+    float v1 = (source.y + source.height) / height;
+    if (flipX)
+    {
+        float u = u0;
+        u0 = u1;
+        u1 = u;
+    }
+
+    float s = sinf(rotation * DEG2RAD);
+    float c = cosf(rotation * DEG2RAD);
+    float xs[4] = { -origin.x, -origin.x, dest.width - origin.x, dest.width - origin.x };
+    float ys[4] = { -origin.y, dest.height - origin.y, dest.height - origin.y, -origin.y };
+    float us[4] = { u0, u0, u1, u1 };
+    float vs[4] = { v0, v1, v1, v0 };
+
+    RendererVertex quad[4];
+    for (int i = 0; i < 4; i++)
+    {
+        quad[i] = MakeVertex(dest.x + xs[i] * c - ys[i] * s, dest.y + xs[i] * s + ys[i] * c, us[i], vs[i], tint);
+    }
+
+    EmitQuad(texture.id, quad);
+}
+
+void RendererDrawTextureRec(Texture texture, Rectangle source, Vector2 position, Color tint)
+{
+    if (!backend)
+    {
+        DrawTextureRec(texture, source, position, tint);
+        return;
+    }
+
+    Rectangle dest = { position.x, position.y, fabsf(source.width), fabsf(source.height) };
+    RendererDrawTexturePro(texture, source, dest, (Vector2) { 0.0f, 0.0f }, 0.0f, tint);
+}
+
+void RendererDrawLineEx(Vector2 start, Vector2 end, float thick, Color color)
+{
+    if (!backend)
+    {
+        DrawLineEx(start, end, thick, color);
+        return;
+    }
+
+    float dx = end.x - start.x;
+    float dy = end.y - start.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length <= 0.0f)
+    {
+        return;
+    }
+
+    // raylib offset thin lines by one pixel instead of centering them
+    float nx = -dy / length;
+    float ny = dx / length;
+    float offset = thick > 1.0f ? -thick * 0.5f : -1.0f;
+
+    float x0 = start.x + nx * offset, y0 = start.y + ny * offset;
+    float x1 = end.x + nx * offset, y1 = end.y + ny * offset;
+    RendererVertex quad[4] = {
+        MakeVertex(x0, y0, 0.0f, 0.0f, color),
+        MakeVertex(x0 + nx * thick, y0 + ny * thick, 0.0f, 0.0f, color),
+        MakeVertex(x1 + nx * thick, y1 + ny * thick, 0.0f, 0.0f, color),
+        MakeVertex(x1, y1, 0.0f, 0.0f, color),
+    };
+    EmitQuad(0, quad);
+}
+
+void RendererDrawCircleV(Vector2 center, float radius, Color color)
+{
+    if (!backend)
+    {
+        DrawCircleV(center, radius, color);
+        return;
+    }
+
+    RendererVertex vertices[CIRCLE_SEGMENTS * 3];
+    for (int i = 0; i < CIRCLE_SEGMENTS; i++)
+    {
+        float a0 = (float)i / CIRCLE_SEGMENTS * 2.0f * PI;
+        float a1 = (float)(i + 1) / CIRCLE_SEGMENTS * 2.0f * PI;
+
+        vertices[i * 3 + 0] = MakeVertex(center.x, center.y, 0.0f, 0.0f, color);
+        vertices[i * 3 + 1] = MakeVertex(center.x + sinf(a0) * radius, center.y + cosf(a0) * radius, 0.0f, 0.0f, color);
+        vertices[i * 3 + 2] = MakeVertex(center.x + sinf(a1) * radius, center.y + cosf(a1) * radius, 0.0f, 0.0f, color);
+    }
+
+    backend->drawTriangles(backend->userData, 0, vertices, CIRCLE_SEGMENTS * 3);
+}
+
+void RendererDrawRectangleRec(Rectangle rec, Color color)
+{
+    if (!backend)
+    {
+        DrawRectangleRec(rec, color);
+        return;
+    }
+
+    EmitRectangle(rec.x, rec.y, rec.width, rec.height, color);
+}
+
+void RendererDrawRectangleLines(Rectangle rec, Color color)
+{
+    if (!backend)
+    {
+        DrawRectangleLines((int)rec.x, (int)rec.y, (int)rec.width, (int)rec.height, color);
+        return;
+    }
+
+    EmitRectangle(rec.x, rec.y, rec.width, 1.0f, color);
+    EmitRectangle(rec.x, rec.y + rec.height - 1.0f, rec.width, 1.0f, color);
+    EmitRectangle(rec.x, rec.y + 1.0f, 1.0f, rec.height - 2.0f, color);
+    EmitRectangle(rec.x + rec.width - 1.0f, rec.y + 1.0f, 1.0f, rec.height - 2.0f, color);
+}
+
+void RendererDrawTriangleLines(Vector2 v1, Vector2 v2, Vector2 v3, Color color)
+{
+    if (!backend)
+    {
+        DrawTriangleLines(v1, v2, v3, color);
+        return;
+    }
+
+    RendererDrawLineEx(v1, v2, 1.0f, color);
+    RendererDrawLineEx(v2, v3, 1.0f, color);
+    RendererDrawLineEx(v3, v1, 1.0f, color);
+}
+
+void RendererDrawText(const char* text, int x, int y, int fontSize, Color color)
+{
+    if (!backend)
+    {
+        DrawText(text, x, y, fontSize, color);
+        return;
+    }
+
+    // Glyph pixels are cells of a 7 rows em, so capitals are about as tall as the raylib font ones
+    float cell = fontSize / 7.0f;
+    float penX = (float)x;
+    float penY = (float)y + cell;
+
+    RendererVertex vertices[TEXT_BATCH_QUADS * 6];
+    int count = 0;
+
+    for (const char* c = text; *c; c++)
+    {
+        if (*c == '\n')
+        {
+            penX = (float)x;
+            penY += fontSize * 1.5f;
+            continue;
+        }
+
+        int code = *c >= 'a' && *c <= 'z' ? *c - 'a' + 'A' : *c;
+        int glyph = code >= ' ' && code - ' ' < FONT_GLYPH_COUNT ? code - ' ' : '?' - ' ';
+
+        for (int row = 0; row < 5; row++)
+        {
+            for (int column = 0; column < 3; column++)
+            {
+                if (!(fontGlyphs[glyph][row] & (4 >> column)))
+                {
+                    continue;
+                }
+
+                float px = penX + column * cell;
+                float py = penY + row * cell;
+                RendererVertex quad[4] = {
+                    MakeVertex(px, py, 0.0f, 0.0f, color),
+                    MakeVertex(px, py + cell, 0.0f, 0.0f, color),
+                    MakeVertex(px + cell, py + cell, 0.0f, 0.0f, color),
+                    MakeVertex(px + cell, py, 0.0f, 0.0f, color),
+                };
+
+                RendererVertex* out = &vertices[count * 6];
+                out[0] = quad[0]; out[1] = quad[1]; out[2] = quad[2];
+                out[3] = quad[0]; out[4] = quad[2]; out[5] = quad[3];
+
+                if (++count == TEXT_BATCH_QUADS)
+                {
+                    backend->drawTriangles(backend->userData, 0, vertices, count * 6);
+                    count = 0;
+                }
+            }
+        }
+
+        penX += cell * 4.0f;
+    }
+
+    if (count > 0)
+    {
+        backend->drawTriangles(backend->userData, 0, vertices, count * 6);
+    }
+}
+
+void RendererDrawTriangles(unsigned int textureId, const RendererVertex* vertices, int vertexCount)
+{
+    if (!backend)
+    {
+        RaylibDrawTriangles(NULL, textureId, vertices, vertexCount);
+        return;
+    }
+
+    const float* m = CurrentTransform()->m;
+    if (m[0] == 1.0f && m[1] == 0.0f && m[2] == 0.0f && m[3] == 0.0f && m[4] == 1.0f && m[5] == 0.0f)
+    {
+        backend->drawTriangles(backend->userData, textureId, vertices, vertexCount);
+        return;
+    }
+
+    // Apply the transform stack in chunks of whole triangles
+    RendererVertex transformed[CIRCLE_SEGMENTS * 3];
+    for (int first = 0; first < vertexCount; first += CIRCLE_SEGMENTS * 3)
+    {
+        int count = vertexCount - first < CIRCLE_SEGMENTS * 3 ? vertexCount - first : CIRCLE_SEGMENTS * 3;
+        for (int i = 0; i < count; i++)
+        {
+            const RendererVertex* vertex = &vertices[first + i];
+            transformed[i] = MakeVertex(vertex->x, vertex->y, vertex->u, vertex->v, vertex->color);
+        }
+
+        backend->drawTriangles(backend->userData, textureId, transformed, count);
+    }
+}
+
+void RendererDrawIndexedTriangles(unsigned int textureId, const RendererVertex* vertices, const uint32_t* indices, int indexCount)
+{
+    RendererVertex batch[INDEXED_BATCH_TRIANGLES * 3];
+    for (int first = 0; first + 3 <= indexCount; first += INDEXED_BATCH_TRIANGLES * 3)
+    {
+        int count = indexCount - first < INDEXED_BATCH_TRIANGLES * 3 ? indexCount - first : INDEXED_BATCH_TRIANGLES * 3;
+        count -= count % 3;
+        for (int i = 0; i < count; i++)
+        {
+            batch[i] = vertices[indices[first + i]];
+        }
+
+        RendererDrawTriangles(textureId, batch, count);
+    }
+}
+
+// Greedy split in triangle order, a part end when one more triangle could bring it over the vertex limit
+// Vertices of triangles in two parts are duplicated. Only count when the mesh has no parts yet
+static void SplitMeshParts(RendererMesh* mesh, const uint32_t* indices, int triangleCount, int* localIndices, int* localParts, int* outVertexCount)
+{
+    MemoryInit(localParts, 0xFF, sizeof(int) * mesh->vertexCount);
+
+    int part = -1;
+    int partVertexCount = MESH_PART_VERTICES;
+    int vertexCount = 0;
+    for (int i = 0; i < triangleCount * 3; i += 3)
+    {
+        if (partVertexCount + 3 > MESH_PART_VERTICES)
+        {
+            part++;
+            partVertexCount = 0;
+
+            // The arrays of a part follow the ones of the previous part
+            if (mesh->parts && part > 0)
+            {
+                Mesh* previous = &mesh->parts[part - 1];
+                mesh->parts[part].vertices = previous->vertices + previous->vertexCount * 3;
+                mesh->parts[part].texcoords = previous->texcoords + previous->vertexCount * 2;
+                mesh->parts[part].colors = previous->colors + previous->vertexCount * 4;
+                mesh->parts[part].indices = previous->indices + previous->triangleCount * 3;
+                mesh->parts[part].vboId = previous->vboId + MESH_VBO_COUNT;
+            }
+        }
+
+        for (int k = 0; k < 3; k++)
+        {
+            uint32_t vertex = indices[i + k];
+            if (localParts[vertex] != part)
+            {
+                localParts[vertex] = part;
+                localIndices[vertex] = partVertexCount++;
+                if (mesh->parts)
+                {
+                    mesh->partVertices[vertexCount] = vertex;
+                }
+                vertexCount++;
+            }
+
+            if (mesh->parts)
+            {
+                Mesh* current = &mesh->parts[part];
+                current->indices[current->triangleCount * 3 + k] = (unsigned short)localIndices[vertex];
+            }
+        }
+
+        if (mesh->parts)
+        {
+            mesh->parts[part].vertexCount = partVertexCount;
+            mesh->parts[part].triangleCount++;
+        }
+    }
+
+    mesh->partCount = part + 1;
+    *outVertexCount = vertexCount;
+}
+
+RendererMesh RendererMeshNew(const RendererVertex* vertices, int vertexCount, const uint32_t* indices, int indexCount)
+{
+    int triangleCount = indexCount / 3;
+    if (vertexCount <= 0 || triangleCount <= 0)
+    {
+        return (RendererMesh) { 0 };
+    }
+
+    int* localIndices = (int*)MemoryAlloc(sizeof(int) * 2 * vertexCount);
+    if (!localIndices)
+    {
+        return (RendererMesh) { 0 };
+    }
+    int* localParts = localIndices + vertexCount;
+
+    RendererMesh mesh = { .vertexCount = vertexCount };
+
+    int partVertexCount;
+    SplitMeshParts(&mesh, indices, triangleCount, localIndices, localParts, &partVertexCount);
+
+    // Parts, their buffer ids, the source of their vertices, then the raylib arrays of all parts one after the other
+    size_t partsSize = sizeof(Mesh) * mesh.partCount + sizeof(unsigned int) * MESH_VBO_COUNT * mesh.partCount;
+    size_t verticesSize = (sizeof(uint32_t) + sizeof(float) * 5 + sizeof(unsigned char) * 4) * partVertexCount;
+    size_t indicesSize = sizeof(unsigned short) * 3 * triangleCount;
+    Mesh* block = (Mesh*)MemoryAlloc(partsSize + verticesSize + indicesSize);
+    if (!block)
+    {
+        MemoryFree(localIndices);
+        return (RendererMesh) { 0 };
+    }
+    MemoryInit(block, 0, partsSize + verticesSize + indicesSize);
+
+    mesh.parts = block;
+    mesh.partVertices = (uint32_t*)((unsigned char*)block + partsSize);
+    mesh.parts[0].vboId = (unsigned int*)(block + mesh.partCount);
+    mesh.parts[0].vertices = (float*)(mesh.partVertices + partVertexCount);
+    mesh.parts[0].texcoords = mesh.parts[0].vertices + partVertexCount * 3;
+    mesh.parts[0].colors = (unsigned char*)(mesh.parts[0].texcoords + partVertexCount * 2);
+    mesh.parts[0].indices = (unsigned short*)(mesh.parts[0].colors + partVertexCount * 4);
+
+    SplitMeshParts(&mesh, indices, triangleCount, localIndices, localParts, &partVertexCount);
+    MemoryFree(localIndices);
+
+    // Z stay 0, only x and y are rewritten by the draws
+    for (int i = 0; i < partVertexCount; i++)
+    {
+        const RendererVertex* vertex = &vertices[mesh.partVertices[i]];
+        mesh.parts[0].vertices[i * 3 + 0] = vertex->x;
+        mesh.parts[0].vertices[i * 3 + 1] = vertex->y;
+        mesh.parts[0].texcoords[i * 2 + 0] = vertex->u;
+        mesh.parts[0].texcoords[i * 2 + 1] = vertex->v;
+        mesh.parts[0].colors[i * 4 + 0] = vertex->color.r;
+        mesh.parts[0].colors[i * 4 + 1] = vertex->color.g;
+        mesh.parts[0].colors[i * 4 + 2] = vertex->color.b;
+        mesh.parts[0].colors[i * 4 + 3] = vertex->color.a;
+    }
+
+    return mesh;
+}
+
+static bool IsMeshUploaded(RendererMesh mesh)
+{
+    return mesh.parts[0].vboId[0] != 0;
+}
+
+void RendererMeshFree(RendererMesh* mesh)
+{
+    if (mesh->parts && IsMeshUploaded(*mesh))
+    {
+        // rlUnloadMesh free the arrays of the part too, they live in our block
+        for (int i = 0; i < mesh->partCount; i++)
+        {
+            Mesh buffers = { .vaoId = mesh->parts[i].vaoId, .vboId = mesh->parts[i].vboId };
+            rlUnloadMesh(buffers);
+        }
+    }
+
+    MemoryFree(mesh->parts);
+    *mesh = (RendererMesh) { 0 };
+}
+
+bool RendererMeshIsValid(RendererMesh mesh)
+{
+    return mesh.partCount > 0 && mesh.parts != NULL;
+}
+
+void RendererDrawMesh(RendererMesh mesh, unsigned int textureId, const RendererVertex* vertices)
+{
+    if (!RendererMeshIsValid(mesh))
+    {
+        return;
+    }
+
+    if (backend)
+    {
+        RendererVertex batch[INDEXED_BATCH_TRIANGLES * 3];
+        const uint32_t* partVertices = mesh.partVertices;
+        for (int i = 0; i < mesh.partCount; i++)
+        {
+            Mesh part = mesh.parts[i];
+            for (int first = 0; first < part.triangleCount * 3; first += INDEXED_BATCH_TRIANGLES * 3)
+            {
+                int count = part.triangleCount * 3 - first < INDEXED_BATCH_TRIANGLES * 3 ? part.triangleCount * 3 - first : INDEXED_BATCH_TRIANGLES * 3;
+                for (int k = 0; k < count; k++)
+                {
+                    batch[k] = vertices[partVertices[part.indices[first + k]]];
+                }
+
+                RendererDrawTriangles(textureId, batch, count);
+            }
+            partVertices += part.vertexCount;
+        }
+        return;
+    }
+
+    // Static buffers for the indices, texture coordinates and colors, only the positions are sent again
+    if (!IsMeshUploaded(mesh))
+    {
+        for (int i = 0; i < mesh.partCount; i++)
+        {
+            rlLoadMesh(&mesh.parts[i], false);
+        }
+    }
+
+    MaterialMap maps[MAX_MATERIAL_MAPS] = { 0 };
+    maps[MAP_DIFFUSE].texture.id = textureId ? textureId : GetTextureDefault().id;
+    maps[MAP_DIFFUSE].color = WHITE;
+
+    Material material = { .shader = GetShaderDefault(), .maps = maps };
+    Matrix identity = { .m0 = 1.0f, .m5 = 1.0f, .m10 = 1.0f, .m15 = 1.0f };
+
+    // What was batched before is drawn under the mesh
+    rlglDraw();
+
+    const uint32_t* partVertices = mesh.partVertices;
+    for (int i = 0; i < mesh.partCount; i++)
+    {
+        Mesh part = mesh.parts[i];
+        for (int k = 0; k < part.vertexCount; k++)
+        {
+            const RendererVertex* vertex = &vertices[partVertices[k]];
+            part.vertices[k * 3 + 0] = vertex->x;
+            part.vertices[k * 3 + 1] = vertex->y;
+        }
+        partVertices += part.vertexCount;
+
+        rlUpdateMesh(part, 0, part.vertexCount);
+        rlDrawMesh(part, material, identity);
+    }
+}
@@ -0,0 +1,72 @@
+#include "RingBuffer.h"
+#include "Atomic.h"
+#include "Memory.h"
+
+bool RingBufferInit(RingBuffer* ring, uint32_t capacity)
+{
+    uint32_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+
+    *ring = (RingBuffer) { 0 };
+    ring->data = (uint8_t*)MemoryAlloc(size);
+    ring->capacity = ring->data ? size : 0;
+    return ring->data != NULL;
+}
+
+void RingBufferFree(RingBuffer* ring)
+{
+    MemoryFree(ring->data);
+    *ring = (RingBuffer) { 0 };
+}
+
+uint32_t RingBufferReadable(const RingBuffer* ring)
+{
+    uint32_t write = (uint32_t)AtomicLoad(&ring->writePosition);
+    uint32_t read = (uint32_t)AtomicLoad(&ring->readPosition);
+    return write - read;
+}
+
+uint32_t RingBufferWritable(const RingBuffer* ring)
+{
+    return ring->capacity - RingBufferReadable(ring);
+}
+
+uint32_t RingBufferWrite(RingBuffer* ring, const void* data, uint32_t size)
+{
+    uint32_t write = (uint32_t)ring->writePosition;
+    uint32_t read = (uint32_t)AtomicLoad(&ring->readPosition);
+
+    uint32_t writable = ring->capacity - (write - read);
+    size = size < writable ? size : writable;
+
+    // Copy in up to two parts around the end of the buffer
+    uint32_t offset = write & (ring->capacity - 1);
+    uint32_t first = ring->capacity - offset < size ? ring->capacity - offset : size;
+    MemoryCopy(ring->data + offset, data, first);
+    MemoryCopy(ring->data, (const uint8_t*)data + first, size - first);
+
+    // Publish the bytes after they are copied
+    AtomicStore(&ring->writePosition, (long)(write + size));
+    return size;
+}
+
+uint32_t RingBufferRead(RingBuffer* ring, void* data, uint32_t size)
+{
+    uint32_t read = (uint32_t)ring->readPosition;
+    uint32_t write = (uint32_t)AtomicLoad(&ring->writePosition);
+
+    uint32_t readable = write - read;
+    size = size < readable ? size : readable;
+
+    uint32_t offset = read & (ring->capacity - 1);
+    uint32_t first = ring->capacity - offset < size ? ring->capacity - offset : size;
+    MemoryCopy(data, ring->data + offset, first);
+    MemoryCopy((uint8_t*)data + first, ring->data, size - first);
+
+    // Release the space after the bytes are copied out
+    AtomicStore(&ring->readPosition, (long)(read + size));
+    return size;
+}
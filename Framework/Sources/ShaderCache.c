@@ -0,0 +1,338 @@
+#include "ShaderCache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#   include <direct.h>
+#   define MakeDirectory(path) _mkdir(path)
+#   define GLAPIENTRY __stdcall
+#else
+#   include <sys/stat.h>
+#   define MakeDirectory(path) mkdir(path, 0755)
+#   define GLAPIENTRY
+#endif
+
+// GLFW is compiled in raylib, only its loader is declared, the GL entry points are fetched at runtime
+typedef void (*GLFWglproc)(void);
+extern GLFWglproc glfwGetProcAddress(const char* procname);
+
+#define GL_VENDOR                       0x1F00
+#define GL_RENDERER                     0x1F01
+#define GL_VERSION                      0x1F02
+#define GL_LINK_STATUS                  0x8B82
+#define GL_PROGRAM_BINARY_LENGTH        0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS   0x87FE
+
+typedef const unsigned char*    (GLAPIENTRY *GLGetStringProc)(unsigned int name);
+typedef void                    (GLAPIENTRY *GLGetIntegervProc)(unsigned int name, int* data);
+typedef unsigned int            (GLAPIENTRY *GLCreateProgramProc)(void);
+typedef void                    (GLAPIENTRY *GLDeleteProgramProc)(unsigned int program);
+typedef void                    (GLAPIENTRY *GLGetProgramivProc)(unsigned int program, unsigned int name, int* params);
+typedef void                    (GLAPIENTRY *GLGetProgramBinaryProc)(unsigned int program, int bufferSize, int* length, unsigned int* format, void* binary);
+typedef void                    (GLAPIENTRY *GLProgramBinaryProc)(unsigned int program, unsigned int format, const void* binary, int length);
+typedef int                     (GLAPIENTRY *GLGetLocationProc)(unsigned int program, const char* name);
+
+static struct
+{
+    GLGetStringProc         GetString;
+    GLGetIntegervProc       GetIntegerv;
+    GLCreateProgramProc     CreateProgram;
+    GLDeleteProgramProc     DeleteProgram;
+    GLGetProgramivProc      GetProgramiv;
+    GLGetProgramBinaryProc  GetProgramBinary;
+    GLProgramBinaryProc     ProgramBinary;
+    GLGetLocationProc       GetAttribLocation;
+    GLGetLocationProc       GetUniformLocation;
+} gl;
+
+#define SHADER_LOCATION_COUNT 32    // MAX_SHADER_LOCATIONS of rlgl, UnloadShader free the array
+#define RAYLIB_VERSION_NAME   "raylib 3.0"  // Default vertex shader and attribute bindings come from raylib
+
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+// Length prefixed so the boundary between the two sources is part of the key
+static uint64_t HashSource(uint64_t hash, const char* code)
+{
+    uint32_t length = code ? (uint32_t)strlen(code) : 0xFFFFFFFFu;
+    hash = HashBytes(hash, &length, sizeof(length));
+    return code ? HashBytes(hash, code, length) : hash;
+}
+
+ShaderCacheKey ShaderCacheMakeKey(const char* driver, const char* vsCode, const char* fsCode)
+{
+    const uint64_t basis = 0xcbf29ce484222325ull;
+
+    ShaderCacheKey key;
+    key.driverHash = HashSource(basis, driver);
+    key.sourceHash = HashSource(HashSource(basis, vsCode), fsCode);
+    return key;
+}
+
+void ShaderCacheFilePath(char* buffer, size_t bufferSize, const char* directory, const char* name)
+{
+    uint64_t hash = HashBytes(0xcbf29ce484222325ull, name, strlen(name));
+    snprintf(buffer, bufferSize, "%s/%016llx.glsb", directory, (unsigned long long)hash);
+}
+
+ShaderCacheResult ShaderCacheRead(const char* directory, const char* name, ShaderCacheKey key, ShaderBinary* outBinary)
+{
+    *outBinary = (ShaderBinary) { 0 };
+
+    char path[512];
+    ShaderCacheFilePath(path, sizeof(path), directory, name);
+
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        return SHADER_CACHE_MISS;
+    }
+
+    ShaderCacheHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION)
+    {
+        fclose(file);
+        return SHADER_CACHE_CORRUPT;
+    }
+
+    if (header.driverHash != key.driverHash || header.sourceHash != key.sourceHash)
+    {
+        fclose(file);
+        return SHADER_CACHE_STALE;
+    }
+
+    void* data = header.binarySize > 0 ? malloc(header.binarySize) : NULL;
+    bool valid = data
+        && fread(data, 1, header.binarySize, file) == header.binarySize
+        && fgetc(file) == EOF
+        && HashBytes(0xcbf29ce484222325ull, data, header.binarySize) == header.checksum;
+    fclose(file);
+
+    if (!valid)
+    {
+        free(data);
+        return SHADER_CACHE_CORRUPT;
+    }
+
+    outBinary->format = header.binaryFormat;
+    outBinary->size = header.binarySize;
+    outBinary->data = data;
+    return SHADER_CACHE_HIT;
+}
+
+bool ShaderCacheWrite(const char* directory, const char* name, ShaderCacheKey key, ShaderBinary binary)
+{
+    // Fail silently when it already exist, fopen report the real errors
+    MakeDirectory(directory);
+
+    char path[512];
+    char tempPath[520];
+    ShaderCacheFilePath(path, sizeof(path), directory, name);
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+
+    ShaderCacheHeader header = {
+        .magic          = SHADER_CACHE_MAGIC,
+        .version        = SHADER_CACHE_VERSION,
+        .driverHash     = key.driverHash,
+        .sourceHash     = key.sourceHash,
+        .binaryFormat   = binary.format,
+        .binarySize     = binary.size,
+        .checksum       = HashBytes(0xcbf29ce484222325ull, binary.data, binary.size),
+    };
+
+    // Written aside then renamed, a crash never leave a half entry under the real name
+    FILE* file = fopen(tempPath, "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(binary.data, 1, binary.size, file) == binary.size;
+    written = fclose(file) == 0 && written;
+
+    remove(path);
+    if (!written || rename(tempPath, path) != 0)
+    {
+        remove(tempPath);
+        return false;
+    }
+
+    return true;
+}
+
+void ShaderCacheRemove(const char* directory, const char* name)
+{
+    char path[512];
+    ShaderCacheFilePath(path, sizeof(path), directory, name);
+    remove(path);
+}
+
+void ShaderBinaryFree(ShaderBinary* binary)
+{
+    free(binary->data);
+    *binary = (ShaderBinary) { 0 };
+}
+
+static bool LoadGLFunctions(void)
+{
+    gl.GetString            = (GLGetStringProc)glfwGetProcAddress("glGetString");
+    gl.GetIntegerv          = (GLGetIntegervProc)glfwGetProcAddress("glGetIntegerv");
+    gl.CreateProgram        = (GLCreateProgramProc)glfwGetProcAddress("glCreateProgram");
+    gl.DeleteProgram        = (GLDeleteProgramProc)glfwGetProcAddress("glDeleteProgram");
+    gl.GetProgramiv         = (GLGetProgramivProc)glfwGetProcAddress("glGetProgramiv");
+    gl.GetProgramBinary     = (GLGetProgramBinaryProc)glfwGetProcAddress("glGetProgramBinary");
+    gl.ProgramBinary        = (GLProgramBinaryProc)glfwGetProcAddress("glProgramBinary");
+    gl.GetAttribLocation    = (GLGetLocationProc)glfwGetProcAddress("glGetAttribLocation");
+    gl.GetUniformLocation   = (GLGetLocationProc)glfwGetProcAddress("glGetUniformLocation");
+
+    return gl.GetString && gl.GetIntegerv && gl.CreateProgram && gl.DeleteProgram && gl.GetProgramiv
+        && gl.GetProgramBinary && gl.ProgramBinary && gl.GetAttribLocation && gl.GetUniformLocation;
+}
+
+ShaderCache ShaderCacheNew(const char* directory)
+{
+    ShaderCache cache = { 0 };
+    strncpy(cache.directory, directory, sizeof(cache.directory) - 1);
+
+    int formatCount = 0;
+    if (LoadGLFunctions())
+    {
+        gl.GetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    }
+
+    if (formatCount > 0)
+    {
+        char driver[512];
+        snprintf(driver, sizeof(driver), "%s|%s|%s|%s",
+            (const char*)gl.GetString(GL_VENDOR), (const char*)gl.GetString(GL_RENDERER), (const char*)gl.GetString(GL_VERSION), RAYLIB_VERSION_NAME);
+
+        cache.available = true;
+        cache.driverHash = ShaderCacheMakeKey(driver, NULL, NULL).driverHash;
+    }
+
+    return cache;
+}
+
+// Same locations LoadShaderCode look up, attributes keep the locations bound before the original link
+static void SetDefaultLocations(Shader* shader)
+{
+    shader->locs[LOC_VERTEX_POSITION]       = gl.GetAttribLocation(shader->id, "vertexPosition");
+    shader->locs[LOC_VERTEX_TEXCOORD01]     = gl.GetAttribLocation(shader->id, "vertexTexCoord");
+    shader->locs[LOC_VERTEX_TEXCOORD02]     = gl.GetAttribLocation(shader->id, "vertexTexCoord2");
+    shader->locs[LOC_VERTEX_NORMAL]         = gl.GetAttribLocation(shader->id, "vertexNormal");
+    shader->locs[LOC_VERTEX_TANGENT]        = gl.GetAttribLocation(shader->id, "vertexTangent");
+    shader->locs[LOC_VERTEX_COLOR]          = gl.GetAttribLocation(shader->id, "vertexColor");
+
+    shader->locs[LOC_MATRIX_MVP]            = gl.GetUniformLocation(shader->id, "mvp");
+    shader->locs[LOC_MATRIX_PROJECTION]     = gl.GetUniformLocation(shader->id, "projection");
+    shader->locs[LOC_MATRIX_VIEW]           = gl.GetUniformLocation(shader->id, "view");
+
+    shader->locs[LOC_COLOR_DIFFUSE]         = gl.GetUniformLocation(shader->id, "colDiffuse");
+    shader->locs[LOC_MAP_DIFFUSE]           = gl.GetUniformLocation(shader->id, "texture0");
+    shader->locs[LOC_MAP_SPECULAR]          = gl.GetUniformLocation(shader->id, "texture1");
+    shader->locs[LOC_MAP_NORMAL]            = gl.GetUniformLocation(shader->id, "texture2");
+}
+
+static bool LoadProgramBinary(const ShaderBinary* binary, Shader* outShader)
+{
+    unsigned int program = gl.CreateProgram();
+    gl.ProgramBinary(program, binary->format, binary->data, (int)binary->size);
+
+    int linked = 0;
+    gl.GetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+        gl.DeleteProgram(program);
+        return false;
+    }
+
+    Shader shader = { program, (int*)malloc(sizeof(int) * SHADER_LOCATION_COUNT) };
+    for (int i = 0; i < SHADER_LOCATION_COUNT; i++)
+    {
+        shader.locs[i] = -1;
+    }
+
+    SetDefaultLocations(&shader);
+    *outShader = shader;
+    return true;
+}
+
+// raylib link without GL_PROGRAM_BINARY_RETRIEVABLE_HINT, drivers that need it report an empty binary
+static bool GetProgramBinary(Shader shader, ShaderBinary* outBinary)
+{
+    int length = 0;
+    gl.GetProgramiv(shader.id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return false;
+    }
+
+    ShaderBinary binary = { 0, 0, malloc(length) };
+    int written = 0;
+    gl.GetProgramBinary(shader.id, length, &written, &binary.format, binary.data);
+    binary.size = (uint32_t)written;
+
+    if (written <= 0)
+    {
+        ShaderBinaryFree(&binary);
+        return false;
+    }
+
+    *outBinary = binary;
+    return true;
+}
+
+Shader ShaderCacheLoad(ShaderCache* cache, const char* name, const char* vsCode, const char* fsCode)
+{
+    if (!cache->available)
+    {
+        return LoadShaderCode(vsCode, fsCode);
+    }
+
+    ShaderCacheKey key = ShaderCacheMakeKey(NULL, vsCode, fsCode);
+    key.driverHash = cache->driverHash;
+
+    ShaderBinary binary;
+    if (ShaderCacheRead(cache->directory, name, key, &binary) == SHADER_CACHE_HIT)
+    {
+        Shader shader;
+        bool loaded = LoadProgramBinary(&binary, &shader);
+        ShaderBinaryFree(&binary);
+
+        if (loaded)
+        {
+            cache->stats.hits++;
+            return shader;
+        }
+
+        cache->stats.rejected++;
+    }
+    cache->stats.misses++;
+
+    Shader shader = LoadShaderCode(vsCode, fsCode);
+    if (shader.id == 0 || shader.id == GetShaderDefault().id)
+    {
+        // Nothing worth caching, keep the stale entry out of the way of the next launch
+        ShaderCacheRemove(cache->directory, name);
+        return shader;
+    }
+
+    if (GetProgramBinary(shader, &binary))
+    {
+        cache->stats.written += ShaderCacheWrite(cache->directory, name, key, binary);
+        ShaderBinaryFree(&binary);
+    }
+
+    return shader;
+}
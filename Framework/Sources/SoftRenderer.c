@@ -0,0 +1,408 @@
+#include "SoftRenderer.h"
+#include "Memory.h"
+#include "JobSystem.h"
+
+#include <math.h>
+#include <string.h>
+
+typedef struct SoftColor
+{
+    float r, g, b, a;
+} SoftColor;
+
+static void SoftClear(void* userData, Color color);
+static void SoftSetBlendMode(void* userData, int blendMode);
+static void SoftDrawTriangles(void* userData, unsigned int textureId, const RendererVertex* vertices, int vertexCount);
+
+SoftRenderer SoftRendererNew(int width, int height)
+{
+    SoftRenderer renderer = { 0 };
+    renderer.width = width;
+    renderer.height = height;
+    renderer.pixels = (uint8_t*)MemoryAlloc((size_t)width * height * 4);
+    MemoryInit(renderer.pixels, 0, (size_t)width * height * 4);
+
+    renderer.tileColumns = (width + SOFT_RENDERER_TILE_SIZE - 1) / SOFT_RENDERER_TILE_SIZE;
+    renderer.tileRows = (height + SOFT_RENDERER_TILE_SIZE - 1) / SOFT_RENDERER_TILE_SIZE;
+
+    int tileCount = renderer.tileColumns * renderer.tileRows;
+    renderer.tileBins = (Array(int)*)MemoryAlloc(sizeof(Array(int)) * tileCount);
+    renderer.tilePixels = (int64_t*)MemoryAlloc(sizeof(int64_t) * tileCount);
+    for (int i = 0; i < tileCount; i++)
+    {
+        renderer.tileBins[i] = ArrayNew(int, 64);
+    }
+
+    renderer.triangles = ArrayNew(SoftTriangle, 1024);
+    renderer.textures = ArrayNew(SoftTexture, 16);
+    renderer.nextTextureId = 1;
+    renderer.blendMode = BLEND_ALPHA;
+    return renderer;
+}
+
+void SoftRendererFree(SoftRenderer* renderer)
+{
+    for (int i = 0, n = renderer->tileColumns * renderer->tileRows; i < n; i++)
+    {
+        ArrayFree(renderer->tileBins[i]);
+    }
+
+    for (int i = 0, n = ArrayCount(renderer->textures); i < n; i++)
+    {
+        MemoryFree(renderer->textures[i].pixels);
+    }
+
+    MemoryFree(renderer->tileBins);
+    MemoryFree(renderer->tilePixels);
+    MemoryFree(renderer->pixels);
+    ArrayFree(renderer->triangles);
+    ArrayFree(renderer->textures);
+    *renderer = (SoftRenderer) { 0 };
+}
+
+const RendererBackend* SoftRendererGetBackend(SoftRenderer* renderer)
+{
+    renderer->backend = (RendererBackend) { renderer, SoftClear, SoftSetBlendMode, NULL, SoftDrawTriangles, NULL };
+    return &renderer->backend;
+}
+
+Texture SoftRendererLoadTexture(SoftRenderer* renderer, Image image)
+{
+    Image copy = ImageCopy(image);
+    ImageFormat(&copy, UNCOMPRESSED_R8G8B8A8);
+
+    SoftTexture texture = { renderer->nextTextureId++, copy.width, copy.height, (uint8_t*)MemoryAlloc((size_t)copy.width * copy.height * 4) };
+    MemoryCopy(texture.pixels, copy.data, (size_t)copy.width * copy.height * 4);
+    UnloadImage(copy);
+
+    ArrayPush(renderer->textures, texture);
+    return (Texture) { texture.id, texture.width, texture.height, 1, UNCOMPRESSED_R8G8B8A8 };
+}
+
+void SoftRendererUnloadTexture(SoftRenderer* renderer, Texture texture)
+{
+    SoftRendererFlush(renderer);
+
+    for (int i = 0, n = ArrayCount(renderer->textures); i < n; i++)
+    {
+        if (renderer->textures[i].id == texture.id)
+        {
+            MemoryFree(renderer->textures[i].pixels);
+            renderer->textures[i] = renderer->textures[n - 1];
+            ArraySetCount(renderer->textures, n - 1);
+            return;
+        }
+    }
+}
+
+static void SoftClear(void* userData, Color color)
+{
+    SoftRenderer* renderer = (SoftRenderer*)userData;
+
+    // Triangles queued before the clear are drawn first, they may be read back
+    SoftRendererFlush(renderer);
+
+    uint8_t* pixels = renderer->pixels;
+    for (int i = 0, n = renderer->width * renderer->height; i < n; i++)
+    {
+        pixels[i * 4 + 0] = color.r;
+        pixels[i * 4 + 1] = color.g;
+        pixels[i * 4 + 2] = color.b;
+        pixels[i * 4 + 3] = color.a;
+    }
+}
+
+static void SoftSetBlendMode(void* userData, int blendMode)
+{
+    SoftRenderer* renderer = (SoftRenderer*)userData;
+    if (renderer->blendMode != blendMode)
+    {
+        renderer->blendMode = blendMode;
+        renderer->stats.blendChanges++;
+    }
+}
+
+static void SoftDrawTriangles(void* userData, unsigned int textureId, const RendererVertex* vertices, int vertexCount)
+{
+    SoftRenderer* renderer = (SoftRenderer*)userData;
+
+    renderer->stats.drawCalls++;
+    if (textureId != renderer->lastTextureId)
+    {
+        renderer->lastTextureId = textureId;
+        renderer->stats.textureChanges++;
+    }
+
+    for (int i = 0; i + 3 <= vertexCount; i += 3)
+    {
+        SoftTriangle triangle = { { vertices[i], vertices[i + 1], vertices[i + 2] }, textureId, renderer->blendMode };
+        ArrayPush(renderer->triangles, triangle);
+        renderer->stats.triangles++;
+    }
+}
+
+static const SoftTexture* FindTexture(const SoftRenderer* renderer, unsigned int id)
+{
+    for (int i = 0, n = ArrayCount(renderer->textures); i < n; i++)
+    {
+        if (renderer->textures[i].id == id)
+        {
+            return &renderer->textures[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Texel with repeat wrap, white for untextured triangles and unknown ids
+static SoftColor SampleTexture(const SoftTexture* texture, float u, float v)
+{
+    if (!texture)
+    {
+        return (SoftColor) { 1.0f, 1.0f, 1.0f, 1.0f };
+    }
+
+    int x = (int)floorf(u * texture->width) % texture->width;
+    int y = (int)floorf(v * texture->height) % texture->height;
+    x += x < 0 ? texture->width : 0;
+    y += y < 0 ? texture->height : 0;
+
+    const uint8_t* texel = texture->pixels + ((size_t)y * texture->width + x) * 4;
+    return (SoftColor) { texel[0] / 255.0f, texel[1] / 255.0f, texel[2] / 255.0f, texel[3] / 255.0f };
+}
+
+static float Saturate(float value)
+{
+    return value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+}
+
+// Same factors as raylib BeginBlendMode, applied to color and alpha alike
+static void BlendPixel(uint8_t* pixel, SoftColor source, int blendMode)
+{
+    SoftColor dest = { pixel[0] / 255.0f, pixel[1] / 255.0f, pixel[2] / 255.0f, pixel[3] / 255.0f };
+    SoftColor result;
+
+    switch (blendMode)
+    {
+    case BLEND_ADDITIVE:
+        result.r = source.r * source.a + dest.r;
+        result.g = source.g * source.a + dest.g;
+        result.b = source.b * source.a + dest.b;
+        result.a = source.a * source.a + dest.a;
+        break;
+
+    case BLEND_MULTIPLIED:
+        result.r = source.r * dest.r + dest.r * (1.0f - source.a);
+        result.g = source.g * dest.g + dest.g * (1.0f - source.a);
+        result.b = source.b * dest.b + dest.b * (1.0f - source.a);
+        result.a = source.a * dest.a + dest.a * (1.0f - source.a);
+        break;
+
+    default:
+        result.r = source.r * source.a + dest.r * (1.0f - source.a);
+        result.g = source.g * source.a + dest.g * (1.0f - source.a);
+        result.b = source.b * source.a + dest.b * (1.0f - source.a);
+        result.a = source.a * source.a + dest.a * (1.0f - source.a);
+        break;
+    }
+
+    pixel[0] = (uint8_t)(Saturate(result.r) * 255.0f + 0.5f);
+    pixel[1] = (uint8_t)(Saturate(result.g) * 255.0f + 0.5f);
+    pixel[2] = (uint8_t)(Saturate(result.b) * 255.0f + 0.5f);
+    pixel[3] = (uint8_t)(Saturate(result.a) * 255.0f + 0.5f);
+}
+
+// Pixels on a shared edge belong to one side only, so quads never blend their diagonal twice
+static bool IsOwnedEdge(float dx, float dy)
+{
+    return dy > 0.0f || (dy == 0.0f && dx < 0.0f);
+}
+
+static int64_t RasterizeTriangle(const SoftRenderer* renderer, const SoftTriangle* triangle, int minTileX, int minTileY, int maxTileX, int maxTileY)
+{
+    const RendererVertex* v0 = &triangle->vertices[0];
+    const RendererVertex* v1 = &triangle->vertices[1];
+    const RendererVertex* v2 = &triangle->vertices[2];
+
+    float area = (v1->x - v0->x) * (v2->y - v0->y) - (v1->y - v0->y) * (v2->x - v0->x);
+    if (area == 0.0f)
+    {
+        return 0;
+    }
+
+    if (area < 0.0f)
+    {
+        const RendererVertex* swap = v1;
+        v1 = v2;
+        v2 = swap;
+        area = -area;
+    }
+
+    float minX = fminf(v0->x, fminf(v1->x, v2->x));
+    float maxX = fmaxf(v0->x, fmaxf(v1->x, v2->x));
+    float minY = fminf(v0->y, fminf(v1->y, v2->y));
+    float maxY = fmaxf(v0->y, fmaxf(v1->y, v2->y));
+
+    int x0 = (int)floorf(minX) > minTileX ? (int)floorf(minX) : minTileX;
+    int y0 = (int)floorf(minY) > minTileY ? (int)floorf(minY) : minTileY;
+    int x1 = (int)ceilf(maxX) < maxTileX ? (int)ceilf(maxX) : maxTileX;
+    int y1 = (int)ceilf(maxY) < maxTileY ? (int)ceilf(maxY) : maxTileY;
+
+    // Edge functions E(p) = dx (p.y - a.y) - dy (p.x - a.x), positive inside
+    const RendererVertex* starts[3] = { v1, v2, v0 };
+    const RendererVertex* ends[3] = { v2, v0, v1 };
+    float edgeX[3], edgeY[3], edgeC[3];
+    bool owned[3];
+    for (int i = 0; i < 3; i++)
+    {
+        float dx = ends[i]->x - starts[i]->x;
+        float dy = ends[i]->y - starts[i]->y;
+        edgeX[i] = -dy;
+        edgeY[i] = dx;
+        edgeC[i] = dy * starts[i]->x - dx * starts[i]->y;
+        owned[i] = IsOwnedEdge(dx, dy);
+    }
+
+    const SoftTexture* texture = triangle->textureId ? FindTexture(renderer, triangle->textureId) : NULL;
+    float invArea = 1.0f / area;
+    int64_t shaded = 0;
+
+    for (int y = y0; y < y1; y++)
+    {
+        float py = y + 0.5f;
+        uint8_t* row = renderer->pixels + (size_t)y * renderer->width * 4;
+
+        // Step the edge functions along the row, the span is convex so it end at the first miss after a hit
+        float rowX = x0 + 0.5f;
+        float w[3];
+        for (int i = 0; i < 3; i++)
+        {
+            w[i] = edgeX[i] * rowX + edgeY[i] * py + edgeC[i];
+        }
+
+        bool entered = false;
+        for (int x = x0; x < x1; x++, w[0] += edgeX[0], w[1] += edgeX[1], w[2] += edgeX[2])
+        {
+            bool inside = (w[0] > 0.0f || (w[0] == 0.0f && owned[0]))
+                       && (w[1] > 0.0f || (w[1] == 0.0f && owned[1]))
+                       && (w[2] > 0.0f || (w[2] == 0.0f && owned[2]));
+            if (!inside)
+            {
+                if (entered)
+                {
+                    break;
+                }
+                continue;
+            }
+            entered = true;
+
+            float l0 = w[0] * invArea;
+            float l1 = w[1] * invArea;
+            float l2 = w[2] * invArea;
+
+            SoftColor texel = SampleTexture(texture, l0 * v0->u + l1 * v1->u + l2 * v2->u, l0 * v0->v + l1 * v1->v + l2 * v2->v);
+            SoftColor color = {
+                texel.r * (l0 * v0->color.r + l1 * v1->color.r + l2 * v2->color.r) / 255.0f,
+                texel.g * (l0 * v0->color.g + l1 * v1->color.g + l2 * v2->color.g) / 255.0f,
+                texel.b * (l0 * v0->color.b + l1 * v1->color.b + l2 * v2->color.b) / 255.0f,
+                texel.a * (l0 * v0->color.a + l1 * v1->color.a + l2 * v2->color.a) / 255.0f,
+            };
+
+            BlendPixel(row + x * 4, color, triangle->blendMode);
+            shaded++;
+        }
+    }
+
+    return shaded;
+}
+
+static void RasterizeTiles(void* userData, int start, int end, int batchIndex)
+{
+    SoftRenderer* renderer = (SoftRenderer*)userData;
+    (void)batchIndex;
+
+    for (int tile = start; tile < end; tile++)
+    {
+        int minX = (tile % renderer->tileColumns) * SOFT_RENDERER_TILE_SIZE;
+        int minY = (tile / renderer->tileColumns) * SOFT_RENDERER_TILE_SIZE;
+        int maxX = minX + SOFT_RENDERER_TILE_SIZE < renderer->width ? minX + SOFT_RENDERER_TILE_SIZE : renderer->width;
+        int maxY = minY + SOFT_RENDERER_TILE_SIZE < renderer->height ? minY + SOFT_RENDERER_TILE_SIZE : renderer->height;
+
+        // Tiles own disjoint pixels, triangles are drawn in submission order within each
+        int64_t shaded = 0;
+        Array(int) bin = renderer->tileBins[tile];
+        for (int i = 0, n = ArrayCount(bin); i < n; i++)
+        {
+            shaded += RasterizeTriangle(renderer, &renderer->triangles[bin[i]], minX, minY, maxX, maxY);
+        }
+
+        renderer->tilePixels[tile] = shaded;
+    }
+}
+
+void SoftRendererFlush(SoftRenderer* renderer)
+{
+    int triangleCount = ArrayCount(renderer->triangles);
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    int tileCount = renderer->tileColumns * renderer->tileRows;
+    for (int i = 0; i < tileCount; i++)
+    {
+        ArrayClear(renderer->tileBins[i]);
+    }
+
+    for (int i = 0; i < triangleCount; i++)
+    {
+        const RendererVertex* v = renderer->triangles[i].vertices;
+        float minX = fminf(v[0].x, fminf(v[1].x, v[2].x));
+        float maxX = fmaxf(v[0].x, fmaxf(v[1].x, v[2].x));
+        float minY = fminf(v[0].y, fminf(v[1].y, v[2].y));
+        float maxY = fmaxf(v[0].y, fmaxf(v[1].y, v[2].y));
+
+        if (maxX < 0.0f || maxY < 0.0f || minX >= renderer->width || minY >= renderer->height)
+        {
+            continue;
+        }
+
+        int tileX0 = minX <= 0.0f ? 0 : (int)minX / SOFT_RENDERER_TILE_SIZE;
+        int tileY0 = minY <= 0.0f ? 0 : (int)minY / SOFT_RENDERER_TILE_SIZE;
+        int tileX1 = maxX >= renderer->width ? renderer->tileColumns - 1 : (int)maxX / SOFT_RENDERER_TILE_SIZE;
+        int tileY1 = maxY >= renderer->height ? renderer->tileRows - 1 : (int)maxY / SOFT_RENDERER_TILE_SIZE;
+
+        for (int ty = tileY0; ty <= tileY1; ty++)
+        {
+            for (int tx = tileX0; tx <= tileX1; tx++)
+            {
+                ArrayPush(renderer->tileBins[ty * renderer->tileColumns + tx], i);
+            }
+        }
+    }
+
+    ParallelFor(tileCount, 1, RasterizeTiles, renderer);
+
+    for (int i = 0; i < tileCount; i++)
+    {
+        renderer->stats.pixelsShaded += renderer->tilePixels[i];
+        renderer->tilePixels[i] = 0;
+    }
+
+    ArrayClear(renderer->triangles);
+}
+
+SoftRendererStats SoftRendererEndFrame(SoftRenderer* renderer)
+{
+    SoftRendererFlush(renderer);
+
+    SoftRendererStats stats = renderer->stats;
+    renderer->stats = (SoftRendererStats) { 0 };
+    renderer->lastTextureId = 0;
+    return stats;
+}
+
+Image SoftRendererGetImage(SoftRenderer* renderer)
+{
+    return (Image) { renderer->pixels, renderer->width, renderer->height, 1, UNCOMPRESSED_R8G8B8A8 };
+}
@@ -0,0 +1,1337 @@
+#include "SpringGrid.h"
+#include "Memory.h"
+#include "FastMath.h"
+#include "AssetArchive.h"
+
+#include <math.h>
+
+#define FLOAT_ARRAY_COUNT   6       // Per point arrays carved in the grid block
+#define TILE_FLOAT_COUNT    3       // Per tile floats: motion, damping and velocity scale
+#define TILE_SIZE           SPRING_GRID_TILE_SIZE
+
+// Run of awake tiles in a tile row, passes update the points of the run at once
+typedef struct TileSpan
+{
+    int     tileY;
+    int     tileX0, tileX1;     // Tiles of the run, the tiles left and right of it sleep or are outside
+    int     i0, i1;             // Rows of points
+    int     j0, j1;             // Columns of points
+} TileSpan;
+
+static int PadToLanes(int count)
+{
+    return (count + 3) & ~3;
+}
+
+static int MinInt(int a, int b)
+{
+    return a < b ? a : b;
+}
+
+static int MaxInt(int a, int b)
+{
+    return a > b ? a : b;
+}
+
+// Bytes of the block holding every array of the grid
+static size_t BlockSize(int cols, int rows)
+{
+    int tileCount = ((cols + TILE_SIZE - 1) / TILE_SIZE) * ((rows + TILE_SIZE - 1) / TILE_SIZE);
+
+    // Floats first, the tile flags at the end keep the arrays aligned
+    size_t floatCount = (size_t)FLOAT_ARRAY_COUNT * PadToLanes(cols * rows) + 2 * PadToLanes(cols + 1) + TILE_FLOAT_COUNT * tileCount;
+    return sizeof(float) * floatCount + 2 * tileCount;
+}
+
+// Allocate the block and carve the arrays in it, the arrays are left uninitialized
+static SpringGrid AllocGrid(int cols, int rows, Vector2 origin, Vector2 spacing, SpringGridParams params)
+{
+    int count = cols * rows;
+    int stride = PadToLanes(count);
+    int rowStride = PadToLanes(cols + 1);
+    int tileCols = (cols + TILE_SIZE - 1) / TILE_SIZE;
+    int tileRows = (rows + TILE_SIZE - 1) / TILE_SIZE;
+    int tileCount = tileCols * tileRows;
+
+    size_t floatCount = (size_t)FLOAT_ARRAY_COUNT * stride + 2 * rowStride + TILE_FLOAT_COUNT * tileCount;
+    float* block = (float*)MemoryAlloc(BlockSize(cols, rows));
+    if (!block)
+    {
+        return (SpringGrid) { 0 };
+    }
+
+    float* tiles = block + FLOAT_ARRAY_COUNT * stride + 2 * rowStride;
+    uint8_t* tileAwake = (uint8_t*)(block + floatCount);
+    return (SpringGrid) {
+        .cols               = cols,
+        .rows               = rows,
+        .count              = count,
+        .origin             = origin,
+        .spacing            = spacing,
+        .params             = params,
+
+        .positionX          = block + 0 * stride,
+        .positionY          = block + 1 * stride,
+        .prevPositionX      = block + 2 * stride,
+        .prevPositionY      = block + 3 * stride,
+        .accelerationX      = block + 4 * stride,
+        .accelerationY      = block + 5 * stride,
+        .forceX             = block + FLOAT_ARRAY_COUNT * stride,
+        .forceY             = block + FLOAT_ARRAY_COUNT * stride + rowStride,
+
+        .tileCols           = tileCols,
+        .tileRows           = tileRows,
+        .tileAwake          = tileAwake,
+        .tileQuietTicks     = tileAwake + tileCount,
+        .tileMotion         = tiles,
+        .tileDamping        = tiles + tileCount,
+        .tileVelocityScale  = tiles + 2 * tileCount,
+    };
+}
+
+SpringGrid SpringGridNew(int cols, int rows, Vector2 origin, Vector2 spacing, SpringGridParams params)
+{
+    if (cols < 2 || rows < 2)
+    {
+        return (SpringGrid) { 0 };
+    }
+
+    SpringGrid grid = AllocGrid(cols, rows, origin, spacing, params);
+    if (!grid.positionX)
+    {
+        return (SpringGrid) { 0 };
+    }
+    MemoryInit(grid.positionX, 0, BlockSize(cols, rows));
+
+    for (int i = 0; i < rows; i++)
+    {
+        for (int j = 0; j < cols; j++)
+        {
+            int index = i * cols + j;
+
+            grid.positionX[index] = grid.prevPositionX[index] = origin.x + j * spacing.x;
+            grid.positionY[index] = grid.prevPositionY[index] = origin.y + i * spacing.y;
+        }
+    }
+
+    // Start awake so the grid settle on its springs before the tiles sleep
+    // Points have not moved yet, their velocity is 0 whatever the scale
+    int tileCount = grid.tileCols * grid.tileRows;
+    for (int tile = 0; tile < tileCount; tile++)
+    {
+        grid.tileDamping[tile] = params.pointDamping;
+    }
+    MemoryInit(grid.tileAwake, 1, tileCount);
+    MemoryInit(grid.tileQuietTicks, 1, tileCount);
+
+    return grid;
+}
+
+void SpringGridFree(SpringGrid* grid)
+{
+    // Every array live in the block of positionX
+    MemoryFree(grid->positionX);
+    *grid = (SpringGrid) { 0 };
+}
+
+bool SpringGridIsValid(SpringGrid grid)
+{
+    return grid.count > 0 && grid.positionX != NULL;
+}
+
+static int TileOfPoint(const SpringGrid* grid, int index)
+{
+    int i = index / grid->cols;
+    int j = index - i * grid->cols;
+    return (i / TILE_SIZE) * grid->tileCols + j / TILE_SIZE;
+}
+
+static bool IsTileAwake(const SpringGrid* grid, int tileY, int tileX)
+{
+    if (tileY < 0 || tileX < 0 || tileY >= grid->tileRows || tileX >= grid->tileCols)
+    {
+        return false;
+    }
+
+    return grid->tileAwake[tileY * grid->tileCols + tileX] != 0;
+}
+
+void SpringGridWake(SpringGrid grid, int index)
+{
+    int tile = TileOfPoint(&grid, index);
+    grid.tileAwake[tile] = 1;
+    grid.tileQuietTicks[tile] = 0;
+}
+
+int SpringGridAwakeTileCount(SpringGrid grid)
+{
+    int count = 0;
+    for (int i = 0, n = grid.tileCols * grid.tileRows; i < n; i++)
+    {
+        count += grid.tileAwake[i];
+    }
+    return count;
+}
+
+void SpringGridApplyForce(SpringGrid grid, int index, Vector2 force, float timeStep)
+{
+    grid.accelerationX[index] += force.x * timeStep;
+    grid.accelerationY[index] += force.y * timeStep;
+    SpringGridWake(grid, index);
+}
+
+// The whole tile share the damping, it is raised once per update whatever the number of points and impulses
+void SpringGridIncreaseDamping(SpringGrid grid, int index, float factor)
+{
+    int tile = TileOfPoint(&grid, index);
+    grid.tileDamping[tile] = fmaxf(grid.tileDamping[tile], grid.params.pointDamping * factor);
+}
+
+// Lattice line at or before position, clamped to [0, count]
+static int LatticeIndex(float position, float spacing, int count)
+{
+    return (int)fmaxf(0.0f, fminf((float)count, floorf(position / spacing)));
+}
+
+SpringGridRange SpringGridRangeInRadius(SpringGrid grid, Vector2 position, float radius)
+{
+    float reach = radius + fmaxf(grid.spacing.x, grid.spacing.y);
+    float x = position.x - grid.origin.x;
+    float y = position.y - grid.origin.y;
+
+    SpringGridRange range;
+    range.row0 = LatticeIndex(y - reach, grid.spacing.y, grid.rows);
+    range.row1 = LatticeIndex(y + reach + grid.spacing.y, grid.spacing.y, grid.rows);
+    range.col0 = LatticeIndex(x - reach, grid.spacing.x, grid.cols);
+    range.col1 = LatticeIndex(x + reach + grid.spacing.x, grid.spacing.x, grid.cols);
+    if (range.row0 >= range.row1 || range.col0 >= range.col1)
+    {
+        range.row1 = range.row0;
+    }
+    return range;
+}
+
+Vector2 SpringGridPosition(SpringGrid grid, int index)
+{
+    return (Vector2) { grid.positionX[index], grid.positionY[index] };
+}
+
+// Velocity scale of the tiles of row i, the velocity of a point is its last move times the scale of its tile
+static inline const float* RowVelocityScales(const SpringGrid* grid, int i)
+{
+    return grid->tileVelocityScale + (i / TILE_SIZE) * grid->tileCols;
+}
+
+// Tiles of a row share their scale unless an impulse raised the damping of some, the passes then skip the lookups
+static bool SameVelocityScales(const float* scales, int tileX0, int tileX1)
+{
+    for (int tileX = tileX0 + 1; tileX < tileX1; tileX++)
+    {
+        if (scales[tileX] != scales[tileX0])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if FASTMATH_SSE
+// Scales of the columns j to j + 3, the lanes can cross a tile border
+static inline __m128 ColumnScales4(const float* scales, int j)
+{
+    return _mm_set_ps(scales[(j + 3) / TILE_SIZE], scales[(j + 2) / TILE_SIZE], scales[(j + 1) / TILE_SIZE], scales[j / TILE_SIZE]);
+}
+#endif
+
+Vector2 SpringGridVelocity(SpringGrid grid, int index)
+{
+    int i = index / grid.cols;
+    float scale = RowVelocityScales(&grid, i)[(index - i * grid.cols) / TILE_SIZE];
+    return (Vector2) { (grid.positionX[index] - grid.prevPositionX[index]) * scale, (grid.positionY[index] - grid.prevPositionY[index]) * scale };
+}
+
+Vector2 SpringGridRenderPosition(SpringGrid grid, int index, float alpha)
+{
+    float x = grid.prevPositionX[index] + (grid.positionX[index] - grid.prevPositionX[index]) * alpha;
+    float y = grid.prevPositionY[index] + (grid.positionY[index] - grid.prevPositionY[index]) * alpha;
+    return (Vector2) { x, y };
+}
+
+// Find the next run of awake tiles from tile, in row order
+static bool NextTileSpan(const SpringGrid* grid, int* tile, TileSpan* span)
+{
+    int tileCount = grid->tileCols * grid->tileRows;
+    while (*tile < tileCount && !grid->tileAwake[*tile])
+    {
+        (*tile)++;
+    }
+
+    if (*tile >= tileCount)
+    {
+        return false;
+    }
+
+    span->tileY = *tile / grid->tileCols;
+    span->tileX0 = *tile - span->tileY * grid->tileCols;
+    span->tileX1 = span->tileX0;
+    while (span->tileX1 < grid->tileCols && grid->tileAwake[span->tileY * grid->tileCols + span->tileX1])
+    {
+        span->tileX1++;
+    }
+    *tile = span->tileY * grid->tileCols + span->tileX1;
+
+    span->i0 = span->tileY * TILE_SIZE;
+    span->i1 = MinInt(span->i0 + TILE_SIZE, grid->rows);
+    span->j0 = span->tileX0 * TILE_SIZE;
+    span->j1 = MinInt(span->tileX1 * TILE_SIZE, grid->cols);
+    return true;
+}
+
+static float DampingFactor(float damping, float timeStep)
+{
+    return fmaxf(0.0f, 1.0f - damping * timeStep);
+}
+
+// Force on the end b of a spring from a to b, zero until it is stretched past its rest length
+static inline void SpringForce(float dx, float dy, float dvx, float dvy, float restLength, float stiffness, float velocityFactor, float* outX, float* outY)
+{
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length > restLength)
+    {
+        float changeRate = (length - restLength) / length;
+        *outX = dx * stiffness * changeRate - dvx * velocityFactor;
+        *outY = dy * stiffness * changeRate - dvy * velocityFactor;
+    }
+    else
+    {
+        *outX = 0.0f;
+        *outY = 0.0f;
+    }
+}
+
+#if FASTMATH_SSE
+static inline void SpringForce4(__m128 dx, __m128 dy, __m128 dvx, __m128 dvy, __m128 restLength, __m128 stiffness, __m128 velocityFactor, __m128* outX, __m128* outY)
+{
+    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+    __m128 stretched = _mm_cmpgt_ps(length, restLength);
+
+    // Lanes at rest divide by zero, the mask clear them
+    __m128 scale = _mm_mul_ps(stiffness, _mm_div_ps(_mm_sub_ps(length, restLength), length));
+    *outX = _mm_and_ps(stretched, _mm_sub_ps(_mm_mul_ps(dx, scale), _mm_mul_ps(dvx, velocityFactor)));
+    *outY = _mm_and_ps(stretched, _mm_sub_ps(_mm_mul_ps(dy, scale), _mm_mul_ps(dvy, velocityFactor)));
+}
+#endif
+
+// Anchors have a rest length of zero, their fixed end is the rest position of the point and does not move
+static inline void UpdateAnchorPoint(SpringGrid* grid, int i, int j, float stiffness, float velocityFactor, float forceScale)
+{
+    int index = i * grid->cols + j;
+    float dx = grid->origin.x + j * grid->spacing.x - grid->positionX[index];
+    float dy = grid->origin.y + i * grid->spacing.y - grid->positionY[index];
+    float scale = RowVelocityScales(grid, i)[j / TILE_SIZE];
+    float vx = (grid->positionX[index] - grid->prevPositionX[index]) * scale;
+    float vy = (grid->positionY[index] - grid->prevPositionY[index]) * scale;
+
+    float forceX, forceY;
+    SpringForce(dx, dy, vx, vy, 0.0f, stiffness, velocityFactor, &forceX, &forceY);
+    grid->accelerationX[index] += forceX * forceScale;
+    grid->accelerationY[index] += forceY * forceScale;
+}
+
+// Every point of the row between j0 and j1 is anchored with the same spring, the top and bottom borders
+static void UpdateAnchorRow(SpringGrid* grid, int i, int j0, int j1, float stiffness, float velocityFactor, float forceScale)
+{
+    int j = j0;
+    int row = i * grid->cols;
+
+#if FASTMATH_SSE
+    // j0 is a tile border, the 4 lanes of a step are in the same tile
+    const float* scales = RowVelocityScales(grid, i);
+    const __m128 scale = _mm_set1_ps(forceScale);
+    const __m128 restY = _mm_set1_ps(grid->origin.y + i * grid->spacing.y);
+    for (; j + 4 <= j1; j += 4)
+    {
+        int index = row + j;
+        __m128 column = _mm_add_ps(_mm_set1_ps((float)j), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+        __m128 restX = _mm_add_ps(_mm_set1_ps(grid->origin.x), _mm_mul_ps(column, _mm_set1_ps(grid->spacing.x)));
+        __m128 px = _mm_loadu_ps(grid->positionX + index);
+        __m128 py = _mm_loadu_ps(grid->positionY + index);
+        __m128 velocityScale = _mm_set1_ps(scales[j / TILE_SIZE]);
+        __m128 vx = _mm_mul_ps(_mm_sub_ps(px, _mm_loadu_ps(grid->prevPositionX + index)), velocityScale);
+        __m128 vy = _mm_mul_ps(_mm_sub_ps(py, _mm_loadu_ps(grid->prevPositionY + index)), velocityScale);
+
+        __m128 forceX, forceY;
+        SpringForce4(_mm_sub_ps(restX, px), _mm_sub_ps(restY, py), vx, vy,
+            _mm_setzero_ps(), _mm_set1_ps(stiffness), _mm_set1_ps(velocityFactor), &forceX, &forceY);
+        _mm_storeu_ps(grid->accelerationX + index, _mm_add_ps(_mm_loadu_ps(grid->accelerationX + index), _mm_mul_ps(forceX, scale)));
+        _mm_storeu_ps(grid->accelerationY + index, _mm_add_ps(_mm_loadu_ps(grid->accelerationY + index), _mm_mul_ps(forceY, scale)));
+    }
+#endif
+
+    for (; j < j1; j++)
+    {
+        UpdateAnchorPoint(grid, i, j, stiffness, velocityFactor, forceScale);
+    }
+}
+
+// First interior anchor column at or after j
+static int FirstAnchorColumn(int j, int step)
+{
+    j = MaxInt(j, step);
+    return (j + step - 1) / step * step;
+}
+
+// Anchor classes come from the indices: the border, and one interior point every anchorStep rows and columns
+// Only anchored points are visited, the rest of the span is not touched by this pass
+static void UpdateAnchorSprings(SpringGrid* grid, const TileSpan* span, float forceScale, float timeStep)
+{
+    const SpringGridParams* params = &grid->params;
+    const float borderFactor = fmaxf(0.0f, 1.0f - params->borderDamping * timeStep);
+    const float anchorFactor = fmaxf(0.0f, 1.0f - params->anchorDamping * timeStep);
+    const bool hasBorder = params->borderStiffness > 0.0f;
+    const bool hasAnchors = params->anchorStiffness > 0.0f && params->anchorStep > 0;
+
+    for (int i = span->i0; i < span->i1; i++)
+    {
+        bool borderRow = i == 0 || i == grid->rows - 1;
+        if (hasBorder)
+        {
+            if (borderRow)
+            {
+                UpdateAnchorRow(grid, i, span->j0, span->j1, params->borderStiffness, borderFactor, forceScale);
+                continue;
+            }
+
+            if (span->j0 == 0)
+            {
+                UpdateAnchorPoint(grid, i, 0, params->borderStiffness, borderFactor, forceScale);
+            }
+
+            if (span->j1 == grid->cols)
+            {
+                UpdateAnchorPoint(grid, i, grid->cols - 1, params->borderStiffness, borderFactor, forceScale);
+            }
+        }
+
+        if (hasAnchors && !borderRow && i % params->anchorStep == 0)
+        {
+            int end = MinInt(span->j1, grid->cols - 1);
+            for (int j = FirstAnchorColumn(span->j0, params->anchorStep); j < end; j += params->anchorStep)
+            {
+                UpdateAnchorPoint(grid, i, j, params->anchorStiffness, anchorFactor, forceScale);
+            }
+        }
+    }
+}
+
+// Spring j pull point j - 1 and point j of the row, forces are gathered in a row first so each point is written once
+// Springs crossing the ends of the span are computed too, a sleeping neighbor is read but never written
+static void UpdateHorizontalSprings(SpringGrid* grid, const TileSpan* span, float forceScale, float velocityFactor)
+{
+    const int cols = grid->cols;
+    const int j0 = span->j0;
+    const int j1 = span->j1;
+    const int first = MaxInt(j0, 1);
+    const int last = MinInt(j1, cols - 1);
+    const float restLength = grid->spacing.x * grid->params.restLength;
+    const float stiffness = grid->params.stiffness;
+
+    float* forceX = grid->forceX;
+    float* forceY = grid->forceY;
+    forceX[0] = forceY[0] = 0.0f;
+    forceX[cols] = forceY[cols] = 0.0f;
+
+    for (int i = span->i0; i < span->i1; i++)
+    {
+        const float* px = grid->positionX + i * cols;
+        const float* py = grid->positionY + i * cols;
+        const float* qx = grid->prevPositionX + i * cols;
+        const float* qy = grid->prevPositionY + i * cols;
+        const float* scales = RowVelocityScales(grid, i);
+        float* ax = grid->accelerationX + i * cols;
+        float* ay = grid->accelerationY + i * cols;
+
+        int j = first;
+#if FASTMATH_SSE
+        // Every lane of the row read the same scale, or each lane the scale of its tile
+        const bool uniform = SameVelocityScales(scales, (first - 1) / TILE_SIZE, last / TILE_SIZE + 1);
+        const __m128 rowScale = _mm_set1_ps(scales[(first - 1) / TILE_SIZE]);
+        for (; j + 4 <= last + 1; j += 4)
+        {
+            __m128 x0 = _mm_loadu_ps(px + j - 1), x1 = _mm_loadu_ps(px + j);
+            __m128 y0 = _mm_loadu_ps(py + j - 1), y1 = _mm_loadu_ps(py + j);
+            __m128 scale0 = uniform ? rowScale : ColumnScales4(scales, j - 1);
+            __m128 scale1 = uniform ? rowScale : ColumnScales4(scales, j);
+            __m128 dvx = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(x1, _mm_loadu_ps(qx + j)), scale1), _mm_mul_ps(_mm_sub_ps(x0, _mm_loadu_ps(qx + j - 1)), scale0));
+            __m128 dvy = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(y1, _mm_loadu_ps(qy + j)), scale1), _mm_mul_ps(_mm_sub_ps(y0, _mm_loadu_ps(qy + j - 1)), scale0));
+
+            __m128 fx, fy;
+            SpringForce4(_mm_sub_ps(x0, x1), _mm_sub_ps(y0, y1), dvx, dvy, _mm_set1_ps(restLength), _mm_set1_ps(stiffness), _mm_set1_ps(velocityFactor), &fx, &fy);
+            _mm_storeu_ps(forceX + j, fx);
+            _mm_storeu_ps(forceY + j, fy);
+        }
+#endif
+        for (; j <= last; j++)
+        {
+            float scale0 = scales[(j - 1) / TILE_SIZE], scale1 = scales[j / TILE_SIZE];
+            float dvx = (px[j] - qx[j]) * scale1 - (px[j - 1] - qx[j - 1]) * scale0;
+            float dvy = (py[j] - qy[j]) * scale1 - (py[j - 1] - qy[j - 1]) * scale0;
+            SpringForce(px[j - 1] - px[j], py[j - 1] - py[j], dvx, dvy, restLength, stiffness, velocityFactor, &forceX[j], &forceY[j]);
+        }
+
+        j = j0;
+#if FASTMATH_SSE
+        const __m128 scale = _mm_set1_ps(forceScale);
+        for (; j + 4 <= j1; j += 4)
+        {
+            __m128 fx = _mm_sub_ps(_mm_loadu_ps(forceX + j), _mm_loadu_ps(forceX + j + 1));
+            __m128 fy = _mm_sub_ps(_mm_loadu_ps(forceY + j), _mm_loadu_ps(forceY + j + 1));
+            _mm_storeu_ps(ax + j, _mm_add_ps(_mm_loadu_ps(ax + j), _mm_mul_ps(fx, scale)));
+            _mm_storeu_ps(ay + j, _mm_add_ps(_mm_loadu_ps(ay + j), _mm_mul_ps(fy, scale)));
+        }
+#endif
+        for (; j < j1; j++)
+        {
+            ax[j] += (forceX[j] - forceX[j + 1]) * forceScale;
+            ay[j] += (forceY[j] - forceY[j + 1]) * forceScale;
+        }
+    }
+}
+
+// Springs between row i - 1 and row i, both ends are in different rows so a whole row is done at once
+// The rows above and below the span are read for the crossing springs but only the rows of the span are written
+static void UpdateVerticalSprings(SpringGrid* grid, const TileSpan* span, float forceScale, float velocityFactor)
+{
+    const int cols = grid->cols;
+    const int j0 = span->j0;
+    const int j1 = span->j1;
+    const float restLength = grid->spacing.y * grid->params.restLength;
+    const float stiffness = grid->params.stiffness;
+
+    for (int i = MaxInt(span->i0, 1), last = MinInt(span->i1, grid->rows - 1); i <= last; i++)
+    {
+        int a = (i - 1) * cols;
+        int b = i * cols;
+        bool writeA = i - 1 >= span->i0;
+        bool writeB = i < span->i1;
+        const float* scalesA = RowVelocityScales(grid, i - 1);
+        const float* scalesB = RowVelocityScales(grid, i);
+
+        int j = j0;
+#if FASTMATH_SSE
+        // j0 is a tile border, the 4 lanes of a step are in the same tile
+        const __m128 scale = _mm_set1_ps(forceScale);
+        for (; j + 4 <= j1; j += 4)
+        {
+            __m128 xa = _mm_loadu_ps(grid->positionX + a + j), ya = _mm_loadu_ps(grid->positionY + a + j);
+            __m128 xb = _mm_loadu_ps(grid->positionX + b + j), yb = _mm_loadu_ps(grid->positionY + b + j);
+            __m128 scaleA = _mm_set1_ps(scalesA[j / TILE_SIZE]), scaleB = _mm_set1_ps(scalesB[j / TILE_SIZE]);
+            __m128 dvx = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(xb, _mm_loadu_ps(grid->prevPositionX + b + j)), scaleB),
+                _mm_mul_ps(_mm_sub_ps(xa, _mm_loadu_ps(grid->prevPositionX + a + j)), scaleA));
+            __m128 dvy = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(yb, _mm_loadu_ps(grid->prevPositionY + b + j)), scaleB),
+                _mm_mul_ps(_mm_sub_ps(ya, _mm_loadu_ps(grid->prevPositionY + a + j)), scaleA));
+            __m128 dx = _mm_sub_ps(xa, xb);
+            __m128 dy = _mm_sub_ps(ya, yb);
+
+            __m128 fx, fy;
+            SpringForce4(dx, dy, dvx, dvy, _mm_set1_ps(restLength), _mm_set1_ps(stiffness), _mm_set1_ps(velocityFactor), &fx, &fy);
+            fx = _mm_mul_ps(fx, scale);
+            fy = _mm_mul_ps(fy, scale);
+
+            if (writeA)
+            {
+                _mm_storeu_ps(grid->accelerationX + a + j, _mm_sub_ps(_mm_loadu_ps(grid->accelerationX + a + j), fx));
+                _mm_storeu_ps(grid->accelerationY + a + j, _mm_sub_ps(_mm_loadu_ps(grid->accelerationY + a + j), fy));
+            }
+
+            if (writeB)
+            {
+                _mm_storeu_ps(grid->accelerationX + b + j, _mm_add_ps(_mm_loadu_ps(grid->accelerationX + b + j), fx));
+                _mm_storeu_ps(grid->accelerationY + b + j, _mm_add_ps(_mm_loadu_ps(grid->accelerationY + b + j), fy));
+            }
+        }
+#endif
+        for (; j < j1; j++)
+        {
+            float scaleA = scalesA[j / TILE_SIZE], scaleB = scalesB[j / TILE_SIZE];
+            float dvx = (grid->positionX[b + j] - grid->prevPositionX[b + j]) * scaleB - (grid->positionX[a + j] - grid->prevPositionX[a + j]) * scaleA;
+            float dvy = (grid->positionY[b + j] - grid->prevPositionY[b + j]) * scaleB - (grid->positionY[a + j] - grid->prevPositionY[a + j]) * scaleA;
+
+            float fx, fy;
+            SpringForce(grid->positionX[a + j] - grid->positionX[b + j], grid->positionY[a + j] - grid->positionY[b + j],
+                dvx, dvy, restLength, stiffness, velocityFactor, &fx, &fy);
+
+            if (writeA)
+            {
+                grid->accelerationX[a + j] -= fx * forceScale;
+                grid->accelerationY[a + j] -= fy * forceScale;
+            }
+
+            if (writeB)
+            {
+                grid->accelerationX[b + j] += fx * forceScale;
+                grid->accelerationY[b + j] += fy * forceScale;
+            }
+        }
+    }
+}
+
+// Semi implicit Euler from the velocity of the last move, the previous positions take the start positions
+// The acceleration is damped here, the velocity when the next update scale the move
+// A point slower than the rest threshold stay where it is and small accelerations snap to zero
+// Return the max squared speed or acceleration of the points for the sleep test
+static float IntegratePoints(SpringGrid* grid, int start, int end, int tile, float timeStep)
+{
+    const float threshold = grid->params.restThreshold;
+    const float thresholdSq = threshold * threshold;
+    const float scale = grid->tileVelocityScale[tile];
+    const float factor = DampingFactor(grid->tileDamping[tile], timeStep);
+    float motion = 0.0f;
+
+    int i = start;
+#if FASTMATH_SSE
+    const __m128 dt = _mm_set1_ps(timeStep);
+    const __m128 velocityScale = _mm_set1_ps(scale);
+    const __m128 snap = _mm_set1_ps(threshold > 0.0f ? thresholdSq : -1.0f);
+    __m128 motion4 = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 ax = _mm_loadu_ps(grid->accelerationX + i);
+        __m128 ay = _mm_loadu_ps(grid->accelerationY + i);
+        __m128 px = _mm_loadu_ps(grid->positionX + i);
+        __m128 py = _mm_loadu_ps(grid->positionY + i);
+        __m128 vx = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(px, _mm_loadu_ps(grid->prevPositionX + i)), velocityScale), _mm_mul_ps(ax, dt));
+        __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(py, _mm_loadu_ps(grid->prevPositionY + i)), velocityScale), _mm_mul_ps(ay, dt));
+
+        __m128 speedSq = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+        __m128 accelerationSq = _mm_add_ps(_mm_mul_ps(ax, ax), _mm_mul_ps(ay, ay));
+        __m128 keepVelocity = _mm_cmpge_ps(speedSq, snap);
+        __m128 keepAcceleration = _mm_cmpge_ps(accelerationSq, snap);
+        motion4 = _mm_max_ps(motion4, _mm_max_ps(speedSq, accelerationSq));
+
+        _mm_storeu_ps(grid->prevPositionX + i, px);
+        _mm_storeu_ps(grid->prevPositionY + i, py);
+        _mm_storeu_ps(grid->positionX + i, _mm_add_ps(px, _mm_and_ps(keepVelocity, _mm_mul_ps(vx, dt))));
+        _mm_storeu_ps(grid->positionY + i, _mm_add_ps(py, _mm_and_ps(keepVelocity, _mm_mul_ps(vy, dt))));
+        _mm_storeu_ps(grid->accelerationX + i, _mm_and_ps(keepAcceleration, _mm_mul_ps(ax, _mm_set1_ps(factor))));
+        _mm_storeu_ps(grid->accelerationY + i, _mm_and_ps(keepAcceleration, _mm_mul_ps(ay, _mm_set1_ps(factor))));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, motion4);
+    motion = fmaxf(fmaxf(lanes[0], lanes[1]), fmaxf(lanes[2], lanes[3]));
+#endif
+
+    for (; i < end; i++)
+    {
+        float ax = grid->accelerationX[i];
+        float ay = grid->accelerationY[i];
+        float px = grid->positionX[i];
+        float py = grid->positionY[i];
+        float vx = (px - grid->prevPositionX[i]) * scale + ax * timeStep;
+        float vy = (py - grid->prevPositionY[i]) * scale + ay * timeStep;
+
+        float speedSq = vx * vx + vy * vy;
+        float accelerationSq = ax * ax + ay * ay;
+        bool keepVelocity = threshold <= 0.0f || speedSq >= thresholdSq;
+        bool keepAcceleration = threshold <= 0.0f || accelerationSq >= thresholdSq;
+        motion = fmaxf(motion, fmaxf(speedSq, accelerationSq));
+
+        grid->prevPositionX[i] = px;
+        grid->prevPositionY[i] = py;
+        grid->positionX[i] = keepVelocity ? px + vx * timeStep : px;
+        grid->positionY[i] = keepVelocity ? py + vy * timeStep : py;
+        grid->accelerationX[i] = keepAcceleration ? ax * factor : 0.0f;
+        grid->accelerationY[i] = keepAcceleration ? ay * factor : 0.0f;
+    }
+
+    return motion;
+}
+
+// Run a point pass tile by tile over the span and keep the max motion of each tile
+// The pass is the last of the update, the next update derive the velocities from the move of this one
+typedef float (*PointPass)(SpringGrid* grid, int start, int end, int tile, float timeStep);
+
+static void UpdateTileMotion(SpringGrid* grid, const TileSpan* span, PointPass pass, float timeStep)
+{
+    for (int tileX = span->tileX0; tileX < span->tileX1; tileX++)
+    {
+        int tile = span->tileY * grid->tileCols + tileX;
+        int j0 = tileX * TILE_SIZE;
+        int j1 = MinInt(j0 + TILE_SIZE, grid->cols);
+
+        float motion = 0.0f;
+        for (int i = span->i0; i < span->i1; i++)
+        {
+            motion = fmaxf(motion, pass(grid, i * grid->cols + j0, i * grid->cols + j1, tile, timeStep));
+        }
+        grid->tileMotion[tile] = motion;
+
+        // The force solver damp the velocity the update leave, the position solver damp it at the start of each sub step
+        float factor = grid->params.solver == SPRING_GRID_SOLVER_POSITION ? 1.0f : DampingFactor(grid->tileDamping[tile], timeStep);
+        grid->tileVelocityScale[tile] = factor / timeStep;
+        grid->tileDamping[tile] = grid->params.pointDamping;
+    }
+}
+
+// Position solver
+// Points move with their velocity first, then each spring moves its ends toward its rest length
+// Springs are relaxed in 4 sets where no point is shared, even and odd springs of the rows then of the columns
+// Compliance is the inverse of the spring constant, scaled by the step it soften the correction so the solver stay stable at any step
+// Velocities come from the moves: the first sub step from the last update, the next ones from the sub step before
+// The acceleration arrays hold the pending forces for the first sub step, then the start positions of the sub steps after the second
+// A spring to a sleeping tile only move its awake end, the sleeping point act as fixed
+//
+// The force solver keep the acceleration and damp it with the point, it act as a low pass over 1 / damping seconds
+// So a force F move a point like F / damping would without the filter, the position solver scale forces and springs the same way
+
+static void PredictPoints(SpringGrid* grid, int start, int end, int tile, float timeStep, int substep)
+{
+    const float damping = grid->tileDamping[tile];
+    const float factor = DampingFactor(damping, timeStep);
+    const float gain = damping > 0.0f ? 1.0f / damping : timeStep;
+    const float scale = substep == 0 ? grid->tileVelocityScale[tile] : 1.0f / timeStep;
+
+    // Start of the sub step before, the last update for the first one
+    float* startX = substep <= 1 ? grid->prevPositionX : grid->accelerationX;
+    float* startY = substep <= 1 ? grid->prevPositionY : grid->accelerationY;
+
+    // Start of this sub step, the previous positions for the first one
+    float* nextStartX = substep == 0 ? grid->prevPositionX : grid->accelerationX;
+    float* nextStartY = substep == 0 ? grid->prevPositionY : grid->accelerationY;
+
+    int i = start;
+#if FASTMATH_SSE
+    const __m128 dt = _mm_set1_ps(timeStep);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(grid->positionX + i);
+        __m128 py = _mm_loadu_ps(grid->positionY + i);
+        __m128 vx = _mm_mul_ps(_mm_sub_ps(px, _mm_loadu_ps(startX + i)), _mm_set1_ps(scale));
+        __m128 vy = _mm_mul_ps(_mm_sub_ps(py, _mm_loadu_ps(startY + i)), _mm_set1_ps(scale));
+
+        // The pending forces are used once, the arrays are free for the start positions after
+        if (substep == 0)
+        {
+            vx = _mm_add_ps(vx, _mm_mul_ps(_mm_loadu_ps(grid->accelerationX + i), _mm_set1_ps(gain)));
+            vy = _mm_add_ps(vy, _mm_mul_ps(_mm_loadu_ps(grid->accelerationY + i), _mm_set1_ps(gain)));
+            _mm_storeu_ps(grid->accelerationX + i, _mm_setzero_ps());
+            _mm_storeu_ps(grid->accelerationY + i, _mm_setzero_ps());
+        }
+        vx = _mm_mul_ps(vx, _mm_set1_ps(factor));
+        vy = _mm_mul_ps(vy, _mm_set1_ps(factor));
+
+        _mm_storeu_ps(nextStartX + i, px);
+        _mm_storeu_ps(nextStartY + i, py);
+        _mm_storeu_ps(grid->positionX + i, _mm_add_ps(px, _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(grid->positionY + i, _mm_add_ps(py, _mm_mul_ps(vy, dt)));
+    }
+#endif
+
+    for (; i < end; i++)
+    {
+        float px = grid->positionX[i];
+        float py = grid->positionY[i];
+        float vx = (px - startX[i]) * scale;
+        float vy = (py - startY[i]) * scale;
+
+        if (substep == 0)
+        {
+            vx += grid->accelerationX[i] * gain;
+            vy += grid->accelerationY[i] * gain;
+            grid->accelerationX[i] = 0.0f;
+            grid->accelerationY[i] = 0.0f;
+        }
+        vx *= factor;
+        vy *= factor;
+
+        nextStartX[i] = px;
+        nextStartY[i] = py;
+        grid->positionX[i] = px + vx * timeStep;
+        grid->positionY[i] = py + vy * timeStep;
+    }
+}
+
+static void PredictTiles(SpringGrid* grid, const TileSpan* span, float timeStep, int substep)
+{
+    for (int tileX = span->tileX0; tileX < span->tileX1; tileX++)
+    {
+        int j0 = tileX * TILE_SIZE;
+        int j1 = MinInt(j0 + TILE_SIZE, grid->cols);
+        for (int i = span->i0; i < span->i1; i++)
+        {
+            PredictPoints(grid, i * grid->cols + j0, i * grid->cols + j1, span->tileY * grid->tileCols + tileX, timeStep, substep);
+        }
+    }
+}
+
+// Move a and b toward each other by factor of the stretch past the rest length
+static inline void ProjectSpring(float* ax, float* ay, float* bx, float* by, float restLength, float factor)
+{
+    float dx = *bx - *ax;
+    float dy = *by - *ay;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length > restLength)
+    {
+        float scale = factor * (length - restLength) / length;
+        *ax += dx * scale;
+        *ay += dy * scale;
+        *bx -= dx * scale;
+        *by -= dy * scale;
+    }
+}
+
+// Move only the point toward the fixed end of the spring
+static inline void ProjectSpringToFixed(float* x, float* y, float fixedX, float fixedY, float restLength, float factor)
+{
+    float dx = fixedX - *x;
+    float dy = fixedY - *y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length > restLength)
+    {
+        float scale = factor * (length - restLength) / length;
+        *x += dx * scale;
+        *y += dy * scale;
+    }
+}
+
+#if FASTMATH_SSE
+static inline void ProjectSpring4(__m128* ax, __m128* ay, __m128* bx, __m128* by, __m128 restLength, __m128 factor)
+{
+    __m128 dx = _mm_sub_ps(*bx, *ax);
+    __m128 dy = _mm_sub_ps(*by, *ay);
+    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+    // Lanes at rest divide by zero, the mask clear them
+    __m128 stretched = _mm_cmpgt_ps(length, restLength);
+    __m128 scale = _mm_and_ps(stretched, _mm_mul_ps(factor, _mm_div_ps(_mm_sub_ps(length, restLength), length)));
+    dx = _mm_mul_ps(dx, scale);
+    dy = _mm_mul_ps(dy, scale);
+
+    *ax = _mm_add_ps(*ax, dx);
+    *ay = _mm_add_ps(*ay, dy);
+    *bx = _mm_sub_ps(*bx, dx);
+    *by = _mm_sub_ps(*by, dy);
+}
+#endif
+
+// Springs between point j - 1 and j of the span rows, for j - 1 of the same parity as first
+// The span is a whole run of awake tiles, springs crossing its ends have a sleeping neighbor
+static void ProjectHorizontalSprings(SpringGrid* grid, const TileSpan* span, int first, float factor, float fixedFactor)
+{
+    const int cols = grid->cols;
+    const int j0 = span->j0;
+    const int j1 = span->j1;
+    const float restLength = grid->spacing.x * grid->params.restLength;
+
+    int start = MaxInt(j0, 1);
+    if (((start - 1 - first) & 1) != 0)
+    {
+        start++;
+    }
+
+    for (int i = span->i0; i < span->i1; i++)
+    {
+        float* px = grid->positionX + i * cols;
+        float* py = grid->positionY + i * cols;
+
+        int j = start;
+        if (j == j0)
+        {
+            ProjectSpringToFixed(&px[j], &py[j], px[j - 1], py[j - 1], restLength, fixedFactor);
+            j += 2;
+        }
+
+#if FASTMATH_SSE
+        // 4 springs from 8 consecutive points, split in even and odd lanes
+        for (; j + 7 <= j1; j += 8)
+        {
+            float* x = px + j - 1;
+            float* y = py + j - 1;
+            __m128 x0 = _mm_loadu_ps(x), x1 = _mm_loadu_ps(x + 4);
+            __m128 y0 = _mm_loadu_ps(y), y1 = _mm_loadu_ps(y + 4);
+            __m128 ax = _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 bx = _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(3, 1, 3, 1));
+            __m128 ay = _mm_shuffle_ps(y0, y1, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 by = _mm_shuffle_ps(y0, y1, _MM_SHUFFLE(3, 1, 3, 1));
+
+            ProjectSpring4(&ax, &ay, &bx, &by, _mm_set1_ps(restLength), _mm_set1_ps(factor));
+
+            _mm_storeu_ps(x, _mm_unpacklo_ps(ax, bx));
+            _mm_storeu_ps(x + 4, _mm_unpackhi_ps(ax, bx));
+            _mm_storeu_ps(y, _mm_unpacklo_ps(ay, by));
+            _mm_storeu_ps(y + 4, _mm_unpackhi_ps(ay, by));
+        }
+#endif
+        for (; j < j1; j += 2)
+        {
+            ProjectSpring(&px[j - 1], &py[j - 1], &px[j], &py[j], restLength, factor);
+        }
+
+        if (j == j1 && j1 < cols)
+        {
+            ProjectSpringToFixed(&px[j1 - 1], &py[j1 - 1], px[j1], py[j1], restLength, fixedFactor);
+        }
+    }
+}
+
+enum { MOVE_BOTH, MOVE_ABOVE, MOVE_BELOW };
+
+// Springs between row i - 1 and row i for the columns j0 to j1
+static void ProjectVerticalRow(SpringGrid* grid, int i, int j0, int j1, int move, float factor, float fixedFactor)
+{
+    const float restLength = grid->spacing.y * grid->params.restLength;
+    float* ax = grid->positionX + (i - 1) * grid->cols;
+    float* ay = grid->positionY + (i - 1) * grid->cols;
+    float* bx = grid->positionX + i * grid->cols;
+    float* by = grid->positionY + i * grid->cols;
+
+    if (move == MOVE_ABOVE)
+    {
+        for (int j = j0; j < j1; j++)
+        {
+            ProjectSpringToFixed(&ax[j], &ay[j], bx[j], by[j], restLength, fixedFactor);
+        }
+        return;
+    }
+
+    if (move == MOVE_BELOW)
+    {
+        for (int j = j0; j < j1; j++)
+        {
+            ProjectSpringToFixed(&bx[j], &by[j], ax[j], ay[j], restLength, fixedFactor);
+        }
+        return;
+    }
+
+    int j = j0;
+#if FASTMATH_SSE
+    for (; j + 4 <= j1; j += 4)
+    {
+        __m128 x0 = _mm_loadu_ps(ax + j), y0 = _mm_loadu_ps(ay + j);
+        __m128 x1 = _mm_loadu_ps(bx + j), y1 = _mm_loadu_ps(by + j);
+
+        ProjectSpring4(&x0, &y0, &x1, &y1, _mm_set1_ps(restLength), _mm_set1_ps(factor));
+
+        _mm_storeu_ps(ax + j, x0);
+        _mm_storeu_ps(ay + j, y0);
+        _mm_storeu_ps(bx + j, x1);
+        _mm_storeu_ps(by + j, y1);
+    }
+#endif
+    for (; j < j1; j++)
+    {
+        ProjectSpring(&ax[j], &ay[j], &bx[j], &by[j], restLength, factor);
+    }
+}
+
+// Springs between row i - 1 and row i, for i - 1 of the same parity as first
+// A spring belong to the tile of its lower point, the tiles above and below the run can be awake or asleep
+static void ProjectVerticalSprings(SpringGrid* grid, const TileSpan* span, int first, float factor, float fixedFactor)
+{
+    int start = MaxInt(span->i0, 1);
+    if (((start - 1 - first) & 1) != 0)
+    {
+        start++;
+    }
+
+    for (int i = start; i <= span->i1 && i < grid->rows; i += 2)
+    {
+        if (i > span->i0 && i < span->i1)
+        {
+            ProjectVerticalRow(grid, i, span->j0, span->j1, MOVE_BOTH, factor, fixedFactor);
+            continue;
+        }
+
+        // Crossing springs, decided tile by tile
+        int neighborY = i == span->i0 ? span->tileY - 1 : span->tileY + 1;
+        for (int tileX = span->tileX0; tileX < span->tileX1; tileX++)
+        {
+            int j0 = tileX * TILE_SIZE;
+            int j1 = MinInt(j0 + TILE_SIZE, grid->cols);
+            bool neighborAwake = IsTileAwake(grid, neighborY, tileX);
+
+            if (i == span->i0)
+            {
+                ProjectVerticalRow(grid, i, j0, j1, neighborAwake ? MOVE_BOTH : MOVE_BELOW, factor, fixedFactor);
+            }
+            else if (!neighborAwake)
+            {
+                ProjectVerticalRow(grid, i, j0, j1, MOVE_ABOVE, factor, fixedFactor);
+            }
+        }
+    }
+}
+
+// The fixed end of an anchor does not move, the point take the whole correction
+static inline void ProjectAnchor(SpringGrid* grid, int i, int j, float factor)
+{
+    int index = i * grid->cols + j;
+    grid->positionX[index] += (grid->origin.x + j * grid->spacing.x - grid->positionX[index]) * factor;
+    grid->positionY[index] += (grid->origin.y + i * grid->spacing.y - grid->positionY[index]) * factor;
+}
+
+static void ProjectAnchors(SpringGrid* grid, const TileSpan* span, float borderFactor, float anchorFactor)
+{
+    const SpringGridParams* params = &grid->params;
+
+    for (int i = span->i0; i < span->i1; i++)
+    {
+        bool borderRow = i == 0 || i == grid->rows - 1;
+        if (borderFactor > 0.0f)
+        {
+            if (borderRow)
+            {
+                for (int j = span->j0; j < span->j1; j++)
+                {
+                    ProjectAnchor(grid, i, j, borderFactor);
+                }
+                continue;
+            }
+
+            if (span->j0 == 0)
+            {
+                ProjectAnchor(grid, i, 0, borderFactor);
+            }
+
+            if (span->j1 == grid->cols)
+            {
+                ProjectAnchor(grid, i, grid->cols - 1, borderFactor);
+            }
+        }
+
+        if (anchorFactor > 0.0f && params->anchorStep > 0 && !borderRow && i % params->anchorStep == 0)
+        {
+            int end = MinInt(span->j1, grid->cols - 1);
+            for (int j = FirstAnchorColumn(span->j0, params->anchorStep); j < end; j += params->anchorStep)
+            {
+                ProjectAnchor(grid, i, j, anchorFactor);
+            }
+        }
+    }
+}
+
+// Velocity is what the points really moved during the last sub step, a point slower than the rest threshold go back to its start
+// Clear the start positions from the acceleration arrays, the next update read pending forces in them
+// Return the max squared speed of the points for the sleep test
+static float FinishPositionStep(SpringGrid* grid, int start, int end, int tile, float timeStep)
+{
+    const int substeps = grid->params.substeps > 0 ? grid->params.substeps : 1;
+    const float threshold = grid->params.restThreshold;
+    const float thresholdSq = threshold * threshold;
+    const float invStep = substeps / timeStep;
+    float* startX = substeps == 1 ? grid->prevPositionX : grid->accelerationX;
+    float* startY = substeps == 1 ? grid->prevPositionY : grid->accelerationY;
+    float motion = 0.0f;
+
+    (void)tile;
+
+    int i = start;
+#if FASTMATH_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 snap = _mm_set1_ps(threshold > 0.0f ? thresholdSq : -1.0f);
+    __m128 motion4 = zero;
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(grid->positionX + i);
+        __m128 py = _mm_loadu_ps(grid->positionY + i);
+        __m128 sx = _mm_loadu_ps(startX + i);
+        __m128 sy = _mm_loadu_ps(startY + i);
+        __m128 vx = _mm_mul_ps(_mm_sub_ps(px, sx), _mm_set1_ps(invStep));
+        __m128 vy = _mm_mul_ps(_mm_sub_ps(py, sy), _mm_set1_ps(invStep));
+        __m128 speedSq = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+        __m128 keep = _mm_cmpge_ps(speedSq, snap);
+        motion4 = _mm_max_ps(motion4, speedSq);
+
+        _mm_storeu_ps(grid->positionX + i, _mm_or_ps(_mm_and_ps(keep, px), _mm_andnot_ps(keep, sx)));
+        _mm_storeu_ps(grid->positionY + i, _mm_or_ps(_mm_and_ps(keep, py), _mm_andnot_ps(keep, sy)));
+        if (substeps > 1)
+        {
+            _mm_storeu_ps(grid->accelerationX + i, zero);
+            _mm_storeu_ps(grid->accelerationY + i, zero);
+        }
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, motion4);
+    motion = fmaxf(fmaxf(lanes[0], lanes[1]), fmaxf(lanes[2], lanes[3]));
+#endif
+
+    for (; i < end; i++)
+    {
+        float vx = (grid->positionX[i] - startX[i]) * invStep;
+        float vy = (grid->positionY[i] - startY[i]) * invStep;
+        float speedSq = vx * vx + vy * vy;
+        bool keep = threshold <= 0.0f || speedSq >= thresholdSq;
+        motion = fmaxf(motion, speedSq);
+
+        grid->positionX[i] = keep ? grid->positionX[i] : startX[i];
+        grid->positionY[i] = keep ? grid->positionY[i] : startY[i];
+        if (substeps > 1)
+        {
+            grid->accelerationX[i] = 0.0f;
+            grid->accelerationY[i] = 0.0f;
+        }
+    }
+
+    return motion;
+}
+
+// Share of the stretch a constraint correct, 1 / (sum of inverse masses + compliance / dt^2)
+static float ConstraintFactor(float stiffness, float force, float inverseMasses, float timeStep)
+{
+    float springConstant = stiffness * force;
+    if (springConstant <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    return 1.0f / (inverseMasses + 1.0f / (springConstant * timeStep * timeStep));
+}
+
+static void SolvePositions(SpringGrid* grid, float timeStep)
+{
+    const SpringGridParams* params = &grid->params;
+    const int substeps = params->substeps > 0 ? params->substeps : 1;
+
+    float step = timeStep / substeps;
+    float force = params->pointDamping > 0.0f ? params->force / params->pointDamping : params->force;
+    float springFactor = ConstraintFactor(params->stiffness, force, 2.0f, step);
+    float fixedFactor = ConstraintFactor(params->stiffness, force, 1.0f, step);
+    float borderFactor = ConstraintFactor(params->borderStiffness, force, 1.0f, step);
+    float anchorFactor = ConstraintFactor(params->anchorStiffness, force, 1.0f, step);
+
+    TileSpan span;
+    for (int substep = 0; substep < substeps; substep++)
+    {
+        for (int tile = 0; NextTileSpan(grid, &tile, &span);)
+        {
+            PredictTiles(grid, &span, step, substep);
+        }
+
+        for (int set = 0; set < 4; set++)
+        {
+            for (int tile = 0; NextTileSpan(grid, &tile, &span);)
+            {
+                if (set < 2)
+                {
+                    ProjectHorizontalSprings(grid, &span, set, springFactor, fixedFactor);
+                }
+                else
+                {
+                    ProjectVerticalSprings(grid, &span, set - 2, springFactor, fixedFactor);
+                }
+            }
+        }
+
+        for (int tile = 0; NextTileSpan(grid, &tile, &span);)
+        {
+            ProjectAnchors(grid, &span, borderFactor, anchorFactor);
+        }
+    }
+
+    for (int tile = 0; NextTileSpan(grid, &tile, &span);)
+    {
+        UpdateTileMotion(grid, &span, FinishPositionStep, timeStep);
+    }
+}
+
+static void SolveForces(SpringGrid* grid, float timeStep)
+{
+    // Spring forces become acceleration over the tick, every point has unit mass
+    float forceScale = grid->params.force * timeStep;
+    float velocityFactor = fmaxf(0.0f, 1.0f - grid->params.damping * timeStep);
+
+    // Every force is gathered before any point moves
+    TileSpan span;
+    for (int tile = 0; NextTileSpan(grid, &tile, &span);)
+    {
+        UpdateAnchorSprings(grid, &span, forceScale, timeStep);
+        UpdateHorizontalSprings(grid, &span, forceScale, velocityFactor);
+        UpdateVerticalSprings(grid, &span, forceScale, velocityFactor);
+    }
+
+    for (int tile = 0; NextTileSpan(grid, &tile, &span);)
+    {
+        UpdateTileMotion(grid, &span, IntegratePoints, timeStep);
+    }
+}
+
+// Stop the points of the tile, the previous positions catch up so rendering does not interpolate a sleeping tile
+static void PutTileToSleep(SpringGrid* grid, int tileY, int tileX)
+{
+    int i0 = tileY * TILE_SIZE, i1 = MinInt(i0 + TILE_SIZE, grid->rows);
+    int j0 = tileX * TILE_SIZE, j1 = MinInt(j0 + TILE_SIZE, grid->cols);
+
+    for (int i = i0; i < i1; i++)
+    {
+        int start = i * grid->cols + j0;
+        int size = sizeof(float) * (j1 - j0);
+        MemoryInit(grid->accelerationX + start, 0, size);
+        MemoryInit(grid->accelerationY + start, 0, size);
+        MemoryCopy(grid->prevPositionX + start, grid->positionX + start, size);
+        MemoryCopy(grid->prevPositionY + start, grid->positionY + start, size);
+    }
+
+    grid->tileAwake[tileY * grid->tileCols + tileX] = 0;
+}
+
+static bool HasMovingNeighbor(const SpringGrid* grid, int tileY, int tileX)
+{
+    for (int y = tileY - 1; y <= tileY + 1; y++)
+    {
+        for (int x = tileX - 1; x <= tileX + 1; x++)
+        {
+            if ((y != tileY || x != tileX) && IsTileAwake(grid, y, x) && grid->tileQuietTicks[y * grid->tileCols + x] == 0)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Tiles that moved keep their neighbors awake, so waves cross the tile borders
+// Woken tiles are not counted as moving this update, only their own motion wake the next ring
+static void UpdateTileSleep(SpringGrid* grid)
+{
+    const float threshold = grid->params.sleepThreshold;
+    const float thresholdSq = threshold * threshold;
+
+    for (int tile = 0, n = grid->tileCols * grid->tileRows; tile < n; tile++)
+    {
+        if (grid->tileAwake[tile])
+        {
+            bool moving = grid->tileMotion[tile] >= thresholdSq;
+            grid->tileQuietTicks[tile] = moving ? 0 : (uint8_t)MinInt(grid->tileQuietTicks[tile] + 1, SPRING_GRID_SLEEP_TICKS);
+        }
+    }
+
+    for (int tileY = 0; tileY < grid->tileRows; tileY++)
+    {
+        for (int tileX = 0; tileX < grid->tileCols; tileX++)
+        {
+            int tile = tileY * grid->tileCols + tileX;
+            bool movingNeighbor = HasMovingNeighbor(grid, tileY, tileX);
+
+            if (!grid->tileAwake[tile])
+            {
+                if (movingNeighbor)
+                {
+                    grid->tileAwake[tile] = 1;
+                    grid->tileQuietTicks[tile] = 1;
+                }
+            }
+            else if (grid->tileQuietTicks[tile] >= SPRING_GRID_SLEEP_TICKS && !movingNeighbor)
+            {
+                PutTileToSleep(grid, tileY, tileX);
+            }
+        }
+    }
+}
+
+void SpringGridUpdate(SpringGrid grid, float timeStep)
+{
+    // The previous positions are saved by the first point pass of the solver, after the velocities are read from them
+    if (grid.params.solver == SPRING_GRID_SOLVER_POSITION)
+    {
+        SolvePositions(&grid, timeStep);
+    }
+    else
+    {
+        SolveForces(&grid, timeStep);
+    }
+
+    if (grid.params.sleepThreshold > 0.0f)
+    {
+        UpdateTileSleep(&grid);
+    }
+}
+
+size_t SpringGridSnapshotSize(SpringGrid grid)
+{
+    return sizeof(SpringGridSnapshotHeader) + BlockSize(grid.cols, grid.rows);
+}
+
+void SpringGridWriteSnapshot(SpringGrid grid, void* buffer)
+{
+    // Zeroed first, the padding of the header go to the file too
+    SpringGridSnapshotHeader header;
+    MemoryInit(&header, 0, sizeof(header));
+    header.magic        = SPRING_GRID_SNAPSHOT_MAGIC;
+    header.version      = SPRING_GRID_SNAPSHOT_VERSION;
+    header.headerSize   = sizeof(SpringGridSnapshotHeader);
+    header.blockSize    = BlockSize(grid.cols, grid.rows);
+    header.cols         = grid.cols;
+    header.rows         = grid.rows;
+    header.origin       = grid.origin;
+    header.spacing      = grid.spacing;
+    header.params       = grid.params;
+
+    // Every array live in the block of positionX, in the order AllocGrid carve them
+    MemoryCopy(buffer, &header, sizeof(header));
+    MemoryCopy((uint8_t*)buffer + sizeof(header), grid.positionX, (size_t)header.blockSize);
+}
+
+SpringGrid SpringGridFromSnapshot(const void* data, size_t size)
+{
+    SpringGridSnapshotHeader header;
+    if (size < sizeof(header))
+    {
+        return (SpringGrid) { 0 };
+    }
+    MemoryCopy(&header, data, sizeof(header));
+
+    // Sizes are checked before BlockSize so a corrupted header cannot overflow it
+    if (header.magic != SPRING_GRID_SNAPSHOT_MAGIC || header.version != SPRING_GRID_SNAPSHOT_VERSION || header.headerSize != sizeof(header)
+        || header.cols < 2 || header.rows < 2 || (int64_t)header.cols * header.rows > INT32_MAX / (FLOAT_ARRAY_COUNT * 4)
+        || header.blockSize != BlockSize(header.cols, header.rows) || size - sizeof(header) < header.blockSize)
+    {
+        return (SpringGrid) { 0 };
+    }
+
+    SpringGrid grid = AllocGrid(header.cols, header.rows, header.origin, header.spacing, header.params);
+    if (grid.positionX)
+    {
+        MemoryCopy(grid.positionX, (const uint8_t*)data + sizeof(header), (size_t)header.blockSize);
+    }
+    return grid;
+}
+
+bool SpringGridSave(SpringGrid grid, const char* path)
+{
+    size_t size = SpringGridSnapshotSize(grid);
+    void* buffer = MemoryAlloc(size);
+    if (!buffer)
+    {
+        return false;
+    }
+    SpringGridWriteSnapshot(grid, buffer);
+
+    AssetArchiveBlob blob = { SPRING_GRID_SNAPSHOT_NAME, ASSET_RAW, { SPRING_GRID_SNAPSHOT_VERSION }, buffer, size };
+    bool result = AssetArchiveWrite(path, &blob, 1);
+
+    MemoryFree(buffer);
+    return result;
+}
+
+SpringGrid SpringGridLoad(const char* path)
+{
+    AssetArchive archive;
+    if (!AssetArchiveOpen(&archive, path))
+    {
+        return (SpringGrid) { 0 };
+    }
+
+    // The only copy of the state is from the mapped file into the grid block
+    SpringGrid grid = { 0 };
+    const AssetArchiveEntry* entry = AssetArchiveFind(&archive, SPRING_GRID_SNAPSHOT_NAME);
+    if (entry)
+    {
+        grid = SpringGridFromSnapshot(AssetArchiveData(&archive, entry), (size_t)entry->size);
+    }
+
+    AssetArchiveClose(&archive);
+    return grid;
+}
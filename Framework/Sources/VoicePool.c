@@ -0,0 +1,226 @@
+#include "VoicePool.h"
+#include "Memory.h"
+#include "Debug.h"
+
+#include <stdlib.h>
+
+VoicePool VoicePoolNew(int voiceCount, VoiceBackend backend)
+{
+    DebugAssert(voiceCount > 0, "Voice pool need at least one voice");
+
+    VoicePool pool = { 0 };
+    pool.backend = backend;
+    pool.voices = (Voice*)MemoryAlloc(sizeof(Voice) * voiceCount);
+    pool.voiceCount = voiceCount;
+    pool.requests = ArrayNew(VoiceRequest, 32);
+
+    MemoryInit(pool.voices, 0, sizeof(Voice) * voiceCount);
+
+    for (int i = 0; i < VOICE_POOL_MAX_CATEGORIES; i++)
+    {
+        pool.categories[i].maxVoices = voiceCount;
+    }
+
+    return pool;
+}
+
+void VoicePoolFree(VoicePool* pool)
+{
+    for (int i = 0; i < pool->voiceCount; i++)
+    {
+        if (pool->voices[i].active)
+        {
+            pool->backend.stop(pool->backend.userData, i);
+        }
+    }
+
+    MemoryFree(pool->voices);
+    ArrayFree(pool->requests);
+    *pool = (VoicePool) { 0 };
+}
+
+void VoicePoolSetCategory(VoicePool* pool, int category, int maxVoices)
+{
+    DebugAssert(category >= 0 && category < VOICE_POOL_MAX_CATEGORIES, "Invalid voice category");
+    pool->categories[category].maxVoices = maxVoices;
+}
+
+void VoicePoolPlay(VoicePool* pool, int category, int sample, float volume, int priority)
+{
+    DebugAssert(category >= 0 && category < VOICE_POOL_MAX_CATEGORIES, "Invalid voice category");
+
+    for (int i = 0, n = ArrayCount(pool->requests); i < n; i++)
+    {
+        VoiceRequest* request = &pool->requests[i];
+        if (request->category == category && request->sample == sample)
+        {
+            request->volume = request->volume > volume ? request->volume : volume;
+            request->priority = request->priority > priority ? request->priority : priority;
+            pool->coalesced++;
+            return;
+        }
+    }
+
+    VoiceRequest request = { category, sample, priority, volume, ArrayCount(pool->requests) };
+    ArrayPush(pool->requests, request);
+}
+
+static void ReleaseVoice(VoicePool* pool, int index, bool stop)
+{
+    Voice* voice = &pool->voices[index];
+    if (stop)
+    {
+        pool->backend.stop(pool->backend.userData, index);
+    }
+
+    pool->categories[voice->category].activeVoices--;
+    voice->active = false;
+}
+
+void VoicePoolStop(VoicePool* pool, int category)
+{
+    for (int i = 0; i < pool->voiceCount; i++)
+    {
+        if (pool->voices[i].active && pool->voices[i].category == category)
+        {
+            ReleaseVoice(pool, i, true);
+        }
+    }
+
+    int count = 0;
+    for (int i = 0, n = ArrayCount(pool->requests); i < n; i++)
+    {
+        if (pool->requests[i].category != category)
+        {
+            pool->requests[count++] = pool->requests[i];
+        }
+    }
+    ArraySetCount(pool->requests, count);
+}
+
+int VoicePoolActiveCount(const VoicePool* pool, int category)
+{
+    return pool->categories[category].activeVoices;
+}
+
+// Highest priority first, then request order
+static int CompareRequests(const void* a, const void* b)
+{
+    const VoiceRequest* ra = (const VoiceRequest*)a;
+    const VoiceRequest* rb = (const VoiceRequest*)b;
+
+    if (ra->priority != rb->priority)
+    {
+        return rb->priority - ra->priority;
+    }
+
+    return ra->order - rb->order;
+}
+
+// Lowest priority then oldest voice, among one category or all when category < 0
+// Voices started this tick are kept, requests of a tick never replace each other
+static int FindVictim(const VoicePool* pool, int category, int maxPriority)
+{
+    int victim = -1;
+    for (int i = 0; i < pool->voiceCount; i++)
+    {
+        const Voice* voice = &pool->voices[i];
+        if (!voice->active || voice->priority > maxPriority || voice->startTick == pool->tick || (category >= 0 && voice->category != category))
+        {
+            continue;
+        }
+
+        if (victim < 0
+            || voice->priority < pool->voices[victim].priority
+            || (voice->priority == pool->voices[victim].priority && voice->startTick < pool->voices[victim].startTick))
+        {
+            victim = i;
+        }
+    }
+
+    return victim;
+}
+
+static int FindFreeVoice(const VoicePool* pool)
+{
+    for (int i = 0; i < pool->voiceCount; i++)
+    {
+        if (!pool->voices[i].active)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+VoicePoolStats VoicePoolUpdate(VoicePool* pool)
+{
+    VoicePoolStats stats = { 0 };
+    stats.coalesced = pool->coalesced;
+
+    for (int i = 0; i < pool->voiceCount; i++)
+    {
+        if (pool->voices[i].active && !pool->backend.isPlaying(pool->backend.userData, i))
+        {
+            ReleaseVoice(pool, i, false);
+        }
+    }
+
+    int requestCount = ArrayCount(pool->requests);
+    qsort(pool->requests, requestCount, sizeof(VoiceRequest), CompareRequests);
+
+    for (int r = 0; r < requestCount; r++)
+    {
+        const VoiceRequest* request = &pool->requests[r];
+        VoiceCategory* category = &pool->categories[request->category];
+
+        int index = -1;
+        if (category->activeVoices >= category->maxVoices)
+        {
+            // Category is full, replace one of its own voices
+            index = FindVictim(pool, request->category, request->priority);
+        }
+        else
+        {
+            index = FindFreeVoice(pool);
+            if (index < 0)
+            {
+                index = FindVictim(pool, -1, request->priority);
+            }
+        }
+
+        if (index < 0)
+        {
+            stats.dropped++;
+            continue;
+        }
+
+        if (pool->voices[index].active)
+        {
+            ReleaseVoice(pool, index, true);
+            stats.stolen++;
+        }
+
+        if (!pool->backend.start(pool->backend.userData, index, request->sample, request->volume))
+        {
+            stats.dropped++;
+            continue;
+        }
+
+        pool->voices[index] = (Voice) {
+            .active     = true,
+            .category   = request->category,
+            .sample     = request->sample,
+            .priority   = request->priority,
+            .startTick  = pool->tick,
+        };
+        category->activeVoices++;
+        stats.started++;
+    }
+
+    ArrayClear(pool->requests);
+    pool->tick++;
+    pool->coalesced = 0;
+    return stats;
+}
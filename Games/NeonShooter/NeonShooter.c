@@ -6,6 +6,9 @@
 #include <stdint.h>
 
 #include <Debug.h>
+#include <Renderer.h>
+#include <JobSystem.h>
+#include <RenderRecorder.h>
 
 #include "NeonShooter_World.h"
 #include "NeonShooter_Assets.h"
@@ -24,117 +27,171 @@ static float lerpf(float start, float end, float amount)
     return start + amount * (end - start);
 }
 
-static int frameCount;
-int GetFrameCount(void)
+typedef struct FixedStepClock
 {
-    return frameCount;
+    float   timer;
+    float   timeStep;
+
+    int     maxStepsPerFrame;   // Ticks beyond this are not caught up, time is dilated instead
+    float   maxFrameTime;       // Frames longer than this (window drag, debugger) are dropped
+    float   updateBudget;       // Time per frame we allow the simulation to take
+
+    bool    adaptive;           // Lower fidelity before dilating time
+    float   updateCost;         // Moving average of one tick cost, in seconds
+    float   fidelity;
+    float   minFidelity;
+    float   fidelityDropRate;   // Part of the gap to the affordable fidelity closed per frame
+    float   fidelityRiseRate;   // Most fidelity gained per frame
+    float   fidelityMargin;     // Headroom needed before rising, so fidelity does not oscillate around the budget
+
+    double  droppedTime;
+    double  dilatedTime;
+    int     droppedFrames;
+    int     dilatedFrames;
+} FixedStepClock;
+
+// Half of the frame time go to the simulation, the ticks of a frame share it whatever the step is
+static FixedStepClock NewFixedStepClock(float timeStep, float frameTime)
+{
+    return (FixedStepClock) {
+        .timer              = 0.0f,
+        .timeStep           = timeStep,
+
+        .maxStepsPerFrame   = 4,
+        .maxFrameTime       = 0.25f,
+        .updateBudget       = 0.5f * frameTime,
+
+        .adaptive           = true,
+        .updateCost         = 0.0f,
+        .fidelity           = 1.0f,
+        .minFidelity        = 0.25f,
+        .fidelityDropRate   = 0.2f,
+        .fidelityRiseRate   = 0.01f,
+        .fidelityMargin     = 0.1f,
+    };
 }
 
-#ifdef RELEASE
-#define main __stdcall WinMain
-#endif
-int main()
+// Accumulate frame time and return how many ticks should run this frame
+static int FixedStepClockAdvance(FixedStepClock* clock, float deltaTime)
 {
-    const int SCREEN_WIDTH = 1280;
-    const int SCREEN_HEIGHT = 720;
+    if (deltaTime > clock->maxFrameTime)
+    {
+        clock->droppedTime += deltaTime - clock->maxFrameTime;
+        clock->droppedFrames++;
 
-    srand((uint32_t)(time(0)));
-    
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Neon shooter");
+        deltaTime = clock->maxFrameTime;
+    }
 
-    DebugPrint("Hello world");
+    clock->timer += deltaTime;
 
-    SetConfigFlags(FLAG_VSYNC_HINT);
-    SetTargetFPS(60);
+    int steps = (int)(clock->timer / clock->timeStep);
+    int maxSteps = clock->maxStepsPerFrame;
 
-    GameAudioInit();
-    InitCacheTextures();
-    InitParticles(); 
+    // Frames without tick say nothing about the cost
+    if (clock->adaptive && clock->updateCost > 0.0f && steps > 0)
+    {
+        // The tick cost scale about linearly with fidelity, aim at the fidelity the budget can afford
+        float fullCost = clock->updateCost / clock->fidelity;
+        float affordable = clampf(clock->updateBudget / (steps * fullCost), clock->minFidelity, 1.0f);
 
-    World world = WorldNew();
-    Vector2 aim;
-    bool fire;
+        // Drop fast to leave the overload, rise slowly and only with some headroom
+        if (affordable < clock->fidelity)
+        {
+            clock->fidelity = lerpf(clock->fidelity, affordable, clock->fidelityDropRate);
+        }
+        else
+        {
+            float riseTarget = affordable >= 1.0f ? 1.0f : affordable - clock->fidelityMargin;
+            if (riseTarget > clock->fidelity)
+            {
+                clock->fidelity = fminf(riseTarget, clock->fidelity + clock->fidelityRiseRate);
+            }
+        }
 
-#if 1
-    const char* bloomShaderSource =
-        "#version 330 core\n"
+        // Only dilate time when there is no fidelity left to drop
+        if (steps * clock->updateCost > clock->updateBudget && affordable <= clock->minFidelity)
+        {
+            int affordableSteps = (int)(clock->updateBudget / clock->updateCost);
+            maxSteps = affordableSteps < 1 ? 1 : (affordableSteps < maxSteps ? affordableSteps : maxSteps);
+        }
+    }
 
-        "in vec2 fragTexCoord;"
-        "in vec4 fragColor;"
+    if (steps > maxSteps)
+    {
+        float dilated = (steps - maxSteps) * clock->timeStep;
 
-        "out vec4 finalColor;"
+        clock->dilatedTime += dilated;
+        clock->dilatedFrames++;
 
-        "uniform sampler2D image;"
+        clock->timer -= dilated;
+        steps = maxSteps;
+    }
 
-        "void main() {"
-        "float weight[5] = float[] (0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);"
+    return steps;
+}
 
-        "vec2 texSize = textureSize(image, 0);"
-        "float size = max(texSize.x, texSize.y);"
+static void FixedStepClockTick(FixedStepClock* clock, float updateCost)
+{
+    const float COST_SMOOTHING = 0.1f;
 
-        "vec2 texOffset = 1.0 / vec2(size, size);"
-        "vec3 result = texture(image, fragTexCoord).rgb * weight[0];"
+    clock->timer -= clock->timeStep;
+    clock->updateCost = clock->updateCost > 0.0f ? lerpf(clock->updateCost, updateCost, COST_SMOOTHING) : updateCost;
+}
 
-        "for(int i = 1; i < 5; ++i) {"
-        "result += texture(image, fragTexCoord + vec2(texOffset.x * i, 0.0)).rgb * weight[i];"
-        "result += texture(image, fragTexCoord - vec2(texOffset.x * i, 0.0)).rgb * weight[i];"
-        "result += texture(image, fragTexCoord + vec2(0.0, texOffset.y * i)).rgb * weight[i];"
-        "result += texture(image, fragTexCoord - vec2(0.0, texOffset.y * i)).rgb * weight[i];"
-        "}"
+static int frameCount;
+int GetFrameCount(void)
+{
+    return frameCount;
+}
 
-        "result = texture(image, fragTexCoord).rgb + result;"
-        "result = vec3(1.0) - exp(-result * 0.5f);"
-        "result = pow(result, vec3(1.0 / 2.2));"
-        "finalColor = vec4(result, 1.0);"
-        "}";
-#else
-    const char* bloomShaderSource =
-        "#version 330\n"
+#ifdef RELEASE
+#define main __stdcall WinMain
+#endif
+int main()
+{
+    const int SCREEN_WIDTH = 1280;
+    const int SCREEN_HEIGHT = 720;
 
-        // Input vertex attributes (from vertex shader)
-        "in vec2 fragTexCoord;"
-        "in vec4 fragColor;"
+    // Simulation run at fixed rate, rendering interpolate between the last two ticks
+    const float SIMULATION_RATE = 60.0f;
+    const int   TARGET_FPS = 60;
 
-        // Output fragment color
-        "out vec4 finalColor;"
+    // Main thread time spent uploading streamed assets each frame
+    const double ASSET_UPLOAD_BUDGET = 0.002;
 
-        // Input uniform values
-        "uniform sampler2D image;"
-        "uniform vec4 colDiffuse;"
+    // Draw calls of a frame captured with F5, replay and summarize it offline with the Benchmarks example
+    const char* FRAME_CAPTURE_PATH = "Frame.rgdc";
 
-        "void main()"
-        "{"
-            "float samples = 5.0;"        // pixels per axis; higher = bigger glow, worse performance
-            "float quality = 1.7;" 	      // lower = smaller glow, better quality
+    srand((uint32_t)(time(0)));
+    
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Neon shooter");
 
-            "vec2 size = textureSize(image, 0);"
-            "vec2 sizeFactor = vec2(1.0) / size * quality;"
+    DebugPrint("Hello world");
 
-            "vec4 sum = vec4(0);"
+    SetConfigFlags(FLAG_VSYNC_HINT);
+    SetTargetFPS(TARGET_FPS);
 
-            // Texel color fetching from texture sampler
-            "vec4 source = texture(image, fragTexCoord);"
+    JobSystemInit(0);
 
-            "int range = 2;"
+    double assetsStart = GetTime();
+    bool packedAssets = OpenAssetArchive();
 
-            "for (int x = -range; x <= range; x++)"
-            "{"
-                "for (int y = -range; y <= range; y++)"
-                "{"
-                    "sum += texture(image, fragTexCoord + vec2(x, y) * sizeFactor);"
-                "}"
-            "}"
+    InitCacheTextures();
+    GameAudioInit();
+    InitParticles(); 
 
-            // Calculate final fragment color
-            "finalColor = ((sum / (samples * samples)) + source) * colDiffuse;"
-        "}";
-#endif
+    DebugPrint("Startup assets requested in %.2fms (%s), streaming in the background", (GetTime() - assetsStart) * 1000.0, packedAssets ? "packed" : "loose files");
 
-    Shader bloomShader = LoadShaderCode(NULL, bloomShaderSource);
+    World world = WorldNew((Vector2) { SCREEN_WIDTH, SCREEN_HEIGHT });
+    Vector2 aim;
+    bool fire;
+
+    // Reloaded in place when Bloom.frag change, the default shader is used until it is ready
+    AssetHandle bloomShader = RequestShader("Shaders/Bloom.frag");
     RenderTexture framebuffer = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
 
-    float   timer    = 0.0f;
-    float   timeStep = 1.0f / 60.0f;
+    FixedStepClock clock = NewFixedStepClock(1.0f / SIMULATION_RATE, 1.0f / TARGET_FPS);
+    const float timeStep = clock.timeStep;
 
     int     fpsCount    = 0;
     int     fpsValue    = 0;
@@ -144,11 +201,15 @@ int main()
     float   axisVertical   = 0.0f;
     float   axisHorizontal = 0.0f;
 
+    RenderRecorder frameRecorder = RenderRecorderNew(RendererGetRaylibBackend());
+    bool captureFrame = false;
+
     while (!WindowShouldClose())
     {
         frameCount++;
 
         GameAudioUpdate();
+        UpdateAssetStreaming(ASSET_UPLOAD_BUDGET);
 
         float deltaTime = GetFrameTime();
 
@@ -161,8 +222,17 @@ int main()
             fpsCount = 0;
         }
 
-        timer += deltaTime;
-        while (timer >= timeStep)
+        // Benchmark keys: spawn 1k/10k/50k enemies, toggle parallel update passes
+        if (IsKeyPressed(KEY_F1)) WorldSpawnStress(&world, 1000);
+        if (IsKeyPressed(KEY_F2)) WorldSpawnStress(&world, 10000);
+        if (IsKeyPressed(KEY_F3)) WorldSpawnStress(&world, 50000);
+        if (IsKeyPressed(KEY_F4)) world.parallel = !world.parallel;
+        if (IsKeyPressed(KEY_F5)) captureFrame = true;
+
+        int steps = FixedStepClockAdvance(&clock, deltaTime);
+        world.fidelity = clock.fidelity;
+
+        for (int step = 0; step < steps; step++)
         {
             const float LERP_RATE = 0.5f;
 
@@ -264,16 +334,28 @@ int main()
 
             fpsCount++;
 
-            timer -= timeStep;
+            double updateStart = GetTime();
 
             WorldUpdate(&world, axes.x, axes.y, aim, fire, timeStep);
+            GameAudioFlush();
 
             UpdateParticles(&world, timeStep);
+
+            FixedStepClockTick(&clock, (float)(GetTime() - updateStart));
         }
 
+        // How far we are between the last tick and the next one
+        float alpha = clock.timer / timeStep;
+
         BeginDrawing();
         {
-            ClearBackground(BLACK);
+            if (captureFrame)
+            {
+                RenderRecorderBeginFrame(&frameRecorder, GetScreenWidth(), GetScreenHeight());
+                RendererSetBackend(RenderRecorderGetBackend(&frameRecorder));
+            }
+
+            RendererClear(BLACK);
             
             //BeginTextureMode(framebuffer);
             //ClearBackground(BLACK);
@@ -284,30 +366,56 @@ int main()
                 0,
                 0.5f,
             };
-            BeginMode2D(camera);
+            RendererBeginMode2D(camera);
             {
-                WorldRender(world);
-                DrawParticles();
+                WorldRender(world, alpha);
+
+                RendererBeginSection("DrawParticles");
+                DrawParticles(alpha);
+                RendererEndSection();
             }
-            EndMode2D();
+            RendererEndMode2D();
 
             //EndTextureMode();
 
-            BeginShaderMode(bloomShader);
-            DrawTextureRec(framebuffer.texture, (Rectangle){ 0, 0, SCREEN_WIDTH, -SCREEN_HEIGHT }, (Vector2){ 0, 0 }, WHITE);
+            BeginShaderMode(GetShader(bloomShader));
+            RendererDrawTextureRec(framebuffer.texture, (Rectangle){ 0, 0, SCREEN_WIDTH, -SCREEN_HEIGHT }, (Vector2){ 0, 0 }, WHITE);
             EndShaderMode();
 
-            DrawText(TextFormat("CPU FPS: %d", fpsValue), 0, 0, 18, RAYWHITE);
-            DrawText(TextFormat("GPU FPS: %d", GetFPS()), 0, 24, 18, RAYWHITE);
+            RendererBeginSection("Hud");
+            RendererDrawText(TextFormat("CPU FPS: %d", fpsValue), 0, 0, 18, RAYWHITE);
+            RendererDrawText(TextFormat("GPU FPS: %d", GetFPS()), 0, 24, 18, RAYWHITE);
+            RendererDrawText(TextFormat("Tick: %.2fms - Fidelity: %d%%", clock.updateCost * 1000.0f, (int)(clock.fidelity * 100.0f)), 0, 48, 18, RAYWHITE);
+            RendererDrawText(TextFormat("Dropped: %.2fs (%d) - Dilated: %.2fs (%d)", clock.droppedTime, clock.droppedFrames, clock.dilatedTime, clock.dilatedFrames), 0, 72, 18, RAYWHITE);
+            RendererDrawText(TextFormat("Enemies: %d - Update: %s (%d workers)", WorldEnemyCount(world), world.parallel ? "parallel" : "serial", JobSystemWorkerCount()), 0, 96, 18, RAYWHITE);
+            RendererEndSection();
+
+            if (captureFrame)
+            {
+                captureFrame = false;
+                RendererSetBackend(NULL);
+
+                RenderRecordSummary summary;
+                int size = RenderRecorderEndFrame(&frameRecorder);
+                if (RenderRecorderSave(&frameRecorder, FRAME_CAPTURE_PATH) && RenderRecordSummarize(frameRecorder.buffer, size, &summary))
+                {
+                    DebugPrint("Captured frame %d to %s", frameCount, FRAME_CAPTURE_PATH);
+                    RenderRecordPrintSummary(&summary);
+                }
+            }
         }
         EndDrawing();
     }
 
     WorldFree(&world);
     ReleaseParticles();
+    RenderRecorderFree(&frameRecorder);
 
-    GameAudioRelease();
     ClearCacheTextures();
+    GameAudioRelease();
+    CloseAssetArchive();
     CloseWindow();
+
+    JobSystemShutdown();
     return 0;
 }
@@ -1,19 +1,126 @@
 #include "NeonShooter_Assets.h"
 
 #include <Array.h>
+#include <Debug.h>
+#include <Atomic.h>
+#include <Memory.h>
+#include <JobSystem.h>
+#include <AssetArchive.h>
+#include <AtlasPacker.h>
+#include <FileWatcher.h>
+#include <ShaderCache.h>
 #include <raylib.h>
+#include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
+#ifdef RELEASE
+#   define ASSET_PATH "Assets"
+#else
+#   define ASSET_PATH "../Binary/NeonShooter/Assets"
+#endif
+
+// Built from ASSET_PATH by Tools/AssetPacker, loose files are used when it is missing
+#define ASSET_ARCHIVE_PATH ASSET_PATH ".pak"
+
+// Compiled shader programs, rebuilt when the sources or the driver change
+#ifdef RELEASE
+#   define SHADER_CACHE_PATH "ShaderCache"
+#else
+#   define SHADER_CACHE_PATH "../Binary/NeonShooter/ShaderCache"
+#endif
+
 typedef uint8_t  u8;
 typedef uint32_t u32;
 typedef uint64_t u64;
 
-typedef struct
+#define MAX_SOUND_COPIES 4
+
+// stb_image is compiled in raylib for LoadImage, only the entry points needed are declared
+// The streaming job decode loose files itself: LoadImage, LoadWave and ImageFormat go through raylib static text buffers
+// that the main thread use at the same time (TextFormat, TraceLog)
+extern u8*      stbi_load_from_memory(const u8* buffer, int len, int* x, int* y, int* channels_in_file, int desired_channels);
+
+#define RETIRED_TEXTURE_SECONDS 10.0    // Longer than any enemy, bullet or particle live
+
+#define ATLAS_NAME      "Art/Sprites.atlas"     // Virtual asset, built from the sprites below when streamed
+#define ATLAS_PADDING   2                       // Transparent pixels around sprites, no bleeding with linear filtering
+#define ATLAS_MIN_SIZE  256
+#define ATLAS_MAX_SIZE  4096
+
+// Every sprite the game draw, packed in one texture so a frame only bind it once per blend mode
+static const char* atlasSpriteNames[] = {
+    "Art/Player.png",
+    "Art/Seeker.png",
+    "Art/Wanderer.png",
+    "Art/Bullet.png",
+    "Art/Black Hole.png",
+    "Art/Laser.png",
+    "Art/Glow.png",
+    "Art/Pointer.png",
+};
+
+#define ATLAS_SPRITE_COUNT (int)(sizeof(atlasSpriteNames) / sizeof(atlasSpriteNames[0]))
+
+typedef struct AtlasSprite
+{
+    u64             hash;       // Of the sprite name, not the file path
+    Rectangle       source;
+} AtlasSprite;
+
+typedef enum AssetKind
+{
+    ASSET_KIND_TEXTURE,
+    ASSET_KIND_SOUND,
+    ASSET_KIND_SHADER,      // Fragment shader source
+    ASSET_KIND_ATLAS,       // Sprites packed in one texture
+} AssetKind;
+
+typedef enum AssetState
+{
+    ASSET_STATE_QUEUED,     // Waiting for the streaming job
+    ASSET_STATE_DECODED,    // Decoded on the streaming job, waiting for upload
+    ASSET_STATE_READY,      // Uploaded on the main thread
+    ASSET_STATE_FAILED,
+} AssetState;
+
+// Slots are allocated one by one so the streaming job keep valid pointers when the table grow
+typedef struct AssetSlot
+{
+    u64             hash;
+    AssetKind       kind;
+    volatile long   state;
+    bool            ownsData;   // Decoded from a loose file, false for archive views
+    bool            forceLoose; // Hot reload read the changed file, the archive is stale
+    int             target;     // Slot a hot reload is swapped into, -1 for regular slots
+    double          requestTime;
+
+    Image           image;
+    Wave            wave;
+    char*           text;       // Always owned, archive entries are not null terminated
+    AtlasSprite*    sprites;    // Atlas layout, malloc'd by the streaming job and kept after the upload
+
+    Texture         texture;
+    Sound           sounds[MAX_SOUND_COPIES];   // Independent copies of one wave, a raylib Sound play once at a time
+    int             soundCopies;
+    Shader          shader;
+
+    char            path[128];      // Name in the archive
+    char            filePath[256];  // Loose file, resolved on the main thread as TextFormat is not thread safe
+} AssetSlot;
+
+typedef struct RetiredTexture
 {
-    u64     hash;
-    Texture texture;
-} CachedTexture;
+    Texture     texture;
+    double      retireTime;
+} RetiredTexture;
+
+typedef struct StreamBatch
+{
+    AssetSlot**     slots;
+    int             count;
+} StreamBatch;
 
 static u64 HashString(const char* path)
 {
@@ -67,55 +174,884 @@ static u64 HashString(const char* path)
     return h;
 }
 
-static Array(CachedTexture) cachedTextures;
+static Array(AssetSlot*)     assetSlots;
+static Array(AssetSlot*)     queuedSlots;
+static Array(AssetSlot*)     reloadSlots;
+static Array(RetiredTexture) retiredTextures;   // Replaced by a reload with another size, entities may still hold them
+static AssetArchive         assetArchive;
+static FileWatcher*         assetWatcher;
+
+static ShaderCache          shaderCache;
+
+static Shader LoadCachedShader(const char* name, const char* vsCode, const char* fsCode)
+{
+    return ShaderCacheLoad(&shaderCache, name, vsCode, fsCode);
+}
+
+static AssetUploader        assetUploader = {
+    LoadTextureFromImage, LoadSoundFromWave, LoadCachedShader,
+    UnloadTexture, UnloadSound, UnloadShader,
+};
+static Texture              placeholderTexture;
+static AssetHandle          atlasHandle = -1;
+static char                 atlasSpritePaths[ATLAS_SPRITE_COUNT][256];
+
+// One streaming job at a time, it decode without raylib and the main thread upload
+static JobCounter           streamCounter;
+static StreamBatch          streamBatch;
+
+bool    OpenAssetArchive(void)
+{
+    if (!AssetArchiveOpen(&assetArchive, ASSET_ARCHIVE_PATH))
+    {
+        DebugPrint("Asset archive %s is missing or invalid, loading loose files", ASSET_ARCHIVE_PATH);
+        return false;
+    }
+
+    return true;
+}
+
+void    CloseAssetArchive(void)
+{
+    AssetArchiveClose(&assetArchive);
+}
+
+// Decoded payloads are views in the mapped archive, raylib copy them on upload
+static const AssetArchiveEntry* FindPackedAsset(const char* path, AssetType type)
+{
+    const AssetArchiveEntry* entry = assetArchive.entryCount > 0 ? AssetArchiveFind(&assetArchive, path) : NULL;
+    return entry && entry->type == (uint32_t)type ? entry : NULL;
+}
+
+static Image ViewPackedImage(const AssetArchiveEntry* entry)
+{
+    return (Image) {
+        .data = (void*)AssetArchiveData(&assetArchive, entry),
+        .width = (int)entry->params[0],
+        .height = (int)entry->params[1],
+        .format = (int)entry->params[2],
+        .mipmaps = (int)entry->params[3],
+    };
+}
+
+static Wave ViewPackedWave(const AssetArchiveEntry* entry)
+{
+    return (Wave) {
+        .sampleCount = entry->params[0],
+        .sampleRate = entry->params[1],
+        .sampleSize = entry->params[2],
+        .channels = entry->params[3],
+        .data = (void*)AssetArchiveData(&assetArchive, entry),
+    };
+}
+
+const void* GetPackedAssetData(const char* path, int* size)
+{
+    const AssetArchiveEntry* entry = FindPackedAsset(path, ASSET_RAW);
+    if (!entry)
+    {
+        return NULL;
+    }
+
+    *size = (int)entry->size;
+    return AssetArchiveData(&assetArchive, entry);
+}
+
+// Read the pages of an archive view so the upload on the main thread does not fault them in
+static void PrefetchPages(const void* data, int size)
+{
+    const volatile u8* bytes = (const volatile u8*)data;
+    for (int i = 0; i < size; i += 4096)
+    {
+        (void)bytes[i];
+    }
+}
+
+// Allocated with malloc, the debug allocator is only used from the main thread
+static char* CopyText(const void* data, long size)
+{
+    char* text = (char*)malloc(size + 1);
+    if (text)
+    {
+        memcpy(text, data, size);
+        text[size] = 0;
+    }
+
+    return text;
+}
+
+// Zero terminated so text files can use it as is
+static char* ReadFileData(const char* path, long* outSize)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* data = size >= 0 ? (char*)malloc(size + 1) : NULL;
+    if (data)
+    {
+        size = (long)fread(data, 1, size, file);
+        data[size] = 0;
+        *outSize = size;
+    }
+
+    fclose(file);
+    return data;
+}
+
+// Any format stb_image read, always RGBA8 with a single mip, pixels allocated with malloc like raylib images
+static Image DecodeImageFile(const char* path)
+{
+    long size = 0;
+    u8* bytes = (u8*)ReadFileData(path, &size);
+    if (!bytes)
+    {
+        return (Image) { 0 };
+    }
+
+    int width = 0, height = 0, channels = 0;
+    u8* pixels = stbi_load_from_memory(bytes, (int)size, &width, &height, &channels, 4);
+    free(bytes);
+
+    return (Image) { .data = pixels, .width = width, .height = height, .mipmaps = 1, .format = UNCOMPRESSED_R8G8B8A8 };
+}
+
+static u32 ReadU32(const u8* bytes)
+{
+    return (u32)bytes[0] | (u32)bytes[1] << 8 | (u32)bytes[2] << 16 | (u32)bytes[3] << 24;
+}
+
+static u32 ReadU16(const u8* bytes)
+{
+    return (u32)bytes[0] | (u32)bytes[1] << 8;
+}
+
+// RIFF wave of 8 or 16 bits PCM, or 32 bits float, the formats raylib play
+static Wave DecodeWaveFile(const char* path)
+{
+    long size = 0;
+    u8* bytes = (u8*)ReadFileData(path, &size);
+    if (!bytes)
+    {
+        return (Wave) { 0 };
+    }
+
+    Wave wave = { 0 };
+    if (size >= 12 && memcmp(bytes, "RIFF", 4) == 0 && memcmp(bytes + 8, "WAVE", 4) == 0)
+    {
+        u32 format = 0;
+        for (long offset = 12; offset + 8 <= size; )
+        {
+            const u8* chunk = bytes + offset;
+            u32 chunkSize = ReadU32(chunk + 4);
+            if (chunkSize > (u32)(size - offset - 8))
+            {
+                break;
+            }
+
+            if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16)
+            {
+                format = ReadU16(chunk + 8);
+                wave.channels = ReadU16(chunk + 10);
+                wave.sampleRate = ReadU32(chunk + 12);
+                wave.sampleSize = ReadU16(chunk + 22);
+            }
+            else if (memcmp(chunk, "data", 4) == 0)
+            {
+                bool supported = (format == 1 && (wave.sampleSize == 8 || wave.sampleSize == 16)) || (format == 3 && wave.sampleSize == 32);
+                if (supported && wave.channels > 0 && (wave.data = malloc(chunkSize ? chunkSize : 1)) != NULL)
+                {
+                    memcpy(wave.data, chunk + 8, chunkSize);
+                    wave.sampleCount = chunkSize / (wave.sampleSize / 8);
+                }
+                break;
+            }
+
+            // Chunks are padded to an even size
+            offset += 8 + chunkSize + (chunkSize & 1);
+        }
+    }
+
+    free(bytes);
+    return wave.data ? wave : (Wave) { 0 };
+}
+
+// Sprites in RGBA8 with a single mip, the layout the atlas is blitted in
+static bool LoadAtlasSprite(int index, bool forceLoose, Image* outImage, bool* outOwned)
+{
+    const AssetArchiveEntry* entry = forceLoose ? NULL : FindPackedAsset(atlasSpriteNames[index], ASSET_IMAGE);
+    if (entry && entry->params[2] == UNCOMPRESSED_R8G8B8A8 && entry->params[3] == 1)
+    {
+        *outImage = ViewPackedImage(entry);
+        *outOwned = false;
+    }
+    else
+    {
+        *outImage = DecodeImageFile(atlasSpritePaths[index]);
+        *outOwned = true;
+    }
+
+    return outImage->data != NULL;
+}
+
+// Smallest square power of two atlas that fit every sprite, tallest sprites first
+static int PackAtlas(const Image* images, AtlasRect* rects)
+{
+    int order[ATLAS_SPRITE_COUNT];
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+    {
+        int j = i;
+        for (; j > 0 && images[order[j - 1]].height < images[i].height; j--)
+        {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+    }
+
+    for (int size = ATLAS_MIN_SIZE; size <= ATLAS_MAX_SIZE; size *= 2)
+    {
+        AtlasPacker packer = AtlasPackerNew(size, size);
+
+        bool packed = true;
+        for (int i = 0; packed && i < ATLAS_SPRITE_COUNT; i++)
+        {
+            const Image* image = &images[order[i]];
+            AtlasRect* rect = &rects[order[i]];
+
+            packed = AtlasPackerAdd(&packer, image->width + ATLAS_PADDING * 2, image->height + ATLAS_PADDING * 2, rect);
+            rect->x += ATLAS_PADDING;
+            rect->y += ATLAS_PADDING;
+            rect->width = image->width;
+            rect->height = image->height;
+        }
+
+        AtlasPackerFree(&packer);
+        if (packed)
+        {
+            return size;
+        }
+    }
+
+    return 0;
+}
+
+static bool DecodeAtlas(AssetSlot* slot)
+{
+    Image images[ATLAS_SPRITE_COUNT] = { 0 };
+    bool owned[ATLAS_SPRITE_COUNT] = { 0 };
+    AtlasRect rects[ATLAS_SPRITE_COUNT];
+
+    bool loaded = true;
+    for (int i = 0; loaded && i < ATLAS_SPRITE_COUNT; i++)
+    {
+        loaded = LoadAtlasSprite(i, slot->forceLoose, &images[i], &owned[i]);
+    }
+
+    int size = loaded ? PackAtlas(images, rects) : 0;
+    u8* pixels = size > 0 ? (u8*)calloc((size_t)size * size, 4) : NULL;
+    AtlasSprite* sprites = pixels ? (AtlasSprite*)malloc(sizeof(AtlasSprite) * ATLAS_SPRITE_COUNT) : NULL;
+
+    if (sprites)
+    {
+        for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+        {
+            const AtlasRect* rect = &rects[i];
+            const u8* source = (const u8*)images[i].data;
+            for (int y = 0; y < rect->height; y++)
+            {
+                memcpy(pixels + ((size_t)(rect->y + y) * size + rect->x) * 4, source + (size_t)y * rect->width * 4, (size_t)rect->width * 4);
+            }
+
+            sprites[i] = (AtlasSprite) {
+                .hash = HashString(atlasSpriteNames[i]),
+                .source = { (float)rect->x, (float)rect->y, (float)rect->width, (float)rect->height },
+            };
+        }
+
+        slot->image = (Image) { .data = pixels, .width = size, .height = size, .mipmaps = 1, .format = UNCOMPRESSED_R8G8B8A8 };
+        slot->ownsData = true;
+        slot->sprites = sprites;
+    }
+    else
+    {
+        free(pixels);
+    }
+
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+    {
+        if (owned[i])
+        {
+            free(images[i].data);
+        }
+    }
+
+    return sprites != NULL;
+}
+
+// Run on the streaming job for queued slots, or on the main thread when an asset is needed right now
+static void DecodeSlot(AssetSlot* slot)
+{
+    bool decoded = false;
+    if (slot->kind == ASSET_KIND_SHADER)
+    {
+        const AssetArchiveEntry* entry = slot->forceLoose ? NULL : FindPackedAsset(slot->path, ASSET_RAW);
+        long size = 0;
+        slot->text = entry ? CopyText(AssetArchiveData(&assetArchive, entry), (long)entry->size) : ReadFileData(slot->filePath, &size);
+        decoded = slot->text != NULL;
+    }
+    else if (slot->kind == ASSET_KIND_ATLAS)
+    {
+        decoded = DecodeAtlas(slot);
+    }
+    else if (slot->kind == ASSET_KIND_TEXTURE)
+    {
+        const AssetArchiveEntry* entry = slot->forceLoose ? NULL : FindPackedAsset(slot->path, ASSET_IMAGE);
+        if (entry)
+        {
+            slot->image = ViewPackedImage(entry);
+            PrefetchPages(slot->image.data, (int)entry->size);
+        }
+        else
+        {
+            slot->image = DecodeImageFile(slot->filePath);
+            slot->ownsData = true;
+        }
+
+        decoded = slot->image.data != NULL;
+    }
+    else
+    {
+        const AssetArchiveEntry* entry = slot->forceLoose ? NULL : FindPackedAsset(slot->path, ASSET_WAVE);
+        if (entry)
+        {
+            slot->wave = ViewPackedWave(entry);
+            PrefetchPages(slot->wave.data, (int)entry->size);
+        }
+        else
+        {
+            slot->wave = DecodeWaveFile(slot->filePath);
+            slot->ownsData = true;
+        }
+
+        decoded = slot->wave.data != NULL;
+    }
+
+    AtomicStore(&slot->state, decoded ? ASSET_STATE_DECODED : ASSET_STATE_FAILED);
+}
+
+static void StreamBatchJob(void* userData)
+{
+    StreamBatch* batch = (StreamBatch*)userData;
+    for (int i = 0; i < batch->count; i++)
+    {
+        DecodeSlot(batch->slots[i]);
+    }
+}
+
+static void FreeDecodedData(AssetSlot* slot)
+{
+    free(slot->text);
+    slot->text = NULL;
+
+    if (slot->ownsData)
+    {
+        if (slot->kind == ASSET_KIND_SOUND)
+        {
+            UnloadWave(slot->wave);
+        }
+        else
+        {
+            UnloadImage(slot->image);
+        }
+    }
+
+    slot->image = (Image) { 0 };
+    slot->wave = (Wave) { 0 };
+    slot->ownsData = false;
+}
+
+// raylib fall back to the default shader when a shader does not compile
+static bool IsShaderValid(Shader shader)
+{
+    return shader.id != 0 && shader.id != GetShaderDefault().id;
+}
+
+static void UnloadSlot(AssetSlot* slot)
+{
+    if (slot->kind == ASSET_KIND_TEXTURE || slot->kind == ASSET_KIND_ATLAS)
+    {
+        assetUploader.unloadTexture(slot->texture);
+    }
+    else if (slot->kind == ASSET_KIND_SHADER)
+    {
+        if (IsShaderValid(slot->shader))
+        {
+            assetUploader.unloadShader(slot->shader);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < slot->soundCopies; i++)
+        {
+            assetUploader.unloadSound(slot->sounds[i]);
+        }
+    }
+}
+
+static void UploadSlot(AssetSlot* slot)
+{
+    if (slot->kind == ASSET_KIND_TEXTURE || slot->kind == ASSET_KIND_ATLAS)
+    {
+        slot->texture = assetUploader.uploadTexture(slot->image);
+    }
+    else if (slot->kind == ASSET_KIND_SHADER)
+    {
+        slot->shader = assetUploader.uploadShader(slot->path, NULL, slot->text);
+    }
+    else
+    {
+        for (int i = 0; i < slot->soundCopies; i++)
+        {
+            slot->sounds[i] = assetUploader.uploadSound(slot->wave);
+        }
+    }
+
+    FreeDecodedData(slot);
+    AtomicStore(&slot->state, ASSET_STATE_READY);
+}
+
+// Hand every queued slot to a new streaming job, the previous one must be done
+static void DispatchStreamBatch(void)
+{
+    MemoryFree(streamBatch.slots);
+    streamBatch = (StreamBatch) { 0 };
+
+    int count = ArrayCount(queuedSlots);
+    if (count == 0)
+    {
+        return;
+    }
+
+    streamBatch.slots = (AssetSlot**)MemoryAlloc(sizeof(AssetSlot*) * count);
+    streamBatch.count = count;
+    MemoryCopy(streamBatch.slots, queuedSlots, sizeof(AssetSlot*) * count);
+    ArrayClear(queuedSlots);
+
+    JobSystemRun(&streamCounter, StreamBatchJob, &streamBatch);
+}
+
+// Make the slot usable now, only used when gameplay can not wait for the stream
+static void FinishSlot(AssetSlot* slot)
+{
+    if (AtomicLoad(&slot->state) == ASSET_STATE_QUEUED)
+    {
+        // The slot is either in the running batch or still queued, never decode beside the streaming job
+        JobSystemWait(&streamCounter);
+
+        if (AtomicLoad(&slot->state) == ASSET_STATE_QUEUED)
+        {
+            for (int i = 0, n = ArrayCount(queuedSlots); i < n; i++)
+            {
+                if (queuedSlots[i] == slot)
+                {
+                    queuedSlots[i] = queuedSlots[n - 1];
+                    ArraySetCount(queuedSlots, n - 1);
+                    break;
+                }
+            }
+
+            DecodeSlot(slot);
+        }
+    }
+
+    if (AtomicLoad(&slot->state) == ASSET_STATE_DECODED)
+    {
+        UploadSlot(slot);
+    }
+}
+
+static AssetHandle RequestAsset(const char* path, AssetKind kind)
+{
+    const char* filePath = GetAssetPath(path);
+    u64 targetHash = HashString(filePath);
+
+    for (int i = 0, n = ArrayCount(assetSlots); i < n; i++)
+    {
+        if (assetSlots[i]->hash == targetHash && assetSlots[i]->kind == kind)
+        {
+            return i;
+        }
+    }
+
+    AssetSlot* slot = (AssetSlot*)MemoryAlloc(sizeof(AssetSlot));
+    *slot = (AssetSlot) { .hash = targetHash, .kind = kind, .state = ASSET_STATE_QUEUED, .target = -1, .soundCopies = 1 };
+    strncpy(slot->path, path, sizeof(slot->path) - 1);
+    strncpy(slot->filePath, filePath, sizeof(slot->filePath) - 1);
+
+    ArrayPush(assetSlots, slot);
+    ArrayPush(queuedSlots, slot);
+    return ArrayCount(assetSlots) - 1;
+}
+
+void    SetAssetUploader(AssetUploader uploader)
+{
+    assetUploader = uploader;
+}
+
+AssetHandle RequestTexture(const char* path)
+{
+    return RequestAsset(path, ASSET_KIND_TEXTURE);
+}
+
+AssetHandle RequestShader(const char* path)
+{
+    return RequestAsset(path, ASSET_KIND_SHADER);
+}
+
+AssetHandle RequestSound(const char* path)
+{
+    return RequestSoundCopies(path, 1);
+}
+
+AssetHandle RequestSoundCopies(const char* path, int copies)
+{
+    AssetHandle handle = RequestAsset(path, ASSET_KIND_SOUND);
+
+    // Copies are uploaded together, a later request can only raise the count before the upload
+    AssetSlot* slot = assetSlots[handle];
+    if (AtomicLoad(&slot->state) != ASSET_STATE_READY)
+    {
+        copies = copies < 1 ? 1 : (copies > MAX_SOUND_COPIES ? MAX_SOUND_COPIES : copies);
+        slot->soundCopies = slot->soundCopies > copies ? slot->soundCopies : copies;
+    }
+
+    return handle;
+}
+
+int     GetSoundCopyCount(AssetHandle handle)
+{
+    return IsAssetReady(handle) ? assetSlots[handle]->soundCopies : 0;
+}
+
+bool    IsAssetReady(AssetHandle handle)
+{
+    return handle >= 0 && handle < ArrayCount(assetSlots) && AtomicLoad(&assetSlots[handle]->state) == ASSET_STATE_READY;
+}
+
+Texture GetTexture(AssetHandle handle)
+{
+    return IsAssetReady(handle) ? assetSlots[handle]->texture : placeholderTexture;
+}
+
+Shader  GetShader(AssetHandle handle)
+{
+    return IsAssetReady(handle) && IsShaderValid(assetSlots[handle]->shader) ? assetSlots[handle]->shader : GetShaderDefault();
+}
+
+Sound   GetSound(AssetHandle handle)
+{
+    return GetSoundCopy(handle, 0);
+}
+
+Sound   GetSoundCopy(AssetHandle handle, int copy)
+{
+    if (!IsAssetReady(handle))
+    {
+        return (Sound) { 0 };
+    }
+
+    AssetSlot* slot = assetSlots[handle];
+    return slot->sounds[copy % slot->soundCopies];
+}
+
+// Swap the reloaded asset into its slot, handles and ready state never change
+static void ApplyReload(AssetSlot* slot, AssetSlot* reload)
+{
+    double uploadStart = GetTime();
+
+    if (slot->kind == ASSET_KIND_TEXTURE || slot->kind == ASSET_KIND_ATLAS)
+    {
+        // Entities keep the source rectangles of their sprite, a moved sprite need a new texture as well
+        bool sameLayout = slot->kind != ASSET_KIND_ATLAS || memcmp(slot->sprites, reload->sprites, sizeof(AtlasSprite) * ATLAS_SPRITE_COUNT) == 0;
+        if (slot->kind == ASSET_KIND_ATLAS)
+        {
+            free(slot->sprites);
+            slot->sprites = reload->sprites;
+            reload->sprites = NULL;
+        }
+
+        Image image = reload->image;
+        if (sameLayout && image.width == slot->texture.width && image.height == slot->texture.height && image.format == slot->texture.format && image.mipmaps == 1)
+        {
+            // Same layout, update in place so the copies held by entities stay valid
+            UpdateTexture(slot->texture, image.data);
+        }
+        else
+        {
+            ArrayPush(retiredTextures, ((RetiredTexture) { .texture = slot->texture, .retireTime = uploadStart }));
+            slot->texture = assetUploader.uploadTexture(image);
+        }
+    }
+    else if (slot->kind == ASSET_KIND_SHADER)
+    {
+        Shader shader = assetUploader.uploadShader(slot->path, NULL, reload->text);
+        if (!IsShaderValid(shader))
+        {
+            DebugPrint("Reload of %s failed to compile, keeping the previous shader", slot->path);
+            FreeDecodedData(reload);
+            return;
+        }
+
+        UnloadSlot(slot);
+        slot->shader = shader;
+    }
+    else
+    {
+        UnloadSlot(slot);
+        for (int i = 0; i < slot->soundCopies; i++)
+        {
+            slot->sounds[i] = assetUploader.uploadSound(reload->wave);
+        }
+    }
+
+    double now = GetTime();
+    DebugPrint("Reloaded %s in %.2fms, main thread upload %.2fms", slot->path, (now - reload->requestTime) * 1000.0, (now - uploadStart) * 1000.0);
+
+    FreeDecodedData(reload);
+}
+
+static void OnAssetChanged(void* userData, const char* path)
+{
+    (void)userData;
+
+    u64 targetHash = HashString(GetAssetPath(path));
+
+    // A changed sprite rebuild the whole atlas
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+    {
+        if (atlasHandle >= 0 && strcmp(path, atlasSpriteNames[i]) == 0)
+        {
+            targetHash = assetSlots[atlasHandle]->hash;
+            break;
+        }
+    }
+
+    for (int i = 0, n = ArrayCount(assetSlots); i < n; i++)
+    {
+        AssetSlot* slot = assetSlots[i];
+        if (slot->hash != targetHash || AtomicLoad(&slot->state) != ASSET_STATE_READY)
+        {
+            continue;
+        }
+
+        // Decode in a shadow slot, the current asset stay in use until the swap
+        AssetSlot* reload = (AssetSlot*)MemoryAlloc(sizeof(AssetSlot));
+        *reload = *slot;
+        reload->state = ASSET_STATE_QUEUED;
+        reload->forceLoose = true;
+        reload->target = i;
+        reload->requestTime = GetTime();
+        reload->ownsData = false;
+        reload->image = (Image) { 0 };
+        reload->wave = (Wave) { 0 };
+        reload->text = NULL;
+        reload->sprites = NULL;
+
+        ArrayPush(reloadSlots, reload);
+        ArrayPush(queuedSlots, reload);
+    }
+}
+
+void    UpdateAssetStreaming(double budgetSeconds)
+{
+    double start = GetTime();
+
+    FileWatcherPoll(assetWatcher, OnAssetChanged, NULL);
+
+    if (JobSystemIsDone(&streamCounter))
+    {
+        DispatchStreamBatch();
+    }
+
+    // The streaming job is done with a slot once it is decoded, it can be freed while the job run
+    for (int i = ArrayCount(reloadSlots) - 1; i >= 0; i--)
+    {
+        AssetSlot* reload = reloadSlots[i];
+        long state = AtomicLoad(&reload->state);
+        if (state == ASSET_STATE_QUEUED)
+        {
+            continue;
+        }
+
+        if (state == ASSET_STATE_DECODED)
+        {
+            ApplyReload(assetSlots[reload->target], reload);
+        }
+        else
+        {
+            DebugPrint("Reload of %s failed, keeping the previous version", reload->path);
+        }
+
+        free(reload->sprites);
+        MemoryFree(reload);
+        reloadSlots[i] = reloadSlots[ArrayCount(reloadSlots) - 1];
+        ArraySetCount(reloadSlots, ArrayCount(reloadSlots) - 1);
+    }
+
+    // Retired in time order, short lived entities are gone and the player resolve its sprite every tick
+    int retired = 0;
+    while (retired < ArrayCount(retiredTextures) && start - retiredTextures[retired].retireTime >= RETIRED_TEXTURE_SECONDS)
+    {
+        assetUploader.unloadTexture(retiredTextures[retired].texture);
+        retired++;
+    }
+    if (retired > 0)
+    {
+        int left = ArrayCount(retiredTextures) - retired;
+        MemoryMove(retiredTextures, retiredTextures + retired, sizeof(RetiredTexture) * left);
+        ArraySetCount(retiredTextures, left);
+    }
+
+    // Upload at least one asset per frame so the stream always make progress
+    for (int i = 0, n = ArrayCount(assetSlots); i < n; i++)
+    {
+        AssetSlot* slot = assetSlots[i];
+        if (AtomicLoad(&slot->state) != ASSET_STATE_DECODED)
+        {
+            continue;
+        }
+
+        UploadSlot(slot);
+        if (GetTime() - start >= budgetSeconds)
+        {
+            break;
+        }
+    }
+}
 
 void    InitCacheTextures(void)
 {
-    cachedTextures = ArrayNew(CachedTexture, 32);
+    assetSlots = ArrayNew(AssetSlot*, 64);
+    queuedSlots = ArrayNew(AssetSlot*, 64);
+    reloadSlots = ArrayNew(AssetSlot*, 8);
+    retiredTextures = ArrayNew(RetiredTexture, 8);
+
+#ifndef RELEASE
+    // Reload changed files while the game run, for tuning art and shaders
+    assetWatcher = FileWatcherCreate(ASSET_PATH);
+    if (!assetWatcher)
+    {
+        DebugPrint("Can not watch %s, hot reload disabled", ASSET_PATH);
+    }
+#endif
+
+    shaderCache = ShaderCacheNew(SHADER_CACHE_PATH);
+    if (!shaderCache.available)
+    {
+        DebugPrint("Driver does not support program binaries, shaders are compiled every launch");
+    }
+
+    Image placeholder = GenImageColor(1, 1, BLANK);
+    placeholderTexture = assetUploader.uploadTexture(placeholder);
+    UnloadImage(placeholder);
+
+    // Stream the atlas of every sprite the game use, so the first spawn of an entity does not load it
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+    {
+        strncpy(atlasSpritePaths[i], GetAssetPath(atlasSpriteNames[i]), sizeof(atlasSpritePaths[i]) - 1);
+    }
+    atlasHandle = RequestAsset(ATLAS_NAME, ASSET_KIND_ATLAS);
 }
 
 void    ClearCacheTextures(void)
 {
-    for (int i = 0, n = ArrayCount(cachedTextures); i < n; i++)
+    JobSystemWait(&streamCounter);
+
+    DebugPrint("Shader cache: %d hits, %d misses, %d rejected by the driver, %d written",
+        shaderCache.stats.hits, shaderCache.stats.misses, shaderCache.stats.rejected, shaderCache.stats.written);
+
+    FileWatcherDestroy(assetWatcher);
+    assetWatcher = NULL;
+
+    for (int i = 0, n = ArrayCount(assetSlots); i < n; i++)
+    {
+        AssetSlot* slot = assetSlots[i];
+        if (AtomicLoad(&slot->state) == ASSET_STATE_READY)
+        {
+            UnloadSlot(slot);
+        }
+
+        FreeDecodedData(slot);
+        free(slot->sprites);
+        MemoryFree(slot);
+    }
+
+    for (int i = 0, n = ArrayCount(reloadSlots); i < n; i++)
     {
-        UnloadTexture(cachedTextures[i].texture);
+        FreeDecodedData(reloadSlots[i]);
+        free(reloadSlots[i]->sprites);
+        MemoryFree(reloadSlots[i]);
     }
 
-    ArrayFree(cachedTextures);
+    for (int i = 0, n = ArrayCount(retiredTextures); i < n; i++)
+    {
+        assetUploader.unloadTexture(retiredTextures[i].texture);
+    }
+
+    assetUploader.unloadTexture(placeholderTexture);
+    placeholderTexture = (Texture) { 0 };
+
+    MemoryFree(streamBatch.slots);
+    streamBatch = (StreamBatch) { 0 };
+
+    ArrayFree(assetSlots);
+    ArrayFree(queuedSlots);
+    ArrayFree(reloadSlots);
+    ArrayFree(retiredTextures);
+    atlasHandle = -1;
 }
 
 const char* GetAssetPath(const char* target)
 {
-#ifdef RELEASE
-#   define ASSET_PATH "Assets"
-#else
-#   define ASSET_PATH "../Binary/NeonShooter/Assets"
-#endif
-
     const char* finalPath = TextFormat("%s/%s", ASSET_PATH, target);
     return finalPath;
 }
 
-Texture CacheTexture(const char* path)
+// Block until the texture is uploaded, for sprites missing from the atlas
+static Texture CacheTexture(const char* path)
+{
+    AssetHandle handle = RequestTexture(path);
+    FinishSlot(assetSlots[handle]);
+    return GetTexture(handle);
+}
+
+Sprite  CacheSprite(const char* path)
 {
-    const char* finalPath = GetAssetPath(path);
-    u64 targetHash = HashString(finalPath);
-    
-    for (int i = 0, n = ArrayCount(cachedTextures); i < n; i++)
+    AssetSlot* atlas = atlasHandle >= 0 ? assetSlots[atlasHandle] : NULL;
+    if (atlas)
     {
-        CachedTexture cachedTexture = cachedTextures[i];
-        if (cachedTexture.hash == targetHash)
-        {
-            return cachedTexture.texture;
-        }
+        FinishSlot(atlas);
     }
 
-    Texture texture = LoadTexture(finalPath);
-    if (texture.id != 0)
+    if (atlas && AtomicLoad(&atlas->state) == ASSET_STATE_READY)
     {
-        CachedTexture newEntry = { targetHash, texture };
-        ArrayPush(cachedTextures, newEntry);
+        u64 hash = HashString(path);
+        for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+        {
+            if (atlas->sprites[i].hash == hash)
+            {
+                return (Sprite) { atlas->texture, atlas->sprites[i].source };
+            }
+        }
     }
 
-    return texture;
+    // Not in the atlas, or the atlas failed to build: a texture of its own
+    Texture texture = CacheTexture(path);
+    return (Sprite) { texture, { 0.0f, 0.0f, (float)texture.width, (float)texture.height } };
 }
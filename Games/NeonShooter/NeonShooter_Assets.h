@@ -1,11 +1,62 @@
 #pragma once
 
 #include <raylib.h>
+#include <stdbool.h>
 
 const char*     GetAssetPath(const char* target);
 
+// Serve assets from the packed archive when it exists, loose files otherwise
+bool            OpenAssetArchive(void);
+void            CloseAssetArchive(void);
+
+// Raw bytes of a file stored as is in the archive, NULL when it is not packed
+const void*     GetPackedAssetData(const char* path, int* size);
+
+// Own every streamed asset, textures and sounds, clear before closing the audio device
 void            InitCacheTextures(void);
 void            ClearCacheTextures(void);
 
-Texture         CacheTexture(const char* path);
+// A region of a texture, sprites share the atlas texture so consecutive draws batch together
+typedef struct Sprite
+{
+    Texture     texture;
+    Rectangle   source;
+} Sprite;
+
+// Block until the sprite atlas is uploaded, sprites missing from the atlas get a texture of their own
+Sprite          CacheSprite(const char* path);
+
+// Asynchronous loading: decode on a streaming job, upload on the main thread
+typedef int     AssetHandle;
+
+// Upload hooks run on the main thread, raylib functions by default, stubs for headless runs
+// Shaders go through the program binary cache by default, name is the asset path
+typedef struct AssetUploader
+{
+    Texture     (*uploadTexture)(Image image);
+    Sound       (*uploadSound)(Wave wave);
+    Shader      (*uploadShader)(const char* name, const char* vsCode, const char* fsCode);
+    void        (*unloadTexture)(Texture texture);
+    void        (*unloadSound)(Sound sound);
+    void        (*unloadShader)(Shader shader);
+} AssetUploader;
+
+void            SetAssetUploader(AssetUploader uploader);
+
+AssetHandle     RequestTexture(const char* path);
+AssetHandle     RequestShader(const char* path);    // Fragment shader, default vertex shader
+AssetHandle     RequestSound(const char* path);
+AssetHandle     RequestSoundCopies(const char* path, int copies);   // Up to 4 copies that can play over each other
+
+bool            IsAssetReady(AssetHandle handle);
+Texture         GetTexture(AssetHandle handle);     // Blank placeholder until ready
+Shader          GetShader(AssetHandle handle);      // Default shader until ready
+Sound           GetSound(AssetHandle handle);       // Empty sound until ready
+Sound           GetSoundCopy(AssetHandle handle, int copy);
+int             GetSoundCopyCount(AssetHandle handle);
+
+// Start the next streaming job and upload decoded assets within the budget, once per frame
+// Outside release builds, files changed under the asset directory are reloaded and swapped in place
+// Textures replaced by a reload are freed RETIRED_TEXTURE_SECONDS later, entities holding them must resolve their sprite again
+void            UpdateAssetStreaming(double budgetSeconds);
 //const char*     CacheText(const char* path);
@@ -2,142 +2,225 @@
 #include "NeonShooter_GameAudio.h"
 
 #include <Array.h>
+#include <VoicePool.h>
+#include <MusicStream.h>
+#include <stddef.h>
 #include <raylib.h>
 
-static Music        music;
-static Array(Sound) shootSounds = 0;
-static Array(Sound) spawnSounds = 0;
-static Array(Sound) explosionSounds = 0;
+// Categories of the voice pool, a higher priority can steal the voices of a lower one
+typedef enum SoundCategory
+{
+    SOUND_SHOOT,
+    SOUND_SPAWN,
+    SOUND_EXPLOSION,
 
-void GameAudioInit(void)
+    SOUND_CATEGORY_COUNT
+} SoundCategory;
+
+typedef struct SoundCategoryDesc
 {
-    InitAudioDevice();
+    const char* format;         // Sample path with the sample number
+    int         sampleCount;
+    int         maxVoices;
+    int         priority;
+    float       volume;
+} SoundCategoryDesc;
+
+static const SoundCategoryDesc soundCategories[SOUND_CATEGORY_COUNT] = {
+    [SOUND_SHOOT]     = { "Audios/shoot-%02d.wav",     4, 3, 1, 0.2f },
+    [SOUND_SPAWN]     = { "Audios/spawn-%02d.wav",     8, 4, 2, 0.3f },
+    [SOUND_EXPLOSION] = { "Audios/explosion-%02d.wav", 8, 4, 3, 0.4f },
+};
+
+#define VOICE_COUNT 12
+
+// Sound copy played by a voice
+typedef struct VoiceSound
+{
+    AssetHandle handle;
+    int         copy;
+} VoiceSound;
 
-    //const char* musicStreamPath = GetAssetPath("Audios/Music.ogg");
-    //music = LoadMusicStream(musicStreamPath);
-    //StopMusicStream(music);
-
-    ArrayPush(shootSounds, LoadSound(GetAssetPath("Audios/shoot-01.wav")));
-    ArrayPush(shootSounds, LoadSound(GetAssetPath("Audios/shoot-02.wav")));
-    ArrayPush(shootSounds, LoadSound(GetAssetPath("Audios/shoot-03.wav")));
-    ArrayPush(shootSounds, LoadSound(GetAssetPath("Audios/shoot-04.wav")));
-
-    ArrayPush(spawnSounds, LoadSound(GetAssetPath("Audios/spawn-01.wav")));
-    ArrayPush(spawnSounds, LoadSound(GetAssetPath("Audios/spawn-02.wav")));
-    ArrayPush(spawnSounds, LoadSound(GetAssetPath("Audios/spawn-03.wav")));
-    ArrayPush(spawnSounds, LoadSound(GetAssetPath("Audios/spawn-04.wav")));
-    ArrayPush(spawnSounds, LoadSound(GetAssetPath("Audios/spawn-05.wav")));
-    ArrayPush(spawnSounds, LoadSound(GetAssetPath("Audios/spawn-06.wav")));
-    ArrayPush(spawnSounds, LoadSound(GetAssetPath("Audios/spawn-07.wav")));
-    ArrayPush(spawnSounds, LoadSound(GetAssetPath("Audios/spawn-08.wav")));
-
-    ArrayPush(explosionSounds, LoadSound(GetAssetPath("Audios/explosion-01.wav")));
-    ArrayPush(explosionSounds, LoadSound(GetAssetPath("Audios/explosion-02.wav")));
-    ArrayPush(explosionSounds, LoadSound(GetAssetPath("Audios/explosion-03.wav")));
-    ArrayPush(explosionSounds, LoadSound(GetAssetPath("Audios/explosion-04.wav")));
-    ArrayPush(explosionSounds, LoadSound(GetAssetPath("Audios/explosion-05.wav")));
-    ArrayPush(explosionSounds, LoadSound(GetAssetPath("Audios/explosion-06.wav")));
-    ArrayPush(explosionSounds, LoadSound(GetAssetPath("Audios/explosion-07.wav")));
-    ArrayPush(explosionSounds, LoadSound(GetAssetPath("Audios/explosion-08.wav")));
+// Frames refilled per processed buffer, the sub-buffer size of a raylib 3.0 audio stream
+#define MUSIC_BUFFER_FRAMES 4096
+#define MUSIC_RING_SECONDS  2.0f
+
+static MusicStream          music;
+static AudioStream          musicOutput;
+static bool                 musicPlaying;
+static int16_t              musicFrames[MUSIC_BUFFER_FRAMES * 2];
+static Array(AssetHandle)   samples = 0;
+static int                  firstSamples[SOUND_CATEGORY_COUNT];
+
+static VoicePool            voicePool;
+static VoiceSound           voiceSounds[VOICE_COUNT];
+
+static bool StartVoice(void* userData, int voice, int sample, float volume)
+{
+    (void)userData;
+
+    AssetHandle handle = samples[sample];
+    if (!IsAssetReady(handle))
+    {
+        return false;
+    }
+
+    // Each copy can only play once at a time, never restart one that another voice still own
+    for (int copy = 0, n = GetSoundCopyCount(handle); copy < n; copy++)
+    {
+        Sound sound = GetSoundCopy(handle, copy);
+        if (!IsSoundPlaying(sound))
+        {
+            SetSoundVolume(sound, volume);
+            PlaySound(sound);
+
+            voiceSounds[voice] = (VoiceSound) { handle, copy };
+            return true;
+        }
+    }
+
+    return false;
 }
 
-void GameAudioRelease(void)
+static void StopVoice(void* userData, int voice)
 {
-    for (int i = 0, n = ArrayCount(shootSounds); i < n; i++)
+    (void)userData;
+
+    if (IsAssetReady(voiceSounds[voice].handle))
     {
-        UnloadSound(shootSounds[i]);
+        StopSound(GetSoundCopy(voiceSounds[voice].handle, voiceSounds[voice].copy));
     }
-    ArrayFree(shootSounds);
+}
+
+static bool IsVoicePlaying(void* userData, int voice)
+{
+    (void)userData;
+
+    return IsAssetReady(voiceSounds[voice].handle) && IsSoundPlaying(GetSoundCopy(voiceSounds[voice].handle, voiceSounds[voice].copy));
+}
+
+static void PlayCategory(SoundCategory category)
+{
+    const SoundCategoryDesc* desc = &soundCategories[category];
 
-    for (int i = 0, n = ArrayCount(spawnSounds); i < n; i++)
+    int sample = firstSamples[category] + GetRandomValue(0, desc->sampleCount - 1);
+    VoicePoolPlay(&voicePool, category, sample, desc->volume, desc->priority);
+}
+
+void GameAudioInit(void)
+{
+    InitAudioDevice();
+
+    // Decoded on its own thread, the game thread only copy out of the ring
+    int packedSize = 0;
+    const void* packedMusic = GetPackedAssetData("Audios/Music.ogg", &packedSize);
+    bool musicOpened = packedMusic
+        ? MusicStreamOpenMemory(&music, packedMusic, packedSize, MUSIC_RING_SECONDS, true)
+        : MusicStreamOpen(&music, GetAssetPath("Audios/Music.ogg"), MUSIC_RING_SECONDS, true);
+    if (musicOpened)
     {
-        UnloadSound(spawnSounds[i]);
+        musicOutput = InitAudioStream(music.sampleRate, 16, music.channels);
     }
-    ArrayFree(spawnSounds);
 
-    for (int i = 0, n = ArrayCount(explosionSounds); i < n; i++)
+    VoiceBackend backend = { NULL, StartVoice, StopVoice, IsVoicePlaying };
+    voicePool = VoicePoolNew(VOICE_COUNT, backend);
+
+    for (int category = 0; category < SOUND_CATEGORY_COUNT; category++)
     {
-        UnloadSound(explosionSounds[i]);
+        const SoundCategoryDesc* desc = &soundCategories[category];
+
+        firstSamples[category] = ArrayCount(samples);
+        for (int i = 0; i < desc->sampleCount; i++)
+        {
+            ArrayPush(samples, RequestSoundCopies(TextFormat(desc->format, i + 1), desc->maxVoices));
+        }
+
+        VoicePoolSetCategory(&voicePool, category, desc->maxVoices);
     }
-    ArrayFree(explosionSounds);
+}
+
+void GameAudioRelease(void)
+{
+    VoicePoolFree(&voicePool);
 
-    //UnloadMusicStream(music);
-    //music = (Music){ 0 };
+    // Sounds are owned by the asset cache, cleared before the device is closed
+    ArrayFree(samples);
+
+    if (musicOutput.buffer)
+    {
+        CloseAudioStream(musicOutput);
+        musicOutput = (AudioStream) { 0 };
+    }
+    MusicStreamClose(&music);
+    musicPlaying = false;
 
     CloseAudioDevice();     // Close audio device
 }
 
 void GameAudioUpdate(void)
 {
-    //UpdateMusicStream(music);
+    if (!musicPlaying)
+    {
+        return;
+    }
+
+    while (IsAudioStreamProcessed(musicOutput))
+    {
+        MusicStreamRead(&music, musicFrames, MUSIC_BUFFER_FRAMES);
+        UpdateAudioStream(musicOutput, musicFrames, MUSIC_BUFFER_FRAMES * music.channels);
+    }
 }
 
-void GameAudioPlayMusic(void)
+void GameAudioFlush(void)
 {
-    //SetMusicVolume(music, 0.5f);
-    //SetMusicLoopCount(music, -1);
+    VoicePoolUpdate(&voicePool);
+}
 
-    //PlayMusicStream(music);
+void GameAudioPlayMusic(void)
+{
+    if (musicOutput.buffer && !musicPlaying)
+    {
+        SetAudioStreamVolume(musicOutput, 0.5f);
+        PlayAudioStream(musicOutput);
+        musicPlaying = true;
+    }
 }
 
 void GameAudioStopMusic(void)
 {
-    //StopMusicStream(music);
+    if (musicPlaying)
+    {
+        StopAudioStream(musicOutput);
+        musicPlaying = false;
+    }
 }
 
 void GameAudioPlayShoot(void)
 {
-    int count = ArrayCount(shootSounds);
-    if (count > 0)
-    {
-        Sound sound = shootSounds[GetRandomValue(0, count - 1)];
-        SetSoundVolume(sound, 0.2f);
-        PlaySound(sound);
-    }
+    PlayCategory(SOUND_SHOOT);
 }
 
 void GameAudioStopShoot(void)
 {
-    for (int i = 0, n = ArrayCount(shootSounds); i < n; i++)
-    {
-        StopSound(shootSounds[i]);
-    }
+    VoicePoolStop(&voicePool, SOUND_SHOOT);
 }
 
 void GameAudioPlayExplosion(void)
 {
-    int count = ArrayCount(explosionSounds);
-    if (count > 0)
-    {
-        Sound sound = explosionSounds[GetRandomValue(0, count - 1)];
-        SetSoundVolume(sound, 0.4f);
-        PlaySound(sound);
-    }
+    PlayCategory(SOUND_EXPLOSION);
 }
 
 void GameAudioStopExplosion(void)
 {
-    for (int i = 0, n = ArrayCount(explosionSounds); i < n; i++)
-    {
-        StopSound(explosionSounds[i]);
-    }
+    VoicePoolStop(&voicePool, SOUND_EXPLOSION);
 }
 
 void GameAudioPlaySpawn(void)
 {
-    int count = ArrayCount(spawnSounds);
-    if (count > 0)
-    {
-        Sound sound = spawnSounds[GetRandomValue(0, count - 1)];
-        SetSoundVolume(sound, 0.3f);
-        PlaySound(sound);
-    }
+    PlayCategory(SOUND_SPAWN);
 }
 
 void GameAudioStopSpawn(void)
 {
-    for (int i = 0, n = ArrayCount(spawnSounds); i < n; i++)
-    {
-        StopSound(spawnSounds[i]);
-    }
+    VoicePoolStop(&voicePool, SOUND_SPAWN);
 }
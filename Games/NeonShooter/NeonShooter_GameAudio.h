@@ -5,6 +5,9 @@ void GameAudioRelease(void);
 
 void GameAudioUpdate(void);
 
+// Start the sounds requested during the tick, identical requests play once
+void GameAudioFlush(void);
+
 void GameAudioPlayMusic(void);
 void GameAudioStopMusic(void);
 
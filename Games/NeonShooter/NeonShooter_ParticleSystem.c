@@ -6,18 +6,25 @@
 
 #include <Array.h>
 #include <FreeList.h>
+#include <FastMath.h>
+#include <Renderer.h>
+#include <JobSystem.h>
+
+#define PARTICLE_BATCH_SIZE 256
 
 typedef struct Particle
 {
     bool        active;
-    Texture     texture;
+    Sprite      sprite;
     Vector2     velocity;
     Vector2     position;
-    float       rotation;
+    Vector2     direction;      // Not normalized, only its angle is used at render time
     Vector2     scale;
     Vector4     color;
     float       timer;
     float       duration;
+    Vector2     prevPosition;
+    Vector2     prevDirection;
 } Particle;
 
 FreeListStruct(Particle);
@@ -38,63 +45,74 @@ void ReleaseParticles(void)
     FreeListFree(particles);
 }
 
-void SpawnParticle(Texture texture, Vector2 position, Vector4 color, float duration, Vector2 scale, float theta, Vector2 velocity)
+void SpawnParticle(Sprite sprite, Vector2 position, Vector4 color, float duration, Vector2 scale, float theta, Vector2 velocity)
 {
+    Vector2 direction;
+    FastSinCosf(theta, &direction.y, &direction.x);
+
     Particle particle = {
         .active = true,
         .scale = scale,
-        .rotation = theta,
+        .direction = direction,
         .position = position,
         .velocity = velocity,
-        .texture = texture,
+        .sprite = sprite,
         .color = color,
         .timer = 0.0f,
-        .duration = duration
+        .duration = duration,
+        .prevPosition = position,
+        .prevDirection = direction,
     };
 
     FreeListAdd(particles, particle);
 }
 
-static bool UpdateParticle(World* world, Particle* p, float dt)
+typedef struct ParticlePass
 {
-    bool result = false;
+    World*  world;
+    float   dt;
+} ParticlePass;
 
+// Expired particles stay active until the serial collect pass, workers must not touch the free list
+static void UpdateParticle(World* world, Particle* p, float dt)
+{
     if (p->active)
     {
+        p->prevPosition = p->position;
+        p->prevDirection = p->direction;
+
         p->timer += dt;
-        if (p->timer >= p->duration)
+
+        if (p->velocity.x != 0.0f || p->velocity.y != 0.0f)
         {
-            result = true;
-            p->active = false;
+            p->direction = p->velocity;
         }
-
-        p->rotation = atan2f(p->velocity.y, p->velocity.x);
         p->position = Vector2Add(p->position, Vector2Scale(p->velocity, dt));
         p->velocity = Vector2Scale(p->velocity, 1.0f - 3 * dt);
 
         p->scale.x = 1.0f - p->timer / p->duration;
         p->color.w = 1.0f - p->timer / p->duration;
 
-        if (p->position.x <= -GetScreenWidth())
+        if (p->position.x <= -world->bounds.x)
         {
             p->velocity.x = fabsf(p->velocity.x);
-            p->position.x = -GetScreenWidth();
+            p->position.x = -world->bounds.x;
         }
-        else if (p->position.x >= GetScreenWidth())
+        else if (p->position.x >= world->bounds.x)
         {
             p->velocity.x = -fabsf(p->velocity.x);
-            p->position.x = GetScreenWidth();
+            p->position.x = world->bounds.x;
         }
 
-        if (p->position.y <= -GetScreenHeight())
+        if (p->position.y <= -world->bounds.y)
         {
             p->velocity.y = fabsf(p->velocity.y);
-            p->position.y = -GetScreenHeight();
+            p->position.y = -world->bounds.y;
         }
-        else if (p->position.y >= GetScreenHeight())
+        else if (p->position.y >= world->bounds.y)
         {
             p->velocity.y = -fabsf(p->velocity.y);
-            p->position.y = GetScreenHeight();
+            p->position.y = world->bounds.y;
         }
 
         for (int i = 0, n = FreeListCount(world->blackHoles); i < n; i++)
@@ -104,8 +122,8 @@ static bool UpdateParticle(World* world, Particle* p, float dt)
 
             Vector2 diff = Vector2Subtract(blackhole->position, p->position);
             float d = Vector2Length(diff);
-            Vector2 normal = Vector2Normalize(diff);
-            p->velocity = Vector2Add(p->velocity, Vector2Scale(normal, fmaxf(0.0f, GetScreenWidth() / d)));
+            Vector2 normal = Vector2Scale(diff, 1.0f / d);
+            p->velocity = Vector2Add(p->velocity, Vector2Scale(normal, fmaxf(0.0f, world->bounds.x / d)));
 
             // add tangential acceleration for nearby particles
             if (d < 10.0f * blackhole->radius)
@@ -114,40 +132,62 @@ static bool UpdateParticle(World* world, Particle* p, float dt)
             }
         }
     }
+}
+
+static void UpdateParticlesPass(void* userData, int start, int end, int batchIndex)
+{
+    ParticlePass* pass = (ParticlePass*)userData;
 
-    return result;
+    for (int i = start; i < end; i++)
+    {
+        UpdateParticle(pass->world, &particles.elements[i], pass->dt);
+    }
 }
 
 void UpdateParticles(World* world, float dt)
 {
+    ParticlePass pass = { world, dt };
+
+    if (world->parallel)
+    {
+        ParallelFor(FreeListCount(particles), PARTICLE_BATCH_SIZE, UpdateParticlesPass, &pass);
+    }
+    else
+    {
+        UpdateParticlesPass(&pass, 0, FreeListCount(particles), 0);
+    }
+
     for (int i = 0, n = FreeListCount(particles); i < n; i++)
     {
         Particle* p = &particles.elements[i];
-        if (UpdateParticle(world, p, dt))
+        if (p->active && p->timer >= p->duration)
         {
+            p->active = false;
             FreeListCollect(particles, i);
         }
     }
 }
 
-void DrawParticles()
+void DrawParticles(float alpha)
 {
-    BeginBlendMode(BLEND_ADDITIVE);
+    RendererBeginBlendMode(BLEND_ADDITIVE);
     for (int i = 0, n = FreeListCount(particles); i < n; i++)
     {
         Particle p = particles.elements[i];
         if (p.active)
         {
             Color color = (Color) { p.color.x * 255, p.color.y * 255, p.color.z * 255, p.color.w * 255 };
-            DrawTexturePro(
-                p.texture, 
-                (Rectangle) { 0, 0, p.texture.width, p.texture.height }, 
-                (Rectangle) { p.position.x, p.position.y, p.texture.width * p.scale.x, p.texture.height * p.scale.y },
-                (Vector2) { p.texture.width * 0.5f, p.texture.height * 0.5f },
-                p.rotation * RAD2DEG, 
+            Vector2 position = Vector2Lerp(p.prevPosition, p.position, alpha);
+            float rotation = FastLerpAngle2f(p.prevDirection.x, p.prevDirection.y, p.direction.x, p.direction.y, alpha);
+            RendererDrawTexturePro(
+                p.sprite.texture, 
+                p.sprite.source, 
+                (Rectangle) { position.x, position.y, p.sprite.source.width * p.scale.x, p.sprite.source.height * p.scale.y },
+                (Vector2) { p.sprite.source.width * 0.5f, p.sprite.source.height * 0.5f },
+                rotation * RAD2DEG, 
                 color
             );
         }
     }
-    EndBlendMode();
+    RendererEndBlendMode();
 }
\ No newline at end of file
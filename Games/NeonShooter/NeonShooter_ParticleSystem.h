@@ -7,7 +7,7 @@ void InitParticles(void);
 void ClearParticles(void);
 void ReleaseParticles(void);
 
-void SpawnParticle(Texture texture, Vector2 position, Vector4 color, float duration, Vector2 scale, float theta, Vector2 velocity);
+void SpawnParticle(Sprite sprite, Vector2 position, Vector4 color, float duration, Vector2 scale, float theta, Vector2 velocity);
 
 void UpdateParticles(World* world, float dt);
-void DrawParticles(void);
\ No newline at end of file
+void DrawParticles(float alpha);
\ No newline at end of file
@@ -7,8 +7,19 @@
 #include <raylib.h>
 #include <raymath.h>
 
+#include <Debug.h>
+#include <FastMath.h>
+#include <Renderer.h>
+#include <JobSystem.h>
+
 #define DEFAULT_POINT_DAMPING 1.0F
 
+// Entities per parallel batch, batches are the unit of event ordering so it must not depend on thread count
+#define ENTITY_BATCH_SIZE       64
+
+// Upper bound of events one entity can queue in a pass (wanderer: 6 grid impulses and a destroy)
+#define MAX_EVENTS_PER_ENTITY   8
+
 int GetFrameCount(void);
 
 static float clampf(float value, float min, float max)
@@ -36,6 +47,24 @@ static float Vector2DistanceSq(Vector2 a, Vector2 b)
     return d;
 }
 
+// Normalize with one division, zero vectors stay zero instead of turning into NaN
+static Vector2 Vector2NormalizeFast(Vector2 v)
+{
+    FastNormalize2f(&v.x, &v.y);
+    return v;
+}
+
+// Entities face where they move, and keep their last facing when they stop
+static Vector2 EntityFacing(Entity entity)
+{
+    if (entity.velocity.x == 0.0f && entity.velocity.y == 0.0f)
+    {
+        return entity.direction;
+    }
+
+    return Vector2NormalizeFast(entity.velocity);
+}
+
 static Vector2 Vector2CatmullRom(Vector2 v1, Vector2 v2, Vector2 v3, Vector2 v4, float amount)
 {
     float squared = amount * amount;
@@ -70,171 +99,40 @@ static Vector4 Vector4Scale(Vector4 v, float scalar)
     return result;
 }
 
-static PointMass NewPointMass(Vector2 position, float invMass)
-{
-    return (PointMass) {
-        .position = position,
-        .velocity = { 0, 0 },
-
-        .acceleration = { 0, 0 }, 
-        .invMass = invMass,
-        .damping = DEFAULT_POINT_DAMPING,
-    };
-}
-
-static void UpdatePointMass(PointMass* p, float timeStep)
-{
-    Vector2 velocity = Vector2Add(p->velocity, Vector2Scale(p->acceleration, timeStep));
-    Vector2 position = Vector2Add(p->position, Vector2Scale(velocity, timeStep));
-
-    if (Vector2LengthSq(velocity) < 0.001f * 0.001f)
-    {
-        velocity = (Vector2) { 0, 0 };
-    }
-    else
-    {
-        velocity = Vector2Scale(velocity, fmaxf(0.0f, 1.0f - p->damping * timeStep));
-    }
-
-    Vector2 acceleration = p->acceleration;
-    if (Vector2LengthSq(acceleration) < 0.001f * 0.001f)
-    {
-        acceleration = (Vector2) { 0, 0 };
-    }
-    else
-    {
-        acceleration = Vector2Scale(acceleration, fmaxf(0.0f, 1.0f - p->damping * timeStep));
-    }
-
-    p->position     = position;
-    p->velocity     = velocity;
-    p->acceleration = acceleration;
-    p->damping      = DEFAULT_POINT_DAMPING;
-}
-
-static void PointMassApplyForce(PointMass* p, Vector2 force, float timeStep)
-{
-    p->acceleration = Vector2Add(p->acceleration, Vector2Scale(force, p->invMass * timeStep));
-}
-
-static void PointMassIncreaseDamping(PointMass* p, float factor)
-{
-    p->damping = p->damping * factor;
-}
-
-static Spring NewSpring(PointMass* p0, PointMass* p1, float stiffness, float damping)
-{
-    return (Spring){
-        .p0 = p0,
-        .p1 = p1,
-
-        .targetLength = Vector2Distance(p0->position, p1->position) * 0.99f,
-        .stiffness = stiffness,
-        .damping = damping,
-        .force = 60.0f,
-    };
-}
-
-static void UpdateSpring(Spring* spring, float timeStep)
-{
-    Vector2 diff = Vector2Subtract(spring->p0->position, spring->p1->position);
-    float len = Vector2Length(diff);
-    if (len > spring->targetLength)
-    {
-        float changeRate = (len - spring->targetLength) / len;
-        Vector2 dvel = Vector2Subtract(spring->p1->velocity, spring->p0->velocity);
-        Vector2 force = Vector2Subtract(Vector2Scale(diff, changeRate * spring->stiffness), Vector2Scale(dvel, fmaxf(0.0f, 1.0f - spring->damping * timeStep)));
-
-        PointMassApplyForce(spring->p0, Vector2Scale(Vector2Negate(force), spring->force), timeStep);
-        PointMassApplyForce(spring->p1, Vector2Scale(force, spring->force), timeStep);
-    }
-}
-
-static WarpGrid NewWarpGrid(Rectangle bounds, Vector2 spacing)
+static SpringGrid NewWarpGrid(Rectangle bounds, Vector2 spacing)
 {
     int cols = (int)(bounds.width / spacing.x) + 1;
     int rows = (int)(bounds.height / spacing.y) + 1;
 
-    int pointCount = cols * rows;
-    Array(Spring) springs = ArrayNew(Spring, 4 * pointCount);
-    Array(PointMass) points = ArrayNew(PointMass, pointCount);
-    Array(PointMass) fixedPoints = ArrayNew(PointMass, pointCount);
-
-    if (!points || !springs || !fixedPoints)
-    {
-        ArrayFree(points);
-        ArrayFree(springs);
-        ArrayFree(fixedPoints);
-
-        return (WarpGrid) { 0 };
-    }
-
-    ArraySetCount(points, pointCount);
-    ArraySetCount(fixedPoints, pointCount);
-
-    for (int i = 0; i < rows; i++)
-    {
-        for (int j = 0; j < cols; j++)
-        {
-            int  index = i * cols + j;
-            Vector2 position = (Vector2){ bounds.x + j * spacing.x, bounds.y + i * spacing.y };
-            
-            points[index] = NewPointMass(position, 1.0f);
-            fixedPoints[index] = NewPointMass(position, 0.0f);
-
-            if ((i == 0) || (j == 0) || (i == rows - 1) || (j == cols - 1)) // anchor the border of the grid
-            {
-                ArrayPush(springs, NewSpring(&fixedPoints[index], &points[index], 0.1f, 5.0f));
-            }
-            else if ((i % 3 == 0) && (j % 3 == 0)) // loosely anchor 1/9th of the point masses
-            {
-                ArrayPush(springs, NewSpring(&fixedPoints[index], &points[index], 0.002f, 40.0f));
-            }
+    SpringGridParams params = {
+        .stiffness = 0.28f,
+        .damping = 30.0f,
+        .restLength = 0.99f,
+        .force = 60.0f,
 
-            const float stiffness = 0.28f;
-            const float damping = 30.0f;
-            if (j > 0)
-            {
-                ArrayPush(springs, NewSpring(&points[i * cols + (j - 1)], &points[index], stiffness, damping));
-            }
+        .borderStiffness = 0.1f,    // anchor the border of the grid
+        .borderDamping = 5.0f,
+        .anchorStiffness = 0.002f,  // loosely anchor 1/9th of the point masses
+        .anchorDamping = 40.0f,
+        .anchorStep = 3,
 
-            if (i > 0)
-            {
-                ArrayPush(springs, NewSpring(&points[(i - 1) * cols + j], &points[index], stiffness, damping));
-            }
-        }
-    }
+        .pointDamping = DEFAULT_POINT_DAMPING,
+        .restThreshold = 0.001f,
 
-    return (WarpGrid) {
-        .cols = cols, .rows = rows, .springs = springs, .points = points, .fixedPoints = fixedPoints
+        .sleepThreshold = 1.0f,     // settled tiles of the grid are not updated
     };
-}
-
-static WarpGrid FreeWarpGrid(WarpGrid grid)
-{
-    ArrayFree(grid.points);
-    ArrayFree(grid.springs);
-    ArrayFree(grid.fixedPoints);
 
-    return (WarpGrid) { 0 };
+    return SpringGridNew(cols, rows, (Vector2) { bounds.x, bounds.y }, spacing, params);
 }
 
-static void UpdateWarpGrid(WarpGrid grid, float timeStep)
+static Vector2 WarpGridRenderPosition(SpringGrid grid, int index, float alpha)
 {
-    for (int i = 0, n = ArrayCount(grid.springs); i < n; i++)
-    {
-        UpdateSpring(&grid.springs[i], timeStep);
-    }
-
-    for (int i = 0, n = ArrayCount(grid.points); i < n; i++)
-    {
-        UpdatePointMass(&grid.points[i], timeStep);
-    }
+    return SpringGridRenderPosition(grid, index, alpha);
 }
 
-static void RenderWarpGrid(WarpGrid grid)
+static void RenderWarpGrid(SpringGrid grid, float alpha)
 {
-    BeginBlendMode(BLEND_ADDITIVE);
+    RendererBeginBlendMode(BLEND_ADDITIVE);
 
     Color color = (Color){ 30, 30, 139, 156 };   // dark blue
 
@@ -247,96 +145,74 @@ static void RenderWarpGrid(WarpGrid grid)
             float horThickness = 2.0f;
             float verThickness = 2.0f;
 
-            Vector2 current = grid.points[i * cols + j].position;
+            Vector2 current = WarpGridRenderPosition(grid, i * cols + j, alpha);
             
-            Vector2 left = grid.points[i * cols + (j - 1)].position;
-            Vector2 up = grid.points[(i - 1) * cols + j].position;
+            Vector2 left = WarpGridRenderPosition(grid, i * cols + (j - 1), alpha);
+            Vector2 up = WarpGridRenderPosition(grid, (i - 1) * cols + j, alpha);
 
             Vector2 midUp = Vector2Scale(Vector2Add(current, up), 0.5f);
             Vector2 midLeft = Vector2Scale(Vector2Add(current, left), 0.5f);
 
-            Vector2 upLeft = grid.points[(i - 1) * cols + (j - 1)].position;
+            Vector2 upLeft = WarpGridRenderPosition(grid, (i - 1) * cols + (j - 1), alpha);
             //DrawLineEx(Vector2Scale(Vector2Add(upLeft, left), 0.5f), midLeft, horThickness, color);   // horizontal line
 
             int j0 = fmaxf(j - 2, 0);
             int j1 = fminf(j + 1, cols - 1);
-            Vector2 horMid = Vector2CatmullRom(grid.points[i * cols + j0].position, left, current, grid.points[i * cols + j1].position, 0.5f);
+            Vector2 horMid = Vector2CatmullRom(WarpGridRenderPosition(grid, i * cols + j0, alpha), left, current, WarpGridRenderPosition(grid, i * cols + j1, alpha), 0.5f);
             if (Vector2DistanceSq(horMid, midLeft) > 1.0f)
             {
-                DrawLineEx(left, horMid, horThickness, color);
-                DrawLineEx(horMid, current, horThickness, color);
-                DrawLineEx(Vector2Scale(Vector2Add(upLeft, up), 0.5f), horMid, verThickness, color);   // vertical line
+                RendererDrawLineEx(left, horMid, horThickness, color);
+                RendererDrawLineEx(horMid, current, horThickness, color);
+                RendererDrawLineEx(Vector2Scale(Vector2Add(upLeft, up), 0.5f), horMid, verThickness, color);   // vertical line
             }
             else
             {
-                DrawLineEx(left, current, horThickness, color);
-                DrawLineEx(Vector2Scale(Vector2Add(upLeft, up), 0.5f), midLeft, verThickness, color);   // vertical line
+                RendererDrawLineEx(left, current, horThickness, color);
+                RendererDrawLineEx(Vector2Scale(Vector2Add(upLeft, up), 0.5f), midLeft, verThickness, color);   // vertical line
             }
             
             int i0 = fmaxf(i - 2, 0);
             int i1 = fminf(i + 1, rows - 1);
-            Vector2 verMid = Vector2CatmullRom(grid.points[i0 * cols + j].position, up, current, grid.points[i1 * cols + j].position, 0.5f);
+            Vector2 verMid = Vector2CatmullRom(WarpGridRenderPosition(grid, i0 * cols + j, alpha), up, current, WarpGridRenderPosition(grid, i1 * cols + j, alpha), 0.5f);
             if (Vector2DistanceSq(verMid, midUp) > 1.0f)
             {
-                DrawLineEx(up, verMid, verThickness, color);
-                DrawLineEx(verMid, current, verThickness, color);
-                DrawLineEx(Vector2Scale(Vector2Add(upLeft, left), 0.5f), verMid, horThickness, color);   // horizontal line
+                RendererDrawLineEx(up, verMid, verThickness, color);
+                RendererDrawLineEx(verMid, current, verThickness, color);
+                RendererDrawLineEx(Vector2Scale(Vector2Add(upLeft, left), 0.5f), verMid, horThickness, color);   // horizontal line
             }
             else
             {
-                DrawLineEx(up, current, verThickness, color);
-                DrawLineEx(Vector2Scale(Vector2Add(upLeft, left), 0.5f), midUp, horThickness, color);   // horizontal line
+                RendererDrawLineEx(up, current, verThickness, color);
+                RendererDrawLineEx(Vector2Scale(Vector2Add(upLeft, left), 0.5f), midUp, horThickness, color);   // horizontal line
             }
         }
     }
 
-    EndBlendMode();
+    RendererEndBlendMode();
 }
 
-static void WarpGridApplyDirectedForce(WarpGrid grid, Vector2 force, Vector2 position, float radius, float timeStep)
+static void WarpGridApplyDirectedForce(SpringGrid grid, Vector2 force, Vector2 position, float radius, float timeStep)
 {
-    for (int i = 0, n = ArrayCount(grid.points); i < n; i++)
+    SpringGridRange range = SpringGridRangeInRadius(grid, position, radius);
+    for (int row = range.row0; row < range.row1; row++)
     {
-        PointMass point = grid.points[i];
-        if (Vector2DistanceSq(position, point.position) < radius * radius)
+        for (int col = range.col0; col < range.col1; col++)
         {
-             PointMassApplyForce(&grid.points[i], Vector2Scale(force, 1.0f / (1.0f + Vector2DistanceSq(position, point.position))), timeStep);
-        }
-    }
-}
+            int i = row * grid.cols + col;
 
-static void WarpGridApplyImplosiveForce(WarpGrid grid, float force, Vector2 position, float radius, float timeStep)
-{
-    for (int i = 0, n = ArrayCount(grid.points); i < n; i++)
-    {
-        PointMass point = grid.points[i];
-        Vector2 diff = Vector2Subtract(position, point.position);
-        float distSq = Vector2LengthSq(diff);
-        if (distSq < radius * radius)
-        {
-            Vector2 appliedForce = Vector2Scale(diff, force * 50.0f / (1000.0f + distSq));
-
-            PointMassApplyForce(&grid.points[i], appliedForce, timeStep);
-            PointMassIncreaseDamping(&grid.points[i], 1.0f / 0.6f);
+            float distSq = Vector2DistanceSq(position, SpringGridPosition(grid, i));
+            if (distSq < radius * radius)
+            {
+                 SpringGridApplyForce(grid, i, Vector2Scale(force, 1.0f / (1.0f + distSq)), timeStep);
+            }
         }
     }
 }
 
-static void WarpGridApplyExplosiveForce(WarpGrid grid, float force, Vector2 position, float radius, float timeStep)
+// Scale particle count of an effect by the current simulation fidelity
+static int ParticleCount(World* world, int count)
 {
-    for (int i = 0, n = ArrayCount(grid.points); i < n; i++)
-    {
-        PointMass point = grid.points[i];
-        Vector2 diff = Vector2Subtract(point.position, position);
-        float distSq = Vector2LengthSq(diff);
-        if (distSq < radius * radius)
-        {
-            Vector2 appliedForce = Vector2Scale(diff, force * 100.0f / (1000.0f + distSq));
-
-            PointMassApplyForce(&grid.points[i], appliedForce, timeStep);
-            PointMassIncreaseDamping(&grid.points[i], 1.0f / 0.6f);
-        }
-    }
+    return (int)(count * world->fidelity + 0.5f);
 }
 
 static inline Vector4 HSV(float h, float s, float v)
@@ -363,7 +239,7 @@ static Entity UpdateEntity(Entity entity, float dt)
 
         .scale = entity.scale,
         .position = Vector2Add(entity.position, Vector2Scale(entity.velocity, entity.movespeed * dt)),
-        .rotation = entity.velocity.x != 0.0f || entity.velocity.y != 0.0f ? atan2f(entity.velocity.y, entity.velocity.x) : entity.rotation,
+        .direction = EntityFacing(entity),
 
         .velocity = entity.velocity,
         .movespeed = entity.movespeed,
@@ -371,7 +247,10 @@ static Entity UpdateEntity(Entity entity, float dt)
         .color = entity.color,
         .radius = entity.radius,
 
-        .texture = entity.texture,
+        .sprite = entity.sprite,
+
+        .prevPosition = entity.prevPosition,
+        .prevDirection = entity.prevDirection,
     };
 }
 
@@ -410,7 +289,7 @@ static Entity UpdateEntityWithBound(Entity entity, Vector2 bound, float dt)
         entity.active,
 
         entity.scale,
-        entity.velocity.x != 0.0f || entity.velocity.y != 0.0f ? atan2f(entity.velocity.y, entity.velocity.x) : entity.rotation,
+        EntityFacing(entity),
         pos,
 
         entity.velocity,
@@ -419,7 +298,10 @@ static Entity UpdateEntityWithBound(Entity entity, Vector2 bound, float dt)
         entity.color,
         entity.radius,
 
-        entity.texture,
+        entity.sprite,
+
+        entity.prevPosition,
+        entity.prevDirection,
     };
 }
 
@@ -431,60 +313,94 @@ static void UpdateEntitiesWithBound(Array(Entity) entities, Vector2 bound, float
     }
 }
 
-static void RenderEntity(Entity entity)
+static void StoreEntityState(Entity* entity)
+{
+    entity->prevPosition = entity->position;
+    entity->prevDirection = entity->direction;
+}
+
+static void StoreEntitiesState(Array(Entity) entities)
+{
+    for (int i = 0, n = ArrayCount(entities); i < n; i++)
+    {
+        StoreEntityState(&entities[i]);
+    }
+}
+
+static void RenderEntity(Entity entity, float alpha)
 {
     if (entity.active)
     {
+        Vector2 position = Vector2Lerp(entity.prevPosition, entity.position, alpha);
+        float   rotation = FastLerpAngle2f(entity.prevDirection.x, entity.prevDirection.y, entity.direction.x, entity.direction.y, alpha);
+
         //DrawTextureEx(entity.texture, entity.position, entity.rotation * RAD2DEG, entity.scale, entity.color
-        DrawTexturePro(
-            entity.texture, 
-            (Rectangle) { 0, 0, entity.texture.width, entity.texture.height }, 
-            (Rectangle) { entity.position.x, entity.position.y, entity.texture.width, entity.texture.height },
-            (Vector2) { entity.texture.width * 0.5f, entity.texture.height * 0.5f },
-            entity.rotation * RAD2DEG, 
+        RendererDrawTexturePro(
+            entity.sprite.texture, 
+            entity.sprite.source, 
+            (Rectangle) { position.x, position.y, entity.sprite.source.width, entity.sprite.source.height },
+            (Vector2) { entity.sprite.source.width * 0.5f, entity.sprite.source.height * 0.5f },
+            rotation * RAD2DEG, 
             entity.color
         );
     }
 }
 
-static void RenderEntities(Array(Entity) entities)
+static void RenderEntities(Array(Entity) entities, float alpha)
 {
     for (int i = 0, n = ArrayCount(entities); i < n; i++)
     {
-        Entity entity = entities[i];
-        if (entity.active)
-        {
-            DrawTexturePro(
-                entity.texture, 
-                (Rectangle) { 0, 0, entity.texture.width, entity.texture.height }, 
-                (Rectangle) { entity.position.x, entity.position.y, entity.texture.width, entity.texture.height },
-                (Vector2) { entity.texture.width * 0.5f, entity.texture.height * 0.5f },
-                entity.rotation * RAD2DEG, 
-                entity.color
-            );
-            //DrawTextureEx(entity.texture, entity.position, entity.rotation * RAD2DEG, entity.scale, entity.color);
-        }
+        RenderEntity(entities[i], alpha);
     }
 }
 
-static void SpawnBullet(World* world, Vector2 pos, Vector2 vel)
+static FreeList(Entity)* GetEntityList(World* world, EntityType type)
 {
-    Texture texture = CacheTexture("Art/Bullet.png");
-    Entity entity = {
-        true,
-        1.0f,
-        atan2f(vel.y, vel.x),
-        pos,
+    switch (type)
+    {
+    case ENTITY_BULLET:     return &world->bullets;
+    case ENTITY_SEEKER:     return &world->seekers;
+    case ENTITY_WANDERER:   return &world->wanderers;
+    case ENTITY_BLACKHOLE:  return &world->blackHoles;
+    default:                return NULL;
+    }
+}
 
-        vel,
-        1280.0f,
+// Events go to the world queue, or to the batch buffer when queued from a parallel pass
+static void QueueEvent(Array(WorldEvent)* events, WorldEvent event)
+{
+    ArrayPush(*events, event);
+}
 
-        WHITE,
-        texture.height * 0.5f,
-        texture,
-    };
+static void QueueSound(World* world, WorldSound sound)
+{
+    QueueEvent(&world->events, (WorldEvent) { .type = WORLD_EVENT_PLAY_SOUND, .playSound = { sound } });
+}
 
-    FreeListAdd(world->bullets, entity);
+static void QueueSpawn(World* world, EntityType entity, Vector2 position, Vector2 velocity)
+{
+    QueueEvent(&world->events, (WorldEvent) { .type = WORLD_EVENT_SPAWN, .spawn = { entity, position, velocity } });
+}
+
+static void QueueGridImpulse(Array(WorldEvent)* events, GridImpulseType impulse, float force, Vector2 position, float radius)
+{
+    QueueEvent(events, (WorldEvent) { .type = WORLD_EVENT_GRID_IMPULSE, .gridImpulse = { impulse, force, position, radius } });
+}
+
+// The entity stop colliding right away, the rest of the destruction is deferred to the flush phase
+static void QueueDestroy(Array(WorldEvent)* events, World* world, EntityType entity, int index, bool explosion)
+{
+    Entity* target = &GetEntityList(world, entity)->elements[index];
+    if (target->active)
+    {
+        target->active = false;
+        QueueEvent(events, (WorldEvent) { .type = WORLD_EVENT_DESTROY, .destroy = { entity, index, explosion, target->position } });
+    }
+}
+
+static void QueueGameOver(World* world)
+{
+    QueueEvent(&world->events, (WorldEvent) { .type = WORLD_EVENT_GAME_OVER });
 }
 
 static void FireBullets(World* world, Vector2 aim_dir)
@@ -497,278 +413,572 @@ static void FireBullets(World* world, Vector2 aim_dir)
     // First bullet
     {
         Vector2 vel = Vector2Normalize(aim_dir);
-        Vector2 pos = Vector2Add(world->player.position, Vector2Scale((Vector2){ cosf(angle + offset), sinf(angle + offset) }, (float)world->player.texture.width * 1.25f));
-        SpawnBullet(world, pos, vel);
+        Vector2 pos = Vector2Add(world->player.position, Vector2Scale((Vector2){ cosf(angle + offset), sinf(angle + offset) }, (float)world->player.sprite.source.width * 1.25f));
+        QueueSpawn(world, ENTITY_BULLET, pos, vel);
     }
 
     // Second bullet
     {
         Vector2 vel = Vector2Normalize(aim_dir);
-        Vector2 pos = Vector2Add(world->player.position, Vector2Scale((Vector2){ cosf(angle - offset), sinf(angle - offset) }, (float)world->player.texture.width * 1.25f));
-        SpawnBullet(world, pos, vel);
+        Vector2 pos = Vector2Add(world->player.position, Vector2Scale((Vector2){ cosf(angle - offset), sinf(angle - offset) }, (float)world->player.sprite.source.width * 1.25f));
+        QueueSpawn(world, ENTITY_BULLET, pos, vel);
     }
+
+    QueueSound(world, WORLD_SOUND_SHOOT);
 }
 
 static Vector2 GetSpawnPosition(World world)
 {
-    const float min_distance_sqr = (GetScreenHeight() * 0.3f) * (GetScreenHeight() * 0.3f);
+    const float min_distance_sqr = (world.bounds.y * 0.3f) * (world.bounds.y * 0.3f);
 
     Vector2 pos;
     do
     {
-        float x = (2.0f * (rand() % 101) / 100.0f - 1.0f) * 0.8f * GetScreenWidth();
-        float y = (2.0f * (rand() % 101) / 100.0f - 1.0f) * 0.8f * GetScreenHeight();
+        float x = (2.0f * (rand() % 101) / 100.0f - 1.0f) * 0.8f * world.bounds.x;
+        float y = (2.0f * (rand() % 101) / 100.0f - 1.0f) * 0.8f * world.bounds.y;
         pos = (Vector2){ x, y };
     } while (Vector2DistanceSq(pos, world.player.position) < min_distance_sqr);
 
     return pos;
 }
 
-static void SpawnSeeker(World* world)
+static void SpawnEnemy(World* world, EntityType type)
 {
-    GameAudioPlaySpawn();
-
     Vector2 pos = GetSpawnPosition(*world);
-    Vector2 vel = Vector2Normalize(Vector2Subtract(world->player.position, pos));
-
-    Texture texture = CacheTexture("Art/Seeker.png");
-
-    Entity entity = {
-        true,
+    Vector2 vel = type == ENTITY_BLACKHOLE ? (Vector2){ 0.0f, 0.0f } : Vector2Normalize(Vector2Subtract(world->player.position, pos));
 
-        1.0f,
-        atan2f(vel.y, vel.x),
-        pos,
-
-        vel,
-        360.0f,
-
-        Fade(WHITE, 0.0f),
-        texture.width * 0.5f,
-        texture
-    };
-
-    FreeListAdd(world->seekers, entity);
+    QueueSpawn(world, type, pos, vel);
+    QueueSound(world, WORLD_SOUND_SPAWN);
 }
 
-static void SpawnWanderer(World* world)
+static void ApplySpawn(World* world, WorldEvent event)
 {
-    GameAudioPlaySpawn();
+    Vector2 pos = event.spawn.position;
+    Vector2 vel = event.spawn.velocity;
 
-    Vector2 pos = GetSpawnPosition(*world);
-    Vector2 vel = Vector2Normalize(Vector2Subtract(world->player.position, pos));
+    Sprite  sprite;
+    float   movespeed;
+    Color   color;
+    float   radius;
 
-    Texture texture = CacheTexture("Art/Wanderer.png");
+    switch (event.spawn.entity)
+    {
+    case ENTITY_BULLET:
+        sprite = CacheSprite("Art/Bullet.png");
+        movespeed = 1280.0f;
+        color = WHITE;
+        radius = sprite.source.height * 0.5f;
+        break;
+
+    case ENTITY_SEEKER:
+        sprite = CacheSprite("Art/Seeker.png");
+        movespeed = 360.0f;
+        color = Fade(WHITE, 0.0f);
+        radius = sprite.source.width * 0.5f;
+        break;
+
+    case ENTITY_WANDERER:
+        sprite = CacheSprite("Art/Wanderer.png");
+        movespeed = 240.0f;
+        color = Fade(WHITE, 0.0f);
+        radius = sprite.source.width * 0.5f;
+        break;
+
+    case ENTITY_BLACKHOLE:
+        sprite = CacheSprite("Art/Black Hole.png");
+        movespeed = 240.0f;
+        color = Fade(WHITE, 0.0f);
+        radius = sprite.source.width * 0.5f;
+        break;
+
+    default:
+        return;
+    }
+
+    Vector2 direction = vel.x != 0.0f || vel.y != 0.0f ? Vector2NormalizeFast(vel) : (Vector2){ 1.0f, 0.0f };
 
     Entity entity = {
         true,
 
         1.0f,
-        atan2f(vel.y, vel.x),
+        direction,
         pos,
 
         vel,
-        240.0f,
+        movespeed,
 
-        Fade(WHITE, 0.0f),
-        texture.width * 0.5f,
-        texture
+        color,
+        radius,
+        sprite,
+
+        pos,
+        direction,
     };
 
-    FreeListAdd(world->wanderers, entity);
+    FreeList(Entity)* list = GetEntityList(world, event.spawn.entity);
+    FreeListAdd(*list, entity);
 }
 
-static void SpawnBlackhole(World* world)
+static void SpawnExplosion(World* world, Vector2 position)
 {
-    GameAudioPlaySpawn();
+    Sprite sprite = CacheSprite("Art/Laser.png");
 
-    Vector2 pos = GetSpawnPosition(*world);
-    Vector2 vel = (Vector2){ 0.0f, 0.0f };
-
-    Texture texture = CacheTexture("Art/Black Hole.png");
-
-    Entity entity = {
-        true,
-
-        1.0f,
-        atan2f(vel.y, vel.x),
-        pos,
-
-        vel,
-        240.0f,
+    float hue1 = rand() % 101 / 100.0f * 6.0f;
+    float hue2 = fmodf(hue1 + (rand() % 101 / 100.0f * 2.0f), 6.0f);
+    Vector4  color1 = HSV(hue1, 0.5f, 1);
+    Vector4  color2 = HSV(hue2, 0.5f, 1);
 
-        Fade(WHITE, 0.0f),
-        texture.width * 0.5f,
-        texture
-    };
+    for (int i = 0, n = ParticleCount(world, 120); i < n; i++)
+    {
+        float speed = 640.0f * (0.2f + (rand() % 101 / 100.0f) * 0.8f);
+        float angle = rand() % 101 / 100.0f * 2 * PI;
+        Vector2  vel = (Vector2){ cosf(angle) * speed, sinf(angle) * speed };
+        Vector4  color = Vector4Add(color1, Vector4Scale(Vector4Subtract(color2, color1), ((rand() % 101) / 100.0f)));
 
-    FreeListAdd(world->blackHoles, entity);
+        SpawnParticle(sprite, position, color, 1.0f, (Vector2){ 1.0f, 1.0f }, 0.0f, vel);
+    }
 }
 
-static void DestroyBullet(World* world, int index, bool explosion)
+static void ApplyDestroy(World* world, WorldEvent event)
 {
-    world->bullets.elements[index].active = false;
-    FreeListCollect(world->bullets, index);
+    FreeList(Entity)* list = GetEntityList(world, event.destroy.entity);
+    FreeListCollect(*list, event.destroy.index);
 
-    if (explosion)
+    if (!event.destroy.explosion)
     {
-        const int PARTICLE_COUNT = 30;
-        Texture texture = CacheTexture("Art/Laser.png");
+        return;
+    }
+
+    if (event.destroy.entity == ENTITY_BULLET)
+    {
+        const int PARTICLE_COUNT = ParticleCount(world, 30);
+        Sprite sprite = CacheSprite("Art/Laser.png");
 
         for (int i = 0; i < PARTICLE_COUNT; i++)
         {
             float speed = 640.0f * (0.2f + (rand() % 101 / 100.0f) * 0.8f);
             float angle = rand() % 101 / 100.0f * 2 * PI;
             Vector2  vel   = (Vector2){ cosf(angle) * speed, sinf(angle) * speed };
-            Vector2  pos   = world->bullets.elements[index].position;
+            Vector2  pos   = event.destroy.position;
             Vector4  color = (Vector4){ 0.6f, 1.0f, 1.0f, 1.0f };
 
-            SpawnParticle(texture, pos, color, 1.0f, (Vector2) { 1.0f, 1.0f }, 0.0f, vel);
+            SpawnParticle(sprite, pos, color, 1.0f, (Vector2) { 1.0f, 1.0f }, 0.0f, vel);
         }
     }
+    else
+    {
+        GameAudioPlayExplosion();
+        SpawnExplosion(world, event.destroy.position);
+    }
 }
 
-static void DestroySeeker(World* world, int index)
+static void ApplyGameOver(World* world)
 {
+    GameAudioStopMusic();
     GameAudioPlayExplosion();
 
-    world->seekers.elements[index].active = false;
-    FreeListCollect(world->seekers, index);
+    FreeListClear(world->bullets);
+    FreeListClear(world->seekers);
+    FreeListClear(world->wanderers);
+    FreeListClear(world->blackHoles);
 
-    Texture texture = CacheTexture("Art/Laser.png");
+    world->gameOverTimer = 3.0f;
+    Sprite sprite = CacheSprite("Art/Laser.png");
 
     float hue1 = rand() % 101 / 100.0f * 6.0f;
     float hue2 = fmodf(hue1 + (rand() % 101 / 100.0f * 2.0f), 6.0f);
     Vector4  color1 = HSV(hue1, 0.5f, 1);
     Vector4  color2 = HSV(hue2, 0.5f, 1);
 
-    for (int i = 0; i < 120; i++)
+    for (int i = 0, n = ParticleCount(world, 1200); i < n; i++)
     {
-        float speed = 640.0f * (0.2f + (rand() % 101 / 100.0f) * 0.8f);
+        float speed = 10.0f * fmaxf(world->bounds.x, world->bounds.y) * (0.6f + (rand() % 101 / 100.0f) * 0.4f);
         float angle = rand() % 101 / 100.0f * 2 * PI;
         Vector2  vel = (Vector2){ cosf(angle) * speed, sinf(angle) * speed };
-        Vector2  pos = world->seekers.elements[index].position;
+
         Vector4  color = Vector4Add(color1, Vector4Scale(Vector4Subtract(color2, color1), ((rand() % 101) / 100.0f)));
+        SpawnParticle(sprite, world->player.position, color, world->gameOverTimer, (Vector2) { 1.0f, 1.0f }, 0.0f, vel);
+    }
+
+    world->player.position = (Vector2){ 0, 0 };
+    world->player.velocity = (Vector2){ 0, 0 };
+    world->player.direction = (Vector2){ 1.0f, 0.0f };
+    StoreEntityState(&world->player);
+}
 
-        SpawnParticle(texture, pos, color, 1.0f, (Vector2){ 1.0f, 1.0f }, 0.0f, vel);
+static void ApplySound(WorldSound sound)
+{
+    switch (sound)
+    {
+    case WORLD_SOUND_SHOOT:     GameAudioPlayShoot(); break;
+    case WORLD_SOUND_SPAWN:     GameAudioPlaySpawn(); break;
+    case WORLD_SOUND_EXPLOSION: GameAudioPlayExplosion(); break;
+    default: break;
     }
 }
 
-void DestroyWanderer(World* world, int index)
+// Apply every grid impulse of this tick, each one visit only the grid cells in its radius
+static void ApplyGridImpulses(SpringGrid grid, const WorldEvent* events, int count, float timeStep)
 {
-    GameAudioPlayExplosion();
+    for (int j = 0; j < count; j++)
+    {
+        if (events[j].type != WORLD_EVENT_GRID_IMPULSE)
+        {
+            continue;
+        }
 
-    world->wanderers.elements[index].active = false;
-    FreeListCollect(world->wanderers, index);
+        GridImpulseType type = events[j].gridImpulse.impulse;
+        float force = events[j].gridImpulse.force;
+        float radius = events[j].gridImpulse.radius;
+        Vector2 position = events[j].gridImpulse.position;
 
-    Texture texture = CacheTexture("Art/Laser.png");
+        SpringGridRange range = SpringGridRangeInRadius(grid, position, radius);
+        for (int row = range.row0; row < range.row1; row++)
+        {
+            for (int col = range.col0; col < range.col1; col++)
+            {
+                int i = row * grid.cols + col;
 
-    float hue1 = rand() % 101 / 100.0f * 6.0f;
-    float hue2 = fmodf(hue1 + (rand() % 101 / 100.0f * 2.0f), 6.0f);
-    Vector4  color1 = HSV(hue1, 0.5f, 1);
-    Vector4  color2 = HSV(hue2, 0.5f, 1);
+                Vector2 diff = Vector2Subtract(SpringGridPosition(grid, i), position);
+                float distSq = Vector2LengthSq(diff);
+                if (distSq < radius * radius)
+                {
+                    float scale = type == GRID_IMPULSE_IMPLOSIVE ? -force * 50.0f : force * 100.0f;
+                    Vector2 appliedForce = Vector2Scale(diff, scale / (1000.0f + distSq));
+
+                    SpringGridApplyForce(grid, i, appliedForce, timeStep);
+                    SpringGridIncreaseDamping(grid, i, 1.0f / 0.6f);
+                }
+            }
+        }
+    }
+}
+
+// Apply deferred events of this tick in batch, the world must not be locked
+static void FlushEvents(World* world, float timeStep)
+{
+    DebugAssert(!world->lock, "World events must be flushed after update passes are done");
 
-    for (int i = 0; i < 120; i++)
+    int count = ArrayCount(world->events);
+    bool gameOver = false;
+
+    // Destroy first, so spawns of this tick can reuse the free slots
+    for (int i = 0; i < count; i++)
     {
-        float speed = 640.0f * (0.2f + (rand() % 101 / 100.0f) * 0.8f);
-        float angle = rand() % 101 / 100.0f * 2 * PI;
-        Vector2  vel = (Vector2){ cosf(angle) * speed, sinf(angle) * speed };
-        Vector2  pos = world->wanderers.elements[index].position;
-        Vector4  color = Vector4Add(color1, Vector4Scale(Vector4Subtract(color2, color1), ((rand() % 101) / 100.0f)));
+        WorldEvent event = world->events[i];
+        if (event.type == WORLD_EVENT_DESTROY)
+        {
+            ApplyDestroy(world, event);
+        }
+        else if (event.type == WORLD_EVENT_GAME_OVER)
+        {
+            gameOver = true;
+        }
+    }
+
+    if (gameOver)
+    {
+        ApplyGameOver(world);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (world->events[i].type == WORLD_EVENT_SPAWN)
+            {
+                ApplySpawn(world, world->events[i]);
+            }
+        }
+    }
+
+    ApplyGridImpulses(world->grid, world->events, count, timeStep);
 
-        SpawnParticle(texture, pos, color, 1.0f, (Vector2){ 1.0f, 1.0f }, 0.0f, vel);
+    for (int i = 0; i < count; i++)
+    {
+        if (world->events[i].type == WORLD_EVENT_PLAY_SOUND)
+        {
+            ApplySound(world->events[i].playSound.sound);
+        }
     }
+
+    // Swap the buffers instead of copying, the queue start empty again
+    Array(WorldEvent) events = world->flushedEvents;
+    world->flushedEvents = world->events;
+    world->events = events;
+    ArrayClear(world->events);
 }
 
-void DestroyBlackhole(World* world, int index)
+bool UpdateBlackhole(Entity* blackhole, Entity* other)
 {
-    GameAudioPlayExplosion();
+    Vector2 diff = Vector2Subtract(blackhole->position, other->position);
+    float distSq = Vector2LengthSq(diff);
 
-    world->blackHoles.elements[index].active = false;
-    FreeListCollect(world->blackHoles, index);
+    float consumeRadius = other->radius + blackhole->radius;
+    float attractRadius = other->radius + blackhole->radius * 10.0f;
 
-    Texture texture = CacheTexture("Art/Laser.png");
+    if (distSq <= consumeRadius * consumeRadius)
+    {
+        return true;
+    }
+    else if (distSq <= attractRadius * attractRadius)
+    {
+        float dist = sqrtf(distSq);
+        Vector2 normal = Vector2Scale(diff, 1.0f / dist);
+        other->velocity = Vector2Add(other->velocity, Vector2Scale(normal, lerpf(1.0f, 0.0f, dist / (blackhole->radius * 10.0f))));
+        other->velocity = Vector2NormalizeFast(other->velocity);
+    }
 
-    float hue1 = rand() % 101 / 100.0f * 6.0f;
-    float hue2 = fmodf(hue1 + (rand() % 101 / 100.0f * 2.0f), 6.0f);
-    Vector4  color1 = HSV(hue1, 0.5f, 1);
-    Vector4  color2 = HSV(hue2, 0.5f, 1);
+    return false;
+}
 
-    for (int i = 0; i < 120; i++)
+// Hash the tick seed with the entity index, so an entity random stream does not depend on which thread run it
+static uint32_t EntityRandomState(uint32_t seed, int index)
+{
+    uint32_t state = seed ^ ((uint32_t)index * 0x9E3779B9u);
+    state = (state ^ (state >> 16)) * 0x85EBCA6Bu;
+    state = (state ^ (state >> 13)) * 0xC2B2AE35u;
+    state = state ^ (state >> 16);
+    return state ? state : 0x6D2B79F5u;
+}
+
+// Xorshift32, return a value in [0, 1]
+static float EntityRandom(uint32_t* state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return (x >> 8) * (1.0f / 16777215.0f);
+}
+
+typedef struct WorldPass
+{
+    World*  world;
+    float   dt;
+} WorldPass;
+
+// Reserve every batch buffer up front, so workers never grow an array (the debug allocator is not thread safe)
+static void BeginPassEvents(World* world, int batchCount)
+{
+    while (ArrayCount(world->passEvents) < batchCount)
     {
-        float speed = 640.0f * (0.2f + (rand() % 101 / 100.0f) * 0.8f);
-        float angle = rand() % 101 / 100.0f * 2 * PI;
-        Vector2  vel = (Vector2){ cosf(angle) * speed, sinf(angle) * speed };
-        Vector2  pos = world->blackHoles.elements[index].position;
-        Vector4  color = Vector4Add(color1, Vector4Scale(Vector4Subtract(color2, color1), ((rand() % 101) / 100.0f)));
+        ArrayPush(world->passEvents, ArrayNew(WorldEvent, ENTITY_BATCH_SIZE * MAX_EVENTS_PER_ENTITY));
+    }
 
-        SpawnParticle(texture, pos, color, 1.0f, (Vector2){ 1.0f, 1.0f }, 0.0f, vel);
+    for (int i = 0; i < batchCount; i++)
+    {
+        ArrayClear(world->passEvents[i]);
+        ArrayEnsure(world->passEvents[i], ENTITY_BATCH_SIZE * MAX_EVENTS_PER_ENTITY);
     }
 }
 
-void OnGameOver(World* world)
+// Merge batch buffers in batch order, the result is the same as a serial pass
+static void EndPassEvents(World* world, int batchCount)
 {
-    GameAudioStopMusic();
-    GameAudioPlayExplosion();
+    for (int i = 0; i < batchCount; i++)
+    {
+        Array(WorldEvent) batchEvents = world->passEvents[i];
+        DebugAssert(ArrayCount(batchEvents) <= ENTITY_BATCH_SIZE * MAX_EVENTS_PER_ENTITY, "Parallel pass queued more events than reserved");
 
-    FreeListClear(world->bullets);
-    FreeListClear(world->seekers);
-    FreeListClear(world->wanderers);
-    FreeListClear(world->blackHoles);
+        for (int j = 0, n = ArrayCount(batchEvents); j < n; j++)
+        {
+            ArrayPush(world->events, batchEvents[j]);
+        }
 
-    world->gameOverTimer = 3.0f;
-    Texture texture = CacheTexture("Art/Laser.png");
+        ArrayClear(world->passEvents[i]);
+    }
+}
 
-    float hue1 = rand() % 101 / 100.0f * 6.0f;
-    float hue2 = fmodf(hue1 + (rand() % 101 / 100.0f * 2.0f), 6.0f);
-    Vector4  color1 = HSV(hue1, 0.5f, 1);
-    Vector4  color2 = HSV(hue2, 0.5f, 1);
+static void RunPass(World* world, int count, ParallelForFunc* func, WorldPass* pass)
+{
+    int batchCount = ParallelForBatchCount(count, ENTITY_BATCH_SIZE);
+    BeginPassEvents(world, batchCount);
 
-    for (int i = 0; i < 1200; i++)
+    if (world->parallel)
     {
-        float speed = 10.0f * fmaxf((float)GetScreenWidth(), (float)GetScreenHeight()) * (0.6f + (rand() % 101 / 100.0f) * 0.4f);
-        float angle = rand() % 101 / 100.0f * 2 * PI;
-        Vector2  vel = (Vector2){ cosf(angle) * speed, sinf(angle) * speed };
+        ParallelFor(count, ENTITY_BATCH_SIZE, func, pass);
+    }
+    else
+    {
+        for (int i = 0; i < batchCount; i++)
+        {
+            int start = i * ENTITY_BATCH_SIZE;
+            func(pass, start, (int)fminf(start + ENTITY_BATCH_SIZE, count), i);
+        }
+    }
 
-        Vector4  color = Vector4Add(color1, Vector4Scale(Vector4Subtract(color2, color1), ((rand() % 101) / 100.0f)));
-        SpawnParticle(texture, world->player.position, color, world->gameOverTimer, (Vector2) { 1.0f, 1.0f }, 0.0f, vel);
+    EndPassEvents(world, batchCount);
+}
+
+static void UpdateBulletsPass(void* userData, int start, int end, int batchIndex)
+{
+    WorldPass* pass = (WorldPass*)userData;
+    World* world = pass->world;
+    Array(WorldEvent)* events = &world->passEvents[batchIndex];
+
+    for (int i = start; i < end; i++)
+    {
+        if (world->bullets.elements[i].active)
+        {
+            Entity bullet = UpdateEntity(FreeListGet(world->bullets, i), pass->dt);
+
+            QueueGridImpulse(events, GRID_IMPULSE_EXPLOSIVE, 4000.0f, bullet.position, 128.0f);
+
+            if (bullet.position.x < -world->bounds.x
+                || bullet.position.x > world->bounds.x
+                || bullet.position.y < -world->bounds.y
+                || bullet.position.y > world->bounds.y)
+            {
+                QueueDestroy(events, world, ENTITY_BULLET, i, true);
+            }
+            else
+            {
+                FreeListSet(world->bullets, i, bullet);
+            }
+        }
     }
+}
 
-    world->player.position = (Vector2){ 0, 0 };
-    world->player.velocity = (Vector2){ 0, 0 };
-    world->player.rotation = 0.0f;
+static void UpdateSeekersPass(void* userData, int start, int end, int batchIndex)
+{
+    WorldPass* pass = (WorldPass*)userData;
+    World* world = pass->world;
+    Array(WorldEvent)* events = &world->passEvents[batchIndex];
+    float dt = pass->dt;
+
+    for (int i = start; i < end; i++)
+    {
+        Entity* s = FreeListRef(world->seekers, i);
+        if (s->active)
+        {
+            if (s->color.a < 255)
+            {
+                int newValue = (int)fmaxf(255, s->color.a + dt * 255);
+                s->color.a = newValue;
+            }
+            else
+            {
+                //MeshGridApplyExplosiveForce(&world->meshGrid, 2.0f * s->movespeed, s->position, dt);
+                QueueGridImpulse(events, GRID_IMPULSE_EXPLOSIVE, 4.0f * s->movespeed, s->position, 30.0f);
+
+                Vector2 dir = Vector2NormalizeFast(Vector2Subtract(world->player.position, s->position));
+                Vector2 acl = Vector2Scale(dir, 10.0f * dt);
+                s->velocity = Vector2NormalizeFast(Vector2Add(s->velocity, acl));
+                *s = UpdateEntity(*s, dt);
+            }
+        }
+    }
 }
 
-bool UpdateBlackhole(Entity* blackhole, Entity* other)
+static void UpdateWanderersPass(void* userData, int start, int end, int batchIndex)
 {
-    if (Vector2Distance(other->position, blackhole->position) <= other->radius + blackhole->radius)
+    WorldPass* pass = (WorldPass*)userData;
+    World* world = pass->world;
+    Array(WorldEvent)* events = &world->passEvents[batchIndex];
+    float dt = pass->dt;
+
+    for (int i = start; i < end; i++)
     {
-        return true;
+        Entity* s = FreeListRef(world->wanderers, i);
+        if (s->active)
+        {
+            if (s->color.a < 255)
+            {
+                int newValue = (int)fmaxf(255, s->color.a + dt * 255);
+                s->color.a = newValue;
+            }
+            else
+            {
+                const int INTERPOLATIONS = 6;
+                const float real_speed = s->movespeed / INTERPOLATIONS;
+
+                uint32_t random = EntityRandomState(world->seed, i);
+
+                // Steer by rotating the unit direction, no angle round trip
+                Vector2 direction = s->direction;
+                for (int j = 0; j < INTERPOLATIONS; j++)
+                {
+                    FastRotate2f(&direction.x, &direction.y, (0.12f * EntityRandom(&random) - 0.06f) * PI);
+
+                    if (s->position.x < -world->bounds.x || s->position.x > world->bounds.x
+                        || s->position.y < -world->bounds.y || s->position.y > world->bounds.y)
+                    {
+                        direction = Vector2NormalizeFast(Vector2Negate(s->position));
+                        FastRotate2f(&direction.x, &direction.y, (1.0f * EntityRandom(&random) - 0.5f) * PI);
+                    }
+
+                    s->direction = direction;
+                    s->velocity = direction;
+                    s->position = Vector2Add(s->position, Vector2Scale(s->velocity, real_speed * dt));
+
+                    // On low fidelity, only the final position disturb the grid
+                    if (world->fidelity >= 0.5f || j == INTERPOLATIONS - 1)
+                    {
+                        QueueGridImpulse(events, GRID_IMPULSE_EXPLOSIVE, 4.0f * s->movespeed, s->position, 30.0f);
+                    }
+                }
+
+                // Cancel the drift of repeated rotations
+                s->direction = Vector2NormalizeFast(s->direction);
+                s->velocity = s->direction;
+            }
+        }
     }
-    else if (Vector2Distance(other->position, blackhole->position) <= other->radius + blackhole->radius * 10.0f)
+}
+
+// Pull the enemies toward every black hole, each enemy only write itself so the pass run per enemy instead of per black hole
+static void AttractEnemies(World* world, Array(WorldEvent)* events, EntityType type, int start, int end)
+{
+    FreeList(Entity)* enemies = GetEntityList(world, type);
+
+    for (int i = start; i < end; i++)
     {
-        Vector2 diff = Vector2Subtract(blackhole->position, other->position);
-        other->velocity = Vector2Add(other->velocity, Vector2Scale(Vector2Normalize(diff), lerpf(1.0f, 0.0f, Vector2Length(diff) / (blackhole->radius * 10.0f))));
-        other->velocity = Vector2Normalize(other->velocity);
+        Entity* other = &enemies->elements[i];
+        if (!other->active || other->color.a < 255) continue;
+
+        for (int j = 0, m = FreeListCount(world->blackHoles); j < m; j++)
+        {
+            Entity* s = &world->blackHoles.elements[j];
+            if (!s->active || s->color.a < 255) continue;
+
+            if (UpdateBlackhole(s, other))
+            {
+                QueueDestroy(events, world, type, i, true);
+                break;
+            }
+        }
     }
+}
 
-    return false;
+static void AttractSeekersPass(void* userData, int start, int end, int batchIndex)
+{
+    World* world = ((WorldPass*)userData)->world;
+    AttractEnemies(world, &world->passEvents[batchIndex], ENTITY_SEEKER, start, end);
 }
 
-World WorldNew(void)
+static void AttractWanderersPass(void* userData, int start, int end, int batchIndex)
+{
+    World* world = ((WorldPass*)userData)->world;
+    AttractEnemies(world, &world->passEvents[batchIndex], ENTITY_WANDERER, start, end);
+}
+
+World WorldNew(Vector2 bounds)
 {
     World world = { 0 };
 
-    world.grid = NewWarpGrid((Rectangle) { -GetScreenWidth() * 1.1f, -GetScreenHeight() * 1.1f, 2.2f * GetScreenWidth(), 2.2f * GetScreenHeight() }, (Vector2) { 128.0f, 128.0f });
+    world.bounds = bounds;
+    world.grid = NewWarpGrid((Rectangle) { -bounds.x * 1.1f, -bounds.y * 1.1f, 2.2f * bounds.x, 2.2f * bounds.y }, (Vector2) { 128.0f, 128.0f });
     
     world.player.active = true;
     world.player.color = WHITE;
     world.player.position = (Vector2) { 0.0f, 0.0f };
-    world.player.rotation = 0.0f;
+    world.player.direction = (Vector2){ 1.0f, 0.0f };
     world.player.scale = 1.0f;
     world.player.movespeed = 720.0f;
-    world.player.texture = CacheTexture("Art/Player.png");
-    world.player.radius = world.player.texture.width * 0.5f;
+    world.player.sprite = CacheSprite("Art/Player.png");
+    world.player.radius = world.player.sprite.source.width * 0.5f;
 
     world.seekerSpawnRate = 80;
     world.wandererSpawnRate = 60;
@@ -784,32 +994,58 @@ World WorldNew(void)
     world.lock = false;
     world.gameOverTimer = 0.5f;
 
+    world.fidelity = 1.0f;
+
     world.bullets = FreeListNew(Entity, 256);
     world.seekers = FreeListNew(Entity, 256);
     world.wanderers = FreeListNew(Entity, 256);
     world.blackHoles = FreeListNew(Entity, 256);
 
+    world.events = ArrayNew(WorldEvent, 256);
+    world.flushedEvents = ArrayNew(WorldEvent, 256);
+    world.passEvents = ArrayNew(Array(WorldEvent), 16);
+    world.parallel = true;
+
     return world;
 }
 
 void WorldFree(World* world)
 {
-    FreeWarpGrid(world->grid);
+    SpringGridFree(&world->grid);
 
     FreeListFree(world->bullets);
     FreeListFree(world->seekers);
     FreeListFree(world->wanderers);
     FreeListFree(world->blackHoles);
 
+    ArrayFree(world->events);
+    ArrayFree(world->flushedEvents);
+
+    for (int i = 0, n = ArrayCount(world->passEvents); i < n; i++)
+    {
+        ArrayFree(world->passEvents[i]);
+    }
+    ArrayFree(world->passEvents);
+
     *world = (World) { 0 };
 }
 
 void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir, bool fire, float dt)
 {
     // Update warp grid
-    UpdateWarpGrid(world->grid, dt);
+    SpringGridUpdate(world->grid, dt);
     //UpdateMeshGrid(&world->meshGrid, dt);
 
+    // Keep the state of last tick, renderer interpolate from it
+    StoreEntityState(&world->player);
+    StoreEntitiesState(world->bullets.elements);
+    StoreEntitiesState(world->seekers.elements);
+    StoreEntitiesState(world->wanderers.elements);
+    StoreEntitiesState(world->blackHoles.elements);
+
+    // The player live for the whole game, pick up the texture of a hot reload before the old one is freed
+    world->player.sprite = CacheSprite("Art/Player.png");
+
     if (world->gameOverTimer > 0.0f)
     {
         world->gameOverTimer -= dt;
@@ -822,6 +1058,9 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
 
     // Update is in progress, locking the list
     world->lock = true;
+    world->seed = (uint32_t)rand();
+
+    WorldPass pass = { world, dt };
    
     Vector2 moveDirection;
     if (horizontal == 0.0f && vertical == 0.0f)
@@ -834,15 +1073,15 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
     }
 
     world->player.velocity = Vector2Lerp(world->player.velocity, moveDirection, 5.0f * dt);
-    world->player = UpdateEntityWithBound(world->player, (Vector2){ GetScreenWidth(), GetScreenHeight() }, dt);
-    WarpGridApplyExplosiveForce(world->grid, 4.0f * world->player.movespeed, world->player.position, 50.0f, dt);
+    world->player = UpdateEntityWithBound(world->player, world->bounds, dt);
+    QueueGridImpulse(&world->events, GRID_IMPULSE_EXPLOSIVE, 4.0f * world->player.movespeed, world->player.position, 50.0f);
     if (Vector2LengthSq(world->player.velocity) > 0.1f && fmodf(GetTime(), 0.025f) <= 0.01f)
     {
         float speed;
         float angle = atan2f(world->player.velocity.y, world->player.velocity.x);
     
-        Texture glow_tex = CacheTexture("Art/Laser.png");
-        Texture line_tex = CacheTexture("Art/Laser.png");
+        Sprite glow_tex = CacheSprite("Art/Laser.png");
+        Sprite line_tex = CacheSprite("Art/Laser.png");
     
         Vector2 vel = Vector2Scale(world->player.velocity, -0.25f * world->player.movespeed);
         Vector2 pos = Vector2Add(world->player.position, Vector2Scale(world->player.velocity, -45.0f));
@@ -866,86 +1105,9 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
         SpawnParticle(line_tex, pos, Vector4Scale((Vector4) { 1.0f, 1.0f, 1.0f, 1.0f }, alpha), 0.4f, (Vector2) { 3.0f, 1.0f }, angle, side_vel2);
     }
 
-    for (int i = 0, n = FreeListCount(world->bullets); i < n; i++)
-    {
-        if (world->bullets.elements[i].active)
-        {
-            Entity bullet = UpdateEntity(FreeListGet(world->bullets, i), dt);
-
-            WarpGridApplyExplosiveForce(world->grid, 4000.0f, bullet.position, 128.0f, dt);
-
-            if (bullet.position.x < -GetScreenWidth()
-                || bullet.position.x > GetScreenWidth()
-                || bullet.position.y < -GetScreenHeight()
-                || bullet.position.y > GetScreenHeight())
-            {
-                DestroyBullet(world, i, true);
-            }
-            else
-            {
-                FreeListSet(world->bullets, i, bullet);
-            }
-        }
-    }
-
-    for (int i = 0, n = FreeListCount(world->seekers); i < n; i++)
-    {
-        Entity* s = FreeListRef(world->seekers, i);
-        if (s->active)
-        {
-            if (s->color.a < 255)
-            {
-                int newValue = (int)fmaxf(255, s->color.a + dt * 255);
-                s->color.a = newValue;
-            }
-            else
-            {
-                //MeshGridApplyExplosiveForce(&world->meshGrid, 2.0f * s->movespeed, s->position, dt);
-                WarpGridApplyExplosiveForce(world->grid, 4.0f * s->movespeed, s->position, 30.0f, dt);
-
-                Vector2 dir = Vector2Normalize(Vector2Subtract(world->player.position, s->position));
-                Vector2 acl = Vector2Scale(dir, 10.0f * dt);
-                s->velocity = Vector2Normalize(Vector2Add(s->velocity, acl));
-                *s = UpdateEntity(*s, dt);
-            }
-        }
-    }
-
-    for (int i = 0, n = FreeListCount(world->wanderers); i < n; i++)
-    {
-        Entity* s = FreeListRef(world->wanderers, i);
-        if (s->active)
-        {
-            if (s->color.a < 255)
-            {
-                int newValue = (int)fmaxf(255, s->color.a + dt * 255);
-                s->color.a = newValue;
-            }
-            else
-            {
-                const int INTERPOLATIONS = 6;
-                const float real_speed = s->movespeed / INTERPOLATIONS;
-
-                float direction = atan2f(s->velocity.y, s->velocity.x);
-                for (int j = 0; j < INTERPOLATIONS; j++)
-                {
-                    direction += (0.12f * (rand() % 101 / 100.0f) - 0.06f) * PI;
-
-                    if (s->position.x < -GetScreenWidth() || s->position.x > GetScreenWidth()
-                        || s->position.y < -GetScreenHeight() || s->position.y > GetScreenHeight())
-                    {
-                        direction = atan2f(-s->position.y, -s->position.x) + (1.0f * (rand() % 101 / 100.0f) - 0.5f) * PI;
-                    }
-
-                    s->rotation = direction;
-                    s->velocity = (Vector2){ cosf(direction), sinf(direction) };
-                    s->position = Vector2Add(s->position, Vector2Scale(s->velocity, real_speed * dt));
-
-                    WarpGridApplyExplosiveForce(world->grid, 4.0f * s->movespeed, s->position, 30.0f, dt);
-                }
-            }
-        }
-    }
+    RunPass(world, FreeListCount(world->bullets), UpdateBulletsPass, &pass);
+    RunPass(world, FreeListCount(world->seekers), UpdateSeekersPass, &pass);
+    RunPass(world, FreeListCount(world->wanderers), UpdateWanderersPass, &pass);
 
     for (int i = 0, n = FreeListCount(world->bullets); i < n; i++)
     {
@@ -959,8 +1121,8 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
 
             if (Vector2Distance(b->position, s->position) <= b->radius + s->radius)
             {
-                DestroyBullet(world, i, true);
-                DestroySeeker(world, j);
+                QueueDestroy(&world->events, world, ENTITY_BULLET, i, true);
+                QueueDestroy(&world->events, world, ENTITY_SEEKER, j, true);
                 break;
             }
         }
@@ -973,8 +1135,8 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
 
             if (Vector2Distance(b->position, s->position) <= b->radius + s->radius)
             {
-                DestroyBullet(world, i, true);
-                DestroyWanderer(world, j);
+                QueueDestroy(&world->events, world, ENTITY_BULLET, i, true);
+                QueueDestroy(&world->events, world, ENTITY_WANDERER, j, true);
                 break;
             }
         }
@@ -988,15 +1150,15 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
             float d = Vector2Distance(b->position, s->position);
             if (d <= b->radius + s->radius)
             {
-                DestroyBullet(world, i, true);
-                DestroyBlackhole(world, j);
+                QueueDestroy(&world->events, world, ENTITY_BULLET, i, true);
+                QueueDestroy(&world->events, world, ENTITY_BLACKHOLE, j, true);
                 break;
             }
             else if (d <= b->radius + s->radius * 5.0f)
             {
                 float r = b->radius + s->radius * 5.0f;
                 float t = (d - r) / r;
-                b->velocity = Vector2Normalize(Vector2Add(b->velocity, Vector2Scale(Vector2Normalize(Vector2Subtract(b->position, s->position)), 0.3f)));
+                b->velocity = Vector2NormalizeFast(Vector2Add(b->velocity, Vector2Scale(Vector2NormalizeFast(Vector2Subtract(b->position, s->position)), 0.3f)));
             }
         }
     }
@@ -1008,7 +1170,7 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
 
         if (Vector2Distance(world->player.position, s->position) <= world->player.radius + s->radius)
         {
-            OnGameOver(world);
+            QueueGameOver(world);
             break;
         }
     }
@@ -1020,7 +1182,7 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
 
         if (Vector2Distance(world->player.position, s->position) <= world->player.radius + s->radius)
         {
-            OnGameOver(world);
+            QueueGameOver(world);
             break;
         }
     }
@@ -1030,8 +1192,8 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
         Entity* s = &world->blackHoles.elements[i];
         if (s->active)
         {
-            Texture glow_tex = CacheTexture("Art/Glow.png");
-            Texture line_tex = CacheTexture("Art/Laser.png");
+            Sprite glow_tex = CacheSprite("Art/Glow.png");
+            Sprite line_tex = CacheSprite("Art/Laser.png");
 
             Vector4 color1 = (Vector4){ 0.3f, 0.8f, 0.4f, 1.0f };
             Vector4 color2 = (Vector4){ 0.5f, 1.0f, 0.7f, 1.0f };
@@ -1052,21 +1214,21 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
 
             if (GetFrameCount() % 60 == 0)
             {
-                Texture texture = CacheTexture("Art/Laser.png");
+                Sprite sprite = CacheSprite("Art/Laser.png");
 
                 float hue1 = rand() % 101 / 100.0f * 6.0f;
                 float hue2 = fmodf(hue1 + (rand() % 101 / 100.0f * 2.0f), 6.0f);
                 Vector4  color1 = HSV(hue1, 0.5f, 1);
                 Vector4  color2 = HSV(hue2, 0.5f, 1);
 
-                for (int i = 0; i < 120.0f; i++)
+                for (int i = 0, n = ParticleCount(world, 120); i < n; i++)
                 {
                     float speed = 180.0f;
                     float angle = rand() % 101 / 100.0f * 2 * PI;
                     Vector2  vel = (Vector2){ cosf(angle) * speed, sinf(angle) * speed };
                     Vector2  pos = Vector2Add(s->position, vel);
                     Vector4  color = Vector4Add(color1, Vector4Scale(Vector4Subtract(color2, color1), ((rand() % 101) / 100.0f)));
-                    SpawnParticle(texture, pos, color, 2.0f, (Vector2) { 1.0f, 1.0f }, 0.0f, (Vector2) { 0.0f, 0.0f });
+                    SpawnParticle(sprite, pos, color, 2.0f, (Vector2) { 1.0f, 1.0f }, 0.0f, (Vector2) { 0.0f, 0.0f });
                 }
             }
 
@@ -1077,41 +1239,20 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
             }
             else
             {
-                WarpGridApplyImplosiveForce(world->grid, 2000.0f, s->position, 1024.0f, dt);
+                QueueGridImpulse(&world->events, GRID_IMPULSE_IMPLOSIVE, 2000.0f, s->position, 1024.0f);
 
                 if (UpdateBlackhole(s, &world->player))
                 {
-                    OnGameOver(world);
+                    QueueGameOver(world);
                     break;
                 }
-
-                for (int j = 0, m = FreeListCount(world->seekers); j < m; j++)
-                {
-                    Entity* other = &world->seekers.elements[j];
-                    if (!other->active || other->color.a < 255) continue;
-
-                    if (UpdateBlackhole(s, other))
-                    {
-                        DestroySeeker(world, j);
-                        break;
-                    }
-                }
-
-                for (int j = 0, m = FreeListCount(world->wanderers); j < m; j++)
-                {
-                    Entity* other = &world->wanderers.elements[j];
-                    if (!other->active || other->color.a < 255) continue;
-
-                    if (UpdateBlackhole(s, other))
-                    {
-                        DestroyWanderer(world, j);
-                        break;
-                    }
-                }
             }
         }
     }
 
+    RunPass(world, FreeListCount(world->seekers), AttractSeekersPass, &pass);
+    RunPass(world, FreeListCount(world->wanderers), AttractWanderersPass, &pass);
+
     // Update is done, unlock the list
     world->lock = false;
 
@@ -1136,8 +1277,6 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
         {
             world->fireTimer = 0;
             FireBullets(world, aim_dir);
-
-            GameAudioPlayShoot();
         }
     }
 
@@ -1147,26 +1286,69 @@ void WorldUpdate(World* world, float horizontal, float vertical, Vector2 aim_dir
     {
         world->spawnTimer -= world->spawnInterval;
 
-        if (rand() % 101 < world->seekerSpawnRate) SpawnSeeker(world);
-        if (rand() % 101 < world->wandererSpawnRate) SpawnWanderer(world);
-        if (rand() % 101 < world->blackHoleSpawnRate) SpawnBlackhole(world);
+        if (rand() % 101 < world->seekerSpawnRate) SpawnEnemy(world, ENTITY_SEEKER);
+        if (rand() % 101 < world->wandererSpawnRate) SpawnEnemy(world, ENTITY_WANDERER);
+        if (rand() % 101 < world->blackHoleSpawnRate) SpawnEnemy(world, ENTITY_BLACKHOLE);
+    }
+
+    // Apply destructions, spawns and side effects of this tick
+    FlushEvents(world, dt);
+}
+
+void WorldSpawnStress(World* world, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        EntityType type = i % 2 == 0 ? ENTITY_SEEKER : ENTITY_WANDERER;
+
+        Vector2 pos = GetSpawnPosition(*world);
+        Vector2 vel = Vector2Normalize(Vector2Subtract(world->player.position, pos));
+        QueueSpawn(world, type, pos, vel);
+    }
+
+    QueueSound(world, WORLD_SOUND_SPAWN);
+}
+
+int WorldEnemyCount(World world)
+{
+    int count = 0;
+
+    for (int i = 0, n = FreeListCount(world.seekers); i < n; i++)
+    {
+        count += world.seekers.elements[i].active;
     }
+
+    for (int i = 0, n = FreeListCount(world.wanderers); i < n; i++)
+    {
+        count += world.wanderers.elements[i].active;
+    }
+
+    for (int i = 0, n = FreeListCount(world.blackHoles); i < n; i++)
+    {
+        count += world.blackHoles.elements[i].active;
+    }
+
+    return count;
 }
 
-void WorldRender(World world)
+void WorldRender(World world, float alpha)
 {
-    RenderWarpGrid(world.grid);
+    RendererBeginSection("RenderWarpGrid");
+    RenderWarpGrid(world.grid, alpha);
     //RenderMeshGrid(world.meshGrid);
+    RendererEndSection();
 
     if (world.gameOverTimer > 0)
     {
         return;
     }
 
-    RenderEntity(world.player);
-    RenderEntities(world.bullets.elements);
-    RenderEntities(world.seekers.elements);
-    RenderEntities(world.wanderers.elements);
-    RenderEntities(world.blackHoles.elements);
+    RendererBeginSection("RenderEntities");
+    RenderEntity(world.player, alpha);
+    RenderEntities(world.bullets.elements, alpha);
+    RenderEntities(world.seekers.elements, alpha);
+    RenderEntities(world.wanderers.elements, alpha);
+    RenderEntities(world.blackHoles.elements, alpha);
+    RendererEndSection();
 }
 
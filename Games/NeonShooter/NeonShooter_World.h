@@ -1,16 +1,20 @@
 #pragma once
 
 #include <raylib.h>
+#include <stdint.h>
 
 #include <Array.h>
 #include <FreeList.h>
+#include <SpringGrid.h>
+
+#include "NeonShooter_Assets.h"
 
 typedef struct Entity
 {
     bool    active;
 
     float   scale;
-    float   rotation;
+    Vector2 direction;  // Unit facing, the rotation angle is only derived at render time
     Vector2 position;
 
     Vector2 velocity;
@@ -19,45 +23,63 @@ typedef struct Entity
     Color   color;
     float   radius;
 
-    Texture texture;
+    Sprite  sprite;
+
+    // State at the start of the current tick, for render interpolation
+    Vector2 prevPosition;
+    Vector2 prevDirection;
 } Entity;
 
 FreeListStruct(Entity);
 
-typedef struct PointMass
+typedef enum EntityType
 {
-    Vector2 position;
-    Vector2 velocity;
-    Vector2 acceleration;
-    float invMass;
-    float damping;
-} PointMass;
+    ENTITY_BULLET,
+    ENTITY_SEEKER,
+    ENTITY_WANDERER,
+    ENTITY_BLACKHOLE,
+} EntityType;
 
-typedef struct Spring
+typedef enum WorldSound
 {
-    PointMass* p0;
-    PointMass* p1;
-
-    float targetLength;
-    float stiffness;
-    float damping;
-    float force;
-} Spring;
+    WORLD_SOUND_SHOOT,
+    WORLD_SOUND_SPAWN,
+    WORLD_SOUND_EXPLOSION,
+} WorldSound;
 
-typedef struct WarpGrid
+typedef enum GridImpulseType
 {
-    int cols;
-    int rows; 
+    GRID_IMPULSE_EXPLOSIVE,
+    GRID_IMPULSE_IMPLOSIVE,
+} GridImpulseType;
 
-    Array(Spring)    springs;
-
-    Array(PointMass) points;
-    Array(PointMass) fixedPoints;
-} WarpGrid;
+typedef enum WorldEventType
+{
+    WORLD_EVENT_SPAWN,
+    WORLD_EVENT_DESTROY,
+    WORLD_EVENT_PLAY_SOUND,
+    WORLD_EVENT_GRID_IMPULSE,
+    WORLD_EVENT_GAME_OVER,
+} WorldEventType;
+
+// Side effect recorded by update passes, applied in batch at the end of the tick
+typedef struct WorldEvent
+{
+    WorldEventType type;
+    union
+    {
+        struct { EntityType entity; Vector2 position; Vector2 velocity; }                   spawn;
+        struct { EntityType entity; int index; bool explosion; Vector2 position; }          destroy;
+        struct { WorldSound sound; }                                                        playSound;
+        struct { GridImpulseType impulse; float force; Vector2 position; float radius; }    gridImpulse;
+    };
+} WorldEvent;
 
 typedef struct World
 {
-    WarpGrid grid;
+    Vector2         bounds;     // Entities stay in [-bounds, bounds], the screen size in the game
+
+    SpringGrid      grid;       // Warp grid in the background, pushed by explosions and black holes
 
     Entity          player;
 
@@ -77,13 +99,36 @@ typedef struct World
     float           spawnTimer;
     float           spawnInterval;
 
+    // Update passes are running, structural changes must go through events
     bool            lock;
     float           gameOverTimer;
+
+    Array(WorldEvent) events;
+
+    // Events applied by the last flush, in order, kept until the next flush to compare runs
+    Array(WorldEvent) flushedEvents;
+
+    // Per batch event buffers of parallel update passes, merged in batch order
+    Array(Array(WorldEvent)) passEvents;
+
+    // Run update passes on the job system, results are the same either way
+    bool            parallel;
+
+    // Random seed of the current tick, entities derive their own stream from it
+    uint32_t        seed;
+
+    // Scale of effects (particles, grid disturbances), lowered when ticks are over budget
+    float           fidelity;
 } World;
 
-World   WorldNew(void);
+World   WorldNew(Vector2 bounds);
 void    WorldFree(World* world);
 
 void    WorldUpdate(World* world, float horizontalInput, float verticalInput, Vector2 aimDir, bool fire, float deltaTime);
-void    WorldRender(World world);
+void    WorldRender(World world, float alpha);
+
+// Queue count enemies (half seekers, half wanderers) to benchmark update passes
+void    WorldSpawnStress(World* world, int count);
+
+int     WorldEnemyCount(World world);
 
@@ -0,0 +1,199 @@
+#include <raylib.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Array.h>
+#include <Memory.h>
+#include <AssetArchive.h>
+
+// Pack every file of an asset directory into one archive
+// Images and waves are stored decoded (RGBA8 pixels, PCM samples), the runtime map them without decoding
+// Other files (shaders, music streams) are stored as is
+
+#define MAX_PATH_LENGTH 512
+
+static char* CopyString(const char* text)
+{
+    size_t length = strlen(text);
+    char* result = (char*)MemoryAlloc(length + 1);
+    MemoryCopy(result, text, length + 1);
+    return result;
+}
+
+static void* CopyData(const void* data, size_t size)
+{
+    void* result = MemoryAlloc(size > 0 ? size : 1);
+    MemoryCopy(result, data, size);
+    return result;
+}
+
+static bool ReadRawFile(const char* path, void** outData, uint64_t* outSize)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void* data = MemoryAlloc(size > 0 ? (size_t)size : 1);
+    bool result = size >= 0 && fread(data, 1, (size_t)size, file) == (size_t)size;
+    fclose(file);
+
+    if (!result)
+    {
+        MemoryFree(data);
+        return false;
+    }
+
+    *outData = data;
+    *outSize = (uint64_t)size;
+    return true;
+}
+
+static bool PackFile(Array(AssetArchiveBlob)* blobs, const char* path, const char* name)
+{
+    AssetArchiveBlob blob = { 0 };
+
+    if (IsFileExtension(path, ".png"))
+    {
+        Image image = LoadImage(path);
+        if (!image.data)
+        {
+            return false;
+        }
+
+        ImageFormat(&image, UNCOMPRESSED_R8G8B8A8);
+
+        blob.type = ASSET_IMAGE;
+        blob.size = (uint64_t)image.width * image.height * 4;
+        blob.data = CopyData(image.data, (size_t)blob.size);
+        blob.params[0] = (uint32_t)image.width;
+        blob.params[1] = (uint32_t)image.height;
+        blob.params[2] = (uint32_t)image.format;
+        blob.params[3] = 1;
+
+        UnloadImage(image);
+    }
+    else if (IsFileExtension(path, ".wav"))
+    {
+        Wave wave = LoadWave(path);
+        if (!wave.data)
+        {
+            return false;
+        }
+
+        blob.type = ASSET_WAVE;
+        blob.size = (uint64_t)wave.sampleCount * (wave.sampleSize / 8);
+        blob.data = CopyData(wave.data, (size_t)blob.size);
+        blob.params[0] = wave.sampleCount;
+        blob.params[1] = wave.sampleRate;
+        blob.params[2] = wave.sampleSize;
+        blob.params[3] = wave.channels;
+
+        UnloadWave(wave);
+    }
+    else
+    {
+        void* data;
+        if (!ReadRawFile(path, &data, &blob.size))
+        {
+            return false;
+        }
+
+        blob.type = ASSET_RAW;
+        blob.data = data;
+    }
+
+    blob.name = CopyString(name);
+    ArrayPush(*blobs, blob);
+
+    printf("  %-40s %10llu bytes\n", name, (unsigned long long)blob.size);
+    return true;
+}
+
+// name is the path relative to the asset root, with '/' separators
+static bool PackDirectory(Array(AssetArchiveBlob)* blobs, const char* root, const char* relative)
+{
+    char directory[MAX_PATH_LENGTH];
+    snprintf(directory, sizeof(directory), relative[0] ? "%s/%s" : "%s", root, relative);
+
+    // GetDirectoryFiles reuse its buffer on each call, copy the names before recursing
+    int count = 0;
+    char** files = GetDirectoryFiles(directory, &count);
+
+    Array(char*) names = ArrayNew(char*, count > 0 ? count : 1);
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(files[i], ".") != 0 && strcmp(files[i], "..") != 0)
+        {
+            ArrayPush(names, CopyString(files[i]));
+        }
+    }
+    ClearDirectoryFiles();
+
+    bool result = true;
+    for (int i = 0, n = ArrayCount(names); i < n && result; i++)
+    {
+        char path[MAX_PATH_LENGTH];
+        char name[MAX_PATH_LENGTH];
+        snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+        snprintf(name, sizeof(name), relative[0] ? "%s/%s" : "%s%s", relative, names[i]);
+
+        if (DirectoryExists(path))
+        {
+            result = PackDirectory(blobs, root, name);
+        }
+        else if (!PackFile(blobs, path, name))
+        {
+            fprintf(stderr, "Failed to pack: %s\n", path);
+            result = false;
+        }
+    }
+
+    for (int i = 0, n = ArrayCount(names); i < n; i++)
+    {
+        MemoryFree(names[i]);
+    }
+    ArrayFree(names);
+
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        printf("Usage: AssetPacker <asset directory> <output archive>\n");
+        return 1;
+    }
+
+    const char* root = argv[1];
+    const char* output = argv[2];
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    Array(AssetArchiveBlob) blobs = ArrayNew(AssetArchiveBlob, 64);
+
+    printf("Packing %s\n", root);
+    bool result = PackDirectory(&blobs, root, "");
+
+    if (result)
+    {
+        result = AssetArchiveWrite(output, blobs, ArrayCount(blobs));
+        printf(result ? "Wrote %s (%d assets)\n" : "Failed to write %s\n", output, ArrayCount(blobs));
+    }
+
+    for (int i = 0, n = ArrayCount(blobs); i < n; i++)
+    {
+        MemoryFree((void*)blobs[i].name);
+        MemoryFree((void*)blobs[i].data);
+    }
+    ArrayFree(blobs);
+
+    return result ? 0 : 1;
+}
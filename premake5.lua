@@ -133,6 +133,10 @@ local function game(name)
     template(name, path.join("Games", name), true)
 end
 
+local function tool(name)
+    template(name, path.join("Tools", name))
+end
+
 example "BasicWindow"
 example "Gestures"
 example "AppState"
@@ -147,5 +151,8 @@ example "UI"
 example "ECS"
 example "FLECS"
 example "Spine"
+example "Benchmarks"
+
+game "NeonShooter"
 
-game "NeonShooter"
\ No newline at end of file
+tool "AssetPacker"
\ No newline at end of file